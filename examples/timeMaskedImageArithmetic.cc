@@ -0,0 +1,110 @@
+// -*- lsst-c++ -*-
+
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Time the MaskedImage arithmetic operators, and report the memory bandwidth they achieve.
+ *
+ * Each operation reads all three planes of both operands and writes all three planes of the left-hand
+ * operand, so the bandwidth is computed from 2 * sizeof(lhs pixel) + sizeof(rhs pixel) bytes per pixel.
+ */
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lsst/geom.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/image.h"
+
+namespace image = lsst::afw::image;
+
+int main(int argc, char **argv) {
+    using MaskedImageT = image::MaskedImage<float>;
+    const unsigned DefNIter = 20;
+    const unsigned DefNCols = 4096;
+    const int DefNThreads = 1;
+
+    if ((argc == 2) && (argv[1][0] == '-')) {
+        std::cout << "Usage: timeMaskedImageArithmetic [nIter [nCols [nRows [nThreads]]]]" << std::endl;
+        std::cout << "nIter (default " << DefNIter << ") is the number of iterations" << std::endl;
+        std::cout << "nCols (default " << DefNCols << ") is the number of columns" << std::endl;
+        std::cout << "nRows (default = nCols) is the number of rows" << std::endl;
+        std::cout << "nThreads (default " << DefNThreads << ") is the number of threads; 0 for all cores"
+                  << std::endl;
+        return 1;
+    }
+
+    unsigned nIter = DefNIter;
+    if (argc > 1) {
+        std::istringstream(argv[1]) >> nIter;
+    }
+    unsigned nCols = DefNCols;
+    if (argc > 2) {
+        std::istringstream(argv[2]) >> nCols;
+    }
+    unsigned nRows = nCols;
+    if (argc > 3) {
+        std::istringstream(argv[3]) >> nRows;
+    }
+    int nThreads = DefNThreads;
+    if (argc > 4) {
+        std::istringstream(argv[4]) >> nThreads;
+    }
+    lsst::afw::detail::setDefaultNumThreads(nThreads);
+
+    MaskedImageT mimage1(lsst::geom::Extent2I(nCols, nRows));
+    MaskedImageT mimage2(mimage1.getDimensions());
+    mimage1 = MaskedImageT::SinglePixel(1.0, 0x0, 1.0);
+    mimage2 = MaskedImageT::SinglePixel(1.0, 0x1, 1.0);
+
+    std::vector<std::pair<std::string, std::function<void()>>> const operations = {
+            {"+=", [&]() { mimage1 += mimage2; }},
+            {"-=", [&]() { mimage1 -= mimage2; }},
+            {"scaledPlus", [&]() { mimage1.scaledPlus(0.5, mimage2); }},
+            {"scaledMinus", [&]() { mimage1.scaledMinus(0.5, mimage2); }},
+            {"*=", [&]() { mimage1 *= mimage2; }},
+            {"/=", [&]() { mimage1 /= mimage2; }},
+    };
+
+    double const megaPix = static_cast<double>(nCols) * nRows / 1.0e6;
+    double const bytesPerPix = 3.0 * (sizeof(MaskedImageT::Image::Pixel) + sizeof(MaskedImageT::Mask::Pixel) +
+                                      sizeof(MaskedImageT::Variance::Pixel));
+    std::cout << "Cols\tRows\tThreads\tOperation\tSecPerIter\tSecPerIterPerMPix\tGBPerSec" << std::endl;
+    for (auto const &operation : operations) {
+        operation.second();  // warm up, and fault in the pages
+        auto const startTime = std::chrono::steady_clock::now();
+        for (unsigned iter = 0; iter < nIter; ++iter) {
+            operation.second();
+        }
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - startTime;
+        double const secPerIter = elapsed.count() / nIter;
+        std::cout << nCols << "\t" << nRows << "\t" << lsst::afw::detail::getDefaultNumThreads() << "\t"
+                  << operation.first << "\t\t" << secPerIter << "\t" << secPerIter / megaPix << "\t"
+                  << megaPix * 1.0e6 * bytesPerPix / secPerIter / 1.0e9 << std::endl;
+    }
+}
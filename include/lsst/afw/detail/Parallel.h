@@ -0,0 +1,115 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_DETAIL_PARALLEL_H
+#define LSST_AFW_DETAIL_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace detail {
+
+/*
+ * Return the number of threads afw's internal parallel loops use when the
+ * caller does not request a specific number.
+ *
+ * The default is one (i.e., serial execution), since most pipelines already
+ * parallelize at the process level.  It may be changed with
+ * setDefaultNumThreads or the AFW_NUM_THREADS environment variable.
+ */
+int getDefaultNumThreads();
+
+/*
+ * Set the number of threads afw's internal parallel loops use by default.
+ *
+ * A value of zero or less selects the number of hardware threads.
+ */
+void setDefaultNumThreads(int nThreads);
+
+/*
+ * Resolve a requested thread count: zero or negative values select the
+ * afw default.
+ */
+inline int resolveNumThreads(int nThreads) { return nThreads > 0 ? nThreads : getDefaultNumThreads(); }
+
+/*
+ * Call `function(i)` for every i in [begin, end), splitting the range into
+ * contiguous chunks that are processed concurrently.
+ *
+ * Each index is visited exactly once; the function must therefore only write
+ * to state that is private to its index.  If any invocation throws, the
+ * remaining work in that chunk is abandoned and the first exception (by
+ * chunk order) is rethrown in the calling thread once all threads have
+ * joined.
+ *
+ * @param[in] begin  First index.
+ * @param[in] end  One past the last index.
+ * @param[in] function  Functor taking a std::size_t.
+ * @param[in] nThreads  Number of threads to use; zero or negative selects
+ *                      getDefaultNumThreads().
+ */
+template <typename Function>
+void parallelFor(std::size_t begin, std::size_t end, Function const& function, int nThreads = 0) {
+    std::size_t const num = end > begin ? end - begin : 0;
+    std::size_t const numChunks = std::min(num, static_cast<std::size_t>(resolveNumThreads(nThreads)));
+    if (numChunks <= 1) {
+        for (std::size_t ii = begin; ii < end; ++ii) {
+            function(ii);
+        }
+        return;
+    }
+    std::vector<std::exception_ptr> errors(numChunks);
+    auto work = [&](std::size_t chunk) {
+        try {
+            std::size_t const stop = begin + (chunk + 1) * num / numChunks;
+            for (std::size_t ii = begin + chunk * num / numChunks; ii < stop; ++ii) {
+                function(ii);
+            }
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(numChunks - 1);
+    for (std::size_t chunk = 1; chunk < numChunks; ++chunk) {
+        threads.emplace_back(work, chunk);
+    }
+    work(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (auto const &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+}  // namespace detail
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_DETAIL_PARALLEL_H
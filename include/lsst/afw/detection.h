@@ -33,5 +33,6 @@
 #include "lsst/afw/detection/Peak.h"
 #include "lsst/afw/detection/Psf.h"
 #include "lsst/afw/detection/GaussianPsf.h"
+#include "lsst/afw/detection/OversampledPsf.h"
 
 #endif
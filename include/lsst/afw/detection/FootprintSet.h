@@ -27,6 +27,9 @@
  * Represent a collections of footprints associated with image data
  */
 #include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
 
 #include "lsst/geom.h"
 #include "lsst/afw/detection/Threshold.h"
@@ -197,14 +200,39 @@ public:
      */
     std::shared_ptr<image::Image<FootprintIdPixel>> insertIntoImage(const bool relativeIDs) const;
 
+    /**
+     * Pass an Image with pixels set to the Footprint%s in the FootprintSet to a function, a band of
+     * rows at a time
+     *
+     * The bands together hold the same pixels as the Image returned by insertIntoImage, but only one
+     * band is in memory at once, so label images of large regions can be written out as they are made.
+     * The Footprint%s are visited in order of their bounding boxes, and each band only looks at
+     * those that overlap it.
+     *
+     * @param function Called with each band in order of increasing y.  A band spans the width of the
+     *                 region, and its xy0 gives its position.  Its pixels are reused for the next band,
+     *                 so the function must copy any that it needs to keep.
+     * @param bandHeight Number of rows in each band; the last band may have fewer
+     * @param relativeIDs Use IDs starting at 0 (rather than the ones in the Footprint%s)
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if bandHeight is not positive
+     * @throws lsst::pex::exceptions::OutOfRangeError if a Footprint extends beyond the region
+     */
+    void insertIntoImageBands(std::function<void(image::Image<FootprintIdPixel> const&)> const& function,
+                              int bandHeight, bool relativeIDs) const;
+
+    /**
+     * Set a mask plane in the pixels of all the Footprint%s
+     *
+     * The Footprint%s are swept through the mask in order of their bounding boxes, a few rows at a
+     * time.
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if a Footprint extends beyond the mask
+     */
     template <typename MaskPixelT>
     void setMask(image::Mask<MaskPixelT>* mask,  ///< Set bits in the mask
                  std::string const& planeName    ///< Here's the name of the mask plane to fit
-    ) {
-        for (auto const& foot : *_footprints) {
-            foot->getSpans()->setMask(*mask, image::Mask<MaskPixelT>::getPlaneBitMask(planeName));
-        }
-    }
+    );
 
     template <typename MaskPixelT>
     void setMask(std::shared_ptr<image::Mask<MaskPixelT>> mask,  ///< Set bits in the mask
@@ -226,8 +254,14 @@ public:
     /**
      * Convert all the Footprints in the FootprintSet to be HeavyFootprint%s
      *
+     * The pixel arrays of all the HeavyFootprint%s share one allocation per
+     * plane, and are filled concurrently (using afw's default number of
+     * threads) unless ctrl asks for the source pixels to be reset.
+     *
      * @param mimg the image providing pixel values
      * @param ctrl Control how we manipulate HeavyFootprints
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if a Footprint is not contained in mimg
      */
     template <typename ImagePixelT, typename MaskPixelT>
     void makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const& mimg,
@@ -37,7 +37,8 @@ namespace detection {
  *  This class is essentially an alternate implementation of meas::algorithms::SingleGaussianPsf;
  *  While SingleGaussianPsf inherits from ImagePsf and KernelPsf, and hence delegates to those
  *  various operations relating to the PSF model image (e.g. computeShape()), GaussianPsf computes
- *  these analytically.
+ *  these analytically.  Images, including those at sub-pixel offsets, are sampled directly from the
+ *  Gaussian as the outer product of 1-d profiles in x and y, and normalized to unit sum.
  */
 class GaussianPsf : public afw::table::io::PersistableFacade<GaussianPsf>, public Psf {
 public:
@@ -87,13 +88,10 @@ protected:
     void write(OutputArchiveHandle& handle) const override;
 
 private:
-#if 0  // We could reimplement this more efficiently than what's in the base class,
-      // but it's tricky to get the position right in all corner cases, and it's
-      // not actually performance-critical, so we should just wait for #3116.
-    virtual std::shared_ptr<Image> doComputeImage(
-        lsst::geom::Point2D const & position, image::Color const& color
-    ) const;
-#endif
+    // Evaluates the Gaussian directly at the offset position, instead of shifting the kernel image
+    // with a warping kernel as the base class does.
+    std::shared_ptr<Image> doComputeImage(lsst::geom::Point2D const& position,
+                                          image::Color const& color) const override;
 
     std::shared_ptr<Image> doComputeKernelImage(lsst::geom::Point2D const& position,
                                                 image::Color const& color) const override;
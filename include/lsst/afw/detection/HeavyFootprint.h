@@ -74,6 +74,22 @@ public:
      */
     explicit HeavyFootprint(Footprint const& foot, HeavyFootprintCtrl const* ctrl = NULL);
 
+    /**
+     * Create a HeavyFootprint from a regular Footprint and arrays that
+     * already hold its flattened pixel values.  The arrays are shared, not
+     * copied; this is used to extract many HeavyFootprints at once.
+     *
+     * @param foot The Footprint defining the pixels
+     * @param image The image values, in the order used by SpanSet::flatten
+     * @param mask The mask values, in the same order
+     * @param variance The variance values, in the same order
+     *
+     * @throws lsst::pex::exceptions::LengthError if any array's size is not foot.getArea()
+     */
+    HeavyFootprint(Footprint const& foot, ndarray::Array<ImagePixelT, 1, 1> const& image,
+                   ndarray::Array<MaskPixelT, 1, 1> const& mask,
+                   ndarray::Array<VariancePixelT, 1, 1> const& variance);
+
     /**
      * Default constructor for HeavyFootprint. Most common use for this will be in combination
      * with the assignment operator
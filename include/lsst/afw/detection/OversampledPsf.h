@@ -0,0 +1,147 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_DETECTION_OversampledPsf_h_INCLUDED
+#define LSST_AFW_DETECTION_OversampledPsf_h_INCLUDED
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "lsst/geom.h"
+#include "lsst/afw/detection/Psf.h"
+
+namespace lsst {
+namespace afw {
+namespace detection {
+
+/**
+ *  A Psf that computes sub-pixel-shifted images of another Psf from precomputed oversampled images.
+ *
+ *  Psf::computeImage normally shifts a kernel image to the requested sub-pixel position with a
+ *  Lanczos convolution each time it is called.  OversampledPsf instead divides a bounding box into
+ *  square cells, and the first time an image is requested in a cell it samples the wrapped Psf on a
+ *  grid `oversampling` times finer than the pixels, by calling its computeImage at each of the
+ *  `oversampling**2` sub-pixel phases at the center of the cell.  Images at any position in the
+ *  cell are then interpolated from that grid with a separable four-tap cubic (Catmull-Rom) filter,
+ *  which needs the same filter weights for every pixel of the image, and renormalized to unit sum.
+ *  Positions outside the bounding box use the nearest cell.
+ *
+ *  Images at positions whose sub-pixel offset is one of the precomputed phases are identical to
+ *  those of the wrapped Psf at the cell center; others differ by the (small) interpolation error of
+ *  the cubic filter on the oversampled grid, and by the spatial variation of the wrapped Psf within
+ *  a cell.  Kernel images, shapes, aperture fluxes and bounding boxes are delegated to the wrapped
+ *  Psf, as are images computed for a specific (not indeterminate) color.
+ *
+ *  Cells are computed lazily, and may be computed from several threads at once.
+ */
+class OversampledPsf : public afw::table::io::PersistableFacade<OversampledPsf>, public Psf {
+public:
+    /**
+     *  Construct an OversampledPsf
+     *
+     *  @param[in] psf           Psf to approximate.
+     *  @param[in] bbox          Pixel region divided into cells.
+     *  @param[in] cellSize      Width and height of each cell, in pixels.
+     *  @param[in] oversampling  Number of samples per pixel in each dimension of the oversampled
+     *                           images.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if `psf` is null, `bbox` is empty, or
+     *      `cellSize` or `oversampling` is not positive.
+     */
+    OversampledPsf(std::shared_ptr<Psf const> psf, lsst::geom::Box2I const& bbox, int cellSize = 256,
+                   int oversampling = 4);
+
+    ~OversampledPsf() override;
+    OversampledPsf(OversampledPsf const&);
+    OversampledPsf(OversampledPsf&&) = delete;
+    OversampledPsf& operator=(OversampledPsf const&) = delete;
+    OversampledPsf& operator=(OversampledPsf&&) = delete;
+
+    /// Polymorphic deep copy; the copy recomputes its cells as needed.
+    std::shared_ptr<Psf> clone() const override;
+
+    /// Return a clone with specified kernel dimensions
+    std::shared_ptr<Psf> resized(int width, int height) const override;
+
+    /// Return the wrapped Psf.
+    std::shared_ptr<Psf const> getPsf() const { return _psf; }
+
+    /// Return the pixel region divided into cells.
+    lsst::geom::Box2I getBBox() const { return _bbox; }
+
+    /// Return the width and height of each cell, in pixels.
+    int getCellSize() const { return _cellSize; }
+
+    /// Return the number of samples per pixel in each dimension of the oversampled images.
+    int getOversampling() const { return _oversampling; }
+
+    lsst::geom::Point2D getAveragePosition() const override { return _psf->getAveragePosition(); }
+
+    /// Whether the Psf is persistable; true if the wrapped Psf is.
+    bool isPersistable() const noexcept override { return _psf->isPersistable(); }
+
+protected:
+    std::string getPersistenceName() const override;
+
+    std::string getPythonModule() const override;
+
+    void write(OutputArchiveHandle& handle) const override;
+
+private:
+    struct Cell;
+
+    std::shared_ptr<Image> doComputeImage(lsst::geom::Point2D const& position,
+                                          image::Color const& color) const override;
+
+    std::shared_ptr<Image> doComputeKernelImage(lsst::geom::Point2D const& position,
+                                                image::Color const& color) const override;
+
+    double doComputeApertureFlux(double radius, lsst::geom::Point2D const& position,
+                                 image::Color const& color) const override;
+
+    geom::ellipses::Quadrupole doComputeShape(lsst::geom::Point2D const& position,
+                                              image::Color const& color) const override;
+
+    lsst::geom::Box2I doComputeBBox(lsst::geom::Point2D const& position,
+                                    image::Color const& color) const override;
+
+    // Return the cell containing (or nearest to) a position, computing it if necessary
+    std::shared_ptr<Cell const> _getCell(lsst::geom::Point2D const& position) const;
+
+    std::shared_ptr<Cell const> _makeCell(int i, int j) const;
+
+    std::shared_ptr<Psf const> _psf;
+    lsst::geom::Box2I _bbox;
+    int _cellSize;
+    int _oversampling;
+    int _nCellsX;
+    int _nCellsY;
+    mutable std::mutex _mutex;
+    mutable std::vector<std::shared_ptr<Cell const>> _cells;
+};
+
+}  // namespace detection
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_DETECTION_OversampledPsf_h_INCLUDED
@@ -25,11 +25,11 @@
 
 #include <string>
 #include <limits>
+#include <vector>
 
 #include <memory>
 
 #include "lsst/daf/base/Citizen.h"
-#include "lsst/utils/CacheFwd.h"
 #include "lsst/afw/geom/ellipses/Quadrupole.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/image/Color.h"
@@ -40,8 +40,8 @@ namespace afw {
 namespace detection {
 namespace detail {
 
-/// Key for caching PSFs with lsst::utils::Cache
-struct PsfCacheKey;
+/// Thread-safe cache of PSF images, keyed by position
+class PsfCache;
 
 }  // namespace detail
 
@@ -132,8 +132,8 @@ public:
      *  @param[in]  owner        Whether to copy the return value or return an internal image that
      *                           must be handled with care (see ImageOwnerEnum).
      *
-     *  The Psf class caches the most recent return value of computeImage, so repeated calls
-     *  with the same arguments will be highly optimized.
+     *  The Psf class caches recent return values of computeImage (see setCacheCapacity and
+     *  setCacheGridSpacing), so repeated calls with the same arguments will be highly optimized.
      *
      *  @note The real work is done in the virtual private member function Psf::doComputeImage;
      *        computeImage only handles caching and default arguments.
@@ -142,6 +142,24 @@ public:
                                         image::Color color = image::Color(),
                                         ImageOwnerEnum owner = COPY) const;
 
+    /**
+     *  Return Images of the PSF at many positions, as computeImage would.
+     *
+     *  @param[in]  positions    Positions to evaluate the PSF at; NaN positions are replaced by
+     *                           getAveragePosition().
+     *  @param[in]  color        Color of the sources for which to evaluate the PSF; defaults to
+     *                           getAverageColor().
+     *  @param[in]  owner        Whether to copy the return values or return internal images that
+     *                           must be handled with care (see ImageOwnerEnum).
+     *
+     *  Images that are not already cached are computed by a single call to the virtual private
+     *  member function Psf::doComputeImages, which derived classes may override to share work
+     *  between positions.
+     */
+    std::vector<std::shared_ptr<Image>> computeImages(std::vector<lsst::geom::Point2D> const& positions,
+                                                      image::Color color = image::Color(),
+                                                      ImageOwnerEnum owner = COPY) const;
+
     /**
      *  Return an Image of the PSF, in a form suitable for convolution.
      *
@@ -158,8 +176,8 @@ public:
      *  @param[in]  owner        Whether to copy the return value or return an internal image that
      *                           must be handled with care (see ImageOwnerEnum).
      *
-     *  The Psf class caches the most recent return value of computeKernelImage, so repeated calls
-     *  with the same arguments will be highly optimized.
+     *  The Psf class caches recent return values of computeKernelImage (see setCacheCapacity and
+     *  setCacheGridSpacing), so repeated calls with the same arguments will be highly optimized.
      *
      *  @note The real work is done in the virtual private member function Psf::doComputeKernelImage;
      *        computeKernelImage only handles caching and default arguments.
@@ -168,6 +186,17 @@ public:
                                               image::Color color = image::Color(),
                                               ImageOwnerEnum owner = COPY) const;
 
+    /**
+     *  Return Images of the PSF suitable for convolution at many positions, as computeKernelImage
+     *  would.
+     *
+     *  Images that are not already cached are computed by a single call to the virtual private
+     *  member function Psf::doComputeKernelImages; see computeImages.
+     */
+    std::vector<std::shared_ptr<Image>> computeKernelImages(
+            std::vector<lsst::geom::Point2D> const& positions, image::Color color = image::Color(),
+            ImageOwnerEnum owner = COPY) const;
+
     /**
      *   Return the peak value of the PSF image.
      *
@@ -270,9 +299,37 @@ public:
     /** Set the capacity of the caches
      *
      * Both the image and kernel image caches will be set to this capacity.
+     *
+     * The caches are thread-safe: computeImage, computeKernelImage and their batch versions may be
+     * called on one Psf from many threads at once, provided the derived class's doCompute* member
+     * functions may be too.  Each cache is split into shards with their own locks and
+     * least-recently-used lists, so the capacity is shared approximately evenly between the shards,
+     * and images may be evicted slightly before the cache as a whole is full.
+     *
+     * This is not thread-safe, and must not be called while other threads are using the Psf.
      */
     void setCacheCapacity(std::size_t capacity);
 
+    /// Return the spacing of the grid kernel images are computed on; zero if there is none.
+    double getCacheGridSpacing() const { return _cacheGridSpacing; }
+
+    /** Compute and cache kernel images on a grid of positions
+     *
+     * When the spacing is positive, computeKernelImage and computeKernelImages round each position
+     * to the nearest point on a grid with this spacing (in pixels) before computing or looking up a
+     * kernel image, so nearby requests share a cache entry.  computeImage and computeImages then
+     * compute their images by shifting the kernel image for the nearest grid point to the exact
+     * position, as recenterKernelImage does, so they remain centered on the requested position; only
+     * the shape of the PSF is taken from the grid point.  A spacing of zero (the default) disables
+     * the grid, and images are computed at the exact positions by doComputeImage.
+     *
+     * Like setCacheCapacity, this is not thread-safe, and must not be called while other threads are
+     * using the Psf.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the spacing is negative.
+     */
+    void setCacheGridSpacing(double spacing);
+
 protected:
     /**
      *  Main constructor for subclasses.
@@ -291,11 +348,18 @@ private:
      *  functions instead so as to let the Psf base class handle caching properly.
      *
      *  Derived classes are responsible for ensuring that returned images sum to one.
+     *
+     *  The default implementations of doComputeImages and doComputeKernelImages call
+     *  doComputeImage and doComputeKernelImage once for each position.
      */
     virtual std::shared_ptr<Image> doComputeImage(lsst::geom::Point2D const& position,
                                                   image::Color const& color) const;
     virtual std::shared_ptr<Image> doComputeKernelImage(lsst::geom::Point2D const& position,
                                                         image::Color const& color) const = 0;
+    virtual std::vector<std::shared_ptr<Image>> doComputeImages(
+            std::vector<lsst::geom::Point2D> const& positions, image::Color const& color) const;
+    virtual std::vector<std::shared_ptr<Image>> doComputeKernelImages(
+            std::vector<lsst::geom::Point2D> const& positions, image::Color const& color) const;
     virtual double doComputeApertureFlux(double radius, lsst::geom::Point2D const& position,
                                          image::Color const& color) const = 0;
     virtual geom::ellipses::Quadrupole doComputeShape(lsst::geom::Point2D const& position,
@@ -304,10 +368,16 @@ private:
                                             image::Color const& color) const = 0;
     //@}
 
+    lsst::geom::Point2D _resolvePosition(lsst::geom::Point2D position, bool forKernel) const;
+
+    std::vector<std::shared_ptr<Image>> _computeImages(
+            detail::PsfCache& cache, std::vector<lsst::geom::Point2D> const& positions,
+            image::Color const& color, ImageOwnerEnum owner, bool forKernel) const;
+
     bool const _isFixed;
-    using PsfCache = utils::Cache<detail::PsfCacheKey, std::shared_ptr<Image>>;
-    std::unique_ptr<PsfCache> _imageCache;
-    std::unique_ptr<PsfCache> _kernelImageCache;
+    double _cacheGridSpacing;
+    std::unique_ptr<detail::PsfCache> _imageCache;
+    std::unique_ptr<detail::PsfCache> _kernelImageCache;
 };
 }  // namespace detection
 }  // namespace afw
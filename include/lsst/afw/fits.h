@@ -299,6 +299,8 @@ class Fits {
     void writeImageImpl(T const* data, int nElements);
     template <typename T>
     void readImageImpl(int nAxis, T* data, long* begin, long* end, long* increment);
+    template <typename T>
+    bool readCompressedImageImpl(T* data, long const* begin, long const* end, int nThreads);
     void getImageShapeImpl(int maxDim, long* nAxes);
 
 public:
@@ -709,6 +711,21 @@ std::shared_ptr<daf::base::PropertyList> readMetadata(fits::Fits& fitsfile, bool
 void setAllowImageCompression(bool allow);
 bool getAllowImageCompression();
 
+/**
+ *  Set the number of threads used to decompress tile-compressed images on read.
+ *
+ *  When more than one thread is requested, reading (a subimage of) a tile-compressed
+ *  image HDU bypasses cfitsio's serial decompression: only the tiles that intersect the
+ *  requested region are read, and they are decompressed concurrently directly into the
+ *  destination array.  Compression schemes that this path doesn't support (PLIO,
+ *  HCOMPRESS, 64-bit integers, non-trivially scaled integers) fall back to cfitsio.
+ *
+ *  @param[in] nThreads  Number of threads; zero or negative means use the afw default
+ *                       (see the AFW_NUM_THREADS environment variable).
+ */
+void setImageReadThreads(int nThreads);
+int getImageReadThreads();
+
 
 
 /**
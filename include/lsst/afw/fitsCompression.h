@@ -154,6 +154,40 @@ std::shared_ptr<PixelArrayBase> makePixelArray(int bitpix, ndarray::Array<T, 1,
     }
 }
 
+/// Random number generator used by cfitsio to dither quantized pixels
+///
+/// We use the exact same random numbers that cfitsio generates, and copy the implementation
+/// for the indexing, so pixels can be quantized (when writing) and restored (when reading)
+/// without going through cfitsio.  The random sequence is shared, but each instance has its
+/// own indices, so separate instances may be used from different threads.
+class CfitsioRandom {
+public:
+    /// Ctor
+    ///
+    /// @param[in] seed  Dither seed (ZDITHER0); must be positive.
+    explicit CfitsioRandom(int seed);
+
+    /// Reset the indices for the i-th tile (counting from zero)
+    void resetForTile(int iTile);
+
+    /// Get the next value
+    float getNext();
+
+    /// Fill an array with the next `num` random values
+    void fill(double* out, std::size_t num);
+
+private:
+    /// Increment the indices
+    void increment();
+
+    /// Start the run of indices over with the new seed value
+    void reseed();
+
+    int _seed;   // Initial seed
+    int _start;  // Starting index for tile; "iseed" in cfitsio
+    int _index;  // Index of next value; "nextrand" in cfitsio
+};
+
 }  // namespace detail
 
 /// Options for tile compression of image pixels
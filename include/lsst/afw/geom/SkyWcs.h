@@ -352,6 +352,41 @@ public:
     }
     //@}
 
+    /**
+     * Compute sky positions from columns of pixel positions.
+     *
+     * The points are transformed in chunks through a scratch buffer that is reused for every chunk,
+     * so no point objects or full-size intermediate arrays are made; this is the fastest way to
+     * transform the centroids of a large catalog.
+     *
+     * @param[in] x, y  Pixel positions.
+     * @param[out] ra, dec  Sky positions in radians, with RA in [0, 2pi); may be views into catalog
+     *                      columns.  Must be the same size as x and y.
+     * @param[in] nThreads  Number of threads to use; zero or negative selects the afw default.
+     *
+     * @throws lsst::pex::exceptions::LengthError if the arrays do not all have the same size.
+     */
+    void pixelToSky(ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y,
+                    ndarray::Array<double, 1> const &ra, ndarray::Array<double, 1> const &dec,
+                    int nThreads = 0) const;
+
+    /**
+     * Compute pixel positions from columns of sky positions.
+     *
+     * @param[in] ra, dec  Sky positions in radians.
+     * @param[out] x, y  Pixel positions; may be views into catalog columns.  Must be the same size as
+     *                   ra and dec.
+     * @param[in] nThreads  Number of threads to use; zero or negative selects the afw default.
+     *
+     * @throws lsst::pex::exceptions::LengthError if the arrays do not all have the same size.
+     *
+     * @see pixelToSky(ndarray::Array<double const, 1> const &, ndarray::Array<double const, 1> const &,
+     *                 ndarray::Array<double, 1> const &, ndarray::Array<double, 1> const &, int)
+     */
+    void skyToPixel(ndarray::Array<double const, 1> const &ra, ndarray::Array<double const, 1> const &dec,
+                    ndarray::Array<double, 1> const &x, ndarray::Array<double, 1> const &y,
+                    int nThreads = 0) const;
+
     static std::string getShortClassName();
 
     /**
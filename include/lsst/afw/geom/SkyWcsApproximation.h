@@ -0,0 +1,139 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_SkyWcsApproximation_h_INCLUDED
+#define LSST_AFW_GEOM_SkyWcsApproximation_h_INCLUDED
+
+#include <memory>
+#include <vector>
+
+#include "lsst/geom/Angle.h"
+#include "lsst/geom/Box.h"
+#include "lsst/geom/Point.h"
+#include "lsst/geom/SpherePoint.h"
+#include "lsst/afw/geom/SkyWcs.h"
+#include "lsst/afw/geom/TransformApproximation.h"
+#include "lsst/afw/table/io/Persistable.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+
+/**
+ *  A fast, thread-safe approximation to a SkyWcs over a pixel bounding box.
+ *
+ *  Pixel coordinates are mapped to a gnomonic projection about a tangent point near the center of
+ *  the box by a TransformApproximation, and the projection is inverted in closed form, so the
+ *  approximation is well-behaved at the poles and across RA = 0.  Like TransformApproximation, it
+ *  never calls AST after construction and may be shared between threads.
+ *
+ *  pixelToSky and skyToPixel have the same signatures as in SkyWcs, so code templated on the WCS
+ *  type can use either.
+ */
+class SkyWcsApproximation final : public table::io::PersistableFacade<SkyWcsApproximation>,
+                                  public table::io::Persistable {
+public:
+    /**
+     *  Approximate a SkyWcs.
+     *
+     *  @param[in]  wcs             WCS to approximate.
+     *  @param[in]  bbox            Pixel bounding box over which the approximation is valid.
+     *  @param[in]  skyTolerance    Target maximum error of pixelToSky.
+     *  @param[in]  pixelTolerance  Target maximum error of skyToPixel, in pixels.
+     *  @param[in]  order           Order of the Chebyshev polynomial in each patch.
+     *  @param[in]  maxLevel        Maximum number of times the bbox may be split in each dimension.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the bbox is empty, a tolerance is
+     *      not positive, or the order or maximum level is out of range.
+     */
+    SkyWcsApproximation(SkyWcs const &wcs, lsst::geom::Box2D const &bbox, lsst::geom::Angle skyTolerance,
+                        double pixelTolerance, int order = 5, int maxLevel = 6);
+
+    /**
+     *  Construct from an existing approximation; intended for persistence.
+     *
+     *  @param[in]  tangentPoint  Tangent point of the gnomonic projection.
+     *  @param[in]  planeScale    Size of a unit of the projection plane, in radians.
+     *  @param[in]  transform     Approximate transform from pixels to the projection plane.
+     */
+    SkyWcsApproximation(lsst::geom::SpherePoint const &tangentPoint, double planeScale,
+                        std::shared_ptr<TransformApproximation const> transform);
+
+    SkyWcsApproximation(SkyWcsApproximation const &) = default;
+    SkyWcsApproximation(SkyWcsApproximation &&) = default;
+    SkyWcsApproximation &operator=(SkyWcsApproximation const &) = delete;
+    SkyWcsApproximation &operator=(SkyWcsApproximation &&) = delete;
+    ~SkyWcsApproximation() override = default;
+
+    /// Compute the approximate sky position of a pixel.
+    lsst::geom::SpherePoint pixelToSky(lsst::geom::Point2D const &pixel) const;
+
+    /// Compute the approximate sky positions of many pixels.
+    std::vector<lsst::geom::SpherePoint> pixelToSky(std::vector<lsst::geom::Point2D> const &pixels) const;
+
+    /// Compute the approximate pixel position of a sky position.
+    lsst::geom::Point2D skyToPixel(lsst::geom::SpherePoint const &sky) const;
+
+    /// Compute the approximate pixel positions of many sky positions.
+    std::vector<lsst::geom::Point2D> skyToPixel(std::vector<lsst::geom::SpherePoint> const &sky) const;
+
+    /// Return the pixel bounding box of the approximation.
+    lsst::geom::Box2D const &getBBox() const { return _transform->getBBox(); }
+
+    /// Return the tangent point of the intermediate gnomonic projection.
+    lsst::geom::SpherePoint const &getTangentPoint() const { return _tangentPoint; }
+
+    /// Return an upper bound on the largest error of pixelToSky found in validation.
+    lsst::geom::Angle getMaxSkyError() const;
+
+    /// Return the largest error of skyToPixel found in validation, in pixels.
+    double getMaxPixelError() const { return _transform->getMaxInverseError(); }
+
+    /// Return the approximate transform from pixels to the (scaled) projection plane.
+    std::shared_ptr<TransformApproximation const> getTransform() const { return _transform; }
+
+    bool isPersistable() const noexcept override { return true; }
+
+protected:
+    std::string getPersistenceName() const override;
+    std::string getPythonModule() const override;
+    void write(OutputArchiveHandle &handle) const override;
+
+private:
+    lsst::geom::SpherePoint _tangentPoint;
+    double _planeScale;  // radians per unit of the projection plane
+    // Unit vectors toward the tangent point, east, and north.
+    double _center[3];
+    double _east[3];
+    double _north[3];
+    std::shared_ptr<TransformApproximation const> _transform;
+
+    void _initialize();
+    lsst::geom::Point2D _project(lsst::geom::SpherePoint const &sky) const;
+    lsst::geom::SpherePoint _deproject(lsst::geom::Point2D const &plane) const;
+};
+
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_GEOM_SkyWcsApproximation_h_INCLUDED
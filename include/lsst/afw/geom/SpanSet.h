@@ -236,6 +236,9 @@ public:
     bool contains(SpanSet const &other) const;
 
     /** Check if a point is contained within the SpanSet instance
+     *
+     * Takes time logarithmic in the number of Spans in the point's row, unless the SpanSet was
+     * constructed from Spans that were neither normalized nor sorted.
      *
      * @param point An integer point object for which membership is to be tested
      */
@@ -739,6 +742,14 @@ private:
      */
     void _initialize();
 
+    /* Build the per-row index used by _findSpan; called by every constructor that creates spans
+     */
+    void _buildRowIndex();
+
+    /* Return the Span containing a point, or nullptr if no Span does
+     */
+    Span const *_findSpan(lsst::geom::Point2I const &point) const;
+
     /* Label Spans according to contiguous group. If the SpanSet is contiguous, all Spans will be labeled 1.
      * If there is more than one group each group will receive a label one higher than the previous.
      */
@@ -775,6 +786,13 @@ private:
 
     // Number of pixels in the SpanSet
     std::size_t _area;
+
+    // True if the Spans are sorted and no two Spans in a row overlap, so they may be binary searched
+    bool _sorted = true;
+
+    // Offsets into _spanVector of the first Span in each row of _bbox, plus one past the last row;
+    // empty if the SpanSet is too sparse in y for a table to be worthwhile
+    std::vector<std::size_t> _rowOffsets;
 };
 }  // namespace geom
 }  // namespace afw
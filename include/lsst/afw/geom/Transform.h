@@ -32,6 +32,7 @@
 #include "ndarray.h"
 
 #include "lsst/afw/geom/Endpoint.h"
+#include "lsst/afw/geom/detail/ThreadLocalMapping.h"
 #include "lsst/afw/table/io/Persistable.h"
 
 namespace lsst {
@@ -56,12 +57,19 @@ class SkyWcs;
  *
  * Transforms are always immutable.
  *
+ * applyForward, applyInverse, getJacobian and inverted may be called on the same Transform from any
+ * number of threads at once.  Each thread evaluates its own deep copy of the mapping: the thread that
+ * constructed the Transform is given one at construction, and any other thread makes one the first
+ * time it is needed (see detail::ThreadLocalMapping), so there is no need to copy a Transform or
+ * SkyWcs for each thread.  The mapping returned by getMapping is the one those copies are made from;
+ * it is not protected in this way, and must not be evaluated while other threads may be using the
+ * Transform.
+ *
  * @note You gain some safety by constructing a Transform from an ast::FrameSet,
  * since the base and current frames in the FrameSet can be checked against by the appropriate endpoint.
  *
- * @note "In place" versions of `applyForward` and `applyInverse` are not available
- * because data must be copied when converting from LSST data types to the type used by astshim,
- * so it didn't seem worth the bother.
+ * @note "In place" versions of `applyForward` and `applyInverse` are only available for raw endpoint
+ * data (the layout astshim uses), because data must be copied when converting from LSST data types.
  */
 template <class FromEndpoint, class ToEndpoint>
 class Transform final : public table::io::PersistableFacade<Transform<FromEndpoint, ToEndpoint>>,
@@ -115,14 +123,14 @@ public:
      *
      * @exceptsafe Provides basic exception safety.
      */
-    bool hasForward() const { return _mapping->hasForward(); }
+    bool hasForward() const { return _threadMapping->get().hasForward(); }
 
     /**
      * Test if this method has an inverse transform.
      *
      * @exceptsafe Provides basic exception safety.
      */
-    bool hasInverse() const { return _mapping->hasInverse(); }
+    bool hasInverse() const { return _threadMapping->get().hasInverse(); }
 
     /**
      * Get the "from" endpoint
@@ -167,6 +175,35 @@ public:
      */
     FromArray applyInverse(ToArray const &array) const;
 
+    /**
+     * Transform raw endpoint data in the forward direction into a preallocated array
+     *
+     * Raw data has shape (nAxes, nPoints), with the values for each axis in the units the endpoint
+     * uses internally (e.g. radians for a SpherePointEndpoint).  No points or endpoint arrays are
+     * constructed, so this is suited to transforming large columns of data in chunks through a
+     * reusable buffer.
+     *
+     * @param[in] rawFrom  Input data with shape (getFromEndpoint().getNAxes(), nPoints).
+     * @param[out] rawTo  Output data with shape (getToEndpoint().getNAxes(), nPoints).
+     *
+     * @throws lsst::pex::exceptions::LengthError if either array has the wrong shape.
+     */
+    void applyForward(ndarray::Array<double const, 2, 2> const &rawFrom,
+                      ndarray::Array<double, 2, 2> const &rawTo) const;
+
+    /**
+     * Transform raw endpoint data in the inverse direction into a preallocated array
+     *
+     * @param[in] rawTo  Input data with shape (getToEndpoint().getNAxes(), nPoints).
+     * @param[out] rawFrom  Output data with shape (getFromEndpoint().getNAxes(), nPoints).
+     *
+     * @throws lsst::pex::exceptions::LengthError if either array has the wrong shape.
+     *
+     * @see applyForward(ndarray::Array<double const, 2, 2> const &, ndarray::Array<double, 2, 2> const &)
+     */
+    void applyInverse(ndarray::Array<double const, 2, 2> const &rawTo,
+                      ndarray::Array<double, 2, 2> const &rawFrom) const;
+
     //@{
     /**
      * The inverse of this Transform.
@@ -288,6 +325,7 @@ private:
     FromEndpoint _fromEndpoint;
     std::shared_ptr<const ast::Mapping> _mapping;
     ToEndpoint _toEndpoint;
+    std::shared_ptr<detail::ThreadLocalMapping const> _threadMapping;  // for evaluating _mapping
 };
 
 /**
@@ -0,0 +1,166 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_TransformApproximation_h_INCLUDED
+#define LSST_AFW_GEOM_TransformApproximation_h_INCLUDED
+
+#include <memory>
+#include <vector>
+
+#include "lsst/geom/Box.h"
+#include "lsst/geom/Point.h"
+#include "lsst/afw/geom/Transform.h"
+#include "lsst/afw/geom/detail/ChebyshevPatches.h"
+#include "lsst/afw/table/io/Persistable.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+
+/**
+ *  A fast, thread-safe approximation to a TransformPoint2ToPoint2 over a bounding box.
+ *
+ *  The approximation is a piecewise Chebyshev interpolant on an adaptively refined grid of
+ *  patches (see detail::ChebyshevPatches).  It is built once by evaluating the true Transform in a
+ *  few large batches, after which it never calls AST; applying it involves only a table lookup and
+ *  a low-order polynomial evaluation per point.  Unlike Transform it holds no mutable state, so a
+ *  single instance may be used concurrently from any number of threads.
+ *
+ *  It supports the same applyForward and applyInverse calls as Transform, and may be used in
+ *  place of it where only those are needed.  The inverse is fit over the bounding box of the
+ *  forward transform's values on the input bbox.  The reported maximum errors are measured on a
+ *  validation grid roughly twice as dense as the points used to fit each patch; errors between
+ *  those points are not strictly bounded, but are in practice much smaller than the tolerance for
+ *  smooth transforms.  Points outside the bounding boxes are extrapolated from the nearest patch,
+ *  with no guarantee of accuracy.
+ */
+class TransformApproximation final : public table::io::PersistableFacade<TransformApproximation>,
+                                     public table::io::Persistable {
+public:
+    /// A function evaluated at many points at once.
+    typedef detail::ChebyshevPatches::Function Function;
+
+    /**
+     *  Approximate a Transform.
+     *
+     *  @param[in]  transform  Transform to approximate.  Its inverse is approximated as well
+     *                         if it has one.
+     *  @param[in]  bbox       Input-coordinate bounding box over which the approximation is valid.
+     *  @param[in]  tolerance  Target maximum error, in output coordinates for the forward transform
+     *                         and input coordinates for the inverse.
+     *  @param[in]  order      Order of the Chebyshev polynomial in each patch.
+     *  @param[in]  maxLevel   Maximum number of times the bbox may be split in each dimension.
+     *
+     *  If the tolerance cannot be reached with maxLevel levels of refinement, the approximation is
+     *  still constructed; check getMaxForwardError() and getMaxInverseError().
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the bbox is empty, the tolerance is
+     *      not positive, or the order or maximum level is out of range.
+     */
+    TransformApproximation(TransformPoint2ToPoint2 const &transform, lsst::geom::Box2D const &bbox,
+                           double tolerance, int order = 5, int maxLevel = 6);
+
+    /**
+     *  Approximate a pair of functions.
+     *
+     *  As the Transform constructor, but with functions for the forward and inverse transforms.
+     *  If `inverse` is empty, the approximation has no inverse.
+     */
+    TransformApproximation(Function const &forward, Function const &inverse, lsst::geom::Box2D const &bbox,
+                           double tolerance, int order = 5, int maxLevel = 6);
+
+    /**
+     *  Construct from already-fit approximations; intended for persistence.
+     *
+     *  @param[in]  forward  Approximation to the forward transform.
+     *  @param[in]  inverse  Approximation to the inverse transform; may be null.
+     */
+    TransformApproximation(detail::ChebyshevPatches forward,
+                           std::shared_ptr<detail::ChebyshevPatches const> inverse);
+
+    TransformApproximation(TransformApproximation const &) = default;
+    TransformApproximation(TransformApproximation &&) = default;
+    TransformApproximation &operator=(TransformApproximation const &) = delete;
+    TransformApproximation &operator=(TransformApproximation &&) = delete;
+    ~TransformApproximation() override = default;
+
+    /// Apply the approximate forward transform.
+    lsst::geom::Point2D applyForward(lsst::geom::Point2D const &point) const { return _forward.apply(point); }
+
+    /// Apply the approximate forward transform to many points.
+    std::vector<lsst::geom::Point2D> applyForward(std::vector<lsst::geom::Point2D> const &points) const {
+        return _forward.apply(points);
+    }
+
+    /**
+     *  Apply the approximate inverse transform.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if there is no inverse.
+     */
+    lsst::geom::Point2D applyInverse(lsst::geom::Point2D const &point) const;
+
+    /**
+     *  Apply the approximate inverse transform to many points.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if there is no inverse.
+     */
+    std::vector<lsst::geom::Point2D> applyInverse(std::vector<lsst::geom::Point2D> const &points) const;
+
+    /// Return true if the inverse transform was approximated.
+    bool hasInverse() const noexcept { return static_cast<bool>(_inverse); }
+
+    /// Return the input-coordinate bounding box of the approximation.
+    lsst::geom::Box2D const &getBBox() const { return _forward.getBBox(); }
+
+    /// Return the output-coordinate bounding box over which the inverse is approximated.
+    lsst::geom::Box2D getOutputBBox() const;
+
+    /// Return the order of the Chebyshev polynomials.
+    int getOrder() const { return _forward.getOrder(); }
+
+    /// Return the number of patches used to approximate the forward transform.
+    std::size_t getForwardPatchCount() const { return _forward.getPatches().size(); }
+
+    /// Return the largest error of the forward approximation, in output coordinates.
+    double getMaxForwardError() const { return _forward.getMaxError(); }
+
+    /// Return the largest error of the inverse approximation, in input coordinates, or NaN if
+    /// there is no inverse.
+    double getMaxInverseError() const;
+
+    bool isPersistable() const noexcept override { return true; }
+
+protected:
+    std::string getPersistenceName() const override;
+    std::string getPythonModule() const override;
+    void write(OutputArchiveHandle &handle) const override;
+
+private:
+    detail::ChebyshevPatches _forward;
+    std::shared_ptr<detail::ChebyshevPatches const> _inverse;
+};
+
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_GEOM_TransformApproximation_h_INCLUDED
@@ -0,0 +1,129 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_DETAIL_ChebyshevPatches_h_INCLUDED
+#define LSST_AFW_GEOM_DETAIL_ChebyshevPatches_h_INCLUDED
+
+#include <functional>
+#include <vector>
+
+#include "lsst/geom/Box.h"
+#include "lsst/geom/Point.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+/**
+ *  A piecewise Chebyshev approximation to a function from a 2-d box to the plane.
+ *
+ *  The box is recursively split into quadrants until the tensor-product Chebyshev interpolant on
+ *  each patch matches the function to within a tolerance.  Patches are looked up through a uniform
+ *  grid of cells at the finest level of refinement, so evaluation is a table lookup followed by a
+ *  fixed-order polynomial evaluation.
+ */
+class ChebyshevPatches final {
+public:
+    /// A function evaluated at many points at once.
+    typedef std::function<std::vector<lsst::geom::Point2D>(std::vector<lsst::geom::Point2D> const &)>
+            Function;
+
+    /// A single patch: its bounding box and level in the quadtree, and (order + 1)^2 coefficients
+    /// for each of x and y, ordered by y then x.
+    struct Patch {
+        lsst::geom::Box2D bbox;
+        int level;
+        std::vector<double> xCoefficients;
+        std::vector<double> yCoefficients;
+    };
+
+    /**
+     *  Fit a function.
+     *
+     *  @param[in]  function   Function to approximate.
+     *  @param[in]  bbox       Domain of the approximation.
+     *  @param[in]  tolerance  Maximum (Euclidean) error of the approximation.
+     *  @param[in]  order      Order of the Chebyshev polynomials in each patch.
+     *  @param[in]  maxLevel   Maximum number of times the domain may be split.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the bbox is empty, the tolerance is
+     *      not positive, or the order or maximum level is out of range.
+     */
+    ChebyshevPatches(Function const &function, lsst::geom::Box2D const &bbox, double tolerance, int order,
+                     int maxLevel);
+
+    /// Construct from already-fit patches, which must tile `bbox`.
+    ChebyshevPatches(lsst::geom::Box2D const &bbox, int order, double maxError, std::vector<Patch> patches);
+
+    ChebyshevPatches(ChebyshevPatches const &) = default;
+    ChebyshevPatches(ChebyshevPatches &&) = default;
+    ChebyshevPatches &operator=(ChebyshevPatches const &) = default;
+    ChebyshevPatches &operator=(ChebyshevPatches &&) = default;
+    ~ChebyshevPatches() = default;
+
+    /// Evaluate the approximation; points outside the bbox are extrapolated from the nearest patch.
+    lsst::geom::Point2D apply(lsst::geom::Point2D const &point) const;
+
+    /// Evaluate the approximation at many points.
+    std::vector<lsst::geom::Point2D> apply(std::vector<lsst::geom::Point2D> const &points) const;
+
+    lsst::geom::Box2D const &getBBox() const { return _bbox; }
+    int getOrder() const { return _order; }
+
+    /// The largest error found when validating the approximation.
+    double getMaxError() const { return _maxError; }
+
+    std::vector<Patch> const &getPatches() const { return _patches; }
+
+    /// Return the bounding box of the function's values at the points used to fit it (empty if
+    /// the patches were not fit by this object).
+    lsst::geom::Box2D const &getRange() const { return _range; }
+
+    /// Maximum supported polynomial order.
+    static int const MAX_ORDER = 15;
+
+    /// Maximum supported level of refinement.
+    static int const MAX_LEVEL = 10;
+
+private:
+    void _buildCells();
+
+    lsst::geom::Point2D _evaluate(Patch const &patch, lsst::geom::Point2D const &point) const;
+
+    lsst::geom::Box2D _bbox;
+    lsst::geom::Box2D _range;
+    int _order;
+    double _maxError;
+    std::vector<Patch> _patches;
+    int _nCells;              // cells per side of the lookup grid
+    double _cellScaleX;       // cells per unit x
+    double _cellScaleY;       // cells per unit y
+    std::vector<int> _cells;  // patch index for each cell, row-major
+};
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_GEOM_DETAIL_ChebyshevPatches_h_INCLUDED
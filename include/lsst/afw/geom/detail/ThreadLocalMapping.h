@@ -0,0 +1,81 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_DETAIL_THREADLOCALMAPPING_H
+#define LSST_AFW_GEOM_DETAIL_THREADLOCALMAPPING_H
+
+#include <cstdint>
+#include <memory>
+
+#include "astshim.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+/**
+ * An ast::Mapping that may be evaluated from any number of threads at once.
+ *
+ * AST objects carry mutable state and may not be used by two threads at the same time.  A
+ * ThreadLocalMapping holds on to the mapping it is constructed from, which serves only as a prototype
+ * and is never evaluated.  The thread that constructs the ThreadLocalMapping is given a deep copy of
+ * the prototype at once; every other thread that calls get() is given its own deep copy the first time
+ * it does so.  Each copy is kept in the thread-local storage of the thread that uses it until the
+ * ThreadLocalMapping has been destroyed and that thread next prunes its copies, or until the thread
+ * exits.  Pruning is amortized: a thread only looks for dead copies once its table of copies has
+ * doubled in size since it last did so.
+ *
+ * Only making a copy takes a lock; once a thread has its copy, get() is a thread-local table lookup.
+ */
+class ThreadLocalMapping final : public std::enable_shared_from_this<ThreadLocalMapping> {
+public:
+    /**
+     * Construct from the mapping to evaluate.
+     *
+     * The mapping is not copied but kept as the prototype, so the caller must not modify it afterwards,
+     * nor evaluate it while other threads may be using the ThreadLocalMapping.
+     */
+    static std::shared_ptr<ThreadLocalMapping const> make(std::shared_ptr<ast::Mapping const> mapping);
+
+    ThreadLocalMapping(ThreadLocalMapping const &) = delete;
+    ThreadLocalMapping(ThreadLocalMapping &&) = delete;
+    ThreadLocalMapping &operator=(ThreadLocalMapping const &) = delete;
+    ThreadLocalMapping &operator=(ThreadLocalMapping &&) = delete;
+    ~ThreadLocalMapping() = default;
+
+    /// Return a mapping that the calling thread may use without synchronization.
+    ast::Mapping const &get() const;
+
+private:
+    explicit ThreadLocalMapping(std::shared_ptr<ast::Mapping const> prototype);
+
+    std::shared_ptr<ast::Mapping const> _prototype;  // only ever copied, never evaluated
+    std::uint64_t _id;                               // never reused, unlike addresses
+};
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif
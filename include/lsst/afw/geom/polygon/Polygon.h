@@ -35,6 +35,7 @@
 #include "lsst/geom/Box.h"
 #include "lsst/geom/Point.h"
 #include "lsst/geom/AffineTransform.h"
+#include "lsst/afw/geom/SpanSet.h"
 #include "lsst/afw/geom/Transform.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
@@ -243,12 +244,27 @@ public:
     /// within the polygon.
     ///
     /// Note that the center of the lower-left pixel is 0,0.
+    ///
+    /// The fractions are computed exactly (up to round-off) by a scanline
+    /// rasterizer, in time proportional to the number of pixels plus the
+    /// number of pixel boundaries crossed by the polygon's edges.
     std::shared_ptr<afw::image::Image<float>> createImage(lsst::geom::Box2I const& bbox) const;
     std::shared_ptr<afw::image::Image<float>> createImage(lsst::geom::Extent2I const& extent) const {
         return createImage(lsst::geom::Box2I(lsst::geom::Point2I(0, 0), extent));
     }
     //@}
 
+    //@{
+    /// Create a SpanSet of the pixels entirely contained within the polygon
+    ///
+    /// These are the pixels that receive value unity in createImage; use
+    /// SpanSet::setMask to rasterize the polygon into a mask plane.
+    std::shared_ptr<SpanSet> createSpanSet(lsst::geom::Box2I const& bbox) const;
+    std::shared_ptr<SpanSet> createSpanSet(lsst::geom::Extent2I const& extent) const {
+        return createSpanSet(lsst::geom::Box2I(lsst::geom::Point2I(0, 0), extent));
+    }
+    //@}
+
     //@{
     /// Whether Polygon is persistable which is always true
     bool isPersistable() const noexcept override { return true; }
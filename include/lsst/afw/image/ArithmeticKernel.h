@@ -0,0 +1,125 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSST_AFW_IMAGE_ArithmeticKernel_h_INCLUDED
+#define LSST_AFW_IMAGE_ArithmeticKernel_h_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/image/MaskedImage.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ *  An arithmetic expression over images, compiled at runtime from a string.
+ *
+ *  This is the runtime counterpart of the expression templates in ImageExpression.h, for callers (in
+ *  particular Python) that cannot instantiate templates: an expression such as `"(raw - bias) * 1.7 /
+ *  flat"` is parsed once into a small stack program, which `evaluate` runs on tiles of each row of the
+ *  output.  Each step of the program is a simple loop over a tile held in cache, so no image-sized
+ *  temporaries are made and the loops can be vectorized.
+ *
+ *  Expressions may contain floating-point constants, variables (identifiers made of letters, digits
+ *  and underscores, not starting with a digit), the binary operators `+ - * /`, unary `-` and
+ *  parentheses, with the usual precedence.  Arithmetic is done in double precision.
+ *
+ *  When evaluated on MaskedImages, variances are propagated assuming all pixels are independent (as in
+ *  the MaskedImage arithmetic operators), and the output mask is the bitwise OR of the operand masks.
+ *
+ *  The output may also be one of the operands.
+ */
+class ArithmeticKernel final {
+public:
+    /**
+     *  Compile an expression.
+     *
+     *  @param[in] expression  The expression to compile.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the expression cannot be parsed or has
+     *      no variables.
+     */
+    explicit ArithmeticKernel(std::string const& expression);
+
+    ArithmeticKernel(ArithmeticKernel const&);
+    ArithmeticKernel(ArithmeticKernel&&);
+    ArithmeticKernel& operator=(ArithmeticKernel const&);
+    ArithmeticKernel& operator=(ArithmeticKernel&&);
+    ~ArithmeticKernel();
+
+    /// Return the expression this kernel was compiled from.
+    std::string const& getExpression() const { return _expression; }
+
+    /// Return the names of the variables, in the order their images must be passed to evaluate.
+    std::vector<std::string> const& getVariables() const { return _variables; }
+
+    /**
+     *  Evaluate the expression into an Image.
+     *
+     *  @param[out] out  Image to fill.
+     *  @param[in] operands  One image for each variable, in the order given by getVariables().
+     *
+     *  @throws lsst::pex::exceptions::LengthError if the number of operands does not match the number
+     *      of variables or the images have different dimensions.
+     */
+    template <typename PixelT>
+    void evaluate(Image<PixelT>& out,
+                  std::vector<std::shared_ptr<Image<PixelT> const>> const& operands) const;
+
+    /**
+     *  Evaluate the expression into a MaskedImage, propagating variances and masks.
+     *
+     *  @param[out] out  MaskedImage to fill.
+     *  @param[in] operands  One MaskedImage for each variable, in the order given by getVariables().
+     *
+     *  @throws lsst::pex::exceptions::LengthError if the number of operands does not match the number
+     *      of variables or the images have different dimensions.
+     */
+    template <typename PixelT>
+    void evaluate(MaskedImage<PixelT>& out,
+                  std::vector<std::shared_ptr<MaskedImage<PixelT> const>> const& operands) const;
+
+    /// One step of the compiled stack program.
+    struct Instruction {
+        enum Code { LOAD, CONSTANT, ADD, SUBTRACT, MULTIPLY, DIVIDE, NEGATE };
+        Code code;
+        int variable;     // index of the operand for LOAD
+        double constant;  // value for CONSTANT
+    };
+
+private:
+    std::string _expression;
+    std::vector<std::string> _variables;
+    std::vector<Instruction> _program;
+    int _stackSize;
+};
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_IMAGE_ArithmeticKernel_h_INCLUDED
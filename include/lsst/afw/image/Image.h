@@ -343,6 +343,9 @@ public:
     /**
      * Add a Function2(x, y) to an Image
      *
+     * The function is evaluated a row at a time with Function2::evaluateRow, and blocks of rows
+     * are processed in parallel (see lsst::afw::detail::setDefaultNumThreads).
+     *
      * @param function function to add
      */
     Image& operator+=(lsst::afw::math::Function2<double> const& function);
@@ -355,6 +358,9 @@ public:
     /**
      * Subtract a Function2(x, y) from an Image
      *
+     * The function is evaluated a row at a time with Function2::evaluateRow, and blocks of rows
+     * are processed in parallel (see lsst::afw::detail::setDefaultNumThreads).
+     *
      * @param function function to add
      */
     Image& operator-=(lsst::afw::math::Function2<double> const& function);
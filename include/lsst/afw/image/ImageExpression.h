@@ -0,0 +1,416 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSST_AFW_IMAGE_ImageExpression_h_INCLUDED
+#define LSST_AFW_IMAGE_ImageExpression_h_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/geom/Extent.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/image/MaskedImage.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ *  Lazily-evaluated arithmetic on whole images.
+ *
+ *  Wrapping images with `term` turns the usual arithmetic operators into builders of an expression
+ *  tree, which `evaluate` computes in a single pass over the rows of the output, with no temporary
+ *  images:
+ *
+ *      using namespace lsst::afw::image::expressions;
+ *      evaluate(out, (term(raw) - term(bias)) * gain / term(flat));
+ *
+ *  Every pixel of the output is computed by one inlined loop over the row, so the compiler can vectorize
+ *  it.  The output may also appear in the expression (`evaluate(a, term(a) - term(b))`), since each
+ *  output pixel depends only on the same pixel of the operands.
+ *
+ *  When a MaskedImage is evaluated, the variance is propagated through the expression assuming all
+ *  pixels are independent (as in the MaskedImage arithmetic operators), and the output mask is the
+ *  bitwise OR of the masks of all MaskedImage operands.  Image operands and scalars have zero variance.
+ */
+namespace expressions {
+
+/// Value and variance of one pixel of an expression.
+template <typename T>
+struct PixelValue {
+    T value;
+    T variance;
+};
+
+/// CRTP base class for all expression nodes.
+template <typename Derived>
+struct Expression {
+    Derived const& self() const { return static_cast<Derived const&>(*this); }
+};
+
+/// Leaf node for an Image operand.
+template <typename PixelT>
+class ImageTerm : public Expression<ImageTerm<PixelT>> {
+public:
+    using Value = PixelT;
+    using MaskValue = MaskPixel;
+
+    explicit ImageTerm(ImageBase<PixelT> const& image)
+            : _array(image.getArray()), _dimensions(image.getDimensions()) {}
+
+    lsst::geom::Extent2I getDimensions() const { return _dimensions; }
+
+    void setRow(int y) { _row = _array[y].getData(); }
+
+    Value value(int x) const { return _row[x]; }
+    PixelValue<Value> pixel(int x) const { return {_row[x], Value(0)}; }
+    MaskValue mask(int) const { return 0; }
+
+private:
+    typename ImageBase<PixelT>::ConstArray _array;
+    lsst::geom::Extent2I _dimensions;
+    PixelT const* _row = nullptr;
+};
+
+/// Leaf node for a MaskedImage operand.
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+class MaskedImageTerm : public Expression<MaskedImageTerm<ImagePixelT, MaskPixelT, VariancePixelT>> {
+public:
+    using Value = typename std::common_type<ImagePixelT, VariancePixelT>::type;
+    using MaskValue = MaskPixelT;
+
+    explicit MaskedImageTerm(MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& image)
+            : _image(image.getImage()->getArray()),
+              _mask(image.getMask()->getArray()),
+              _variance(image.getVariance()->getArray()),
+              _dimensions(image.getDimensions()) {}
+
+    lsst::geom::Extent2I getDimensions() const { return _dimensions; }
+
+    void setRow(int y) {
+        _imageRow = _image[y].getData();
+        _maskRow = _mask[y].getData();
+        _varianceRow = _variance[y].getData();
+    }
+
+    Value value(int x) const { return _imageRow[x]; }
+    PixelValue<Value> pixel(int x) const { return {Value(_imageRow[x]), Value(_varianceRow[x])}; }
+    MaskValue mask(int x) const { return _maskRow[x]; }
+
+private:
+    typename ImageBase<ImagePixelT>::ConstArray _image;
+    typename ImageBase<MaskPixelT>::ConstArray _mask;
+    typename ImageBase<VariancePixelT>::ConstArray _variance;
+    lsst::geom::Extent2I _dimensions;
+    ImagePixelT const* _imageRow = nullptr;
+    MaskPixelT const* _maskRow = nullptr;
+    VariancePixelT const* _varianceRow = nullptr;
+};
+
+/// Leaf node for a scalar operand, which has no dimensions, variance or mask.
+template <typename T>
+class ScalarTerm : public Expression<ScalarTerm<T>> {
+public:
+    using Value = T;
+    using MaskValue = MaskPixel;
+
+    explicit ScalarTerm(T value) : _value(value) {}
+
+    void setRow(int) {}
+
+    Value value(int) const { return _value; }
+    PixelValue<Value> pixel(int) const { return {_value, Value(0)}; }
+    MaskValue mask(int) const { return 0; }
+
+private:
+    T _value;
+};
+
+/// @internal Binary operations, with variance propagation for independent operands.
+struct Plus {
+    template <typename T>
+    static T value(T l, T r) {
+        return l + r;
+    }
+    template <typename T>
+    static PixelValue<T> pixel(PixelValue<T> const& l, PixelValue<T> const& r) {
+        return {l.value + r.value, l.variance + r.variance};
+    }
+};
+
+struct Minus {
+    template <typename T>
+    static T value(T l, T r) {
+        return l - r;
+    }
+    template <typename T>
+    static PixelValue<T> pixel(PixelValue<T> const& l, PixelValue<T> const& r) {
+        return {l.value - r.value, l.variance + r.variance};
+    }
+};
+
+struct Multiplies {
+    template <typename T>
+    static T value(T l, T r) {
+        return l * r;
+    }
+    template <typename T>
+    static PixelValue<T> pixel(PixelValue<T> const& l, PixelValue<T> const& r) {
+        return {l.value * r.value, l.value * l.value * r.variance + r.value * r.value * l.variance};
+    }
+};
+
+struct Divides {
+    template <typename T>
+    static T value(T l, T r) {
+        return l / r;
+    }
+    template <typename T>
+    static PixelValue<T> pixel(PixelValue<T> const& l, PixelValue<T> const& r) {
+        T const r2 = r.value * r.value;
+        return {l.value / r.value, (l.value * l.value * r.variance + r2 * l.variance) / (r2 * r2)};
+    }
+};
+
+/// Interior node applying a binary operation to two subexpressions.
+template <typename Op, typename L, typename R>
+class BinaryExpression : public Expression<BinaryExpression<Op, L, R>> {
+public:
+    using Value = typename std::common_type<typename L::Value, typename R::Value>::type;
+    using MaskValue = typename std::common_type<typename L::MaskValue, typename R::MaskValue>::type;
+
+    BinaryExpression(L const& lhs, R const& rhs) : _lhs(lhs), _rhs(rhs) {}
+
+    /**
+     *  Return the dimensions of the image operands.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if the operands have different dimensions.
+     */
+    lsst::geom::Extent2I getDimensions() const { return combineDimensions(_lhs, _rhs); }
+
+    void setRow(int y) {
+        _lhs.setRow(y);
+        _rhs.setRow(y);
+    }
+
+    Value value(int x) const { return Op::value(Value(_lhs.value(x)), Value(_rhs.value(x))); }
+
+    PixelValue<Value> pixel(int x) const {
+        auto const l = _lhs.pixel(x);
+        auto const r = _rhs.pixel(x);
+        return Op::pixel(PixelValue<Value>{Value(l.value), Value(l.variance)},
+                         PixelValue<Value>{Value(r.value), Value(r.variance)});
+    }
+
+    MaskValue mask(int x) const { return _lhs.mask(x) | _rhs.mask(x); }
+
+private:
+    template <typename T, typename E>
+    static lsst::geom::Extent2I combineDimensions(ScalarTerm<T> const&, E const& other) {
+        return other.getDimensions();
+    }
+
+    template <typename E, typename T>
+    static lsst::geom::Extent2I combineDimensions(E const& other, ScalarTerm<T> const&) {
+        return other.getDimensions();
+    }
+
+    template <typename E1, typename E2>
+    static lsst::geom::Extent2I combineDimensions(E1 const& lhs, E2 const& rhs) {
+        lsst::geom::Extent2I const lhsDimensions = lhs.getDimensions();
+        lsst::geom::Extent2I const rhsDimensions = rhs.getDimensions();
+        if (lhsDimensions != rhsDimensions) {
+            throw LSST_EXCEPT(pex::exceptions::LengthError,
+                              (boost::format("Images are of different size, %dx%d v %dx%d") %
+                               lhsDimensions.getX() % lhsDimensions.getY() % rhsDimensions.getX() %
+                               rhsDimensions.getY())
+                                      .str());
+        }
+        return lhsDimensions;
+    }
+
+    L _lhs;
+    R _rhs;
+};
+
+/// Interior node negating a subexpression.
+template <typename E>
+class NegatedExpression : public Expression<NegatedExpression<E>> {
+public:
+    using Value = typename E::Value;
+    using MaskValue = typename E::MaskValue;
+
+    explicit NegatedExpression(E const& operand) : _operand(operand) {}
+
+    lsst::geom::Extent2I getDimensions() const { return _operand.getDimensions(); }
+
+    void setRow(int y) { _operand.setRow(y); }
+
+    Value value(int x) const { return -_operand.value(x); }
+
+    PixelValue<Value> pixel(int x) const {
+        auto const p = _operand.pixel(x);
+        return {-p.value, p.variance};
+    }
+
+    MaskValue mask(int x) const { return _operand.mask(x); }
+
+private:
+    E _operand;
+};
+
+/// Wrap an Image for use in an expression.
+template <typename PixelT>
+ImageTerm<PixelT> term(ImageBase<PixelT> const& image) {
+    return ImageTerm<PixelT>(image);
+}
+
+/// Wrap a MaskedImage for use in an expression.
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+MaskedImageTerm<ImagePixelT, MaskPixelT, VariancePixelT> term(
+        MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& image) {
+    return MaskedImageTerm<ImagePixelT, MaskPixelT, VariancePixelT>(image);
+}
+
+#define LSST_AFW_IMAGE_EXPRESSION_OPERATOR(SYMBOL, OP)                                                   \
+    template <typename L, typename R>                                                                    \
+    BinaryExpression<OP, L, R> operator SYMBOL(Expression<L> const& lhs, Expression<R> const& rhs) {    \
+        return BinaryExpression<OP, L, R>(lhs.self(), rhs.self());                                       \
+    }                                                                                                    \
+    template <typename L, typename T,                                                                    \
+              typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>                      \
+    BinaryExpression<OP, L, ScalarTerm<T>> operator SYMBOL(Expression<L> const& lhs, T rhs) {           \
+        return BinaryExpression<OP, L, ScalarTerm<T>>(lhs.self(), ScalarTerm<T>(rhs));                   \
+    }                                                                                                    \
+    template <typename T, typename R,                                                                    \
+              typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>                      \
+    BinaryExpression<OP, ScalarTerm<T>, R> operator SYMBOL(T lhs, Expression<R> const& rhs) {           \
+        return BinaryExpression<OP, ScalarTerm<T>, R>(ScalarTerm<T>(lhs), rhs.self());                   \
+    }
+
+LSST_AFW_IMAGE_EXPRESSION_OPERATOR(+, Plus)
+LSST_AFW_IMAGE_EXPRESSION_OPERATOR(-, Minus)
+LSST_AFW_IMAGE_EXPRESSION_OPERATOR(*, Multiplies)
+LSST_AFW_IMAGE_EXPRESSION_OPERATOR(/, Divides)
+
+#undef LSST_AFW_IMAGE_EXPRESSION_OPERATOR
+
+template <typename E>
+NegatedExpression<E> operator-(Expression<E> const& operand) {
+    return NegatedExpression<E>(operand.self());
+}
+
+namespace detail {
+
+// Minimum number of pixels in each block of rows evaluated by one thread.
+std::size_t const MIN_BLOCK_PIXELS = 1 << 16;
+
+// Call function(rowExpression, y) for every row, with blocks of rows processed concurrently.
+template <typename E, typename Function>
+void forEachRow(E const& expr, lsst::geom::Extent2I const& dimensions, Function const& function) {
+    std::size_t const width = dimensions.getX();
+    std::size_t const height = dimensions.getY();
+    if (width == 0 || height == 0) {
+        return;
+    }
+    std::size_t const nBlocks =
+            std::max<std::size_t>(1, std::min(height, width * height / MIN_BLOCK_PIXELS));
+    lsst::afw::detail::parallelFor(0, nBlocks, [&](std::size_t block) {
+        E rowExpr(expr);  // each block needs its own row pointers
+        for (std::size_t y = block * height / nBlocks, end = (block + 1) * height / nBlocks; y < end; ++y) {
+            rowExpr.setRow(y);
+            function(rowExpr, y);
+        }
+    });
+}
+
+template <typename E>
+void checkDimensions(lsst::geom::Extent2I const& outDimensions, E const& expr) {
+    lsst::geom::Extent2I const dimensions = expr.getDimensions();
+    if (dimensions != outDimensions) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Images are of different size, %dx%d v %dx%d") %
+                           outDimensions.getX() % outDimensions.getY() % dimensions.getX() %
+                           dimensions.getY())
+                                  .str());
+    }
+}
+
+}  // namespace detail
+
+/**
+ *  Evaluate an expression into an Image.
+ *
+ *  Masks and variances of any MaskedImage operands are ignored.
+ *
+ *  @throws lsst::pex::exceptions::LengthError if the operands and output have different dimensions.
+ */
+template <typename PixelT, typename E>
+void evaluate(Image<PixelT>& out, Expression<E> const& expr) {
+    detail::checkDimensions(out.getDimensions(), expr.self());
+    auto const array = out.getArray();
+    int const width = out.getWidth();
+    detail::forEachRow(expr.self(), out.getDimensions(), [&](E const& rowExpr, std::size_t y) {
+        PixelT* row = array[y].getData();
+        for (int x = 0; x < width; ++x) {
+            row[x] = static_cast<PixelT>(rowExpr.value(x));
+        }
+    });
+}
+
+/**
+ *  Evaluate an expression into a MaskedImage, propagating variances and masks.
+ *
+ *  @throws lsst::pex::exceptions::LengthError if the operands and output have different dimensions.
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename E>
+void evaluate(MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& out, Expression<E> const& expr) {
+    detail::checkDimensions(out.getDimensions(), expr.self());
+    auto const image = out.getImage()->getArray();
+    auto const mask = out.getMask()->getArray();
+    auto const variance = out.getVariance()->getArray();
+    int const width = out.getWidth();
+    detail::forEachRow(expr.self(), out.getDimensions(), [&](E const& rowExpr, std::size_t y) {
+        ImagePixelT* imageRow = image[y].getData();
+        MaskPixelT* maskRow = mask[y].getData();
+        VariancePixelT* varianceRow = variance[y].getData();
+        for (int x = 0; x < width; ++x) {
+            auto const p = rowExpr.pixel(x);
+            imageRow[x] = static_cast<ImagePixelT>(p.value);
+            maskRow[x] = static_cast<MaskPixelT>(rowExpr.mask(x));
+            varianceRow[x] = static_cast<VariancePixelT>(p.variance);
+        }
+    });
+}
+
+}  // namespace expressions
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_IMAGE_ImageExpression_h_INCLUDED
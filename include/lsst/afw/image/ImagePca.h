@@ -28,12 +28,14 @@
 #ifndef LSST_AFW_IMAGE_IMAGEPCA_H
 #define LSST_AFW_IMAGE_IMAGEPCA_H
 
+#include <cstddef>
 #include <vector>
 #include <string>
 #include <utility>
 
 #include "boost/mpl/bool.hpp"
 #include <memory>
+#include "Eigen/Core"
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/MaskedImage.h"
@@ -69,6 +71,19 @@ public:
      * @throws lsst::pex::exceptions::LengthError if all the images aren't the same size
      */
     void addImage(std::shared_ptr<ImageT> img, double flux = 0.0);
+
+    /**
+     * Remove an image from the set to be analyzed
+     *
+     * If inner products are being reused (see setReuseInnerProducts), those between the remaining
+     * images are kept for the next call to analyze().
+     *
+     * @param index Position of the image in getImageList()
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if there is no such image
+     */
+    void removeImage(std::size_t index);
+
     /// Return the list of images being analyzed
     ImageList getImageList() const;
 
@@ -79,7 +94,48 @@ public:
      * Return the mean of the images in ImagePca's list
      */
     std::shared_ptr<ImageT> getMean() const;
+
+    /**
+     * Calculate the PCA decomposition (Karhunen-Loeve basis) of the images
+     *
+     * The images' inner products are computed together, as one product of a matrix holding all their
+     * pixels.  If setReuseInnerProducts(true) has been called, they are kept for later calls, and
+     * only the inner products involving images added since the last call are computed.
+     *
+     * @throws lsst::pex::exceptions::LengthError if there are no images
+     */
     virtual void analyze();
+
+    /**
+     * Set the number of components computed by analyze()
+     *
+     * @param nComponents Number of eigenvalues and eigenimages to compute.  If zero (the default) all
+     *                    the eigenvalues are computed, and up to 100 eigenimages.  If it is much smaller
+     *                    than the number of images the components are found by a randomized truncated
+     *                    eigen-solver, rather than a full decomposition.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if nComponents is negative
+     */
+    void setNumComponents(int nComponents);
+
+    /// Return the number of components computed by analyze(); zero means the default
+    int getNumComponents() const { return _nComponents; }
+
+    /**
+     * Set whether analyze() reuses the inner products computed by earlier calls
+     *
+     * Reuse is off by default.  When it is on, the caller must call imagesModified() after changing
+     * the pixels of any image already added (through the pointers passed to addImage or returned by
+     * getImageList) other than by updateBadPixels, or analyze() will use stale inner products.
+     */
+    void setReuseInnerProducts(bool reuse);
+
+    /// Return whether analyze() reuses the inner products computed by earlier calls
+    bool getReuseInnerProducts() const { return _reuseInnerProducts; }
+
+    /// Discard the saved inner products, as the pixels of images already added have changed
+    void imagesModified() { _nInnerProducts = 0; }
+
     /**
      * Update the bad pixels (i.e. those for which (value & mask) != 0) based on the current PCA
      * decomposition;
@@ -111,6 +167,11 @@ private:
 
     std::vector<double> _eigenValues;  // Eigen values
     ImageList _eigenImages;            // Eigen images
+
+    int _nComponents;                // number of components to compute; 0 for the default
+    bool _reuseInnerProducts;        // should analyze() reuse _innerProducts?
+    Eigen::MatrixXd _innerProducts;  // inner products of the first _nInnerProducts images
+    std::size_t _nInnerProducts;
 };
 
 /**
@@ -820,6 +820,13 @@ public:
     void assign(MaskedImage const& rhs, lsst::geom::Box2I const& bbox = lsst::geom::Box2I(),
                 ImageOrigin origin = PARENT);
 
+    /*
+     * The operators and scaled operations that take a MaskedImage update all three planes in a single
+     * pass over the rows, which may be split between threads (see lsst::afw::detail::parallelFor for
+     * how the number of threads is chosen).  They throw lsst::pex::exceptions::LengthError if the
+     * images have different dimensions.
+     */
+
     /// Add a scalar rhs to a MaskedImage
     MaskedImage& operator+=(ImagePixelT const rhs);
     /**
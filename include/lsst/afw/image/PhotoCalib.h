@@ -473,6 +473,14 @@ private:
      */
     double evaluate(lsst::geom::Point<double, 2> const &point) const;
 
+    /**
+     * Return the calibration evaluated at the centroid of every record in a catalog.
+     *
+     * Spatially-varying calibrations are evaluated in batches, in parallel if
+     * lsst::afw::detail::getDefaultNumThreads() allows.
+     */
+    ndarray::Array<double const, 1> evaluateCatalog(afw::table::SourceCatalog const &sourceCatalog) const;
+
     /// Returns the spatially-constant calibration (for setting _calibrationMean)
     double computeCalibrationMean(std::shared_ptr<afw::math::BoundedField> calibration) const;
 
@@ -87,6 +87,22 @@ public:
     virtual ndarray::Array<double, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
                                                   ndarray::Array<double const, 1> const& y) const;
 
+    /**
+     *  Evaluate the field on the grid formed by the outer product of x and y coordinates
+     *
+     *  @param[in]  x         array of x coordinates of the grid columns
+     *  @param[in]  y         array of y coordinates of the grid rows
+     *  @returns an array of output values with shape (y.size, x.size)
+     *
+     *  The default implementation calls the multi-point evaluate() once for each row.  Subclasses
+     *  that are separable in x and y can share work between rows and columns by overriding it.
+     *  This is used by fillImage, addToImage, multiplyImage and divideImage, which may call it
+     *  concurrently from several threads (see lsst::afw::detail::getDefaultNumThreads), so overrides
+     *  must not modify shared state.
+     */
+    virtual ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                                      ndarray::Array<double const, 1> const& y) const;
+
     /**
      * Compute the integral of this function over its bounding-box.
      *
@@ -193,8 +193,27 @@ public:
     /// @copydoc BoundedField::evaluate
     double evaluate(lsst::geom::Point2D const& position) const override;
 
+    /**
+     *  @copydoc BoundedField::evaluate(ndarray::Array<double const, 1> const&,
+     *                                  ndarray::Array<double const, 1> const&) const
+     *
+     *  The Clenshaw recurrences are run for blocks of points in lockstep, so the inner loops run
+     *  over points and can be vectorized.
+     */
+    ndarray::Array<double, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
+                                          ndarray::Array<double const, 1> const& y) const override;
+
     using BoundedField::evaluate;
 
+    /**
+     *  @copydoc BoundedField::evaluateGrid
+     *
+     *  The x basis functions are computed once per column and the coefficients are contracted with
+     *  the y basis functions once per row, leaving a single order-(orderX+1) sum per point.
+     */
+    ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                              ndarray::Array<double const, 1> const& y) const override;
+
     /// @copydoc BoundedField::integrate
     double integrate() const override;
 
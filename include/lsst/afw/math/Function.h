@@ -28,6 +28,7 @@
  * Define the basic Function classes.
  */
 #include <cmath>
+#include <cstddef>
 #include <stdexcept>
 #include <sstream>
 #include <vector>
@@ -298,6 +299,27 @@ public:
 
     virtual ReturnT operator()(double x, double y) const = 0;
 
+    /**
+     * Evaluate the function at n consecutive integer steps along a row
+     *
+     * Sets out[i] = (*this)(x0 + i, y) for i in [0, n).  Subclasses whose computation separates into
+     * a part that depends only on y may override this to do that part once per row.
+     *
+     * Image arithmetic with a Function2 calls this concurrently for different rows, so overrides must
+     * not modify any state (including the caches used by operator()).  The default implementation
+     * calls operator(), so subclasses whose operator() modifies cached state must override it.
+     *
+     * @param[in] y  y position of the row
+     * @param[in] x0  x position of the first point
+     * @param[in] n  number of points
+     * @param[out] out  array of at least n values to fill
+     */
+    virtual void evaluateRow(double y, double x0, std::size_t n, ReturnT* out) const {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = (*this)(x0 + i, y);
+        }
+    }
+
     std::string toString(std::string const& prefix = "") const override {
         return std::string("Function2: ") + Function<ReturnT>::toString(prefix);
     }
@@ -29,6 +29,8 @@
  */
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 #include "lsst/geom.h"
 #include "lsst/afw/math/Function.h"
@@ -235,6 +237,25 @@ public:
                                              ((pos2 * pos2) / (2.0 * this->_params[1] * this->_params[1]))));
     }
 
+    void evaluateRow(double y, double x0, std::size_t n, ReturnT* out) const override {
+        // Same arithmetic as operator(), but without the angle cache, and with the factors that are
+        // constant along the row computed once.
+        double const sinAngle = std::sin(this->_params[2]);
+        double const cosAngle = std::cos(this->_params[2]);
+        double const norm = _multFac / (this->_params[0] * this->_params[1]);
+        double const twoVar1 = 2.0 * this->_params[0] * this->_params[0];
+        double const twoVar2 = 2.0 * this->_params[1] * this->_params[1];
+        double const ySin = sinAngle * y;
+        double const yCos = cosAngle * y;
+        for (std::size_t i = 0; i < n; ++i) {
+            double const x = x0 + i;
+            double const pos1 = (cosAngle * x) + ySin;
+            double const pos2 = (-sinAngle * x) + yCos;
+            out[i] = static_cast<ReturnT>(norm *
+                                          std::exp(-((pos1 * pos1) / twoVar1) - ((pos2 * pos2) / twoVar2)));
+        }
+    }
+
     std::string toString(std::string const& prefix) const override {
         std::ostringstream os;
         os << "GaussianFunction2: ";
@@ -498,39 +519,20 @@ public:
 
         Then compute f(x,y) by solving the 1-d polynomial in x in the usual way.
         */
-        const int maxXCoeffInd = this->_order;
-
         if ((y != _oldY) || !this->_isCacheValid) {
-            // update _xCoeffs cache
-            // note: paramInd is decremented in both of the following loops
-            int paramInd = static_cast<int>(this->_params.size()) - 1;
-
-            // initialize _xCoeffs to coeffs for pure y^n; e.g. for 3rd order:
-            // _xCoeffs[0] = _params[9], _xCoeffs[1] = _params[8], ... _xCoeffs[3] = _params[6]
-            for (int xCoeffInd = 0; xCoeffInd <= maxXCoeffInd; ++xCoeffInd, --paramInd) {
-                _xCoeffs[xCoeffInd] = this->_params[paramInd];
-            }
-
-            // finish computing _xCoeffs
-            for (int xCoeffInd = 0, endXCoeffInd = maxXCoeffInd; paramInd >= 0; --paramInd) {
-                _xCoeffs[xCoeffInd] = (_xCoeffs[xCoeffInd] * y) + this->_params[paramInd];
-                ++xCoeffInd;
-                if (xCoeffInd >= endXCoeffInd) {
-                    xCoeffInd = 0;
-                    --endXCoeffInd;
-                }
-            }
-
+            _computeXCoeffs(y, _xCoeffs.data());
             _oldY = y;
             this->_isCacheValid = true;
         }
+        return static_cast<ReturnT>(_evaluateX(x, _xCoeffs.data()));
+    }
 
-        // use _xCoeffs to compute result
-        double retVal = _xCoeffs[maxXCoeffInd];
-        for (int xCoeffInd = maxXCoeffInd - 1; xCoeffInd >= 0; --xCoeffInd) {
-            retVal = (retVal * x) + _xCoeffs[xCoeffInd];
+    void evaluateRow(double y, double x0, std::size_t n, ReturnT* out) const override {
+        std::vector<double> xCoeffs(this->_order + 1);
+        _computeXCoeffs(y, xCoeffs.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<ReturnT>(_evaluateX(x0 + i, xCoeffs.data()));
         }
-        return static_cast<ReturnT>(retVal);
     }
 
     /**
@@ -554,6 +556,44 @@ protected:
     void write(afw::table::io::OutputArchiveHandle& handle) const override;
 
 private:
+    /**
+     * Compute the coefficients Cx0, Cx1, ... Cxn of the polynomial in x at a given y
+     */
+    void _computeXCoeffs(double y, double* xCoeffs) const noexcept {
+        const int maxXCoeffInd = this->_order;
+
+        // note: paramInd is decremented in both of the following loops
+        int paramInd = static_cast<int>(this->_params.size()) - 1;
+
+        // initialize xCoeffs to coeffs for pure y^n; e.g. for 3rd order:
+        // xCoeffs[0] = _params[9], xCoeffs[1] = _params[8], ... xCoeffs[3] = _params[6]
+        for (int xCoeffInd = 0; xCoeffInd <= maxXCoeffInd; ++xCoeffInd, --paramInd) {
+            xCoeffs[xCoeffInd] = this->_params[paramInd];
+        }
+
+        // finish computing xCoeffs
+        for (int xCoeffInd = 0, endXCoeffInd = maxXCoeffInd; paramInd >= 0; --paramInd) {
+            xCoeffs[xCoeffInd] = (xCoeffs[xCoeffInd] * y) + this->_params[paramInd];
+            ++xCoeffInd;
+            if (xCoeffInd >= endXCoeffInd) {
+                xCoeffInd = 0;
+                --endXCoeffInd;
+            }
+        }
+    }
+
+    /**
+     * Evaluate the polynomial in x with coefficients computed by _computeXCoeffs
+     */
+    double _evaluateX(double x, double const* xCoeffs) const noexcept {
+        const int maxXCoeffInd = this->_order;
+        double retVal = xCoeffs[maxXCoeffInd];
+        for (int xCoeffInd = maxXCoeffInd - 1; xCoeffInd >= 0; --xCoeffInd) {
+            retVal = (retVal * x) + xCoeffs[xCoeffInd];
+        }
+        return retVal;
+    }
+
     mutable double _oldY;                  ///< value of y for which _xCoeffs is valid
     mutable std::vector<double> _xCoeffs;  ///< working vector
 
@@ -805,51 +845,31 @@ public:
         double const xPrime = (x + _offsetX) * _scaleX;
         double const yPrime = (y + _offsetY) * _scaleY;
 
-        const int nParams = static_cast<int>(this->_params.size());
-        const int order = this->_order;
-
-        if (order == 0) {
+        if (this->_order == 0) {
             return this->_params[0];  // No caching required
         }
 
         if ((yPrime != _oldYPrime) || !this->_isCacheValid) {
             // update cached _yCheby and _xCoeffs
-            _yCheby[0] = 1.0;
-            _yCheby[1] = yPrime;
-            for (int chebyInd = 2; chebyInd <= order; chebyInd++) {
-                _yCheby[chebyInd] = (2 * yPrime * _yCheby[chebyInd - 1]) - _yCheby[chebyInd - 2];
-            }
-
-            for (int coeffInd = 0; coeffInd <= order; coeffInd++) {
-                _xCoeffs[coeffInd] = 0;
-            }
-            for (int coeffInd = 0, endCoeffInd = 0, paramInd = 0; paramInd < nParams; paramInd++) {
-                _xCoeffs[coeffInd] += this->_params[paramInd] * _yCheby[endCoeffInd];
-                --coeffInd;
-                ++endCoeffInd;
-                if (coeffInd < 0) {
-                    coeffInd = endCoeffInd;
-                    endCoeffInd = 0;
-                }
-            }
-
+            _computeXCoeffs(yPrime, _yCheby.data(), _xCoeffs.data());
             _oldYPrime = yPrime;
             this->_isCacheValid = true;
         }
+        return _clenshaw(xPrime, _xCoeffs.data());
+    }
 
-        // Clenshaw function for solving the Chebyshev polynomial
-        // Non-recursive version from Kresimir Cosic
-        if (order == 1) {
-            return _xCoeffs[0] + (_xCoeffs[1] * xPrime);
+    void evaluateRow(double y, double x0, std::size_t n, ReturnT* out) const override {
+        if (this->_order == 0) {
+            std::fill_n(out, n, static_cast<ReturnT>(this->_params[0]));
+            return;
         }
-        double cshPrev = _xCoeffs[order];
-        double csh = (2 * xPrime * _xCoeffs[order]) + _xCoeffs[order - 1];
-        for (int i = order - 2; i > 0; --i) {
-            double cshNext = (2 * xPrime * csh) + _xCoeffs[i] - cshPrev;
-            cshPrev = csh;
-            csh = cshNext;
+        double const yPrime = (y + _offsetY) * _scaleY;
+        std::vector<double> yCheby(this->_order + 1);
+        std::vector<double> xCoeffs(this->_order + 1);
+        _computeXCoeffs(yPrime, yCheby.data(), xCoeffs.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<ReturnT>(_clenshaw((x0 + i + _offsetX) * _scaleX, xCoeffs.data()));
         }
-        return (xPrime * csh) + _xCoeffs[0] - cshPrev;
     }
 
     std::string toString(std::string const& prefix) const override {
@@ -868,6 +888,53 @@ protected:
     void write(afw::table::io::OutputArchiveHandle& handle) const override;
 
 private:
+    /**
+     * Compute Tn(y') and the coefficients of the Chebyshev polynomial in x' at y'; order must be > 0
+     */
+    void _computeXCoeffs(double yPrime, double* yCheby, double* xCoeffs) const noexcept {
+        const int nParams = static_cast<int>(this->_params.size());
+        const int order = this->_order;
+
+        yCheby[0] = 1.0;
+        yCheby[1] = yPrime;
+        for (int chebyInd = 2; chebyInd <= order; chebyInd++) {
+            yCheby[chebyInd] = (2 * yPrime * yCheby[chebyInd - 1]) - yCheby[chebyInd - 2];
+        }
+
+        for (int coeffInd = 0; coeffInd <= order; coeffInd++) {
+            xCoeffs[coeffInd] = 0;
+        }
+        for (int coeffInd = 0, endCoeffInd = 0, paramInd = 0; paramInd < nParams; paramInd++) {
+            xCoeffs[coeffInd] += this->_params[paramInd] * yCheby[endCoeffInd];
+            --coeffInd;
+            ++endCoeffInd;
+            if (coeffInd < 0) {
+                coeffInd = endCoeffInd;
+                endCoeffInd = 0;
+            }
+        }
+    }
+
+    /**
+     * Evaluate the Chebyshev polynomial in x' with coefficients computed by _computeXCoeffs
+     *
+     * Uses the Clenshaw algorithm; non-recursive version from Kresimir Cosic.
+     */
+    double _clenshaw(double xPrime, double const* xCoeffs) const noexcept {
+        const int order = this->_order;
+        if (order == 1) {
+            return xCoeffs[0] + (xCoeffs[1] * xPrime);
+        }
+        double cshPrev = xCoeffs[order];
+        double csh = (2 * xPrime * xCoeffs[order]) + xCoeffs[order - 1];
+        for (int i = order - 2; i > 0; --i) {
+            double cshNext = (2 * xPrime * csh) + xCoeffs[i] - cshPrev;
+            cshPrev = csh;
+            csh = cshNext;
+        }
+        return (xPrime * csh) + xCoeffs[0] - cshPrev;
+    }
+
     mutable double _oldYPrime;
     mutable std::vector<double> _yCheby;   ///< working vector: value of Tn(y')
     mutable std::vector<double> _xCoeffs;  ///< working vector: transformed coeffs of x polynomial
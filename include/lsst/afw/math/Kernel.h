@@ -206,10 +206,95 @@ public:
      *                                              sum is exactly 0
      *
      * @note computeNewImage has been retired; it doesn't need to be a member
+     *
+     * @note This is computeImage(image, doNormalize, computeKernelParameters(x, y)); it does not
+     * change the kernel parameters, so images may be computed from several threads at once
+     * (provided nothing modifies the kernel meanwhile).
      */
     double computeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize, double x = 0.0,
                         double y = 0.0) const;
 
+    /**
+     * Compute an image (pixellized representation of the kernel) in place for given kernel parameters
+     *
+     * The spatial model (if any) and the kernel's own parameters are ignored, and the kernel is not
+     * modified, so this may be called from several threads at once.
+     *
+     * @param image image whose pixels are to be set (output); xy0 of the image will be
+     *              set to -kernel.getCtr()
+     * @param doNormalize normalize the image (so sum is 1)?
+     * @param kernelParams kernel parameters, e.g. from computeKernelParameters
+     *
+     * @returns The kernel sum
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the image is the wrong size or
+     *                                                      kernelParams is the wrong length
+     * @throws lsst::pex::exceptions::OverflowError if doNormalize is true and the kernel
+     *                                              sum is exactly 0
+     */
+    double computeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                        std::vector<double> const &kernelParams) const;
+
+    /**
+     * Scratch space for computing images of one kernel at many positions
+     *
+     * Kernels whose functions hold their own parameters (such as AnalyticKernel and SeparableKernel)
+     * keep copies of those functions in their workspaces, and set the parameters for each position on
+     * the copies, so computing an image with a workspace neither allocates memory nor copies the
+     * functions.  Make one with makeWorkspace, and use it only with that kernel and from one thread at
+     * a time.
+     */
+    class Workspace {
+    public:
+        explicit Workspace(Kernel const &kernel);
+        virtual ~Workspace() = default;
+
+        Workspace(Workspace const &) = delete;
+        Workspace(Workspace &&) = delete;
+        Workspace &operator=(Workspace const &) = delete;
+        Workspace &operator=(Workspace &&) = delete;
+
+        /// Return the kernel this workspace was made for
+        Kernel const &getKernel() const noexcept { return _kernel; }
+
+        /// Return storage for the kernel parameters at the current position
+        std::vector<double> &getKernelParameters() noexcept { return _kernelParams; }
+
+    private:
+        Kernel const &_kernel;
+        std::vector<double> _kernelParams;
+    };
+
+    /**
+     * Return a new workspace for computing images of this kernel (see Workspace)
+     *
+     * The kernel must not be modified while the workspace is in use.
+     */
+    virtual std::unique_ptr<Workspace> makeWorkspace() const;
+
+    /**
+     * Compute an image (pixellized representation of the kernel) in place, using a workspace
+     *
+     * This is equivalent to computeImage(image, doNormalize, x, y), but is faster when computing
+     * images of a spatially varying kernel at many positions.
+     *
+     * @param image image whose pixels are to be set (output); xy0 of the image will be
+     *              set to -kernel.getCtr()
+     * @param doNormalize normalize the image (so sum is 1)?
+     * @param x x (column position) at which to compute spatial function
+     * @param y y (row position) at which to compute spatial function
+     * @param workspace workspace made by this kernel's makeWorkspace
+     *
+     * @returns The kernel sum
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the image is the wrong size or the
+     *                                                      workspace belongs to another kernel
+     * @throws lsst::pex::exceptions::OverflowError if doNormalize is true and the kernel
+     *                                              sum is exactly 0
+     */
+    double computeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize, double x, double y,
+                        Workspace &workspace) const;
+
     /**
      * Return the Kernel's dimensions (width, height)
      */
@@ -297,8 +382,8 @@ public:
     /**
      * Return the current kernel parameters
      *
-     * If the kernel is spatially varying then the parameters are those last computed.
-     * See also computeKernelParametersFromSpatialModel.
+     * Computing an image does not change these, so for a spatially varying kernel they are not
+     * the parameters at any particular position; use computeKernelParameters for those.
      * If there are no kernel parameters then returns an empty vector.
      */
     virtual std::vector<double> getKernelParameters() const;
@@ -421,6 +506,14 @@ public:
      */
     void computeKernelParametersFromSpatialModel(std::vector<double> &kernelParams, double x, double y) const;
 
+    /**
+     * Return the kernel parameters at a specified point
+     *
+     * These come from the spatial model if the kernel is spatially varying, and are the current
+     * kernel parameters (getKernelParameters) otherwise.
+     */
+    std::vector<double> computeKernelParameters(double x, double y) const;
+
     /**
      * Return a string representation of the kernel
      */
@@ -455,7 +548,7 @@ protected:
      * Classes that have kernel parameters must subclass this function.
      *
      * This function is marked "const", despite modifying unimportant internals,
-     * so that computeImage can be const.
+     * so that setKernelParametersFromSpatialModel can be const.
      *
      * @throws lsst::pex::exceptions::InvalidParameterError always (unless subclassed)
      */
@@ -466,23 +559,56 @@ protected:
      *
      * This function has no effect if there is no spatial model.
      *
-     * This function is marked "const", despite modifying unimportant internals,
-     * so that computeImage can be const.
+     * This function is marked "const", despite modifying unimportant internals.
+     * computeImage does not use it; it computes the parameters without storing them.
      */
     void setKernelParametersFromSpatialModel(double x, double y) const;
 
+    /**
+     * Check that a vector of kernel parameters is valid for this kernel
+     *
+     * This checks the length; classes with further restrictions on their kernel parameters (as
+     * enforced by setKernelParameter) should override it to check those too, calling this first.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if kernelParams.size() != getNKernelParameters()
+     *                                                      or the parameters are otherwise invalid
+     */
+    virtual void checkKernelParameters(std::vector<double> const &kernelParams) const;
+
     /**
      * Low-level version of computeImage
      *
      * Before this is called the image dimensions are checked, the image's xy0 is set
-     * and the kernel's parameters are set.
-     * This routine sets the pixels, including normalization if requested.
+     * and the length of kernelParams is checked.
+     * This routine sets the pixels, including normalization if requested, using kernelParams
+     * rather than the kernel's own parameters.  It must not modify the kernel, as it may be
+     * called from several threads at once.
      *
      * @param image image whose pixels are to be set (output)
      * @param doNormalize normalize the image (so sum is 1)?
+     * @param kernelParams kernel parameters
      * @returns The kernel sum
      */
-    virtual double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize) const = 0;
+    virtual double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                                  std::vector<double> const &kernelParams) const = 0;
+
+    /**
+     * Low-level version of computeImage with a workspace
+     *
+     * As doComputeImage(image, doNormalize, kernelParams), but may use the workspace, which was made
+     * by this kernel's makeWorkspace, in place of allocating its own scratch space.  kernelParams may
+     * be workspace.getKernelParameters().  The default implementation ignores the workspace.
+     */
+    virtual double doComputeImageWithWorkspace(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                                               std::vector<double> const &kernelParams,
+                                               Workspace &workspace) const;
+
+    /**
+     * Check that a workspace was made by this kernel's makeWorkspace
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if it was not
+     */
+    void checkWorkspace(Workspace const &workspace) const;
 
     std::vector<SpatialFunctionPtr> _spatialFunctionList;
 
@@ -546,7 +672,8 @@ public:
     class Factory;
 
 protected:
-    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize) const override;
+    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                          std::vector<double> const &kernelParams) const override;
 
     std::string getPersistenceName() const override;
 
@@ -645,6 +772,35 @@ public:
     double computeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize, double x = 0.0,
                         double y = 0.0) const;
 
+    /**
+     * Compute an image (pixellized representation of the kernel) in place for given kernel parameters
+     *
+     * Like Kernel::computeImage(image, doNormalize, kernelParams), but accepts any size image,
+     * as computeImage(image, doNormalize, x, y) does.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if kernelParams is the wrong length
+     * @throws lsst::pex::exceptions::OverflowError if doNormalize is true and the kernel sum is
+     * exactly 0
+     */
+    double computeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                        std::vector<double> const &kernelParams) const;
+
+    /**
+     * Compute an image (pixellized representation of the kernel) in place, using a workspace
+     *
+     * Like Kernel::computeImage(image, doNormalize, x, y, workspace), but accepts any size image,
+     * as computeImage(image, doNormalize, x, y) does.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the workspace belongs to another kernel
+     * @throws lsst::pex::exceptions::OverflowError if doNormalize is true and the kernel sum is
+     * exactly 0
+     */
+    double computeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize, double x, double y,
+                        Workspace &workspace) const;
+
+    /// Return a workspace holding a copy of the kernel function
+    std::unique_ptr<Workspace> makeWorkspace() const final;
+
     std::vector<double> getKernelParameters() const override;
 
     /**
@@ -659,7 +815,12 @@ public:
     class Factory;
 
 protected:
-    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize) const override;
+    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                          std::vector<double> const &kernelParams) const override;
+
+    double doComputeImageWithWorkspace(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                                       std::vector<double> const &kernelParams,
+                                       Workspace &workspace) const override;
 
     std::string getPersistenceName() const override;
 
@@ -714,7 +875,8 @@ public:
     class Factory;
 
 protected:
-    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize) const override;
+    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                          std::vector<double> const &kernelParams) const override;
 
     std::string getPersistenceName() const override;
 
@@ -860,7 +1022,8 @@ public:
     class Factory;
 
 protected:
-    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize) const override;
+    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                          std::vector<double> const &kernelParams) const override;
 
     std::string getPersistenceName() const override;
 
@@ -968,6 +1131,52 @@ public:
     double computeVectors(std::vector<Pixel> &colList, std::vector<Pixel> &rowList, bool doNormalize,
                           double x = 0.0, double y = 0.0) const;
 
+    /**
+     * Compute the column and row arrays in place for given kernel parameters
+     *
+     * The spatial model (if any) and the kernel's own parameters are ignored, and the kernel is not
+     * modified, so this may be called from several threads at once.
+     *
+     * @param colList column vector
+     * @param rowList row vector
+     * @param doNormalize normalize the image (so sum of each is 1)?
+     * @param kernelParams kernel parameters: those of the column function followed by those of
+     *                     the row function
+     * @returns the kernel sum (1.0 if doNormalize true)
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if colList, rowList or kernelParams
+     *                                                      is the wrong size
+     * @throws lsst::pex::exceptions::OverflowError if doNormalize is true and the kernel sum is
+     * exactly 0
+     */
+    double computeVectors(std::vector<Pixel> &colList, std::vector<Pixel> &rowList, bool doNormalize,
+                          std::vector<double> const &kernelParams) const;
+
+    /**
+     * Compute the column and row arrays in place, using a workspace
+     *
+     * This is equivalent to computeVectors(colList, rowList, doNormalize, x, y), but is faster when
+     * computing the vectors of a spatially varying kernel at many positions.
+     *
+     * @param colList column vector
+     * @param rowList row vector
+     * @param doNormalize normalize the image (so sum of each is 1)?
+     * @param x x (column position) at which to compute spatial function
+     * @param y y (row position) at which to compute spatial function
+     * @param workspace workspace made by this kernel's makeWorkspace
+     * @returns the kernel sum (1.0 if doNormalize true)
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if colList or rowList is the wrong size,
+     *                                                      or the workspace belongs to another kernel
+     * @throws lsst::pex::exceptions::OverflowError if doNormalize is true and the kernel sum is
+     * exactly 0
+     */
+    double computeVectors(std::vector<Pixel> &colList, std::vector<Pixel> &rowList, bool doNormalize,
+                          double x, double y, Workspace &workspace) const;
+
+    /// Return a workspace holding copies of the column and row functions
+    std::unique_ptr<Workspace> makeWorkspace() const final;
+
     double getKernelParameter(unsigned int i) const override {
         unsigned int const ncol = _kernelColFunctionPtr->getNParameters();
         if (i < ncol) {
@@ -1008,7 +1217,12 @@ public:
     int getCacheSize() const override;
 
 protected:
-    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize) const override;
+    double doComputeImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                          std::vector<double> const &kernelParams) const override;
+
+    double doComputeImageWithWorkspace(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                                       std::vector<double> const &kernelParams,
+                                       Workspace &workspace) const override;
 
     void setKernelParameter(unsigned int ind, double value) const override;
 
@@ -1019,6 +1233,8 @@ private:
      * @param colList column vector
      * @param rowList row vector
      * @param doNormalize normalize the arrays (so sum of each is 1)?
+     * @param colFunction column function, with the desired parameters
+     * @param rowFunction row function, with the desired parameters
      * @returns the kernel sum (1.0 if doNormalize true)
      *
      * Warning: the length of colList and rowList are not verified!
@@ -1026,13 +1242,25 @@ private:
      * @throws lsst::pex::exceptions::OverflowError if doNormalize is true and the kernel sum is
      * exactly 0
      */
-    double basicComputeVectors(std::vector<Pixel> &colList, std::vector<Pixel> &rowList,
-                               bool doNormalize) const;
+    double basicComputeVectors(std::vector<Pixel> &colList, std::vector<Pixel> &rowList, bool doNormalize,
+                               KernelFunction const &colFunction, KernelFunction const &rowFunction) const;
+
+    /**
+     * Check the lengths of colList and rowList
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if colList or rowList is the wrong size
+     */
+    void _checkVectors(std::vector<Pixel> const &colList, std::vector<Pixel> const &rowList) const;
+
+    /**
+     * Compute the column and row arrays in place for checked kernel parameters, using the
+     * functions in a workspace made by this kernel's makeWorkspace
+     */
+    double _computeVectors(std::vector<Pixel> &colList, std::vector<Pixel> &rowList, bool doNormalize,
+                           std::vector<double> const &kernelParams, Workspace &workspace) const;
 
     KernelFunctionPtr _kernelColFunctionPtr;
     KernelFunctionPtr _kernelRowFunctionPtr;
-    mutable std::vector<Pixel> _localColList;  // used by doComputeImage
-    mutable std::vector<Pixel> _localRowList;
     mutable std::vector<double> _kernelX;  // used by SeparableKernel::basicComputeVectors
     mutable std::vector<double> _kernelY;
     //
@@ -69,6 +69,17 @@ public:
     /// @copydoc BoundedField::evaluate
     double evaluate(lsst::geom::Point2D const &position) const override;
 
+    /**
+     *  @copydoc BoundedField::evaluate(ndarray::Array<double const, 1> const&,
+     *                                  ndarray::Array<double const, 1> const&) const
+     *
+     *  All the points are transformed to the sky in a single call to the SkyWcs.
+     */
+    ndarray::Array<double, 1, 1> evaluate(ndarray::Array<double const, 1> const &x,
+                                          ndarray::Array<double const, 1> const &y) const override;
+
+    using BoundedField::evaluate;
+
     /// TransformBoundedField is not persistable.
     bool isPersistable() const noexcept override { return false; }
 
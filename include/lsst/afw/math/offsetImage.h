@@ -69,15 +69,66 @@ std::shared_ptr<ImageT> rotateImageBy90(ImageT const& image, int nQuarter);
  */
 template <typename ImageT>
 std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipTB);
+
+/**
+ * Flip an image left--right and/or top--bottom in place
+ *
+ * Flipping both left--right and top--bottom rotates the image by 180 degrees.
+ *
+ * @param image The %image to flip
+ * @param flipLR Flip left <--> right?
+ * @param flipTB Flip top <--> bottom?
+ */
+template <typename ImageT>
+void flipImageInPlace(ImageT& image, bool flipLR, bool flipTB);
 /**
+ * Bin an image by integral factors
+ *
+ * Each output pixel is computed from a binX*binY block of input pixels; input pixels at the right and
+ * top that do not fill a block are ignored.  The mask of an output pixel is the bitwise OR of the masks
+ * of its input pixels, and NaNs are propagated.
+ *
+ * Blocks of output rows are computed in parallel (see lsst::afw::detail::setDefaultNumThreads).
+ *
  * @param inImage The %image to bin
  * @param binX Output pixels are binX*binY input pixels
  * @param binY Output pixels are binX*binY input pixels
- * @param flags how to generate super-pixels
+ * @param flags how to generate super-pixels: one of MEAN, SUM, MEDIAN, MIN or MAX
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if flags is not a supported statistic
+ * @throws lsst::pex::exceptions::DomainError if binX or binY is not positive
  */
 template <typename ImageT>
 std::shared_ptr<ImageT> binImage(ImageT const& inImage, int const binX, int const binY,
                                  lsst::afw::math::Property const flags = lsst::afw::math::MEAN);
+/**
+ * Bin an image by integral factors, ignoring masked and NaN pixels
+ *
+ * As the other binImage overloads, except that:
+ * - input pixels with any of the bits of `sctrl.getAndMask()` set are ignored (MaskedImages only);
+ * - NaN input pixels are ignored if `sctrl.getNanSafe()`, and propagated otherwise;
+ * - output pixels with no good input pixels are NaN (0 for integer images), and have
+ *   `sctrl.getNoGoodPixelsMask()` set in their masks;
+ * - if keepPartialBins, the output also includes pixels for the partial blocks at the right and top.
+ *
+ * The variance of an output pixel is that of the sum or mean of its good input pixels, assuming they
+ * are independent; for MEDIAN it is pi/2 times the variance of the mean, as for Gaussian noise, and
+ * for MIN and MAX it is the variance of the selected pixel.
+ *
+ * @param inImage The %image to bin
+ * @param binX Output pixels are binX*binY input pixels
+ * @param binY Output pixels are binX*binY input pixels
+ * @param flags how to generate super-pixels: one of MEAN, SUM, MEDIAN, MIN or MAX
+ * @param sctrl control for which pixels are ignored
+ * @param keepPartialBins include output pixels for partial blocks of input pixels?
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if flags is not a supported statistic
+ * @throws lsst::pex::exceptions::DomainError if binX or binY is not positive
+ */
+template <typename ImageT>
+std::shared_ptr<ImageT> binImage(ImageT const& inImage, int const binX, int const binY,
+                                 lsst::afw::math::Property const flags, StatisticsControl const& sctrl,
+                                 bool keepPartialBins = false);
 /**
  * @param inImage The %image to bin
  * @param binsize Output pixels are binsize*binsize input pixels
@@ -85,6 +85,8 @@ public:
 
 protected:
     void setKernelParameter(unsigned int ind, double value) const override;
+
+    void checkKernelParameters(std::vector<double> const &kernelParams) const override;
 };
 
 /**
@@ -149,6 +151,8 @@ public:
 
 protected:
     void setKernelParameter(unsigned int ind, double value) const override;
+
+    void checkKernelParameters(std::vector<double> const &kernelParams) const override;
 };
 
 /**
@@ -212,6 +216,8 @@ public:
 
 protected:
     void setKernelParameter(unsigned int ind, double value) const override;
+
+    void checkKernelParameters(std::vector<double> const &kernelParams) const override;
 };
 
 /**
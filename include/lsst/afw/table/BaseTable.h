@@ -2,6 +2,7 @@
 #ifndef AFW_TABLE_BaseTable_h_INCLUDED
 #define AFW_TABLE_BaseTable_h_INCLUDED
 #include <memory>
+#include <vector>
 
 #include "lsst/base.h"
 #include "lsst/daf/base/Citizen.h"
@@ -55,9 +56,18 @@ public:
     /// Template of CatalogT used to hold const records of the associated type.
     typedef CatalogT<Record const> ConstCatalog;
 
-    /// Number of records in each memory block.
+    /// Number of records in the first memory block of a new table.
     static int nRecordsPerBlock;
 
+    /**
+     *  Factor by which a new table's memory blocks grow each time one is filled.
+     *
+     *  The default of 1 allocates blocks of nRecordsPerBlock records, so a table's memory footprint
+     *  does not depend on how many records it holds; tables that are built by appending many records
+     *  may opt in to geometric growth with BaseTable::setBlockGrowthFactor.
+     */
+    static double blockGrowthFactor;
+
     /// Return the flexible metadata associated with the table.  May be null.
     std::shared_ptr<daf::base::PropertyList> getMetadata() const { return _metadata; }
 
@@ -140,6 +150,46 @@ public:
      */
     std::size_t getBufferSize() const;
 
+    /**
+     *  Return the number of records the next memory block allocated for new records will hold.
+     *
+     *  This block is only allocated when a record is created and the current block is full;
+     *  preallocate() allocates blocks of exactly the requested size instead.
+     */
+    std::size_t getBlockSize() const { return _blockSize; }
+
+    /**
+     *  Set the number of records the next memory block allocated for new records will hold.
+     *
+     *  Subsequent blocks grow from this size by the block growth factor.
+     */
+    void setBlockSize(std::size_t nRecords);
+
+    /// Return the factor by which the block size grows each time a block is filled.
+    double getBlockGrowthFactor() const { return _blockGrowthFactor; }
+
+    /**
+     *  Set the factor by which the block size grows each time a block is filled.
+     *
+     *  A factor of 1 allocates fixed-size blocks; larger factors make catalogs built by
+     *  appending records use a logarithmic (rather than linear) number of blocks, at the
+     *  cost of leaving some of the last block unused.  Blocks never grow beyond
+     *  approximately 64 MiB.
+     */
+    void setBlockGrowthFactor(double factor);
+
+    /**
+     *  Move the field data of a sequence of records into a single contiguous memory block.
+     *
+     *  The records keep their identity: pointers and references to the records themselves remain
+     *  valid, but arrays and references to field data obtained before the move refer to the old
+     *  memory.  All records must belong to this table.
+     *
+     *  This is mostly useful via CatalogT::makeContiguous, which uses it to allow column views of
+     *  catalogs that were built up by appending records.
+     */
+    void relocate(std::vector<BaseRecord*> const& records);
+
     /**
      *  Construct a new table.
      *
@@ -186,7 +236,11 @@ protected:
 
     /// Copy construct.
     BaseTable(BaseTable const& other)
-            : daf::base::Citizen(other), _schema(other._schema), _metadata(other._metadata) {
+            : daf::base::Citizen(other),
+              _schema(other._schema),
+              _metadata(other._metadata),
+              _blockSize(other._blockSize),
+              _blockGrowthFactor(other._blockGrowthFactor) {
         if (_metadata) _metadata = std::static_pointer_cast<daf::base::PropertyList>(_metadata->deepCopy());
     }
     // Delegate to copy-constructor for backwards compatibility
@@ -219,6 +273,8 @@ private:
     Schema _schema;                                      // schema that defines the table's fields
     ndarray::Manager::Ptr _manager;                      // current memory block to use for new records
     std::shared_ptr<daf::base::PropertyList> _metadata;  // flexible metadata; may be null
+    std::size_t _blockSize;                              // number of records in the next block
+    double _blockGrowthFactor;                           // factor by which _blockSize grows
 };
 }  // namespace table
 }  // namespace afw
@@ -123,10 +123,10 @@ public:
      *  before it can be used.
      */
     explicit CatalogT(std::shared_ptr<Table> const& table = std::shared_ptr<Table>())
-            : _table(table), _internal() {}
+            : _table(table), _internal(), _version(0) {}
 
     /// Construct a catalog from a schema, creating a table with Table::make(schema).
-    explicit CatalogT(Schema const& schema) : _table(Table::make(schema)), _internal() {}
+    explicit CatalogT(Schema const& schema) : _table(Table::make(schema)), _internal(), _version(0) {}
 
     /**
      *  Construct a catalog from a table and an iterator range.
@@ -140,12 +140,12 @@ public:
      */
     template <typename InputIterator>
     CatalogT(std::shared_ptr<Table> const& table, InputIterator first, InputIterator last, bool deep = false)
-            : _table(table), _internal() {
+            : _table(table), _internal(), _version(0) {
         insert(end(), first, last, deep);
     }
 
     /// Shallow copy constructor.
-    CatalogT(CatalogT const& other) : _table(other._table), _internal(other._internal) {}
+    CatalogT(CatalogT const& other) : _table(other._table), _internal(other._internal), _version(0) {}
     // Delegate to copy constructor for backward compatibility
     CatalogT(CatalogT&& other) : CatalogT(other) {}
 
@@ -159,13 +159,14 @@ public:
      */
     template <typename OtherRecordT>
     CatalogT(CatalogT<OtherRecordT> const& other)
-            : _table(other.getTable()), _internal(other.begin().base(), other.end().base()) {}
+            : _table(other.getTable()), _internal(other.begin().base(), other.end().base()), _version(0) {}
 
     /// Shallow assigment.
     CatalogT& operator=(CatalogT const& other) {
         if (&other != this) {
             _table = other._table;
             _internal = other._internal;
+            ++_version;
         }
         return *this;
     }
@@ -387,6 +388,28 @@ public:
     /// Return true if all records are contiguous.
     bool isContiguous() const { return ColumnView::isRangeContiguous(_table, begin(), end()); }
 
+    /**
+     *  Move the field data of all records into a single contiguous block of memory, in catalog order.
+     *
+     *  After this call isContiguous() is true and getColumnView() succeeds.  Unlike a deep copy, the
+     *  records themselves are not replaced, so other catalogs and pointers that share them see the
+     *  same (relocated) records.  Arrays and references to field data obtained before the call
+     *  refer to the old memory and are no longer shared with the records.
+     *
+     *  This is a no-op if the catalog is already contiguous.
+     *
+     *  @throws pex::exceptions::LogicError if any record does not belong to the catalog's table.
+     */
+    void makeContiguous() {
+        if (isContiguous()) return;
+        std::vector<BaseRecord*> records;
+        records.reserve(size());
+        for (auto const& record : _internal) {
+            records.push_back(const_cast<BaseRecord*>(static_cast<BaseRecord const*>(record.get())));
+        }
+        _table->relocate(records);
+    }
+
     //@{
     /**
      *  Iterator access.
@@ -446,7 +469,10 @@ public:
     std::shared_ptr<RecordT> const get(size_type i) const { return _internal[i]; }
 
     /// Set the record at index i to a pointer.
-    void set(size_type i, std::shared_ptr<RecordT> const& p) { _internal[i] = p; }
+    void set(size_type i, std::shared_ptr<RecordT> const& p) {
+        _internal[i] = p;
+        ++_version;
+    }
 
     /**
      *  Replace the contents of the table with an iterator range.
@@ -463,20 +489,28 @@ public:
     void push_back(Record const& r) {
         std::shared_ptr<RecordT> p = _table->copyRecord(r);
         _internal.push_back(p);
+        ++_version;
     }
 
     /// Add the given record to the end of the catalog without copying.
-    void push_back(std::shared_ptr<RecordT> const& p) { _internal.push_back(p); }
+    void push_back(std::shared_ptr<RecordT> const& p) {
+        _internal.push_back(p);
+        ++_version;
+    }
 
     /// Create a new record, add it to the end of the catalog, and return a pointer to it.
     std::shared_ptr<RecordT> addNew() {
         std::shared_ptr<RecordT> r = _table->makeRecord();
         _internal.push_back(r);
+        ++_version;
         return r;
     }
 
     /// Remove the last record in the catalog
-    void pop_back() { _internal.pop_back(); }
+    void pop_back() {
+        _internal.pop_back();
+        ++_version;
+    }
 
     /// Deep-copy the catalog using a cloned table.
     CatalogT copy() const { return CatalogT(getTable()->clone(), begin(), end(), true); }
@@ -535,19 +569,25 @@ public:
     /// Insert a copy of the given record at the given position.
     iterator insert(iterator pos, Record const& r) {
         std::shared_ptr<RecordT> p = _table->copyRecord(r);
+        ++_version;
         return iterator(_internal.insert(pos.base(), p));
     }
 
     /// Insert the given record at the given position without copying.
     iterator insert(iterator pos, std::shared_ptr<RecordT> const& p) {
+        ++_version;
         return iterator(_internal.insert(pos.base(), p));
     }
 
     /// Erase the record pointed to by pos, and return an iterator the next record.
-    iterator erase(iterator pos) { return iterator(_internal.erase(pos.base())); }
+    iterator erase(iterator pos) {
+        ++_version;
+        return iterator(_internal.erase(pos.base()));
+    }
 
     /// Erase the records in the range [first, last).
     iterator erase(iterator first, iterator last) {
+        ++_version;
         return iterator(_internal.erase(first.base(), last.base()));
     }
 
@@ -555,10 +595,15 @@ public:
     void swap(CatalogT& other) noexcept {
         _table.swap(other._table);
         _internal.swap(other._internal);
+        ++_version;
+        ++other._version;
     }
 
     /// Remove all records from the catalog.
-    void clear() { _internal.clear(); }
+    void clear() {
+        _internal.clear();
+        ++_version;
+    }
 
     /// Return true if the catalog is in ascending order according to the given key.
     template <typename T>
@@ -652,12 +697,20 @@ public:
      *  of Record::operator=), those algorithms should be called on the iterators of these internal
      *  containers.  When an algorithm should be called in such a way that records are deep-copied,
      *  the regular Catalog iterators should be used.
+     *
+     *  Non-const access is assumed to modify the catalog, invalidating any CatalogIndex built on it.
      */
-    Internal& getInternal() { return _internal; }
+    Internal& getInternal() {
+        ++_version;
+        return _internal;
+    }
     Internal const& getInternal() const { return _internal; }
     //@}
 
 private:
+    template <typename R, typename T>
+    friend class CatalogIndex;
+
     template <typename InputIterator>
     void _maybeReserve(iterator& pos, InputIterator first, InputIterator last, bool deep,
                        std::random_access_iterator_tag*) {
@@ -670,6 +723,7 @@ private:
 
     std::shared_ptr<Table> _table;
     Internal _internal;
+    std::size_t _version;  // incremented whenever the sequence of records changes; see CatalogIndex
 };
 
 namespace detail {
@@ -722,6 +776,7 @@ template <typename Compare>
 void CatalogT<RecordT>::sort(Compare cmp) {
     detail::ComparisonAdaptor<RecordT, Compare> f = {cmp};
     std::stable_sort(_internal.begin(), _internal.end(), f);
+    ++_version;
 }
 
 template <typename RecordT>
@@ -0,0 +1,179 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_CatalogIndex_h_INCLUDED
+#define AFW_TABLE_CatalogIndex_h_INCLUDED
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lsst/afw/table/Catalog.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/**
+ *  A secondary index over a scalar field of a catalog.
+ *
+ *  CatalogT::find and friends require the catalog to be sorted by the field being searched, so
+ *  only one field can be searched efficiently at a time.  A CatalogIndex instead builds either a
+ *  hash table (HASH) or a sorted permutation (SORTED) of the records' positions, which allows
+ *  fast lookups of all records with a given value without reordering the catalog:
+ *  @code
+ *  CatalogIndex<SourceRecord, RecordId> byParent(catalog, catalog.getTable()->getParentKey());
+ *  auto children = byParent.equalRange(parentId);
+ *  for (auto iter = children.first; iter != children.second; ++iter) {
+ *      SourceRecord & child = catalog[*iter];
+ *  }
+ *  @endcode
+ *
+ *  The index refers to the catalog it was built from, which must outlive it.  It is built on
+ *  first use and rebuilt lazily whenever the sequence of records has been changed through the
+ *  catalog's own interface (e.g. push_back, insert, erase, sort, set).  Changing the value of the
+ *  indexed field in a record does not change the catalog, so invalidate() must be called
+ *  explicitly in that case.
+ *
+ *  NaN values of floating-point fields never compare equal, so those records are never found.
+ *
+ *  Lookups are not thread-safe when a rebuild may be necessary.
+ */
+template <typename RecordT, typename T>
+class CatalogIndex {
+public:
+    typedef CatalogT<RecordT> Catalog;
+    typedef typename Field<T>::Value Value;
+
+    /// Iterator over the positions (in the catalog) of matching records.
+    typedef std::vector<std::size_t>::const_iterator Iterator;
+
+    /// Method used to index the records.
+    enum Method {
+        HASH,   ///< Hash table: O(1) lookups, O(N) construction.
+        SORTED  ///< Sorted permutation: O(log N) lookups, O(N log N) construction.
+    };
+
+    /**
+     *  Construct an index over a catalog.
+     *
+     *  @param[in] catalog  Catalog to index; must outlive the index.
+     *  @param[in] key  Key for the field to index.
+     *  @param[in] method  Indexing method.
+     */
+    CatalogIndex(Catalog const& catalog, Key<T> const& key, Method method = HASH)
+            : _catalog(&catalog), _key(key), _method(method), _valid(false), _version(0) {}
+
+    CatalogIndex(CatalogIndex const&) = default;
+    CatalogIndex(CatalogIndex&&) = default;
+    CatalogIndex& operator=(CatalogIndex const&) = default;
+    CatalogIndex& operator=(CatalogIndex&&) = default;
+    ~CatalogIndex() = default;
+
+    /// Return the key of the indexed field.
+    Key<T> const& getKey() const { return _key; }
+
+    /// Return the indexing method.
+    Method getMethod() const { return _method; }
+
+    /**
+     *  Return the range of positions of the records with the given value.
+     *
+     *  Positions of records with equal values are in catalog order.
+     */
+    std::pair<Iterator, Iterator> equalRange(Value const& value) const {
+        _ensureBuilt();
+        if (_method == HASH) {
+            auto const iter = _hash.find(value);
+            if (iter == _hash.end()) {
+                return std::make_pair(_order.end(), _order.end());
+            }
+            return std::make_pair(_order.begin() + iter->second.first, _order.begin() + iter->second.second);
+        }
+        auto const range = std::equal_range(_values.begin(), _values.end(), value);
+        return std::make_pair(_order.begin() + (range.first - _values.begin()),
+                              _order.begin() + (range.second - _values.begin()));
+    }
+
+    /// Return the number of records with the given value.
+    std::size_t count(Value const& value) const {
+        auto const range = equalRange(value);
+        return range.second - range.first;
+    }
+
+    /// Return the first record (in catalog order) with the given value, or a null pointer.
+    std::shared_ptr<RecordT> find(Value const& value) const {
+        auto const range = equalRange(value);
+        if (range.first == range.second) {
+            return std::shared_ptr<RecordT>();
+        }
+        return _catalog->get(*range.first);
+    }
+
+    /// Force the index to be rebuilt on the next lookup.
+    void invalidate() { _valid = false; }
+
+private:
+    void _ensureBuilt() const {
+        if (_valid && _version == _catalog->_version) {
+            return;
+        }
+        _order.clear();
+        _values.clear();
+        _hash.clear();
+        std::size_t const size = _catalog->size();
+        if (_method == HASH) {
+            // Counting sort by value: the first pass counts the records for each value, the second
+            // turns counts into offsets, and the third fills in the positions.
+            _hash.reserve(size);
+            for (std::size_t ii = 0; ii < size; ++ii) {
+                Value const value = (*_catalog)[ii].get(_key);
+                if (!(value == value)) continue;  // NaN
+                ++_hash[value].second;
+            }
+            std::size_t offset = 0;
+            for (auto& entry : _hash) {
+                std::size_t const num = entry.second.second;
+                entry.second.first = entry.second.second = offset;
+                offset += num;
+            }
+            _order.resize(offset);
+            for (std::size_t ii = 0; ii < size; ++ii) {
+                Value const value = (*_catalog)[ii].get(_key);
+                if (!(value == value)) continue;
+                _order[_hash[value].second++] = ii;
+            }
+        } else {
+            std::vector<Value> values(size);
+            _order.reserve(size);
+            for (std::size_t ii = 0; ii < size; ++ii) {
+                values[ii] = (*_catalog)[ii].get(_key);
+                if (!(values[ii] == values[ii])) continue;
+                _order.push_back(ii);
+            }
+            std::stable_sort(_order.begin(), _order.end(),
+                             [&values](std::size_t a, std::size_t b) { return values[a] < values[b]; });
+            _values.reserve(_order.size());
+            for (auto ii : _order) {
+                _values.push_back(values[ii]);
+            }
+        }
+        _version = _catalog->_version;
+        _valid = true;
+    }
+
+    Catalog const* _catalog;
+    Key<T> _key;
+    Method _method;
+    mutable bool _valid;
+    mutable std::size_t _version;
+    mutable std::vector<std::size_t> _order;  // positions of records, grouped by value
+    mutable std::vector<Value> _values;       // SORTED: values in the order of _order
+    mutable std::unordered_map<Value, std::pair<std::size_t, std::size_t>> _hash;  // HASH: [begin, end)
+};
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_CatalogIndex_h_INCLUDED
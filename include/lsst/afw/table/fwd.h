@@ -61,6 +61,8 @@ template <typename RecordT>
 class CatalogT;
 template <typename RecordT>
 class SortedCatalogT;
+template <typename RecordT, typename T>
+class CatalogIndex;
 template <typename RecordT>
 class SourceColumnViewT;
 template <typename RecordT>
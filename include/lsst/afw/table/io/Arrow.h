@@ -0,0 +1,119 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_IO_Arrow_h_INCLUDED
+#define AFW_TABLE_IO_Arrow_h_INCLUDED
+
+#include <cstdint>
+
+#include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/Catalog.h"
+
+// The Arrow C Data Interface structures, exactly as given in the Arrow specification
+// (https://arrow.apache.org/docs/format/CDataInterface.html).  The interface is a stable ABI,
+// so no Arrow library is needed to produce or consume these; the guard lets this header be
+// combined with Arrow's own headers.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+}  // extern "C"
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace io {
+
+/**
+ *  Export a catalog as an Arrow struct array, using the Arrow C Data Interface.
+ *
+ *  Each field becomes a child of the struct array, with the following Arrow types:
+ *   - numeric scalars map to the Arrow integer or floating-point type of the same width;
+ *   - Angle fields are exported as float64 radians;
+ *   - Flag fields are exported as (bit-packed) booleans;
+ *   - string fields are exported as utf8 strings, trimmed at the first null character;
+ *   - fixed-length array fields are exported as fixed-size lists, and variable-length array fields
+ *     as lists.
+ *  Field documentation and units (and the information needed to restore Angle and fixed-length
+ *  string fields) are saved in the field metadata, under keys prefixed with "afw:".  Aliases
+ *  and table metadata are not exported.
+ *
+ *  Arrow columns must be contiguous in memory, while catalog records are stored row by row (and
+ *  padded), so the data are always copied: every column is repacked, in parallel over columns,
+ *  into buffers owned by the exported array, which is independent of the catalog once this
+ *  returns.
+ *
+ *  @param[in] catalog   Catalog to export; any catalog type may be passed.
+ *  @param[out] schema   Uninitialized structure to fill with the Arrow type of the catalog.
+ *  @param[out] array    Uninitialized structure to fill with the catalog data.
+ *
+ *  The caller is responsible for calling the release callbacks of both structures.
+ *
+ *  @throws pex::exceptions::LengthError if the total size of a string or variable-length array
+ *      column exceeds the range of Arrow's 32-bit offsets.
+ */
+void exportArrow(BaseCatalog const& catalog, ArrowSchema* schema, ArrowArray* array);
+
+/**
+ *  Import an Arrow struct array, using the Arrow C Data Interface, as a new catalog.
+ *
+ *  This is the inverse of exportArrow, but any struct array whose children have types supported
+ *  by afw.table may be imported (uint8, uint16, int32, int64, float32, float64, boolean, utf8,
+ *  and fixed-size lists or lists of uint8, uint16, int32, float32 or float64).  Strings without
+ *  a saved size become fixed-length fields large enough for the longest value.  Null entries
+ *  are left at the field's default value (NaN for floating-point fields).
+ *
+ *  The data are always copied, since catalogs store their records row by row.
+ *
+ *  @param[in,out] schema  Arrow type of the array; released before returning.
+ *  @param[in,out] array   Struct array to import; released before returning.
+ *
+ *  @throws pex::exceptions::InvalidParameterError if the array is not a struct array or a child
+ *      has a type with no afw.table equivalent.
+ */
+BaseCatalog importArrow(ArrowSchema* schema, ArrowArray* array);
+
+}  // namespace io
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_IO_Arrow_h_INCLUDED
@@ -22,11 +22,16 @@
 #ifndef AFW_TABLE_PYTHON_CATALOG_H_INCLUDED
 #define AFW_TABLE_PYTHON_CATALOG_H_INCLUDED
 
+#include <algorithm>
+#include <cstdint>
+
 #include "pybind11/pybind11.h"
 
 #include "lsst/utils/python.h"
 #include "lsst/afw/table/BaseColumnView.h"
 #include "lsst/afw/table/Catalog.h"
+#include "lsst/afw/table/CatalogIndex.h"
+#include "lsst/afw/table/io/Arrow.h"
 
 namespace lsst {
 namespace afw {
@@ -113,6 +118,51 @@ void declareCatalogOverloads(PyCatalog<Record> &cls) {
             [](Catalog const &self, Key<T> const &key) { return _getArrayFromCatalog(self, key); });
 }
 
+/**
+Wrap an instantiation of lsst::afw::table::CatalogIndex<Record, T>.
+
+@tparam T  Field type.
+@tparam Record  Record type, e.g. BaseRecord or SimpleRecord.
+
+@param[in] mod  Module object class will be added to.
+@param[in] name  Name prefix of the record type, e.g. "Base" or "Simple".
+@param[in] suffix  Suffix of the field type, e.g. "I" or "L".
+*/
+template <typename T, typename Record>
+void declareCatalogIndex(pybind11::module &mod, std::string const &name, std::string const &suffix) {
+    namespace py = pybind11;
+    using namespace pybind11::literals;
+
+    typedef CatalogIndex<Record, T> Index;
+    typedef typename Index::Value Value;
+
+    py::class_<Index, std::shared_ptr<Index>> cls(mod, (name + "CatalogIndex" + suffix).c_str());
+
+    py::enum_<typename Index::Method>(cls, "Method")
+            .value("HASH", Index::HASH)
+            .value("SORTED", Index::SORTED)
+            .export_values();
+
+    // The index refers to the catalog, so the catalog must be kept alive as long as the index.
+    cls.def(py::init<CatalogT<Record> const &, Key<T> const &, typename Index::Method>(), "catalog"_a,
+            "key"_a, "method"_a = Index::HASH, py::keep_alive<1, 2>());
+
+    cls.def("getKey", &Index::getKey);
+    cls.def("getMethod", &Index::getMethod);
+    // Return the positions of the matching records, rather than a pair of iterators.
+    cls.def("equalRange",
+            [](Index const &self, Value const &value) -> ndarray::Array<std::int64_t, 1, 1> {
+                auto const range = self.equalRange(value);
+                ndarray::Array<std::int64_t, 1, 1> out = ndarray::allocate(range.second - range.first);
+                std::copy(range.first, range.second, out.begin());
+                return out;
+            },
+            "value"_a);
+    cls.def("count", &Index::count, "value"_a);
+    cls.def("find", &Index::find, "value"_a);
+    cls.def("invalidate", &Index::invalidate);
+}
+
 /**
 Wrap an instantiation of lsst::afw::table::CatalogT<Record>.
 
@@ -199,6 +249,15 @@ PyCatalog<Record> declareCatalog(pybind11::module &mod, std::string const &name,
     cls.def("_getitem_",
             [](Catalog &self, int i) { return self.get(utils::python::cppIndex(self.size(), i)); });
     cls.def("isContiguous", &Catalog::isContiguous);
+    cls.def("makeContiguous", &Catalog::makeContiguous);
+    // Export to the Arrow C Data Interface structures at the given addresses (e.g. allocated by
+    // pyarrow.cffi), which can then be imported with pyarrow.RecordBatch._import_from_c.
+    cls.def("exportArrow",
+            [](Catalog const &self, std::uintptr_t schemaAddress, std::uintptr_t arrayAddress) {
+                io::exportArrow(self, reinterpret_cast<ArrowSchema *>(schemaAddress),
+                                reinterpret_cast<ArrowArray *>(arrayAddress));
+            },
+            "schemaAddress"_a, "arrayAddress"_a);
     cls.def("writeFits",
             (void (Catalog::*)(std::string const &, std::string const &, int) const) & Catalog::writeFits,
             "filename"_a, "mode"_a = "w", "flags"_a = 0);
@@ -216,6 +275,11 @@ PyCatalog<Record> declareCatalog(pybind11::module &mod, std::string const &name,
     declareCatalogOverloads<double>(cls);
     declareCatalogOverloads<lsst::geom::Angle>(cls);
 
+    declareCatalogIndex<std::int32_t, Record>(mod, name, "I");
+    declareCatalogIndex<std::int64_t, Record>(mod, name, "L");
+    declareCatalogIndex<float, Record>(mod, name, "F");
+    declareCatalogIndex<double, Record>(mod, name, "D");
+
     cls.def("_getitem_", [](Catalog const &self, Key<Flag> const &key) -> ndarray::Array<bool const, 1, 0> {
         return _getArrayFromCatalog(self, key);
     });
@@ -42,6 +42,9 @@ namespace table {
  *                  - "centroid": a field containing lsst::geom::Point2D; this field is written
  *                  - "hasCentroid": a flag; this field is written
  *
+ * Contiguous catalogs are read and written through column views; other collections are copied to and
+ * from temporary columns.  Either way, the transform is applied with the columnar SkyWcs::skyToPixel.
+ *
  * @throws lsst::pex::exceptions::NotFoundError if refList's schema does not have the required fields.
  */
 template <typename ReferenceCollection>
@@ -57,6 +60,9 @@ void updateRefCentroids(geom::SkyWcs const& wcs, ReferenceCollection& refList);
  *                  - "slot_Centroid": a field containing lsst::geom::Point2D; this field is read
  *                  - "coord": a field containing an ICRS lsst::afw::SpherePoint; this field is written
  *
+ * Contiguous catalogs are read and written through column views; other collections are copied to and
+ * from temporary columns.  Either way, the transform is applied with the columnar SkyWcs::pixelToSky.
+ *
  * @throws lsst::pex::exceptions::NotFoundError if refList's schema does not have the required fields.
  */
 template <typename SourceCollection>
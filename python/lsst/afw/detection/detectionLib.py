@@ -11,6 +11,7 @@ from .peak import *
 from .peak import *
 from .footprintCtrl import *
 from .gaussianPsf import *
+from .oversampledPsf import *
 from .footprintMerge import *
 from .footprintMerge import *
 from .heavyFootprint import *
@@ -22,6 +22,7 @@
 
 #include <pybind11/pybind11.h>
 //#include <pybind11/operators.h>
+#include <pybind11/functional.h>
 #include <pybind11/stl.h>
 
 #include "lsst/afw/detection/FootprintSet.h"
@@ -111,6 +112,8 @@ PYBIND11_MODULE(footprintSet, mod) {
     clsFootprintSet.def("setRegion", &FootprintSet::setRegion);
     clsFootprintSet.def("getRegion", &FootprintSet::getRegion);
     clsFootprintSet.def("insertIntoImage", &FootprintSet::insertIntoImage);
+    clsFootprintSet.def("insertIntoImageBands", &FootprintSet::insertIntoImageBands, "function"_a,
+                        "bandHeight"_a, "relativeIDs"_a);
     clsFootprintSet.def("setMask", (void (FootprintSet::*)(image::Mask<lsst::afw::image::MaskPixel> *,
                                                            std::string const &)) &
                                            FootprintSet::setMask<lsst::afw::image::MaskPixel>);
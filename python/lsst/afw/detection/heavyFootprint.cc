@@ -52,6 +52,10 @@ void declareHeavyFootprint(py::module &mod, std::string const &suffix) {
             "foot"_a, "mimage"_a, "ctrl"_a = nullptr);
     clsHeavyFootprint.def(py::init<Footprint const &, HeavyFootprintCtrl const *>(), "foot"_a,
                           "ctrl"_a = nullptr);
+    clsHeavyFootprint.def(py::init<Footprint const &, ndarray::Array<ImagePixelT, 1, 1> const &,
+                                   ndarray::Array<MaskPixelT, 1, 1> const &,
+                                   ndarray::Array<VariancePixelT, 1, 1> const &>(),
+                          "foot"_a, "image"_a, "mask"_a, "variance"_a);
 
     /* Members */
     clsHeavyFootprint.def("isHeavy", &Class::isHeavy);
@@ -0,0 +1,58 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <pybind11/pybind11.h>
+
+#include "lsst/afw/table/io/python.h"  // for addPersistableMethods
+#include "lsst/afw/detection/OversampledPsf.h"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+namespace lsst {
+namespace afw {
+namespace detection {
+
+PYBIND11_MODULE(oversampledPsf, mod) {
+    py::module::import("lsst.afw.detection.psf");
+
+    py::class_<OversampledPsf, std::shared_ptr<OversampledPsf>, Psf> cls(mod, "OversampledPsf");
+
+    table::io::python::addPersistableMethods<OversampledPsf>(cls);
+
+    cls.def(py::init([](std::shared_ptr<Psf> psf, lsst::geom::Box2I const &bbox, int cellSize,
+                        int oversampling) {
+                return std::make_shared<OversampledPsf>(psf, bbox, cellSize, oversampling);
+            }),
+            "psf"_a, "bbox"_a, "cellSize"_a = 256, "oversampling"_a = 4);
+
+    cls.def("clone", &OversampledPsf::clone);
+    cls.def("resized", &OversampledPsf::resized, "width"_a, "height"_a);
+    cls.def("getPsf",
+            [](OversampledPsf const &self) { return std::const_pointer_cast<Psf>(self.getPsf()); });
+    cls.def("getBBox", &OversampledPsf::getBBox);
+    cls.def("getCellSize", &OversampledPsf::getCellSize);
+    cls.def("getOversampling", &OversampledPsf::getOversampling);
+    cls.def("isPersistable", &OversampledPsf::isPersistable);
+}
+}  // namespace detection
+}  // namespace afw
+}  // namespace lsst
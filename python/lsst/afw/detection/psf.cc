@@ -23,7 +23,7 @@
 #include <memory>
 
 #include <pybind11/pybind11.h>
-//#include <pybind11/stl.h>
+#include <pybind11/stl.h>
 
 #include "lsst/daf/base/Citizen.h"
 #include "lsst/geom/Point.h"
@@ -61,6 +61,10 @@ PYBIND11_MODULE(psf, mod) {
             "owner"_a = Psf::ImageOwnerEnum::COPY);
     cls.def("computeKernelImage", &Psf::computeKernelImage, "position"_a = NullPoint,
             "color"_a = image::Color(), "owner"_a = Psf::ImageOwnerEnum::COPY);
+    cls.def("computeImages", &Psf::computeImages, "positions"_a, "color"_a = image::Color(),
+            "owner"_a = Psf::ImageOwnerEnum::COPY);
+    cls.def("computeKernelImages", &Psf::computeKernelImages, "positions"_a, "color"_a = image::Color(),
+            "owner"_a = Psf::ImageOwnerEnum::COPY);
     cls.def("computePeak", &Psf::computePeak, "position"_a = NullPoint, "color"_a = image::Color());
     cls.def("computeApertureFlux", &Psf::computeApertureFlux, "radius"_a, "position"_a = NullPoint,
             "color"_a = image::Color());
@@ -73,6 +77,8 @@ PYBIND11_MODULE(psf, mod) {
                    "warpAlgorithm"_a = "lanczos5", "warpBuffer"_a = 5);
     cls.def("getCacheCapacity", &Psf::getCacheCapacity);
     cls.def("setCacheCapacity", &Psf::setCacheCapacity);
+    cls.def("getCacheGridSpacing", &Psf::getCacheGridSpacing);
+    cls.def("setCacheGridSpacing", &Psf::setCacheGridSpacing, "spacing"_a);
 }
 }
 }
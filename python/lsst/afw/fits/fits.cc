@@ -231,6 +231,8 @@ PYBIND11_MODULE(fits, mod) {
             }, "fileName"_a, "hdu"_a=DEFAULT_HDU, "strip"_a=false);
     mod.def("setAllowImageCompression", &setAllowImageCompression, "allow"_a);
     mod.def("getAllowImageCompression", &getAllowImageCompression);
+    mod.def("setImageReadThreads", &setImageReadThreads, "nThreads"_a);
+    mod.def("getImageReadThreads", &getImageReadThreads);
 
     mod.def("compressionAlgorithmFromString", &compressionAlgorithmFromString);
     mod.def("compressionAlgorithmToString", &compressionAlgorithmToString);
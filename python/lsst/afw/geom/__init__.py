@@ -42,3 +42,4 @@ from .skyWcs import *
 from .transformFromString import *
 from . import wcsUtils
 from .sipApproximation import *
+from .transformApproximation import *
@@ -30,6 +30,7 @@
 #include "lsst/geom/Box.h"
 #include "lsst/geom/Point.h"
 #include "lsst/geom/AffineTransform.h"
+#include "lsst/afw/geom/SpanSet.h"
 #include "lsst/afw/geom/Transform.h"
 #include "lsst/afw/geom/polygon/Polygon.h"
 #include "lsst/afw/table/io/python.h"  // for addPersistableMethods
@@ -44,6 +45,7 @@ namespace polygon {
 
 PYBIND11_MODULE(polygon, mod) {
     py::module::import("lsst.pex.exceptions");
+    py::module::import("lsst.afw.geom.spanSet");
 
     // TODO: Commented-out code is waiting until needed and is untested.
     // Add tests for it and enable it or remove it before the final pybind11 merge.
@@ -124,6 +126,12 @@ PYBIND11_MODULE(polygon, mod) {
             "createImage",
             (std::shared_ptr<afw::image::Image<float>>(Polygon::*)(lsst::geom::Extent2I const &) const) &
                     Polygon::createImage);
+    clsPolygon.def("createSpanSet",
+                   (std::shared_ptr<SpanSet>(Polygon::*)(lsst::geom::Box2I const &) const) &
+                           Polygon::createSpanSet);
+    clsPolygon.def("createSpanSet",
+                   (std::shared_ptr<SpanSet>(Polygon::*)(lsst::geom::Extent2I const &) const) &
+                           Polygon::createSpanSet);
     // clsPolygon.def("isPersistable", &Polygon::isPersistable);
 }
 }  // namespace polygon
@@ -144,6 +144,26 @@ PYBIND11_MODULE(skyWcs, mod) {
                      const) &
                     SkyWcs::skyToPixel,
             "sky"_a);
+    cls.def(
+            "pixelToSkyArray",
+            [](SkyWcs const &self, ndarray::Array<double const, 1> const &x,
+               ndarray::Array<double const, 1> const &y, int nThreads) {
+                ndarray::Array<double, 1, 1> ra = ndarray::allocate(x.getSize<0>());
+                ndarray::Array<double, 1, 1> dec = ndarray::allocate(x.getSize<0>());
+                self.pixelToSky(x, y, ra, dec, nThreads);
+                return std::make_pair(ra, dec);
+            },
+            "x"_a, "y"_a, "nThreads"_a = 0);
+    cls.def(
+            "skyToPixelArray",
+            [](SkyWcs const &self, ndarray::Array<double const, 1> const &ra,
+               ndarray::Array<double const, 1> const &dec, int nThreads) {
+                ndarray::Array<double, 1, 1> x = ndarray::allocate(ra.getSize<0>());
+                ndarray::Array<double, 1, 1> y = ndarray::allocate(ra.getSize<0>());
+                self.skyToPixel(ra, dec, x, y, nThreads);
+                return std::make_pair(x, y);
+            },
+            "ra"_a, "dec"_a, "nThreads"_a = 0);
     // Do not wrap getShortClassName because it returns the name of the class;
     // use `<class>.__name__` or `type(<instance>).__name__` instead.
     // Do not wrap readStream or writeStream because C++ streams are not easy to wrap.
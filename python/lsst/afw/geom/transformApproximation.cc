@@ -0,0 +1,108 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include "lsst/afw/geom/TransformApproximation.h"
+#include "lsst/afw/geom/SkyWcsApproximation.h"
+#include "lsst/afw/table/io/python.h"  // for addPersistableMethods
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst { namespace afw { namespace geom { namespace {
+
+using PyTransformApproximation =
+        py::class_<TransformApproximation, std::shared_ptr<TransformApproximation>>;
+using PySkyWcsApproximation = py::class_<SkyWcsApproximation, std::shared_ptr<SkyWcsApproximation>>;
+
+void declareTransformApproximation(py::module &mod) {
+    PyTransformApproximation cls(mod, "TransformApproximation");
+
+    cls.def(py::init<TransformPoint2ToPoint2 const &, lsst::geom::Box2D const &, double, int, int>(),
+            "transform"_a, "bbox"_a, "tolerance"_a, "order"_a=5, "maxLevel"_a=6);
+
+    table::io::python::addPersistableMethods<TransformApproximation>(cls);
+
+    using ScalarTransform =
+            lsst::geom::Point2D (TransformApproximation::*)(lsst::geom::Point2D const &) const;
+    using VectorTransform = std::vector<lsst::geom::Point2D> (TransformApproximation::*)(
+            std::vector<lsst::geom::Point2D> const &) const;
+
+    cls.def("applyForward", (ScalarTransform)&TransformApproximation::applyForward, "point"_a);
+    cls.def("applyForward", (VectorTransform)&TransformApproximation::applyForward, "points"_a);
+    cls.def("applyInverse", (ScalarTransform)&TransformApproximation::applyInverse, "point"_a);
+    cls.def("applyInverse", (VectorTransform)&TransformApproximation::applyInverse, "points"_a);
+    cls.def("hasInverse", &TransformApproximation::hasInverse);
+    cls.def("getBBox", &TransformApproximation::getBBox);
+    cls.def("getOutputBBox", &TransformApproximation::getOutputBBox);
+    cls.def("getOrder", &TransformApproximation::getOrder);
+    cls.def("getForwardPatchCount", &TransformApproximation::getForwardPatchCount);
+    cls.def("getMaxForwardError", &TransformApproximation::getMaxForwardError);
+    cls.def("getMaxInverseError", &TransformApproximation::getMaxInverseError);
+}
+
+void declareSkyWcsApproximation(py::module &mod) {
+    PySkyWcsApproximation cls(mod, "SkyWcsApproximation");
+
+    cls.def(py::init<SkyWcs const &, lsst::geom::Box2D const &, lsst::geom::Angle, double, int, int>(),
+            "wcs"_a, "bbox"_a, "skyTolerance"_a, "pixelTolerance"_a, "order"_a=5, "maxLevel"_a=6);
+
+    table::io::python::addPersistableMethods<SkyWcsApproximation>(cls);
+
+    cls.def("pixelToSky",
+            (lsst::geom::SpherePoint (SkyWcsApproximation::*)(lsst::geom::Point2D const &) const) &
+                    SkyWcsApproximation::pixelToSky,
+            "pixel"_a);
+    cls.def("pixelToSky",
+            (std::vector<lsst::geom::SpherePoint> (SkyWcsApproximation::*)(
+                    std::vector<lsst::geom::Point2D> const &) const) &
+                    SkyWcsApproximation::pixelToSky,
+            "pixels"_a);
+    cls.def("skyToPixel",
+            (lsst::geom::Point2D (SkyWcsApproximation::*)(lsst::geom::SpherePoint const &) const) &
+                    SkyWcsApproximation::skyToPixel,
+            "sky"_a);
+    cls.def("skyToPixel",
+            (std::vector<lsst::geom::Point2D> (SkyWcsApproximation::*)(
+                    std::vector<lsst::geom::SpherePoint> const &) const) &
+                    SkyWcsApproximation::skyToPixel,
+            "sky"_a);
+    cls.def("getBBox", &SkyWcsApproximation::getBBox);
+    cls.def("getTangentPoint", &SkyWcsApproximation::getTangentPoint);
+    cls.def("getMaxSkyError", &SkyWcsApproximation::getMaxSkyError);
+    cls.def("getMaxPixelError", &SkyWcsApproximation::getMaxPixelError);
+    cls.def("getTransform", [](SkyWcsApproximation const &self) {
+        return std::const_pointer_cast<TransformApproximation>(self.getTransform());
+    });
+}
+
+PYBIND11_MODULE(transformApproximation, mod) {
+    py::module::import("lsst.geom");
+    py::module::import("lsst.afw.geom.transform");
+    py::module::import("lsst.afw.geom.skyWcs");
+
+    declareTransformApproximation(mod);
+    declareSkyWcsApproximation(mod);
+}
+
+}}}}  // namespace lsst::afw::<anonymous>
@@ -37,6 +37,7 @@ from .exposureInfo import *
 from .exposure import *
 from .photoCalib import *
 from .imagePca import *
+from .arithmeticKernel import *
 from .imageUtils import *
 from .readMetadata import *
 
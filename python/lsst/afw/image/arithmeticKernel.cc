@@ -0,0 +1,71 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <memory>
+#include <vector>
+
+#include "lsst/afw/image/ArithmeticKernel.h"
+
+namespace py = pybind11;
+
+using namespace py::literals;
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+template <typename ImageT>
+void declareEvaluate(py::class_<ArithmeticKernel, std::shared_ptr<ArithmeticKernel>> &cls) {
+    cls.def("evaluate",
+            [](ArithmeticKernel const &self, ImageT &out,
+               std::vector<std::shared_ptr<ImageT>> const &operands) {
+                std::vector<std::shared_ptr<ImageT const>> constOperands(operands.begin(), operands.end());
+                self.evaluate(out, constOperands);
+            },
+            "out"_a, "operands"_a);
+}
+
+}  // namespace
+
+PYBIND11_MODULE(arithmeticKernel, mod) {
+    py::module::import("lsst.afw.image.image");
+    py::module::import("lsst.afw.image.maskedImage");
+
+    py::class_<ArithmeticKernel, std::shared_ptr<ArithmeticKernel>> cls(mod, "ArithmeticKernel");
+    cls.def(py::init<std::string const &>(), "expression"_a);
+    cls.def("getExpression", &ArithmeticKernel::getExpression);
+    cls.def("getVariables", &ArithmeticKernel::getVariables);
+    declareEvaluate<Image<float>>(cls);
+    declareEvaluate<Image<double>>(cls);
+    declareEvaluate<MaskedImage<float>>(cls);
+    declareEvaluate<MaskedImage<double>>(cls);
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -45,7 +45,13 @@ static void declareImagePca(py::module &mod, std::string const &suffix) {
     cls.def("getImageList", &ImagePca<ImageT>::getImageList);
     cls.def("getDimensions", &ImagePca<ImageT>::getDimensions);
     cls.def("getMean", &ImagePca<ImageT>::getMean);
+    cls.def("removeImage", &ImagePca<ImageT>::removeImage, "index"_a);
     cls.def("analyze", &ImagePca<ImageT>::analyze);
+    cls.def("setNumComponents", &ImagePca<ImageT>::setNumComponents, "nComponents"_a);
+    cls.def("getNumComponents", &ImagePca<ImageT>::getNumComponents);
+    cls.def("setReuseInnerProducts", &ImagePca<ImageT>::setReuseInnerProducts, "reuse"_a);
+    cls.def("getReuseInnerProducts", &ImagePca<ImageT>::getReuseInnerProducts);
+    cls.def("imagesModified", &ImagePca<ImageT>::imagesModified);
     cls.def("updateBadPixels", &ImagePca<ImageT>::updateBadPixels);
     cls.def("getEigenValues", &ImagePca<ImageT>::getEigenValues);
     cls.def("getEigenImages", &ImagePca<ImageT>::getEigenImages);
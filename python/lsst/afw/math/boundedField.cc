@@ -76,6 +76,7 @@ PYBIND11_MODULE(boundedField, mod) {
                     BoundedField::evaluate);
     cls.def("evaluate",
             (double (BoundedField::*)(lsst::geom::Point2D const &) const) & BoundedField::evaluate);
+    cls.def("evaluateGrid", &BoundedField::evaluateGrid, "x"_a, "y"_a);
     cls.def("integrate", &BoundedField::integrate);
     cls.def("mean", &BoundedField::mean);
     cls.def("getBBox", &BoundedField::getBBox);
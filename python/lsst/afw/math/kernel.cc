@@ -40,8 +40,15 @@ PYBIND11_MODULE(kernel, mod) {
 
     clsKernel.def("clone", &Kernel::clone);
     clsKernel.def("resized", &Kernel::resized, "width"_a, "height"_a);
-    clsKernel.def("computeImage", &Kernel::computeImage, "image"_a, "doNormalize"_a, "x"_a = 0.0,
-                  "y"_a = 0.0);
+    clsKernel.def("computeImage",
+                  (double (Kernel::*)(lsst::afw::image::Image<Kernel::Pixel> &, bool, double, double) const) &
+                          Kernel::computeImage,
+                  "image"_a, "doNormalize"_a, "x"_a = 0.0, "y"_a = 0.0);
+    clsKernel.def("computeImage",
+                  (double (Kernel::*)(lsst::afw::image::Image<Kernel::Pixel> &, bool,
+                                      std::vector<double> const &) const) &
+                          Kernel::computeImage,
+                  "image"_a, "doNormalize"_a, "kernelParams"_a);
     clsKernel.def("getDimensions", &Kernel::getDimensions);
     clsKernel.def("setDimensions", &Kernel::setDimensions);
     clsKernel.def("setWidth", &Kernel::setWidth);
@@ -72,6 +79,7 @@ PYBIND11_MODULE(kernel, mod) {
     clsKernel.def("setSpatialParameters", &Kernel::setSpatialParameters);
     clsKernel.def("computeKernelParametersFromSpatialModel",
                   &Kernel::computeKernelParametersFromSpatialModel);
+    clsKernel.def("computeKernelParameters", &Kernel::computeKernelParameters, "x"_a, "y"_a);
     clsKernel.def("toString", &Kernel::toString, "prefix"_a = "");
     clsKernel.def("computeCache", &Kernel::computeCache);
     clsKernel.def("getCacheSize", &Kernel::getCacheSize);
@@ -102,8 +110,16 @@ PYBIND11_MODULE(kernel, mod) {
                           "width"_a, "height"_a, "kernelFunction"_a, "spatialFunctionList"_a);
     clsAnalyticKernel.def("clone", &AnalyticKernel::clone);
     clsAnalyticKernel.def("resized", &AnalyticKernel::resized, "width"_a, "height"_a);
-    clsAnalyticKernel.def("computeImage", &AnalyticKernel::computeImage, "image"_a, "doNormalize"_a,
-                          "x"_a = 0.0, "y"_a = 0.0);
+    clsAnalyticKernel.def("computeImage",
+                          (double (AnalyticKernel::*)(lsst::afw::image::Image<Kernel::Pixel> &, bool, double,
+                                                      double) const) &
+                                  AnalyticKernel::computeImage,
+                          "image"_a, "doNormalize"_a, "x"_a = 0.0, "y"_a = 0.0);
+    clsAnalyticKernel.def("computeImage",
+                          (double (AnalyticKernel::*)(lsst::afw::image::Image<Kernel::Pixel> &, bool,
+                                                      std::vector<double> const &) const) &
+                                  AnalyticKernel::computeImage,
+                          "image"_a, "doNormalize"_a, "kernelParams"_a);
     clsAnalyticKernel.def("getKernelParameters", &AnalyticKernel::getKernelParameters);
     clsAnalyticKernel.def("getKernelFunction", &AnalyticKernel::getKernelFunction);
     clsAnalyticKernel.def("toString", &AnalyticKernel::toString, "prefix"_a = "");
@@ -162,7 +178,15 @@ PYBIND11_MODULE(kernel, mod) {
                            "spatialFunctionList"_a);
     clsSeparableKernel.def("clone", &SeparableKernel::clone);
     clsSeparableKernel.def("resized", &SeparableKernel::resized, "width"_a, "height"_a);
-    clsSeparableKernel.def("computeVectors", &SeparableKernel::computeVectors);
+    typedef std::vector<Kernel::Pixel> PixelVector;
+    clsSeparableKernel.def(
+            "computeVectors",
+            (double (SeparableKernel::*)(PixelVector &, PixelVector &, bool, double, double) const) &
+                    SeparableKernel::computeVectors);
+    clsSeparableKernel.def("computeVectors",
+                           (double (SeparableKernel::*)(PixelVector &, PixelVector &, bool,
+                                                        std::vector<double> const &) const) &
+                                   SeparableKernel::computeVectors);
     clsSeparableKernel.def("getKernelParameter", &SeparableKernel::getKernelParameter);
     clsSeparableKernel.def("getKernelParameters", &SeparableKernel::getKernelParameters);
     clsSeparableKernel.def("getKernelColFunction", &SeparableKernel::getKernelColFunction);
@@ -50,6 +50,7 @@ static void declareRotateImageBy90(py::module& mod) {
 template <typename ImageT>
 static void declareFlipImage(py::module& mod) {
     mod.def("flipImage", flipImage<ImageT>, "inImage"_a, "flipLR"_a, "flipTB"_a);
+    mod.def("flipImageInPlace", flipImageInPlace<ImageT>, "image"_a, "flipLR"_a, "flipTB"_a);
 }
 
 template <typename ImageT>
@@ -60,6 +61,10 @@ static void declareBinImage(py::module& mod) {
     mod.def("binImage", (std::shared_ptr<ImageT>(*)(ImageT const&, int const,
                                                     lsst::afw::math::Property const))binImage<ImageT>,
             "inImage"_a, "binsize"_a, "flags"_a = lsst::afw::math::MEAN);
+    mod.def("binImage",
+            (std::shared_ptr<ImageT>(*)(ImageT const&, int const, int const, lsst::afw::math::Property const,
+                                        lsst::afw::math::StatisticsControl const&, bool))binImage<ImageT>,
+            "inImage"_a, "binX"_a, "binY"_a, "flags"_a, "sctrl"_a, "keepPartialBins"_a = false);
 }
 }  // namespace
 
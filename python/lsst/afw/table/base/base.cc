@@ -38,6 +38,7 @@ and makes wrapping Base catalogs more similar to all other types of catalog.
 #include "lsst/afw/table/BaseColumnView.h"
 #include "lsst/afw/table/BaseRecord.h"
 #include "lsst/afw/table/BaseTable.h"
+#include "lsst/afw/table/io/Arrow.h"
 #include "lsst/afw/table/python/catalog.h"
 #include "lsst/afw/table/python/columnView.h"
 
@@ -159,6 +160,10 @@ PyBaseTable declareBaseTable(py::module &mod) {
     cls.def("getSchema", &BaseTable::getSchema);
     cls.def_property_readonly("schema", &BaseTable::getSchema);
     cls.def("getBufferSize", &BaseTable::getBufferSize);
+    cls.def("getBlockSize", &BaseTable::getBlockSize);
+    cls.def("setBlockSize", &BaseTable::setBlockSize, "nRecords"_a);
+    cls.def("getBlockGrowthFactor", &BaseTable::getBlockGrowthFactor);
+    cls.def("setBlockGrowthFactor", &BaseTable::setBlockGrowthFactor, "factor"_a);
     cls.def("clone", &BaseTable::clone);
     cls.def("preallocate", &BaseTable::preallocate);
 
@@ -183,6 +188,13 @@ PYBIND11_MODULE(base, mod) {
     clsBaseCatalog.attr("Record") = clsBaseRecord;
     clsBaseCatalog.attr("Table") = clsBaseTable;
     clsBaseCatalog.attr("ColumnView") = clsBaseColumnView;
+
+    mod.def("importArrow",
+            [](std::uintptr_t schemaAddress, std::uintptr_t arrayAddress) {
+                return io::importArrow(reinterpret_cast<ArrowSchema *>(schemaAddress),
+                                       reinterpret_cast<ArrowArray *>(arrayAddress));
+            },
+            "schemaAddress"_a, "arrayAddress"_a);
 }
 }
 }
@@ -0,0 +1,63 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+#include "lsst/afw/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace detail {
+
+namespace {
+
+int hardwareThreads() {
+    int const num = std::thread::hardware_concurrency();
+    return num > 0 ? num : 1;
+}
+
+int initialNumThreads() {
+    char const *env = std::getenv("AFW_NUM_THREADS");
+    if (!env) {
+        return 1;
+    }
+    int const num = std::atoi(env);
+    return num > 0 ? num : hardwareThreads();
+}
+
+std::atomic<int> &defaultNumThreads() {
+    static std::atomic<int> num(initialNumThreads());
+    return num;
+}
+
+}  // anonymous namespace
+
+int getDefaultNumThreads() { return defaultNumThreads().load(); }
+
+void setDefaultNumThreads(int nThreads) {
+    defaultNumThreads().store(nThreads > 0 ? nThreads : hardwareThreads());
+}
+
+}  // namespace detail
+}  // namespace afw
+}  // namespace lsst
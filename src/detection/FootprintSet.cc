@@ -40,14 +40,18 @@
        cout << "Found " << sources.getFootprints()->size() << " sources" << std::endl;
  */
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <algorithm>
 #include <cassert>
 #include <set>
 #include <string>
 #include <typeinfo>
+#include <vector>
 #include "boost/format.hpp"
 #include "lsst/pex/exceptions.h"
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Statistics.h"
 #include "lsst/afw/detection/Peak.h"
@@ -465,45 +469,150 @@ int resolve_alias(std::vector<int> const &aliases, /* list of aliases */
 
     return (resolved);
 }
+/*
+ * Visit the Spans of a list of Footprints a band of rows at a time.
+ *
+ * The Footprints are sorted by the lowest row of their bounding boxes, so each band only looks at
+ * the Footprints that overlap it, and only at their Spans that lie in the band.  Bands must be
+ * visited in order of increasing y.
+ */
+class SpanSweep {
+public:
+    explicit SpanSweep(FootprintSet::FootprintList const &footprints) : _footprints(footprints), _next(0) {
+        _bboxes.reserve(footprints.size());
+        _sorted.reserve(footprints.size());
+        for (std::size_t i = 0; i < footprints.size(); ++i) {
+            // SpanSets constructed without normalization need not be sorted, so don't trust their bboxes
+            lsst::geom::Box2I bbox;
+            bool sorted = true;
+            int lastY = std::numeric_limits<int>::min();
+            for (geom::Span const &span : *footprints[i]->getSpans()) {
+                bbox.include(lsst::geom::Box2I(span.getMin(), span.getMax()));
+                sorted = sorted && span.getY() >= lastY;
+                lastY = span.getY();
+            }
+            _bboxes.push_back(bbox);
+            _sorted.push_back(sorted);
+            if (!bbox.isEmpty()) {
+                _order.push_back(i);
+            }
+        }
+        std::stable_sort(_order.begin(), _order.end(), [this](std::size_t a, std::size_t b) {
+            return _bboxes[a].getMinY() < _bboxes[b].getMinY();
+        });
+    }
+
+    // Throw if any Footprint extends beyond bbox
+    void checkContained(lsst::geom::Box2I const &bbox) const {
+        for (std::size_t i : _order) {
+            if (!bbox.contains(_bboxes[i])) {
+                throw LSST_EXCEPT(pex::exceptions::OutOfRangeError,
+                                  "SpanSet bounding box lands outside array");
+            }
+        }
+    }
+
+    // Call function(index, span) for every Span in rows [y0, y1), Footprint by Footprint in list order
+    template <typename Function>
+    void visitRows(int y0, int y1, Function const &function) {
+        while (_next < _order.size() && _bboxes[_order[_next]].getMinY() < y1) {
+            _active.push_back(_order[_next++]);
+        }
+        _active.erase(std::remove_if(_active.begin(), _active.end(),
+                                     [this, y0](std::size_t i) { return _bboxes[i].getMaxY() < y0; }),
+                      _active.end());
+        std::sort(_active.begin(), _active.end());
+        for (std::size_t i : _active) {
+            geom::SpanSet const &spans = *_footprints[i]->getSpans();
+            auto span = spans.begin();
+            if (_sorted[i]) {
+                span = std::lower_bound(spans.begin(), spans.end(), y0,
+                                        [](geom::Span const &s, int y) { return s.getY() < y; });
+            }
+            for (; span != spans.end() && (!_sorted[i] || span->getY() < y1); ++span) {
+                if (span->getY() >= y0 && span->getY() < y1) {
+                    function(i, *span);
+                }
+            }
+        }
+    }
+
+private:
+    FootprintSet::FootprintList const &_footprints;
+    std::vector<lsst::geom::Box2I> _bboxes;
+    std::vector<bool> _sorted;
+    std::vector<std::size_t> _order;   // indices of non-empty Footprints, by lowest row
+    std::vector<std::size_t> _active;  // indices of Footprints that may overlap the current band
+    std::size_t _next;                 // position in _order of the next Footprint to become active
+};
 /// @endcond
 }  // namespace
 
 namespace {
+/*
+ * Set isPeak[i] for the n pixels starting at row[0], comparing each with its eight neighbours in
+ * below, row and above (which must all be valid from index -1 to n); a pixel is a peak unless one of
+ * its neighbours is better.
+ *
+ * The comparisons are combined without short-circuiting, so the loop has no branches and can be
+ * vectorized.
+ */
+template <typename PixelT, typename Better>
+void markPeaks(PixelT const *below, PixelT const *row, PixelT const *above, int n, Better better,
+               unsigned char *isPeak) {
+    for (int i = 0; i < n; ++i) {
+        PixelT const val = row[i];
+        isPeak[i] = !(better(above[i - 1], val) | better(above[i], val) | better(above[i + 1], val) |
+                      better(row[i - 1], val) | better(row[i + 1], val) | better(below[i - 1], val) |
+                      better(below[i], val) | better(below[i + 1], val));
+    }
+}
+
+/*
+ * Add a peak to foot for every pixel in it that is at least margin pixels from the edge of image and
+ * that no neighbour exceeds (or, if !polarity, is less than).  The margin must be at least 1.
+ */
 template <typename ImageT>
 void findPeaksInFootprint(ImageT const &image, bool polarity, PeakCatalog &peaks, Footprint &foot,
-                          std::size_t const margin = 0) {
+                          std::size_t const margin = 1) {
     auto spanSet = foot.getSpans();
     if (spanSet->size() == 0) {
         return;
     }
-    auto bbox = image.getBBox();
-    for (auto const &spanIter : *spanSet) {
-        auto y = spanIter.getY() - image.getY0();
-        if (static_cast<std::size_t>(y + image.getY0()) < bbox.getMinY() + margin ||
-            static_cast<std::size_t>(y + image.getY0()) > bbox.getMaxY() - margin) {
+    using PixelT = typename ImageT::Pixel;
+    auto const array = image.getArray();
+    int const x0 = image.getX0();
+    int const y0 = image.getY0();
+    // Range of local pixel indices that are far enough from the edges.
+    int const minX = static_cast<int>(margin);
+    int const maxX = image.getWidth() - 1 - minX;
+    int const minY = static_cast<int>(margin);
+    int const maxY = image.getHeight() - 1 - minY;
+    std::vector<unsigned char> isPeak;
+    for (auto const &span : *spanSet) {
+        int const y = span.getY() - y0;
+        if (y < minY || y > maxY) {
             continue;
         }
-        for (auto x = spanIter.getMinX() - image.getX0(); x <= spanIter.getMaxX() - image.getX0(); ++x) {
-            if (static_cast<std::size_t>(x + image.getX0()) < (bbox.getMinX() + margin) ||
-                static_cast<std::size_t>(x + image.getX0()) > (bbox.getMaxX() - margin)) {
-                continue;
-            }
-            auto val = image(x, y);
-            if (polarity) {  // look for +ve peaks
-                if (image(x - 1, y + 1) > val || image(x, y + 1) > val || image(x + 1, y + 1) > val ||
-                    image(x - 1, y) > val || image(x + 1, y) > val || image(x - 1, y - 1) > val ||
-                    image(x, y - 1) > val || image(x + 1, y - 1) > val) {
-                    continue;
-                }
-            } else {  // look for -ve "peaks" (pits)
-                if (image(x - 1, y + 1) < val || image(x, y + 1) < val || image(x + 1, y + 1) < val ||
-                    image(x - 1, y) < val || image(x + 1, y) < val || image(x - 1, y - 1) < val ||
-                    image(x, y - 1) < val || image(x + 1, y - 1) < val) {
-                    continue;
-                }
+        int const begin = std::max(span.getMinX() - x0, minX);
+        int const end = std::min(span.getMaxX() - x0, maxX) + 1;
+        if (begin >= end) {
+            continue;
+        }
+        int const n = end - begin;
+        isPeak.resize(n);
+        PixelT const *below = array[y - 1].getData() + begin;
+        PixelT const *row = array[y].getData() + begin;
+        PixelT const *above = array[y + 1].getData() + begin;
+        if (polarity) {  // look for +ve peaks
+            markPeaks(below, row, above, n, std::greater<PixelT>(), isPeak.data());
+        } else {  // look for -ve "peaks" (pits)
+            markPeaks(below, row, above, n, std::less<PixelT>(), isPeak.data());
+        }
+        for (int i = 0; i < n; ++i) {
+            if (isPeak[i]) {
+                foot.addPeak(begin + i + x0, y + y0, row[i]);
             }
-
-            foot.addPeak(x + image.getX0(), y + image.getY0(), val);
         }
     }
 }
@@ -943,6 +1052,61 @@ std::shared_ptr<image::Image<FootprintIdPixel>> FootprintSet::insertIntoImage(bo
     return im;
 }
 
+void FootprintSet::insertIntoImageBands(
+        std::function<void(image::Image<FootprintIdPixel> const &)> const &function, int bandHeight,
+        bool relativeIDs) const {
+    if (bandHeight <= 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Band height %d is not positive") % bandHeight).str());
+    }
+    SpanSweep sweep(*_footprints);
+    sweep.checkContained(_region);
+    if (_region.isEmpty()) {
+        return;
+    }
+    int const x0 = _region.getMinX();
+    int const bufferHeight = std::min(bandHeight, _region.getHeight());
+    image::Image<FootprintIdPixel> buffer(
+            lsst::geom::Box2I(_region.getMin(), lsst::geom::Extent2I(_region.getWidth(), bufferHeight)));
+    for (int y0 = _region.getMinY(); y0 <= _region.getMaxY(); y0 += bandHeight) {
+        int const y1 = std::min(y0 + bandHeight, _region.getMaxY() + 1);
+        image::Image<FootprintIdPixel> band(
+                buffer, lsst::geom::Box2I(buffer.getXY0(), lsst::geom::Extent2I(_region.getWidth(), y1 - y0)),
+                image::PARENT, false);
+        band = 0;
+        band.setXY0(x0, y0);
+        auto array = band.getArray();
+        sweep.visitRows(y0, y1, [&](std::size_t i, geom::Span const &span) {
+            FootprintIdPixel const id = relativeIDs ? i + 1 : (*_footprints)[i]->getId();
+            FootprintIdPixel *row = array[span.getY() - y0].getData() + (span.getMinX() - x0);
+            for (int x = 0; x < span.getWidth(); ++x) {
+                row[x] += id;
+            }
+        });
+        function(band);
+    }
+}
+
+template <typename MaskPixelT>
+void FootprintSet::setMask(image::Mask<MaskPixelT> *mask, std::string const &planeName) {
+    MaskPixelT const bitmask = image::Mask<MaskPixelT>::getPlaneBitMask(planeName);
+    SpanSweep sweep(*_footprints);
+    lsst::geom::Box2I const bbox = mask->getBBox();
+    sweep.checkContained(bbox);
+    // Sweeping the Footprints through the mask a few rows at a time keeps the writes local
+    int const bandHeight = 64;
+    auto array = mask->getArray();
+    for (int y0 = bbox.getMinY(); y0 <= bbox.getMaxY(); y0 += bandHeight) {
+        sweep.visitRows(y0, y0 + bandHeight, [&](std::size_t, geom::Span const &span) {
+            MaskPixelT *row =
+                    array[span.getY() - bbox.getMinY()].getData() + (span.getMinX() - bbox.getMinX());
+            for (int x = 0; x < span.getWidth(); ++x) {
+                row[x] |= bitmask;
+            }
+        });
+    }
+}
+
 template <typename ImagePixelT, typename MaskPixelT>
 void FootprintSet::makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const &mimg,
                              HeavyFootprintCtrl const *ctrl) {
@@ -952,8 +1116,58 @@ void FootprintSet::makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const &
         ctrl = &ctrl_s;
     }
 
-    for (FootprintList::iterator ptr = _footprints->begin(), end = _footprints->end(); ptr != end; ++ptr) {
-        ptr->reset(new HeavyFootprint<ImagePixelT, MaskPixelT>(**ptr, mimg, ctrl));
+    lsst::geom::Point2I const xy0 = mimg.getXY0();
+    std::size_t const nFootprints = _footprints->size();
+    // Size every HeavyFootprint's arrays first, so one allocation per plane holds them all
+    std::vector<std::size_t> offsets(nFootprints + 1, 0);
+    for (std::size_t i = 0; i < nFootprints; ++i) {
+        Footprint const &foot = *(*_footprints)[i];
+        if (!mimg.getBBox().contains(foot.getBBox())) {
+            throw LSST_EXCEPT(pex::exceptions::OutOfRangeError, "SpanSet bounding box lands outside array");
+        }
+        offsets[i + 1] = offsets[i] + foot.getArea();
+    }
+    ndarray::Array<ImagePixelT, 1, 1> images = ndarray::allocate(offsets[nFootprints]);
+    ndarray::Array<MaskPixelT, 1, 1> masks = ndarray::allocate(offsets[nFootprints]);
+    ndarray::Array<image::VariancePixel, 1, 1> variances = ndarray::allocate(offsets[nFootprints]);
+
+    auto imageArray = mimg.getImage()->getArray();
+    auto maskArray = mimg.getMask()->getArray();
+    auto varianceArray = mimg.getVariance()->getArray();
+    bool const modify = (ctrl->getModifySource() == HeavyFootprintCtrl::SET);
+    ImagePixelT const ival = ctrl->getImageVal();
+    MaskPixelT const mval = ctrl->getMaskVal();
+    image::VariancePixel const vval = ctrl->getVarianceVal();
+    auto extract = [&](std::size_t i) {
+        std::size_t offset = offsets[i];
+        for (geom::Span const &span : *(*_footprints)[i]->getSpans()) {
+            int const y = span.getY() - xy0.getY();
+            int const x = span.getMinX() - xy0.getX();
+            int const width = span.getWidth();
+            ImagePixelT *imagePtr = imageArray[y].getData() + x;
+            MaskPixelT *maskPtr = maskArray[y].getData() + x;
+            image::VariancePixel *variancePtr = varianceArray[y].getData() + x;
+            std::copy(imagePtr, imagePtr + width, images.getData() + offset);
+            std::copy(maskPtr, maskPtr + width, masks.getData() + offset);
+            std::copy(variancePtr, variancePtr + width, variances.getData() + offset);
+            if (modify) {
+                std::fill(imagePtr, imagePtr + width, ival);
+                for (int j = 0; j < width; ++j) {
+                    maskPtr[j] &= ~mval;
+                }
+                std::fill(variancePtr, variancePtr + width, vval);
+            }
+            offset += width;
+        }
+    };
+    // Resetting the source pixels makes the result depend on the order in which overlapping
+    // Footprints are visited, so only plain copies are made concurrently.
+    lsst::afw::detail::parallelFor(0, nFootprints, extract, modify ? 1 : 0);
+
+    for (std::size_t i = 0; i < nFootprints; ++i) {
+        auto const view = ndarray::view(offsets[i], offsets[i + 1]);
+        (*_footprints)[i] = std::make_shared<HeavyFootprint<ImagePixelT, MaskPixelT>>(
+                *(*_footprints)[i], images[view], masks[view], variances[view]);
     }
 }
 
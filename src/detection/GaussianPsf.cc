@@ -21,11 +21,14 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <cmath>
 #include <memory>
 
+#include "Eigen/Core"
 #include "ndarray/eigen.h"
 
 #include "lsst/afw/detection/GaussianPsf.h"
+#include "lsst/afw/image/ImageUtils.h"
 #include "lsst/afw/table/io/InputArchive.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"
@@ -96,6 +99,28 @@ void checkDimensions(lsst::geom::Extent2I const& dimensions) {
     }
 }
 
+// Return a unit-sum 1-d Gaussian profile sampled at pixels [begin, begin + size), centered on `center`.
+Eigen::VectorXd makeProfile(int begin, int size, double center, double sigma) {
+    Eigen::VectorXd profile(size);
+    double const factor = -0.5 / (sigma * sigma);
+    for (int i = 0; i < size; ++i) {
+        double const d = begin + i - center;
+        profile[i] = std::exp(factor * d * d);
+    }
+    profile /= profile.sum();
+    return profile;
+}
+
+// Fill an image with a unit-sum Gaussian centered on `center` (in its parent coordinates).  A
+// circular Gaussian is separable, so this is the outer product of 1-d profiles in y and x, which needs
+// only width + height exponentials; normalizing the profiles normalizes their product.
+void fillGaussian(image::Image<double>& out, lsst::geom::Point2D const& center, double sigma) {
+    Eigen::VectorXd const xProfile = makeProfile(out.getX0(), out.getWidth(), center.getX(), sigma);
+    Eigen::VectorXd const yProfile = makeProfile(out.getY0(), out.getHeight(), center.getY(), sigma);
+    image::Image<double>::Array array = out.getArray();
+    ndarray::asEigenMatrix(array) = yProfile * xProfile.transpose();
+}
+
 }  // namespace
 
 GaussianPsf::GaussianPsf(int width, int height, double sigma)
@@ -134,19 +159,23 @@ void GaussianPsf::write(OutputArchiveHandle& handle) const {
     handle.saveCatalog(catalog);
 }
 
+std::shared_ptr<GaussianPsf::Image> GaussianPsf::doComputeImage(lsst::geom::Point2D const& position,
+                                                                image::Color const&) const {
+    // Use the same bounding box as Psf::recenterKernelImage: the kernel image's, shifted by the pixel
+    // index nearest to the position.
+    lsst::geom::Box2I bbox = computeBBox();
+    bbox.shift(lsst::geom::Extent2I(image::positionToIndex(position.getX(), true).first,
+                                    image::positionToIndex(position.getY(), true).first));
+    auto result = std::make_shared<Image>(bbox);
+    fillGaussian(*result, position, _sigma);
+    return result;
+}
+
 std::shared_ptr<GaussianPsf::Image> GaussianPsf::doComputeKernelImage(lsst::geom::Point2D const&,
                                                                       image::Color const&) const {
-    std::shared_ptr<Image> r(new Image(computeBBox()));
-    Image::Array array = r->getArray();
-    double sum = 0.0;
-    for (int yIndex = 0, y = r->getY0(); yIndex < _dimensions.getY(); ++yIndex, ++y) {
-        Image::Array::Reference row = array[yIndex];
-        for (int xIndex = 0, x = r->getX0(); xIndex < _dimensions.getX(); ++xIndex, ++x) {
-            sum += row[xIndex] = std::exp(-0.5 * (x * x + y * y) / (_sigma * _sigma));
-        }
-    }
-    ndarray::asEigenMatrix(array) /= sum;
-    return r;
+    auto result = std::make_shared<Image>(computeBBox());
+    fillGaussian(*result, lsst::geom::Point2D(0.0, 0.0), _sigma);
+    return result;
 }
 
 double GaussianPsf::doComputeApertureFlux(double radius, lsst::geom::Point2D const& position,
@@ -115,6 +115,20 @@ HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::HeavyFootprint(Footprin
           _mask(ndarray::allocate(ndarray::makeVector(foot.getArea()))),
           _variance(ndarray::allocate(ndarray::makeVector(foot.getArea()))) {}
 
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::HeavyFootprint(
+        Footprint const& foot, ndarray::Array<ImagePixelT, 1, 1> const& image,
+        ndarray::Array<MaskPixelT, 1, 1> const& mask, ndarray::Array<VariancePixelT, 1, 1> const& variance)
+        : Footprint(foot), _image(image), _mask(mask), _variance(variance) {
+    std::size_t const area = foot.getArea();
+    if (_image.getSize<0>() != area || _mask.getSize<0>() != area || _variance.getSize<0>() != area) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Arrays have sizes %d, %d, %d; Footprint has area %d") %
+                           _image.getSize<0>() % _mask.getSize<0>() % _variance.getSize<0>() % area)
+                                  .str());
+    }
+}
+
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 void HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::insert(
         image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& mimage) const {
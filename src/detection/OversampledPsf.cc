@@ -0,0 +1,317 @@
+// -*- LSST-C++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "ndarray/eigen.h"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/detection/OversampledPsf.h"
+#include "lsst/afw/image/ImageUtils.h"
+#include "lsst/afw/table/io/InputArchive.h"
+#include "lsst/afw/table/io/OutputArchive.h"
+#include "lsst/afw/table/io/CatalogVector.h"
+#include "lsst/afw/table/aggregates.h"
+#include "lsst/afw/table/io/Persistable.cc"
+
+namespace lsst {
+namespace afw {
+
+template std::shared_ptr<detection::OversampledPsf> table::io::PersistableFacade<
+        detection::OversampledPsf>::dynamicCast(std::shared_ptr<table::io::Persistable> const&);
+
+namespace detection {
+
+namespace {
+
+// Number of zero samples added on each side of the oversampled images, so the four-tap filter
+// never needs bounds checks.
+int const PADDING = 2;
+
+// Catmull-Rom weights for the samples at offsets -1, 0, 1, 2 from a point a fraction t past
+// offset 0.
+void computeCubicWeights(double t, double weights[4]) {
+    double const t2 = t * t;
+    double const t3 = t2 * t;
+    weights[0] = 0.5 * (-t3 + 2.0 * t2 - t);
+    weights[1] = 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0);
+    weights[2] = 0.5 * (-3.0 * t3 + 4.0 * t2 + t);
+    weights[3] = 0.5 * (t3 - t2);
+}
+
+// Sub-pixel offset of phase a, in [-0.5, 0.5), matching the residuals of image::positionToIndex.
+double getPhaseOffset(int a, int oversampling) { return -0.5 + static_cast<double>(a) / oversampling; }
+
+struct OversampledPsfPersistenceHelper {
+    afw::table::Schema schema;
+    afw::table::Key<int> psf;
+    afw::table::Box2IKey bbox;
+    afw::table::Key<int> cellSize;
+    afw::table::Key<int> oversampling;
+
+    static OversampledPsfPersistenceHelper const& get() {
+        static OversampledPsfPersistenceHelper const instance;
+        return instance;
+    }
+
+    OversampledPsfPersistenceHelper(OversampledPsfPersistenceHelper const&) = delete;
+    OversampledPsfPersistenceHelper& operator=(OversampledPsfPersistenceHelper const&) = delete;
+    OversampledPsfPersistenceHelper(OversampledPsfPersistenceHelper&&) = delete;
+    OversampledPsfPersistenceHelper& operator=(OversampledPsfPersistenceHelper&&) = delete;
+
+private:
+    OversampledPsfPersistenceHelper()
+            : schema(),
+              psf(schema.addField<int>("psf", "archive ID of the wrapped Psf")),
+              bbox(afw::table::Box2IKey::addFields(schema, "bbox", "region divided into cells", "pixel")),
+              cellSize(schema.addField<int>("cellSize", "width and height of each cell", "pixel")),
+              oversampling(schema.addField<int>("oversampling", "samples per pixel in each dimension")) {
+        schema.getCitizen().markPersistent();
+    }
+};
+
+class OversampledPsfFactory : public afw::table::io::PersistableFactory {
+public:
+    std::shared_ptr<afw::table::io::Persistable> read(InputArchive const& archive,
+                                                      CatalogVector const& catalogs) const override {
+        static OversampledPsfPersistenceHelper const& keys = OversampledPsfPersistenceHelper::get();
+        LSST_ARCHIVE_ASSERT(catalogs.size() == 1u);
+        LSST_ARCHIVE_ASSERT(catalogs.front().size() == 1u);
+        afw::table::BaseRecord const& record = catalogs.front().front();
+        LSST_ARCHIVE_ASSERT(record.getSchema() == keys.schema);
+        return std::make_shared<OversampledPsf>(archive.get<Psf>(record.get(keys.psf)),
+                                                record.get(keys.bbox), record.get(keys.cellSize),
+                                                record.get(keys.oversampling));
+    }
+
+    OversampledPsfFactory(std::string const& name) : afw::table::io::PersistableFactory(name) {}
+};
+
+OversampledPsfFactory registration("OversampledPsf");
+
+}  // namespace
+
+// The wrapped Psf sampled on a grid `oversampling` times finer than the pixels, about the integer
+// point nearest the center of a cell.
+struct OversampledPsf::Cell {
+    // Bounding box of the wrapped Psf's images, relative to the integer part of their position
+    lsst::geom::Box2I kernelBBox;
+    // Number of samples in each row, including padding
+    int stride;
+    // Row-major samples, with PADDING zeros on each side; sample PADDING + l in each dimension is
+    // the Psf at an offset of kernelBBox.getMin() + 0.5 + (l + 1 - oversampling) / oversampling
+    // pixels from its center.
+    std::vector<double> samples;
+};
+
+OversampledPsf::OversampledPsf(std::shared_ptr<Psf const> psf, lsst::geom::Box2I const& bbox, int cellSize,
+                               int oversampling)
+        : Psf(false), _psf(std::move(psf)), _bbox(bbox), _cellSize(cellSize), _oversampling(oversampling) {
+    if (!_psf) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Psf must not be null");
+    }
+    if (_bbox.isEmpty()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Bounding box must not be empty");
+    }
+    if (_cellSize <= 0 || _oversampling <= 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Cell size and oversampling factor must be positive");
+    }
+    _nCellsX = (_bbox.getWidth() + _cellSize - 1) / _cellSize;
+    _nCellsY = (_bbox.getHeight() + _cellSize - 1) / _cellSize;
+    _cells.resize(static_cast<std::size_t>(_nCellsX) * _nCellsY);
+}
+
+OversampledPsf::OversampledPsf(OversampledPsf const& other)
+        : Psf(other),
+          _psf(other._psf),
+          _bbox(other._bbox),
+          _cellSize(other._cellSize),
+          _oversampling(other._oversampling),
+          _nCellsX(other._nCellsX),
+          _nCellsY(other._nCellsY) {
+    // Cells are immutable once computed, so they can be shared.
+    std::lock_guard<std::mutex> lock(other._mutex);
+    _cells = other._cells;
+}
+
+OversampledPsf::~OversampledPsf() = default;
+
+std::shared_ptr<Psf> OversampledPsf::clone() const {
+    return std::make_shared<OversampledPsf>(_psf->clone(), _bbox, _cellSize, _oversampling);
+}
+
+std::shared_ptr<Psf> OversampledPsf::resized(int width, int height) const {
+    return std::make_shared<OversampledPsf>(_psf->resized(width, height), _bbox, _cellSize, _oversampling);
+}
+
+std::shared_ptr<OversampledPsf::Cell const> OversampledPsf::_getCell(
+        lsst::geom::Point2D const& position) const {
+    auto cellIndex = [this](double x, int min, int n) {
+        double const i = std::floor((std::floor(x + 0.5) - min) / _cellSize);
+        return static_cast<int>(std::min(std::max(i, 0.0), n - 1.0));
+    };
+    int const i = cellIndex(position.getX(), _bbox.getMinX(), _nCellsX);
+    int const j = cellIndex(position.getY(), _bbox.getMinY(), _nCellsY);
+    std::size_t const index = static_cast<std::size_t>(j) * _nCellsX + i;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cells[index]) {
+            return _cells[index];
+        }
+    }
+    // Compute without holding the lock, so other cells can be used meanwhile; if another thread
+    // computes the same cell first, keep its result.
+    std::shared_ptr<Cell const> cell = _makeCell(i, j);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_cells[index]) {
+        _cells[index] = cell;
+    }
+    return _cells[index];
+}
+
+std::shared_ptr<OversampledPsf::Cell const> OversampledPsf::_makeCell(int i, int j) const {
+    int const x0 = _bbox.getMinX() + i * _cellSize;
+    int const y0 = _bbox.getMinY() + j * _cellSize;
+    int const x1 = std::min(x0 + _cellSize - 1, _bbox.getMaxX());
+    int const y1 = std::min(y0 + _cellSize - 1, _bbox.getMaxY());
+    lsst::geom::Extent2I const center((x0 + x1) / 2, (y0 + y1) / 2);
+    int const n = _oversampling;
+
+    auto cell = std::make_shared<Cell>();
+    for (int b = 0; b < n; ++b) {
+        for (int a = 0; a < n; ++a) {
+            lsst::geom::Point2D const position(center.getX() + getPhaseOffset(a, n),
+                                               center.getY() + getPhaseOffset(b, n));
+            std::shared_ptr<Image const> phaseImage =
+                    _psf->computeImage(position, image::Color(), INTERNAL);
+            lsst::geom::Box2I const kernelBBox(phaseImage->getBBox().getMin() - center,
+                                               phaseImage->getDimensions());
+            if (a == 0 && b == 0) {
+                cell->kernelBBox = kernelBBox;
+                cell->stride = n * kernelBBox.getWidth() + 2 * PADDING;
+                std::size_t const nRows = n * kernelBBox.getHeight() + 2 * PADDING;
+                cell->samples.assign(nRows * cell->stride, 0.0);
+            } else if (kernelBBox != cell->kernelBBox) {
+                throw LSST_EXCEPT(pex::exceptions::LogicError,
+                                  "Psf image bounding box varies with sub-pixel position");
+            }
+            // Larger offsets of the image correspond to smaller offsets within each pixel's samples.
+            for (int v = 0; v < phaseImage->getHeight(); ++v) {
+                double* row = cell->samples.data() + (n * v + n - 1 - b + PADDING) * cell->stride;
+                for (int u = 0; u < phaseImage->getWidth(); ++u) {
+                    row[n * u + n - 1 - a + PADDING] = (*phaseImage)(u, v);
+                }
+            }
+        }
+    }
+    return cell;
+}
+
+std::shared_ptr<OversampledPsf::Image> OversampledPsf::doComputeImage(lsst::geom::Point2D const& position,
+                                                                      image::Color const& color) const {
+    if (!color.isIndeterminate()) {
+        return _psf->computeImage(position, color);
+    }
+    std::shared_ptr<Cell const> cell = _getCell(position);
+    int const n = _oversampling;
+    std::pair<int, double> const irX = image::positionToIndex(position.getX(), true);
+    std::pair<int, double> const irY = image::positionToIndex(position.getY(), true);
+
+    // The sample grid index of pixel u, relative to its first sample, is n*u + g; g is the same for
+    // every pixel, so so are the filter weights.
+    double const gx = n * (0.5 - irX.second) - 1.0;
+    double const gy = n * (0.5 - irY.second) - 1.0;
+    int const kx = static_cast<int>(std::floor(gx));
+    int const ky = static_cast<int>(std::floor(gy));
+    double wx[4], wy[4];
+    computeCubicWeights(gx - kx, wx);
+    computeCubicWeights(gy - ky, wy);
+
+    lsst::geom::Box2I const bbox(cell->kernelBBox.getMin() + lsst::geom::Extent2I(irX.first, irY.first),
+                                 cell->kernelBBox.getDimensions());
+    auto result = std::make_shared<Image>(bbox);
+    Image::Array array = result->getArray();
+    double sum = 0.0;
+    for (int v = 0; v < bbox.getHeight(); ++v) {
+        double const* rows[4];
+        for (int k = 0; k < 4; ++k) {
+            rows[k] = cell->samples.data() + (n * v + ky + k - 1 + PADDING) * cell->stride + kx - 1 + PADDING;
+        }
+        Image::Array::Reference out = array[v];
+        for (int u = 0; u < bbox.getWidth(); ++u) {
+            int const offset = n * u;
+            double value = 0.0;
+            for (int k = 0; k < 4; ++k) {
+                double const* p = rows[k] + offset;
+                value += wy[k] * (wx[0] * p[0] + wx[1] * p[1] + wx[2] * p[2] + wx[3] * p[3]);
+            }
+            out[u] = value;
+            sum += value;
+        }
+    }
+    if (sum != 0.0) {
+        ndarray::asEigenMatrix(array) /= sum;
+    }
+    return result;
+}
+
+std::shared_ptr<OversampledPsf::Image> OversampledPsf::doComputeKernelImage(
+        lsst::geom::Point2D const& position, image::Color const& color) const {
+    return _psf->computeKernelImage(position, color);
+}
+
+double OversampledPsf::doComputeApertureFlux(double radius, lsst::geom::Point2D const& position,
+                                             image::Color const& color) const {
+    return _psf->computeApertureFlux(radius, position, color);
+}
+
+geom::ellipses::Quadrupole OversampledPsf::doComputeShape(lsst::geom::Point2D const& position,
+                                                          image::Color const& color) const {
+    return _psf->computeShape(position, color);
+}
+
+lsst::geom::Box2I OversampledPsf::doComputeBBox(lsst::geom::Point2D const& position,
+                                                image::Color const& color) const {
+    return _psf->computeBBox(position, color);
+}
+
+std::string OversampledPsf::getPersistenceName() const { return "OversampledPsf"; }
+
+std::string OversampledPsf::getPythonModule() const { return "lsst.afw.detection"; }
+
+void OversampledPsf::write(OutputArchiveHandle& handle) const {
+    static OversampledPsfPersistenceHelper const& keys = OversampledPsfPersistenceHelper::get();
+    afw::table::BaseCatalog catalog = handle.makeCatalog(keys.schema);
+    std::shared_ptr<afw::table::BaseRecord> record = catalog.addNew();
+    record->set(keys.psf, handle.put(_psf));
+    record->set(keys.bbox, _bbox);
+    record->set(keys.cellSize, _cellSize);
+    record->set(keys.oversampling, _oversampling);
+    handle.saveCatalog(catalog);
+}
+
+}  // namespace detection
+}  // namespace afw
+}  // namespace lsst
@@ -1,10 +1,17 @@
 // -*- LSST-C++ -*-
+#include <algorithm>
+#include <array>
 #include <limits>
+#include <list>
+#include <mutex>
 #include <typeinfo>
 #include <cmath>
 #include <memory>
+#include <unordered_map>
 
-#include "lsst/utils/Cache.h"
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
 #include "lsst/afw/detection/Psf.h"
 #include "lsst/afw/math/offsetImage.h"
 #include "lsst/afw/table/io/Persistable.cc"
@@ -18,7 +25,7 @@ template std::shared_ptr<detection::Psf> table::io::PersistableFacade<detection:
 namespace detection {
 namespace detail {
 
-// Key for caching PSFs with lsst::utils::Cache
+// Key for caching PSFs with PsfCache
 //
 // We cache PSFs by their x,y position. Although there are placeholders
 // in the `Psf` class and here for `image::Color`, these are not used
@@ -62,6 +69,111 @@ struct hash<lsst::afw::detection::detail::PsfCacheKey> {
 namespace lsst {
 namespace afw {
 namespace detection {
+namespace detail {
+
+// A least-recently-used cache of PSF images that may be used from many threads at once.
+//
+// Keys are distributed between shards by their hash, and each shard has its own lock, so threads
+// working on different positions rarely contend.  Images are computed outside the locks; if two
+// threads miss on the same key at once, both compute it and the first to finish is kept.
+class PsfCache {
+public:
+    using Value = std::shared_ptr<Psf::Image>;
+
+    explicit PsfCache(std::size_t capacity) { reserve(capacity); }
+
+    PsfCache(PsfCache const &) = delete;
+    PsfCache(PsfCache &&) = delete;
+    PsfCache &operator=(PsfCache const &) = delete;
+    PsfCache &operator=(PsfCache &&) = delete;
+
+    // Return the cached value for a key, or null if there is none.
+    Value get(PsfCacheKey const &key) {
+        Shard &shard = _getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto iter = shard.index.find(key);
+        if (iter == shard.index.end()) {
+            return Value();
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+        return iter->second->second;
+    }
+
+    // Add a value to the cache, and return the value now cached for the key.
+    Value add(PsfCacheKey const &key, Value const &value) {
+        Shard &shard = _getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto iter = shard.index.find(key);
+        if (iter != shard.index.end()) {
+            return iter->second->second;
+        }
+        if (shard.capacity == 0) {
+            return value;
+        }
+        shard.entries.emplace_front(key, value);
+        shard.index.emplace(key, shard.entries.begin());
+        while (shard.entries.size() > shard.capacity) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+        return value;
+    }
+
+    template <typename Function>
+    Value operator()(PsfCacheKey const &key, Function func) {
+        Value result = get(key);
+        return result ? result : add(key, func(key));
+    }
+
+    std::size_t capacity() const { return _capacity; }
+
+    // Not thread-safe; must not be called while other threads use the cache.
+    void reserve(std::size_t capacity) {
+        // Small caches use fewer shards, so they hold no more than one extra entry per shard.
+        std::size_t const nShards = std::max<std::size_t>(1, std::min(N_SHARDS, capacity));
+        if (nShards != _nShards) {
+            // Keys would now map to different shards.
+            for (Shard &shard : _shards) {
+                shard.index.clear();
+                shard.entries.clear();
+            }
+            _nShards = nShards;
+        }
+        _capacity = capacity;
+        std::size_t const shardCapacity = (capacity + _nShards - 1) / _nShards;
+        for (Shard &shard : _shards) {
+            shard.capacity = shardCapacity;
+            while (shard.entries.size() > shard.capacity) {
+                shard.index.erase(shard.entries.back().first);
+                shard.entries.pop_back();
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t N_SHARDS = 16;
+
+    struct Shard {
+        std::mutex mutex;
+        std::size_t capacity = 0;
+        // Most recently used first
+        std::list<std::pair<PsfCacheKey, Value>> entries;
+        std::unordered_map<PsfCacheKey, std::list<std::pair<PsfCacheKey, Value>>::iterator> index;
+    };
+
+    Shard &_getShard(PsfCacheKey const &key) {
+        std::size_t const hash = std::hash<PsfCacheKey>()(key);
+        return _shards[(hash ^ (hash >> 17)) % _nShards];
+    }
+
+    std::size_t _capacity = 0;
+    std::size_t _nShards = 0;
+    std::array<Shard, N_SHARDS> _shards;
+};
+
+constexpr std::size_t PsfCache::N_SHARDS;
+
+}  // namespace detail
 
 namespace {
 
@@ -69,18 +181,22 @@ bool isPointNull(lsst::geom::Point2D const &p) { return std::isnan(p.getX()) &&
 
 }  // namespace
 
-Psf::Psf(bool isFixed, std::size_t capacity) : daf::base::Citizen(typeid(this)), _isFixed(isFixed) {
-    _imageCache = std::make_unique<PsfCache>(capacity);
-    _kernelImageCache = std::make_unique<PsfCache>(capacity);
+Psf::Psf(bool isFixed, std::size_t capacity)
+        : daf::base::Citizen(typeid(this)), _isFixed(isFixed), _cacheGridSpacing(0.0) {
+    _imageCache = std::make_unique<detail::PsfCache>(capacity);
+    _kernelImageCache = std::make_unique<detail::PsfCache>(capacity);
 }
 
 Psf::~Psf() = default;
 
-Psf::Psf(Psf const &other) : Psf(other._isFixed, other.getCacheCapacity()) {}
+Psf::Psf(Psf const &other) : Psf(other._isFixed, other.getCacheCapacity()) {
+    _cacheGridSpacing = other._cacheGridSpacing;
+}
 
 Psf::Psf(Psf &&other)
         : daf::base::Citizen(std::move(other)),
           _isFixed(other._isFixed),
+          _cacheGridSpacing(other._cacheGridSpacing),
           _imageCache(std::move(other._imageCache)),
           _kernelImageCache(std::move(other._kernelImageCache)) {}
 
@@ -100,13 +216,31 @@ std::shared_ptr<image::Image<double>> Psf::recenterKernelImage(std::shared_ptr<I
     return im;
 }
 
+lsst::geom::Point2D Psf::_resolvePosition(lsst::geom::Point2D position, bool forKernel) const {
+    if ((forKernel && _isFixed) || isPointNull(position)) {
+        return getAveragePosition();
+    }
+    // Only kernel images, which are centered on the origin, are looked up on the grid.
+    if (forKernel && _cacheGridSpacing > 0.0) {
+        position = lsst::geom::Point2D(std::round(position.getX() / _cacheGridSpacing) * _cacheGridSpacing,
+                                       std::round(position.getY() / _cacheGridSpacing) * _cacheGridSpacing);
+    }
+    return position;
+}
+
 std::shared_ptr<Psf::Image> Psf::computeImage(lsst::geom::Point2D position, image::Color color,
                                               ImageOwnerEnum owner) const {
-    if (isPointNull(position)) position = getAveragePosition();
+    position = _resolvePosition(position, false);
     if (color.isIndeterminate()) color = getAverageColor();
     std::shared_ptr<Psf::Image> result = (*_imageCache)(
-            detail::PsfCacheKey(position, color),
-            [this](detail::PsfCacheKey const &key) { return doComputeImage(key.position, key.color); });
+            detail::PsfCacheKey(position, color), [this](detail::PsfCacheKey const &key) {
+                if (_cacheGridSpacing > 0.0) {
+                    // Shift the kernel image from the nearest grid point to the exact position.
+                    return recenterKernelImage(computeKernelImage(key.position, key.color, COPY),
+                                               key.position);
+                }
+                return doComputeImage(key.position, key.color);
+            });
     if (owner == COPY) {
         result = std::make_shared<Image>(*result, true);
     }
@@ -115,7 +249,7 @@ std::shared_ptr<Psf::Image> Psf::computeImage(lsst::geom::Point2D position, imag
 
 std::shared_ptr<Psf::Image> Psf::computeKernelImage(lsst::geom::Point2D position, image::Color color,
                                                     ImageOwnerEnum owner) const {
-    if (_isFixed || isPointNull(position)) position = getAveragePosition();
+    position = _resolvePosition(position, true);
     if (_isFixed || color.isIndeterminate()) color = getAverageColor();
     std::shared_ptr<Psf::Image> result = (*_kernelImageCache)(
             detail::PsfCacheKey(position, color),
@@ -126,6 +260,72 @@ std::shared_ptr<Psf::Image> Psf::computeKernelImage(lsst::geom::Point2D position
     return result;
 }
 
+std::vector<std::shared_ptr<Psf::Image>> Psf::computeImages(std::vector<lsst::geom::Point2D> const &positions,
+                                                            image::Color color, ImageOwnerEnum owner) const {
+    if (color.isIndeterminate()) color = getAverageColor();
+    return _computeImages(*_imageCache, positions, color, owner, false);
+}
+
+std::vector<std::shared_ptr<Psf::Image>> Psf::computeKernelImages(
+        std::vector<lsst::geom::Point2D> const &positions, image::Color color, ImageOwnerEnum owner) const {
+    if (_isFixed || color.isIndeterminate()) color = getAverageColor();
+    return _computeImages(*_kernelImageCache, positions, color, owner, true);
+}
+
+std::vector<std::shared_ptr<Psf::Image>> Psf::_computeImages(
+        detail::PsfCache &cache, std::vector<lsst::geom::Point2D> const &positions, image::Color const &color,
+        ImageOwnerEnum owner, bool forKernel) const {
+    std::vector<std::shared_ptr<Image>> results(positions.size());
+    // Positions that missed the cache, each with the indices of the results that need it
+    std::vector<lsst::geom::Point2D> missed;
+    std::vector<std::vector<std::size_t>> missedIndices;
+    std::unordered_map<detail::PsfCacheKey, std::size_t> missedLookup;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        detail::PsfCacheKey const key(_resolvePosition(positions[i], forKernel), color);
+        results[i] = cache.get(key);
+        if (!results[i]) {
+            auto inserted = missedLookup.emplace(key, missed.size());
+            if (inserted.second) {
+                missed.push_back(key.position);
+                missedIndices.emplace_back();
+            }
+            missedIndices[inserted.first->second].push_back(i);
+        }
+    }
+    if (!missed.empty()) {
+        std::vector<std::shared_ptr<Image>> computed;
+        if (forKernel) {
+            computed = doComputeKernelImages(missed, color);
+        } else if (_cacheGridSpacing > 0.0) {
+            // Shift the kernel images from the nearest grid points to the exact positions.
+            computed = computeKernelImages(missed, color, COPY);
+            for (std::size_t j = 0; j < missed.size(); ++j) {
+                computed[j] = recenterKernelImage(computed[j], missed[j]);
+            }
+        } else {
+            computed = doComputeImages(missed, color);
+        }
+        if (computed.size() != missed.size()) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError,
+                              (boost::format("Psf computed %d images for %d positions") % computed.size() %
+                               missed.size())
+                                      .str());
+        }
+        for (std::size_t j = 0; j < missed.size(); ++j) {
+            std::shared_ptr<Image> cached = cache.add(detail::PsfCacheKey(missed[j], color), computed[j]);
+            for (std::size_t i : missedIndices[j]) {
+                results[i] = cached;
+            }
+        }
+    }
+    if (owner == COPY) {
+        for (auto &result : results) {
+            result = std::make_shared<Image>(*result, true);
+        }
+    }
+    return results;
+}
+
 lsst::geom::Box2I Psf::computeBBox(lsst::geom::Point2D position, image::Color color) const {
     if (isPointNull(position)) position = getAveragePosition();
     if (color.isIndeterminate()) color = getAverageColor();
@@ -166,6 +366,26 @@ std::shared_ptr<Psf::Image> Psf::doComputeImage(lsst::geom::Point2D const &posit
     return recenterKernelImage(im, position);
 }
 
+std::vector<std::shared_ptr<Psf::Image>> Psf::doComputeImages(
+        std::vector<lsst::geom::Point2D> const &positions, image::Color const &color) const {
+    std::vector<std::shared_ptr<Image>> results;
+    results.reserve(positions.size());
+    for (auto const &position : positions) {
+        results.push_back(doComputeImage(position, color));
+    }
+    return results;
+}
+
+std::vector<std::shared_ptr<Psf::Image>> Psf::doComputeKernelImages(
+        std::vector<lsst::geom::Point2D> const &positions, image::Color const &color) const {
+    std::vector<std::shared_ptr<Image>> results;
+    results.reserve(positions.size());
+    for (auto const &position : positions) {
+        results.push_back(doComputeKernelImage(position, color));
+    }
+    return results;
+}
+
 lsst::geom::Point2D Psf::getAveragePosition() const { return lsst::geom::Point2D(); }
 
 std::size_t Psf::getCacheCapacity() const { return _kernelImageCache->capacity(); }
@@ -175,6 +395,20 @@ void Psf::setCacheCapacity(std::size_t capacity) {
     _kernelImageCache->reserve(capacity);
 }
 
+void Psf::setCacheGridSpacing(double spacing) {
+    if (!(spacing >= 0.0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Cache grid spacing must be non-negative; got %g") % spacing).str());
+    }
+    if (spacing != _cacheGridSpacing) {
+        // Cached images were computed at positions that were rounded differently.
+        std::size_t const capacity = getCacheCapacity();
+        _imageCache = std::make_unique<detail::PsfCache>(capacity);
+        _kernelImageCache = std::make_unique<detail::PsfCache>(capacity);
+        _cacheGridSpacing = spacing;
+    }
+}
+
 }  // namespace detection
 }  // namespace afw
 }  // namespace lsst
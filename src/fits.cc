@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstdio>
 #include <complex>
+#include <cstdlib>
+#include <cstring>
 #include <cmath>
 #include <sstream>
 #include <unordered_set>
@@ -24,6 +26,7 @@ extern "C" {
 #include "lsst/geom/Angle.h"
 #include "lsst/afw/geom/wcsUtils.h"
 #include "lsst/afw/fitsCompression.h"
+#include "lsst/afw/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -345,6 +348,7 @@ bool isFitsImageTypeSigned(int constant) {
 }
 
 static bool allowImageCompression = true;
+static int imageReadThreads = 0;
 
 int fitsTypeForBitpix(int bitpix) {
     switch (bitpix) {
@@ -1303,8 +1307,314 @@ struct NullValue<T, typename std::enable_if<std::numeric_limits<T>::has_quiet_Na
 
 }  // namespace
 
+// ---- Parallel decompression of tile-compressed images ----------------------------------------------------
+
+namespace {
+
+int const ZERO_VALUE = -2147483646;  // Value flagging exact zeros with SUBTRACTIVE_DITHER_2 (cfitsio)
+
+/// Compressed data and scaling for a single tile of a compressed image HDU
+struct CompressedTile {
+    long row;             // 1-indexed row in the compressed table
+    long x0, y0;          // 0-indexed position of the first pixel of the tile in the image
+    long width, height;   // dimensions of the tile
+    bool lossless;        // tile holds losslessly-compressed floating-point values (GZIP_COMPRESSED_DATA)
+    double zscale, zzero; // quantization scaling for this tile
+    long zblank;          // value of undefined pixels
+    bool hasBlank;        // is zblank defined?
+    std::vector<unsigned char> bytes;  // compressed data
+};
+
+/// Interpret big-endian bytes as a native value
+template <typename U>
+U readBigEndian(unsigned char const *bytes) {
+    U value;
+    unsigned char *out = reinterpret_cast<unsigned char *>(&value);
+#if BYTESWAPPED
+    for (std::size_t ii = 0; ii < sizeof(U); ++ii) {
+        out[ii] = bytes[sizeof(U) - ii - 1];
+    }
+#else
+    std::memcpy(out, bytes, sizeof(U));
+#endif
+    return value;
+}
+
+/// Inflate gzipped tile data, optionally undoing the GZIP_2 byte shuffle
+///
+/// Returns the decompressed bytes and sets the number of bytes per pixel.
+std::vector<unsigned char> inflateTile(CompressedTile const &tile, bool shuffled, std::size_t &elementSize) {
+    std::size_t const numPixels = tile.width * tile.height;
+    std::size_t bufferSize = numPixels * sizeof(double);
+    char *buffer = static_cast<char *>(std::malloc(bufferSize));
+    std::size_t outSize = 0;
+    int status = 0;
+    uncompress2mem_from_mem(reinterpret_cast<char *>(const_cast<unsigned char *>(tile.bytes.data())),
+                            tile.bytes.size(), &buffer, &bufferSize, realloc, &outSize, &status);
+    std::vector<unsigned char> out(buffer, buffer + (status == 0 ? outSize : 0));
+    std::free(buffer);
+    if (status != 0 || numPixels == 0 || outSize % numPixels != 0) {
+        throw LSST_EXCEPT(FitsError, (boost::format("Unable to inflate compressed tile in row %d") %
+                                      tile.row).str());
+    }
+    elementSize = outSize / numPixels;
+    if (shuffled && elementSize > 1) {
+        std::vector<unsigned char> unshuffled(outSize);
+        for (std::size_t ii = 0; ii < numPixels; ++ii) {
+            for (std::size_t jj = 0; jj < elementSize; ++jj) {
+                unshuffled[ii * elementSize + jj] = out[jj * numPixels + ii];
+            }
+        }
+        out.swap(unshuffled);
+    }
+    return out;
+}
+
+/// Decode the integers stored in a tile
+std::vector<long> decodeIntegerTile(CompressedTile const &tile, FITSfile const &file) {
+    std::size_t const numPixels = tile.width * tile.height;
+    std::vector<long> values(numPixels);
+    int const compressedSize = tile.bytes.size();
+    unsigned char *compressed = const_cast<unsigned char *>(tile.bytes.data());
+    int result = 0;
+    switch (file.compress_type) {
+        case RICE_1:
+            switch (file.rice_bytepix) {
+                case 1: {
+                    std::vector<unsigned char> raw(numPixels);
+                    result = fits_rdecomp_byte(compressed, compressedSize, raw.data(), numPixels,
+                                               file.rice_blocksize);
+                    std::copy(raw.begin(), raw.end(), values.begin());
+                    break;
+                }
+                case 2: {
+                    std::vector<unsigned short> raw(numPixels);
+                    result = fits_rdecomp_short(compressed, compressedSize, raw.data(), numPixels,
+                                                file.rice_blocksize);
+                    std::transform(raw.begin(), raw.end(), values.begin(),
+                                   [](unsigned short vv) { return static_cast<short>(vv); });
+                    break;
+                }
+                default: {
+                    std::vector<unsigned int> raw(numPixels);
+                    result = fits_rdecomp(compressed, compressedSize, raw.data(), numPixels,
+                                          file.rice_blocksize);
+                    std::transform(raw.begin(), raw.end(), values.begin(),
+                                   [](unsigned int vv) { return static_cast<int>(vv); });
+                    break;
+                }
+            }
+            break;
+        case GZIP_1:
+        case GZIP_2: {
+            std::size_t elementSize = 0;
+            auto const raw = inflateTile(tile, file.compress_type == GZIP_2, elementSize);
+            for (std::size_t ii = 0; ii < numPixels; ++ii) {
+                unsigned char const *ptr = raw.data() + ii * elementSize;
+                switch (elementSize) {
+                    case 1: values[ii] = *ptr; break;
+                    case 2: values[ii] = readBigEndian<std::int16_t>(ptr); break;
+                    case 4: values[ii] = readBigEndian<std::int32_t>(ptr); break;
+                    default: result = -1; break;
+                }
+            }
+            break;
+        }
+        default:
+            result = -1;
+    }
+    if (result != 0) {
+        throw LSST_EXCEPT(FitsError, (boost::format("Unable to decompress tile in row %d") %
+                                      tile.row).str());
+    }
+    return values;
+}
+
+/// Decode a tile into floating-point pixel values, following cfitsio's scaling and null conventions
+///
+/// Undefined pixels are set to NaN when `checkNulls` is set.
+void decodeTile(CompressedTile const &tile, FITSfile const &file, bool checkNulls, std::vector<double> &out) {
+    std::size_t const numPixels = tile.width * tile.height;
+    out.resize(numPixels);
+    double const nan = std::numeric_limits<double>::quiet_NaN();
+    if (tile.lossless) {
+        std::size_t elementSize = 0;
+        auto const raw = inflateTile(tile, false, elementSize);
+        if (elementSize != sizeof(float) && elementSize != sizeof(double)) {
+            throw LSST_EXCEPT(FitsError, (boost::format("Unexpected pixel size in lossless tile in row %d") %
+                                          tile.row).str());
+        }
+        for (std::size_t ii = 0; ii < numPixels; ++ii) {
+            unsigned char const *ptr = raw.data() + ii * elementSize;
+            out[ii] = elementSize == sizeof(float) ? readBigEndian<float>(ptr) : readBigEndian<double>(ptr);
+        }
+        return;
+    }
+    auto const values = decodeIntegerTile(tile, file);
+    bool const quantized = file.zbitpix < 0;
+    bool const dither = quantized && (file.quantize_method == SUBTRACTIVE_DITHER_1 ||
+                                      file.quantize_method == SUBTRACTIVE_DITHER_2);
+    if (!dither) {
+        for (std::size_t ii = 0; ii < numPixels; ++ii) {
+            out[ii] = (checkNulls && tile.hasBlank && values[ii] == tile.zblank)
+                              ? nan
+                              : values[ii] * tile.zscale + tile.zzero;
+        }
+        return;
+    }
+    // Same random sequence as cfitsio's unquantize functions, restarting for each tile (row of the table)
+    std::vector<double> fuzz(numPixels);
+    detail::CfitsioRandom random(file.dither_seed);
+    random.resetForTile(tile.row - 1);
+    random.fill(fuzz.data(), numPixels);
+    bool const checkZero = file.quantize_method == SUBTRACTIVE_DITHER_2;
+    for (std::size_t ii = 0; ii < numPixels; ++ii) {
+        if (checkNulls && tile.hasBlank && values[ii] == tile.zblank) {
+            out[ii] = nan;
+        } else if (checkZero && values[ii] == ZERO_VALUE) {
+            out[ii] = 0.0;
+        } else {
+            out[ii] = (values[ii] - fuzz[ii] + 0.5) * tile.zscale + tile.zzero;
+        }
+    }
+}
+
+/// Convert a decoded pixel value to the requested type, checking for overflow as cfitsio does
+template <typename T>
+T convertPixel(double value, std::true_type /* is_integer */) {
+    if (value < std::numeric_limits<T>::lowest() || value > std::numeric_limits<T>::max()) {
+        throw LSST_EXCEPT(FitsError, "Numerical overflow converting decompressed pixel value");
+    }
+    return static_cast<T>(value);
+}
+
+template <typename T>
+T convertPixel(double value, std::false_type /* is_integer */) {
+    return static_cast<T>(value);
+}
+
+}  // anonymous namespace
+
+template <typename T>
+bool Fits::readCompressedImageImpl(T *data, long const *begin, long const *end, int nThreads) {
+    auto fits = reinterpret_cast<fitsfile *>(fptr);
+    FITSfile const &file = *fits->Fptr;
+    bool const isInteger = std::numeric_limits<T>::is_integer;
+    if (!fits_is_compressed_image(fits, &status) || file.zndim != 2) {
+        return false;
+    }
+    if (file.compress_type != RICE_1 && file.compress_type != GZIP_1 && file.compress_type != GZIP_2) {
+        return false;  // PLIO and HCOMPRESS are left to cfitsio
+    }
+    if (file.zbitpix == LONGLONG_IMG || (isInteger && sizeof(T) > 4)) {
+        return false;  // double can't hold all 64-bit integers
+    }
+    bool const quantized = file.zbitpix < 0 && file.cn_zscale != 0;
+    if (file.zbitpix < 0 && !quantized) {
+        return false;  // lossless floating-point tiles are rare; let cfitsio deal with them
+    }
+    if (quantized && file.dither_seed < 1 &&
+        (file.quantize_method == SUBTRACTIVE_DITHER_1 || file.quantize_method == SUBTRACTIVE_DITHER_2)) {
+        return false;  // no valid dither seed; leave it to cfitsio
+    }
+    if (isInteger && file.zbitpix > 0 &&
+        (file.cn_bscale != 1.0 || file.cn_bzero != std::floor(file.cn_bzero))) {
+        return false;  // cfitsio's rounding of scaled integers is not worth replicating
+    }
+
+    // Identify the tiles that intersect the requested region (FITS ordering, 1-indexed inclusive)
+    long const xTile = file.tilesize[0], yTile = file.tilesize[1];
+    long const xNumTiles = (file.znaxis[0] - 1) / xTile + 1;
+    long const xMin = begin[0] - 1, xMax = end[0] - 1;
+    long const yMin = begin[1] - 1, yMax = end[1] - 1;
+    std::vector<CompressedTile> tiles;
+    for (long yy = yMin / yTile; yy <= yMax / yTile; ++yy) {
+        for (long xx = xMin / xTile; xx <= xMax / xTile; ++xx) {
+            CompressedTile tile;
+            tile.row = 1 + xx + yy * xNumTiles;
+            tile.x0 = xx * xTile;
+            tile.y0 = yy * yTile;
+            tile.width = std::min(xTile, file.znaxis[0] - tile.x0);
+            tile.height = std::min(yTile, file.znaxis[1] - tile.y0);
+            tiles.push_back(std::move(tile));
+        }
+    }
+    if (tiles.size() < 2) {
+        return false;  // nothing to gain
+    }
+
+    // Read the compressed bytes and per-tile scaling serially: cfitsio handles aren't thread-safe
+    int anyNull = 0;
+    for (auto &tile : tiles) {
+        LONGLONG repeat = 0, offset = 0;
+        fits_read_descriptll(fits, file.cn_compressed, tile.row, &repeat, &offset, &status);
+        int column = file.cn_compressed;
+        tile.lossless = false;
+        if (repeat == 0) {
+            // cfitsio falls back to lossless storage for tiles that can't be quantized
+            if (file.cn_gzip_data <= 0) {
+                return false;  // UNCOMPRESSED_DATA
+            }
+            fits_read_descriptll(fits, file.cn_gzip_data, tile.row, &repeat, &offset, &status);
+            column = file.cn_gzip_data;
+            tile.lossless = true;
+        }
+        tile.bytes.resize(repeat);
+        fits_read_col(fits, TBYTE, column, tile.row, 1, repeat, nullptr, tile.bytes.data(), &anyNull,
+                      &status);
+
+        tile.zscale = file.cn_bscale;
+        tile.zzero = file.cn_bzero;
+        if (file.cn_zscale > 0) {
+            fits_read_col(fits, TDOUBLE, file.cn_zscale, tile.row, 1, 1, nullptr, &tile.zscale, &anyNull,
+                          &status);
+            fits_read_col(fits, TDOUBLE, file.cn_zzero, tile.row, 1, 1, nullptr, &tile.zzero, &anyNull,
+                          &status);
+        } else if (file.cn_zscale == -1) {
+            tile.zscale = file.zscale;
+            tile.zzero = file.zzero;
+        }
+        tile.hasBlank = file.cn_zblank != 0;
+        tile.zblank = file.zblank;
+        if (file.cn_zblank > 0) {
+            int blank = 0;
+            fits_read_col(fits, TINT, file.cn_zblank, tile.row, 1, 1, nullptr, &blank, &anyNull, &status);
+            tile.zblank = blank;
+        }
+        if (behavior & AUTO_CHECK) LSST_FITS_CHECK_STATUS(*this, "Reading compressed tiles");
+        if (status != 0) {
+            return false;
+        }
+    }
+
+    fits_init_randoms();  // initialize the shared random sequence before any thread reads it
+    using IsInteger = std::integral_constant<bool, std::numeric_limits<T>::is_integer>;
+    bool const checkNulls = !isInteger;  // cfitsio doesn't check for nulls when the null value is zero
+    long const width = xMax - xMin + 1;
+    lsst::afw::detail::parallelFor(0, tiles.size(), [&](std::size_t ii) {
+        CompressedTile const &tile = tiles[ii];
+        std::vector<double> pixels;
+        decodeTile(tile, file, checkNulls, pixels);
+        long const x0 = std::max(xMin, tile.x0), x1 = std::min(xMax + 1, tile.x0 + tile.width);
+        long const y0 = std::max(yMin, tile.y0), y1 = std::min(yMax + 1, tile.y0 + tile.height);
+        for (long yy = y0; yy < y1; ++yy) {
+            double const *in = pixels.data() + (yy - tile.y0) * tile.width + (x0 - tile.x0);
+            T *out = data + (yy - yMin) * width + (x0 - xMin);
+            for (long xx = x0; xx < x1; ++xx, ++in, ++out) {
+                *out = convertPixel<T>(*in, IsInteger());
+            }
+        }
+    }, nThreads);
+    return true;
+}
+
 template <typename T>
 void Fits::readImageImpl(int nAxis, T *data, long *begin, long *end, long *increment) {
+    int const nThreads = getImageReadThreads();
+    if (nThreads > 1 && nAxis == 2 && increment[0] == 1 && increment[1] == 1 &&
+        readCompressedImageImpl(data, begin, end, nThreads)) {
+        return;
+    }
     T null = NullValue<T>::value;
     int anyNulls = 0;
     fits_read_subset(reinterpret_cast<fitsfile *>(fptr), FitsType<T>::CONSTANT, begin, end, increment,
@@ -1440,6 +1750,10 @@ void setAllowImageCompression(bool allow) { allowImageCompression = allow; }
 
 bool getAllowImageCompression() { return allowImageCompression; }
 
+void setImageReadThreads(int nThreads) { imageReadThreads = nThreads; }
+
+int getImageReadThreads() { return lsst::afw::detail::resolveNumThreads(imageReadThreads); }
+
 // ---- Manipulating files ----------------------------------------------------------------------------------
 
 Fits::Fits(std::string const &filename, std::string const &mode, int behavior_)
@@ -1718,6 +2032,7 @@ std::shared_ptr<daf::base::PropertySet> ImageWriteOptions::validate(daf::base::P
                                    std::shared_ptr<daf::base::PropertySet const>,          \
                                    std::shared_ptr<image::Mask<image::MaskPixel> const>);  \
     template void Fits::readImageImpl(int, T *, long *, long *, long *);                   \
+    template bool Fits::readCompressedImageImpl(T *, long const *, long const *, int);     \
     template bool Fits::checkImageType<T>();                                               \
     template int getBitPix<T>();
 
@@ -1,5 +1,9 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "fitsio.h"
 extern "C" {
 #include "fitsio2.h"
@@ -9,6 +13,7 @@ extern "C" {
 #include "lsst/afw/math/Random.h"
 
 #include "lsst/afw/fitsCompression.h"
+#include "lsst/afw/detail/Parallel.h"
 
 extern float* fits_rand_value;     // Random numbers, defined in cfitsio
 int const N_RESERVED_VALUES = 10;  // Number of reserved values for float --> bitpix=32 conversions (cfitsio)
@@ -144,39 +149,100 @@ ImageScalingOptions::ImageScalingOptions(ScalingAlgorithm algorithm_, int bitpix
 
 namespace {
 
-/// Calculate median and standard deviation for an image
+/// Maximum number of pixels used to estimate the median and standard deviation
+///
+/// Quartiles of 10^5 samples are good to a fraction of a percent, which is plenty
+/// for setting the quantization scale; beyond that, copying and partially sorting
+/// the pixels only costs time and memory.
+std::size_t const MAX_STATISTICS_SAMPLES = 100000;
+
+/// Greatest common divisor
+std::size_t greatestCommonDivisor(std::size_t aa, std::size_t bb) {
+    while (bb != 0) {
+        std::size_t const rr = aa % bb;
+        aa = bb;
+        bb = rr;
+    }
+    return aa;
+}
+
+/// Return the smallest stride no less than `stride` that shares no factor with `width`
+///
+/// Sampling the pixels of an image at such a stride steps through every column, rather than
+/// following the same few columns down the image (where bad columns, gradients or amplifier
+/// boundaries would bias the statistics).
+std::size_t coprimeStride(std::size_t stride, std::size_t width) {
+    while (stride > 1 && greatestCommonDivisor(stride, width) != 1) {
+        ++stride;
+    }
+    return stride;
+}
+
+/// Robust statistics of an image, as used by the STDEV_* scaling algorithms
+template <typename T>
+struct ImageStatistics {
+    T median;  ///< Median of (sampled) good pixels
+    T stdev;   ///< Standard deviation from the (sampled) interquartile range
+    T min;     ///< Minimum of all good, finite pixels
+    T max;     ///< Maximum of all good, finite pixels
+};
+
+/// Calculate median, standard deviation, min and max for an image
+///
+/// The min and max are exact, but the median and standard deviation are estimated from
+/// at most MAX_STATISTICS_SAMPLES good pixels selected at a regular stride, so no full
+/// copy of the image is made.  The stride has no factor in common with the width of the
+/// image, so the samples are spread over all columns.
 template <typename T, int N>
-std::pair<T, T> calculateMedianStdev(ndarray::Array<T const, N, N> const& image,
-                                     ndarray::Array<bool, N, N> const& mask) {
-    std::size_t num = 0;
+ImageStatistics<T> calculateStatistics(ndarray::Array<T const, N, N> const& image,
+                                       ndarray::Array<bool, N, N> const& mask) {
     auto const& flatMask = ndarray::flatten<1>(mask);
-    for (auto mm = flatMask.begin(); mm != flatMask.end(); ++mm) {
-        if (!*mm) ++num;
-    }
-    ndarray::Array<T, 1, 1> array = ndarray::allocate(num);
     auto const& flatImage = ndarray::flatten<1>(image);
-    auto mm = ndarray::flatten<1>(mask).begin();
-    auto aa = array.begin();
-    for (auto ii = flatImage.begin(); ii != flatImage.end(); ++ii, ++mm) {
-        if (*mm) continue;
-        *aa = *ii;
-        ++aa;
+    std::size_t const size = flatImage.getNumElements();
+    bool const* maskData = flatMask.getData();
+    T const* imageData = flatImage.getData();
+
+    std::size_t numGood = 0;
+    for (std::size_t ii = 0; ii < size; ++ii) {
+        numGood += !maskData[ii];
+    }
+    std::size_t const width = image.getShape()[N - 1];
+    std::size_t const stride =
+            coprimeStride(std::max<std::size_t>(1, numGood / MAX_STATISTICS_SAMPLES), width);
+
+    ImageStatistics<T> stats;
+    stats.min = std::numeric_limits<T>::max();
+    stats.max = std::numeric_limits<T>::lowest();
+    std::vector<T> samples;
+    samples.reserve(numGood / stride + 1);
+    for (std::size_t ii = 0, iGood = 0; ii < size; ++ii) {
+        if (maskData[ii]) continue;
+        bool const isSample = (iGood++ % stride == 0);
+        T const value = imageData[ii];
+        if (!std::isfinite(value)) continue;
+        stats.min = std::min(stats.min, value);
+        stats.max = std::max(stats.max, value);
+        if (isSample) samples.push_back(value);
     }
 
     // Quartiles; from https://stackoverflow.com/a/11965377/834250
+    std::size_t const num = samples.size();
+    if (num == 0) {
+        stats.median = stats.stdev = std::numeric_limits<T>::quiet_NaN();
+        return stats;
+    }
     auto const q1 = num / 4;
     auto const q2 = num / 2;
     auto const q3 = q1 + q2;
-    std::nth_element(array.begin(), array.begin() + q1, array.end());
-    std::nth_element(array.begin() + q1 + 1, array.begin() + q2, array.end());
-    std::nth_element(array.begin() + q2 + 1, array.begin() + q3, array.end());
+    std::nth_element(samples.begin(), samples.begin() + q1, samples.end());
+    std::nth_element(samples.begin() + q1 + 1, samples.begin() + q2, samples.end());
+    std::nth_element(samples.begin() + q2 + 1, samples.begin() + q3, samples.end());
 
-    T const median = num % 2 ? array[num / 2] : 0.5 * (array[num / 2] + array[num / 2 - 1]);
+    stats.median = num % 2 ? samples[num / 2] : 0.5 * (samples[num / 2] + samples[num / 2 - 1]);
     // No, we're not doing any interpolation for the lower and upper quartiles.
     // We're estimating the noise, so it doesn't need to be super precise.
-    T const lq = array[q1];
-    T const uq = array[q3];
-    return std::make_pair(median, 0.741 * (uq - lq));
+    stats.stdev = 0.741 * (samples[q3] - samples[q1]);
+    return stats;
 }
 
 /// Calculate min and max for an image
@@ -233,14 +299,13 @@ template <typename T, int N>
 ImageScale ImageScalingOptions::determineFromStdev(ndarray::Array<T const, N, N> const& image,
                                                    ndarray::Array<bool, N, N> const& mask, bool isUnsigned,
                                                    bool cfitsioPadding) const {
-    auto stats = calculateMedianStdev(image, mask);
-    auto const median = stats.first, stdev = stats.second;
+    auto const stats = calculateStatistics(image, mask);
+    auto const median = stats.median, stdev = stats.stdev;
     double const bscale = static_cast<T>(stdev / quantizeLevel);
 
     /// Use min/max-based bzero if we can possibly fit everything in
-    auto minMax = calculateMinMax(image, mask);
-    T const min = minMax.first;
-    T const max = minMax.second;
+    T const min = stats.min;
+    T const max = stats.max;
     double range = rangeForBitpix<T>(bitpix, cfitsioPadding);  // Range of values for target BITPIX
     double const numUnique = (max - min) / bscale;             // Number of unique values
 
@@ -326,82 +391,75 @@ ImageScale ImageScalingOptions::determine(ndarray::Array<T const, N, N> const& i
 }
 #endif
 
-namespace {
+namespace detail {
 
-/// Random number generator used by cfitsio
-///
-/// We use the exact same random numbers that cfitsio generates, and
-/// copy the implementation for the indexing.
-class CfitsioRandom {
-public:
-    /// Ctor
-    CfitsioRandom(int seed) : _seed(seed) {
-        assert(seed != 0 && seed < N_RANDOM);
-        fits_init_randoms();
-        resetForTile(0);
-    }
+CfitsioRandom::CfitsioRandom(int seed) : _seed(seed) {
+    assert(seed > 0);
+    fits_init_randoms();
+    resetForTile(0);
+}
 
-    /// Reset the indices for the i-th tile
-    void resetForTile(int iTile) {
-        _start = (iTile + _seed - 1) % N_RANDOM;
-        reseed();
-    }
+void CfitsioRandom::resetForTile(int iTile) {
+    _start = (iTile + _seed - 1) % N_RANDOM;
+    reseed();
+}
 
-    /// Get the next value
-    float getNext() {
-        float const value = fits_rand_value[_index];
-        increment();
-        return value;
-    }
+float CfitsioRandom::getNext() {
+    float const value = fits_rand_value[_index];
+    increment();
+    return value;
+}
 
-    /// Increment the indices
-    void increment() {
-        ++_index;
-        if (_index == N_RANDOM) {
-            ++_start;
-            if (_start == N_RANDOM) {
-                _start = 0;
-            }
-            reseed();
-        }
+void CfitsioRandom::fill(double* out, std::size_t num) {
+    for (std::size_t ii = 0; ii < num; ++ii) {
+        out[ii] = getNext();
     }
+}
 
-    /// Generate a flattened image of random numbers
-    template <typename T>
-    ndarray::Array<T, 1, 1> forImage(typename ndarray::Array<T const, 2, 2>::Index const& shape,
-                                     ndarray::Array<long, 1> const& tiles) {
-        std::size_t const xSize = shape[1], ySize = shape[0];
-        ndarray::Array<T, 1, 1> out = ndarray::allocate(xSize * ySize);
-        std::size_t const xTileSize = tiles[0] <= 0 ? xSize : tiles[0];
-        std::size_t const yTileSize = tiles[1] < 0 ? ySize : (tiles[1] == 0 ? 1 : tiles[1]);
-        int const xNumTiles = std::ceil(xSize / static_cast<float>(xTileSize));
-        int const yNumTiles = std::ceil(ySize / static_cast<float>(yTileSize));
-        for (int iTile = 0, yTile = 0; yTile < yNumTiles; ++yTile) {
-            int const yStart = yTile * yTileSize;
-            int const yStop = std::min(yStart + yTileSize, ySize);
-            for (int xTile = 0; xTile < xNumTiles; ++xTile, ++iTile) {
-                int const xStart = xTile * xTileSize;
-                int const xStop = std::min(xStart + xTileSize, xSize);
-                resetForTile(iTile);
-                for (int y = yStart; y < yStop; ++y) {
-                    auto iter = out.begin() + y * xSize + xStart;
-                    for (int x = xStart; x < xStop; ++x, ++iter) {
-                        *iter = static_cast<T>(getNext());
-                    }
-                }
-            }
+void CfitsioRandom::increment() {
+    ++_index;
+    if (_index == N_RANDOM) {
+        ++_start;
+        if (_start == N_RANDOM) {
+            _start = 0;
         }
-        return out;
+        reseed();
     }
+}
 
-private:
-    /// Start the run of indices over with the new seed value
-    void reseed() { _index = static_cast<int>(fits_rand_value[_start] * 500); }
+void CfitsioRandom::reseed() { _index = static_cast<int>(fits_rand_value[_start] * 500); }
 
-    int _seed;   // Initial seed
-    int _start;  // Starting index for tile; "iseed" in cfitsio
-    int _index;  // Index of next value; "nextrand" in cfitsio
-};
+}  // namespace detail
+
+namespace {
+
+/// Quantize a row of pixels
+///
+/// Written without any dependencies between iterations so the compiler can vectorize it.
+///
+/// @param[in] in  Input pixels
+/// @param[out] out  Quantized values
+/// @param[in] num  Number of pixels
+/// @param[in] fuzz  Random values in [0,1) to add before quantizing, or nullptr for none
+/// @param[in] bzero, scale  Scaling to apply: (in - bzero)*scale
+/// @param[in] min, max  Range of allowed values; values outside are set to blank
+/// @param[in] blank  Value for non-finite pixels or those out of range
+template <typename T>
+void quantizeRow(T const* in, double* out, std::size_t num, double const* fuzz, double bzero,
+                 double scale, double min, double max, double blank) {
+    for (std::size_t ii = 0; ii < num; ++ii) {
+        double value = (in[ii] - bzero) * scale;
+        if (fuzz) {
+            // Add random factor [0.0,1.0): adds a variance of 1/12,
+            // but preserves the expectation value given the floor()
+            value += fuzz[ii];
+        }
+        // Non-finite values fail both comparisons. This choice of "blank" for non-finite and overflow
+        // pixels is mainly cosmetic --- it has to be something, and "min" would produce holes in the cores
+        // of bright stars.
+        out[ii] = (value >= min && value <= max) ? std::floor(value) : blank;
+    }
+}
 
 }  // anonymous namespace
 
@@ -451,34 +509,50 @@ std::shared_ptr<detail::PixelArrayBase> ImageScale::toFits(ndarray::Array<T cons
     double const scale = 1.0 / bscale;
     std::size_t const num = image.getNumElements();
     bool const applyFuzz = fuzz && !std::numeric_limits<T>::is_integer && bitpix > 0;
-    ndarray::Array<double, 1, 1> out;
+    if (applyFuzz && tiles.isEmpty()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Tile sizes must be provided if fuzzing is desired");
+    }
+
+    // Work tile by tile: the random sequence for the fuzz restarts on each compression tile (as in
+    // cfitsio), so tiles are independent and can be quantized concurrently. Without fuzz, any
+    // blocking will do.
+    std::size_t const xSize = image.getShape()[1], ySize = image.getShape()[0];
+    std::size_t xTileSize = xSize, yTileSize = 64;
     if (applyFuzz) {
-        if (tiles.isEmpty()) {
-            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
-                              "Tile sizes must be provided if fuzzing is desired");
-        }
-        out = CfitsioRandom(seed).forImage<double>(image.getShape(), tiles);
-    } else {
-        out = ndarray::allocate(num);
-        out.deep() = 0;
+        xTileSize = tiles[0] <= 0 ? xSize : tiles[0];
+        yTileSize = tiles[1] < 0 ? ySize : (tiles[1] == 0 ? 1 : tiles[1]);
     }
-    auto outIter = out.begin();
-    auto const& flatImage = ndarray::flatten<1>(image);
-    for (auto inIter = flatImage.begin(); inIter != flatImage.end(); ++inIter, ++outIter) {
-        double value = (*inIter - bzero) * scale;
-        if (!std::isfinite(value)) {
-            // This choice of "max" for non-finite and overflow pixels is mainly cosmetic --- it has to be
-            // something, and "min" would produce holes in the cores of bright stars.
-            *outIter = blank;
-            continue;
-        }
+    std::size_t const xNumTiles = xSize == 0 ? 0 : (xSize - 1) / xTileSize + 1;
+    std::size_t const yNumTiles = ySize == 0 ? 0 : (ySize - 1) / yTileSize + 1;
+
+    ndarray::Array<double, 1, 1> out = ndarray::allocate(num);
+    if (applyFuzz) {
+        // set up cfitsio's random numbers before threads start
+        detail::CfitsioRandom const initializer(seed);
+    }
+    T const* const inData = image.getData();
+    double* const outData = out.getData();
+    lsst::afw::detail::parallelFor(0, xNumTiles * yNumTiles, [&](std::size_t iTile) {
+        std::size_t const xStart = (iTile % xNumTiles) * xTileSize;
+        std::size_t const yStart = (iTile / xNumTiles) * yTileSize;
+        std::size_t const width = std::min(xStart + xTileSize, xSize) - xStart;
+        std::size_t const yStop = std::min(yStart + yTileSize, ySize);
+        std::unique_ptr<detail::CfitsioRandom> rng;
+        std::vector<double> fuzzValues;
         if (applyFuzz) {
-            // Add random factor [0.0,1.0): adds a variance of 1/12,
-            // but preserves the expectation value given the floor()
-            value += *outIter;
+            rng.reset(new detail::CfitsioRandom(seed));
+            rng->resetForTile(iTile);
+            fuzzValues.resize(width);
         }
-        *outIter = (value < min ? blank : (value > max ? blank : std::floor(value)));
-    }
+        for (std::size_t y = yStart; y < yStop; ++y) {
+            if (applyFuzz) {
+                rng->fill(fuzzValues.data(), width);
+            }
+            quantizeRow(inData + y * xSize + xStart, outData + y * xSize + xStart, width,
+                        applyFuzz ? fuzzValues.data() : nullptr, bzero, scale, min, max, blank);
+        }
+    });
     return detail::makePixelArray(bitpix, out);
 }
 
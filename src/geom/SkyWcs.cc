@@ -34,6 +34,7 @@
 #include "lsst/geom/Angle.h"
 #include "lsst/geom/Point.h"
 #include "lsst/geom/SpherePoint.h"
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/formatters/Utils.h"
 #include "lsst/afw/table.h"
 #include "lsst/afw/table/io/CatalogVector.h"
@@ -111,6 +112,63 @@ std::string getSkyWcsPersistenceName() { return "SkyWcs"; }
 
 SkyWcsFactory registration(getSkyWcsPersistenceName());
 
+// Number of points passed to AST at once by the columnar pixelToSky and skyToPixel.
+std::size_t const COLUMN_CHUNK_SIZE = 4096;
+
+/*
+ * Transform a pair of columns into another pair of columns, in chunks of COLUMN_CHUNK_SIZE points.
+ *
+ * The columns are split into one contiguous block per thread, and each thread copies its block into
+ * and out of a single scratch buffer, calling `apply(rawIn, rawOut)` once per chunk.  `apply` may be
+ * called from several threads at once; Transform evaluates a private copy of its mapping on each
+ * thread, including the calling one.  If `wrapLongitude`, the first output column is wrapped into
+ * [0, 2pi).
+ */
+template <typename Apply>
+void transformColumns(ndarray::Array<double const, 1> const& in0, ndarray::Array<double const, 1> const& in1,
+                      ndarray::Array<double, 1> const& out0, ndarray::Array<double, 1> const& out1,
+                      Apply const& apply, bool wrapLongitude, int nThreads) {
+    std::size_t const size = in0.getSize<0>();
+    if (in1.getSize<0>() != size || out0.getSize<0>() != size || out1.getSize<0>() != size) {
+        std::ostringstream os;
+        os << "Column sizes " << size << ", " << in1.getSize<0>() << ", " << out0.getSize<0>() << " and "
+           << out1.getSize<0>() << " are not all equal";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    if (size == 0) {
+        return;
+    }
+    std::size_t const nChunks = (size + COLUMN_CHUNK_SIZE - 1) / COLUMN_CHUNK_SIZE;
+    std::size_t const nBlocks =
+            std::min(nChunks, static_cast<std::size_t>(lsst::afw::detail::resolveNumThreads(nThreads)));
+    auto const transformBlock = [&](std::size_t block) {
+        std::size_t const blockBegin = (block * nChunks / nBlocks) * COLUMN_CHUNK_SIZE;
+        std::size_t const blockEnd = std::min(size, ((block + 1) * nChunks / nBlocks) * COLUMN_CHUNK_SIZE);
+        std::size_t const bufferSize = std::min(COLUMN_CHUNK_SIZE, blockEnd - blockBegin);
+        ndarray::Array<double, 1, 1> buffer = ndarray::allocate(4 * bufferSize);
+        for (std::size_t begin = blockBegin; begin < blockEnd; begin += COLUMN_CHUNK_SIZE) {
+            std::size_t const n = std::min(COLUMN_CHUNK_SIZE, blockEnd - begin);
+            // The last chunk may be short, so lay out (2, n) arrays in the buffer for each chunk.
+            auto const shape = ndarray::makeVector(std::size_t(2), n);
+            ndarray::Array<double, 2, 2> in = ndarray::external(buffer.getData(), shape, ndarray::ROW_MAJOR);
+            ndarray::Array<double, 2, 2> out =
+                    ndarray::external(buffer.getData() + 2 * n, shape, ndarray::ROW_MAJOR);
+            for (std::size_t i = 0; i < n; ++i) {
+                in[0][i] = in0[begin + i];
+                in[1][i] = in1[begin + i];
+            }
+            apply(in, out);
+            for (std::size_t i = 0; i < n; ++i) {
+                double const value = out[0][i];
+                out0[begin + i] = wrapLongitude ? (value * lsst::geom::radians).wrap().asRadians() : value;
+                out1[begin + i] = out[1][i];
+            }
+        }
+    };
+    // nBlocks already accounts for nThreads, so give each block its own thread.
+    lsst::afw::detail::parallelFor(0, nBlocks, transformBlock, static_cast<int>(nBlocks));
+}
+
 ast::FrameDict makeSkyWcsFrameDict(TransformPoint2ToPoint2 const& pixelsToFieldAngle,
                                    lsst::geom::Angle const& orientation, bool flipX,
                                    lsst::geom::SpherePoint const& crval,
@@ -275,6 +333,22 @@ lsst::geom::AffineTransform SkyWcs::linearizeSkyToPixel(lsst::geom::Point2D cons
     return _linearizeSkyToPixel(pix, pixelToSky(pix), skyUnit);
 }
 
+void SkyWcs::pixelToSky(ndarray::Array<double const, 1> const& x, ndarray::Array<double const, 1> const& y,
+                        ndarray::Array<double, 1> const& ra, ndarray::Array<double, 1> const& dec,
+                        int nThreads) const {
+    auto const apply = [this](ndarray::Array<double, 2, 2> const& in,
+                              ndarray::Array<double, 2, 2> const& out) { _transform->applyForward(in, out); };
+    transformColumns(x, y, ra, dec, apply, true, nThreads);
+}
+
+void SkyWcs::skyToPixel(ndarray::Array<double const, 1> const& ra, ndarray::Array<double const, 1> const& dec,
+                        ndarray::Array<double, 1> const& x, ndarray::Array<double, 1> const& y,
+                        int nThreads) const {
+    auto const apply = [this](ndarray::Array<double, 2, 2> const& in,
+                              ndarray::Array<double, 2, 2> const& out) { _transform->applyInverse(in, out); };
+    transformColumns(ra, dec, x, y, apply, false, nThreads);
+}
+
 std::string SkyWcs::getShortClassName() { return "SkyWcs"; };
 
 bool SkyWcs::isFlipped() const {
@@ -0,0 +1,228 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/geom/SkyWcsApproximation.h"
+#include "lsst/afw/table/aggregates.h"
+#include "lsst/afw/table/io/CatalogVector.h"
+#include "lsst/afw/table/io/InputArchive.h"
+#include "lsst/afw/table/io/OutputArchive.h"
+#include "lsst/afw/table/io/Persistable.cc"
+
+namespace lsst {
+namespace afw {
+
+template std::shared_ptr<geom::SkyWcsApproximation> table::io::PersistableFacade<
+        geom::SkyWcsApproximation>::dynamicCast(std::shared_ptr<table::io::Persistable> const &);
+
+namespace geom {
+
+SkyWcsApproximation::SkyWcsApproximation(SkyWcs const &wcs, lsst::geom::Box2D const &bbox,
+                                         lsst::geom::Angle skyTolerance, double pixelTolerance, int order,
+                                         int maxLevel)
+        : _tangentPoint(wcs.pixelToSky(bbox.getCenter())) {
+    if (!(skyTolerance.asRadians() > 0.0) || !(pixelTolerance > 0.0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Tolerances must be positive.");
+    }
+    // Scale the projection plane so that one tolerance applies to both directions.
+    _planeScale = skyTolerance.asRadians() / pixelTolerance;
+    _initialize();
+    auto forward = [this, &wcs](std::vector<lsst::geom::Point2D> const &pixels) {
+        std::vector<lsst::geom::SpherePoint> const sky = wcs.pixelToSky(pixels);
+        std::vector<lsst::geom::Point2D> plane;
+        plane.reserve(sky.size());
+        for (auto const &point : sky) {
+            plane.push_back(_project(point));
+        }
+        return plane;
+    };
+    auto inverse = [this, &wcs](std::vector<lsst::geom::Point2D> const &plane) {
+        std::vector<lsst::geom::SpherePoint> sky;
+        sky.reserve(plane.size());
+        for (auto const &point : plane) {
+            sky.push_back(_deproject(point));
+        }
+        return wcs.skyToPixel(sky);
+    };
+    _transform = std::make_shared<TransformApproximation>(forward, inverse, bbox, pixelTolerance, order,
+                                                          maxLevel);
+}
+
+SkyWcsApproximation::SkyWcsApproximation(lsst::geom::SpherePoint const &tangentPoint, double planeScale,
+                                         std::shared_ptr<TransformApproximation const> transform)
+        : _tangentPoint(tangentPoint), _planeScale(planeScale), _transform(std::move(transform)) {
+    if (!_transform || !_transform->hasInverse()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Transform approximation must exist and have an inverse.");
+    }
+    _initialize();
+}
+
+void SkyWcsApproximation::_initialize() {
+    double const ra = _tangentPoint.getLongitude().asRadians();
+    double const dec = _tangentPoint.getLatitude().asRadians();
+    double const cosRa = std::cos(ra), sinRa = std::sin(ra);
+    double const cosDec = std::cos(dec), sinDec = std::sin(dec);
+    _center[0] = cosDec * cosRa;
+    _center[1] = cosDec * sinRa;
+    _center[2] = sinDec;
+    _east[0] = -sinRa;
+    _east[1] = cosRa;
+    _east[2] = 0.0;
+    _north[0] = -sinDec * cosRa;
+    _north[1] = -sinDec * sinRa;
+    _north[2] = cosDec;
+}
+
+lsst::geom::Point2D SkyWcsApproximation::_project(lsst::geom::SpherePoint const &sky) const {
+    double const ra = sky.getLongitude().asRadians();
+    double const dec = sky.getLatitude().asRadians();
+    double const cosDec = std::cos(dec);
+    double const v[3] = {cosDec * std::cos(ra), cosDec * std::sin(ra), std::sin(dec)};
+    double const d = v[0] * _center[0] + v[1] * _center[1] + v[2] * _center[2];
+    if (!(d > 0.0)) {
+        // Not in the hemisphere centered on the tangent point.
+        double const nan = std::numeric_limits<double>::quiet_NaN();
+        return lsst::geom::Point2D(nan, nan);
+    }
+    double const scale = 1.0 / (d * _planeScale);
+    return lsst::geom::Point2D((v[0] * _east[0] + v[1] * _east[1]) * scale,
+                               (v[0] * _north[0] + v[1] * _north[1] + v[2] * _north[2]) * scale);
+}
+
+lsst::geom::SpherePoint SkyWcsApproximation::_deproject(lsst::geom::Point2D const &plane) const {
+    double const x = plane.getX() * _planeScale, y = plane.getY() * _planeScale;
+    double v[3];
+    for (int i = 0; i < 3; ++i) {
+        v[i] = _center[i] + x * _east[i] + y * _north[i];
+    }
+    return lsst::geom::SpherePoint(std::atan2(v[1], v[0]) * lsst::geom::radians,
+                                   std::atan2(v[2], std::hypot(v[0], v[1])) * lsst::geom::radians);
+}
+
+lsst::geom::SpherePoint SkyWcsApproximation::pixelToSky(lsst::geom::Point2D const &pixel) const {
+    return _deproject(_transform->applyForward(pixel));
+}
+
+std::vector<lsst::geom::SpherePoint> SkyWcsApproximation::pixelToSky(
+        std::vector<lsst::geom::Point2D> const &pixels) const {
+    std::vector<lsst::geom::Point2D> const plane = _transform->applyForward(pixels);
+    std::vector<lsst::geom::SpherePoint> result;
+    result.reserve(plane.size());
+    for (auto const &point : plane) {
+        result.push_back(_deproject(point));
+    }
+    return result;
+}
+
+lsst::geom::Point2D SkyWcsApproximation::skyToPixel(lsst::geom::SpherePoint const &sky) const {
+    return _transform->applyInverse(_project(sky));
+}
+
+std::vector<lsst::geom::Point2D> SkyWcsApproximation::skyToPixel(
+        std::vector<lsst::geom::SpherePoint> const &sky) const {
+    std::vector<lsst::geom::Point2D> plane;
+    plane.reserve(sky.size());
+    for (auto const &point : sky) {
+        plane.push_back(_project(point));
+    }
+    return _transform->applyInverse(plane);
+}
+
+lsst::geom::Angle SkyWcsApproximation::getMaxSkyError() const {
+    // The gnomonic projection never shrinks distances, so the error in the plane bounds the error
+    // on the sky.
+    return _transform->getMaxForwardError() * _planeScale * lsst::geom::radians;
+}
+
+// ------------------ persistence ---------------------------------------------------------------------------
+
+namespace {
+
+struct PersistenceHelper {
+    table::Schema schema;
+    table::CoordKey tangentPoint;
+    table::Key<double> planeScale;
+    table::Key<int> transform;
+
+    static PersistenceHelper const &get() {
+        static PersistenceHelper const instance;
+        return instance;
+    }
+
+private:
+    PersistenceHelper()
+            : schema(),
+              tangentPoint(table::CoordKey::addFields(schema, "tangent_point",
+                                                      "tangent point of the gnomonic projection")),
+              planeScale(schema.addField<double>("plane_scale", "size of a unit of the projection plane",
+                                                 "rad")),
+              transform(schema.addField<int>("transform", "archive ID of the pixel-to-plane transform")) {}
+};
+
+class SkyWcsApproximationFactory : public table::io::PersistableFactory {
+public:
+    explicit SkyWcsApproximationFactory(std::string const &name) : afw::table::io::PersistableFactory(name) {}
+
+    std::shared_ptr<table::io::Persistable> read(InputArchive const &archive,
+                                                 CatalogVector const &catalogs) const override {
+        LSST_ARCHIVE_ASSERT(catalogs.size() == 1u);
+        LSST_ARCHIVE_ASSERT(catalogs.front().size() == 1u);
+        auto const &keys = PersistenceHelper::get();
+        LSST_ARCHIVE_ASSERT(catalogs.front().getSchema() == keys.schema);
+        table::BaseRecord const &record = catalogs.front().front();
+        auto transform = archive.get<TransformApproximation>(record.get(keys.transform));
+        return std::make_shared<SkyWcsApproximation>(record.get(keys.tangentPoint),
+                                                     record.get(keys.planeScale), transform);
+    }
+};
+
+std::string getSkyWcsApproximationPersistenceName() { return "SkyWcsApproximation"; }
+
+SkyWcsApproximationFactory registration(getSkyWcsApproximationPersistenceName());
+
+}  // namespace
+
+std::string SkyWcsApproximation::getPersistenceName() const {
+    return getSkyWcsApproximationPersistenceName();
+}
+
+std::string SkyWcsApproximation::getPythonModule() const { return "lsst.afw.geom"; }
+
+void SkyWcsApproximation::write(OutputArchiveHandle &handle) const {
+    auto const &keys = PersistenceHelper::get();
+    table::BaseCatalog catalog = handle.makeCatalog(keys.schema);
+    std::shared_ptr<table::BaseRecord> record = catalog.addNew();
+    record->set(keys.tangentPoint, _tangentPoint);
+    record->set(keys.planeScale, _planeScale);
+    record->set(keys.transform, handle.put(_transform));
+    handle.saveCatalog(catalog);
+}
+
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
@@ -41,6 +41,10 @@ template std::shared_ptr<geom::SpanSet> table::io::PersistableFacade<geom::SpanS
 namespace geom {
 namespace {
 
+/* Largest number of points passed to a Transform at once by transformedBy
+ */
+int const MAX_TRANSFORM_BATCH = 1 << 16;
+
 /* These classes are used in the erode operator to quickly calculate the
  * contents of the shrunken SpanSet
  */
@@ -187,6 +191,7 @@ SpanSet::SpanSet(lsst::geom::Box2I const& box) : _bbox(box), _area(box.getArea()
     for (int i = beginY; i < _bbox.getEndY(); ++i) {
         _spanVector.push_back(Span(i, beginX, maxX));
     }
+    _buildRowIndex();
 }
 
 // Construct a SpanSet from a std vector by copying
@@ -278,6 +283,68 @@ void SpanSet::_initialize() {
     }
     _bbox = lsst::geom::Box2I(lsst::geom::Point2I(minX, _spanVector.front().getY()),
                               lsst::geom::Point2I(maxX, _spanVector.back().getY()));
+    _buildRowIndex();
+}
+
+void SpanSet::_buildRowIndex() {
+    /* Spans passed to a constructor with normalize=false are not guaranteed to be sorted or disjoint;
+     * lookups in such a SpanSet fall back to a linear scan.
+     */
+    _rowOffsets.clear();
+    _sorted = true;
+    for (std::size_t i = 1; i < _spanVector.size(); ++i) {
+        Span const& prev = _spanVector[i - 1];
+        Span const& next = _spanVector[i];
+        if (prev.getY() > next.getY() || (prev.getY() == next.getY() && prev.getMaxX() >= next.getMinX())) {
+            _sorted = false;
+            return;
+        }
+    }
+    // A table with one entry per row is only worth its memory if most rows contain a Span; otherwise
+    // the whole vector is binary searched, which is still logarithmic.
+    std::size_t const height = _bbox.isEmpty() ? 0 : _bbox.getHeight();
+    if (height == 0 || height > 4 * _spanVector.size()) {
+        return;
+    }
+    _rowOffsets.reserve(height + 1);
+    std::size_t i = 0;
+    for (int y = _bbox.getMinY(); y <= _bbox.getMaxY(); ++y) {
+        while (i < _spanVector.size() && _spanVector[i].getY() < y) {
+            ++i;
+        }
+        _rowOffsets.push_back(i);
+    }
+    _rowOffsets.push_back(_spanVector.size());
+}
+
+Span const* SpanSet::_findSpan(lsst::geom::Point2I const& point) const {
+    if (!_bbox.contains(point)) {
+        return nullptr;
+    }
+    if (!_sorted) {
+        for (auto const& spn : _spanVector) {
+            if (spn.contains(point)) {
+                return &spn;
+            }
+        }
+        return nullptr;
+    }
+    auto first = _spanVector.begin();
+    auto last = _spanVector.end();
+    if (!_rowOffsets.empty()) {
+        std::size_t const row = point.getY() - _bbox.getMinY();
+        last = first + _rowOffsets[row + 1];
+        first += _rowOffsets[row];
+    }
+    // Find the last Span that starts at or before the point; it is the only one that can contain it
+    auto iter = std::upper_bound(first, last, point, [](lsst::geom::Point2I const& p, Span const& spn) {
+        return p.getY() < spn.getY() || (p.getY() == spn.getY() && p.getX() < spn.getMinX());
+    });
+    if (iter == first) {
+        return nullptr;
+    }
+    --iter;
+    return iter->contains(point) ? &(*iter) : nullptr;
 }
 
 // Getter for the area property
@@ -490,15 +557,7 @@ bool SpanSet::contains(SpanSet const& other) const {
     return true;
 }
 
-bool SpanSet::contains(lsst::geom::Point2I const& point) const {
-    // Check to see if a given point is found within any spans in this
-    for (auto& spn : _spanVector) {
-        if (spn.contains(point)) {
-            return true;
-        }
-    }
-    return false;
-}
+bool SpanSet::contains(lsst::geom::Point2I const& point) const { return _findSpan(point) != nullptr; }
 
 lsst::geom::Point2D SpanSet::computeCentroid() const {
     // Find the centroid of the SpanSet
@@ -864,42 +923,56 @@ std::shared_ptr<SpanSet> SpanSet::transformedBy(TransformPoint2ToPoint2 const& t
     }
 
     lsst::geom::Box2I newBBoxI(newBBoxD);
-
-    std::vector<lsst::geom::Point2D> newBoxPoints;
-    newBoxPoints.reserve(newBBoxI.getWidth());
     std::vector<Span> tempVec;
-    for (int y = newBBoxI.getBeginY(); y < newBBoxI.getEndY(); ++y) {
-        bool inSpan = false;  // Are we in a span?
-        int start = -1;       // Start of span
+    if (newBBoxI.isEmpty() || empty()) {
+        return std::make_shared<SpanSet>(std::move(tempVec));
+    }
 
-        // vectorize one row at a time (vectorizing the whole bbox would further improve performance
-        // but could lead to memory issues for very large bounding boxes)
+    // Map several rows at a time to amortize the overhead of each call to the transform, while keeping
+    // the temporary point vectors small for very large bounding boxes.
+    int const width = newBBoxI.getWidth();
+    int const rowsPerBatch = std::max(1, MAX_TRANSFORM_BATCH / width);
+    std::vector<lsst::geom::Point2D> newBoxPoints;
+    newBoxPoints.reserve(static_cast<std::size_t>(rowsPerBatch) * width);
+    for (int yBatch = newBBoxI.getBeginY(); yBatch < newBBoxI.getEndY(); yBatch += rowsPerBatch) {
+        int const yBatchEnd = std::min(yBatch + rowsPerBatch, newBBoxI.getEndY());
         newBoxPoints.clear();
-        for (int x = newBBoxI.getBeginX(); x < newBBoxI.getEndX(); ++x) {
-            newBoxPoints.emplace_back(lsst::geom::Point2D(x, y));
+        for (int y = yBatch; y < yBatchEnd; ++y) {
+            for (int x = newBBoxI.getBeginX(); x < newBBoxI.getEndX(); ++x) {
+                newBoxPoints.emplace_back(lsst::geom::Point2D(x, y));
+            }
         }
         auto oldBoxPoints = t.applyInverse(newBoxPoints);
         auto oldBoxPointIter = oldBoxPoints.cbegin();
-        for (int x = newBBoxI.getBeginX(); x < newBBoxI.getEndX(); ++x, ++oldBoxPointIter) {
-            auto p = *oldBoxPointIter;
-            int const xSource = std::floor(0.5 + p.getX());
-            int const ySource = std::floor(0.5 + p.getY());
-
-            if (contains(lsst::geom::Point2I(xSource, ySource))) {
-                if (!inSpan) {
-                    inSpan = true;
-                    start = x;
+        for (int y = yBatch; y < yBatchEnd; ++y) {
+            bool inSpan = false;  // Are we in a span?
+            int start = -1;       // Start of span
+            // Neighbouring pixels of a row usually map into the same source Span, so check the last one
+            // found before searching for another.
+            Span const* source = nullptr;
+            for (int x = newBBoxI.getBeginX(); x < newBBoxI.getEndX(); ++x, ++oldBoxPointIter) {
+                auto p = *oldBoxPointIter;
+                lsst::geom::Point2I const sourcePoint(std::floor(0.5 + p.getX()), std::floor(0.5 + p.getY()));
+                if (source == nullptr || !source->contains(sourcePoint)) {
+                    source = _findSpan(sourcePoint);
+                }
+                if (source != nullptr) {
+                    if (!inSpan) {
+                        inSpan = true;
+                        start = x;
+                    }
+                } else if (inSpan) {
+                    inSpan = false;
+                    tempVec.push_back(Span(y, start, x - 1));
                 }
-            } else if (inSpan) {
-                inSpan = false;
-                tempVec.push_back(Span(y, start, x - 1));
             }
-        }
-        if (inSpan) {
-            tempVec.push_back(Span(y, start, newBBoxI.getMaxX()));
+            if (inSpan) {
+                tempVec.push_back(Span(y, start, newBBoxI.getMaxX()));
+            }
         }
     }
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    // Spans were generated in order and never touch, so they are already normalized
+    return std::make_shared<SpanSet>(std::move(tempVec), false);
 }
 
 template <typename ImageT>
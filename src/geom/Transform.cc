@@ -45,7 +45,8 @@ template <class FromEndpoint, class ToEndpoint>
 Transform<FromEndpoint, ToEndpoint>::Transform(ast::Mapping const &mapping, bool simplify)
         : _fromEndpoint(mapping.getNIn()),
           _mapping(simplify ? mapping.simplified() : mapping.copy()),
-          _toEndpoint(mapping.getNOut()) {}
+          _toEndpoint(mapping.getNOut()),
+          _threadMapping(detail::ThreadLocalMapping::make(_mapping)) {}
 
 template <typename FromEndpoint, typename ToEndpoint>
 Transform<FromEndpoint, ToEndpoint>::Transform(ast::FrameSet const &frameSet, bool simplify)
@@ -69,17 +70,21 @@ Transform<FromEndpoint, ToEndpoint>::Transform(ast::FrameSet const &frameSet, bo
     frameSetCopy->setBase(baseIndex);
     frameSetCopy->setCurrent(currentIndex);
     _mapping = simplify ? frameSetCopy->getMapping()->simplified() : frameSetCopy->getMapping();
+    _threadMapping = detail::ThreadLocalMapping::make(_mapping);
 }
 
 template <typename FromEndpoint, typename ToEndpoint>
 Transform<FromEndpoint, ToEndpoint>::Transform(std::shared_ptr<ast::Mapping> mapping)
-        : _fromEndpoint(mapping->getNIn()), _mapping(mapping), _toEndpoint(mapping->getNOut()) {}
+        : _fromEndpoint(mapping->getNIn()),
+          _mapping(mapping),
+          _toEndpoint(mapping->getNOut()),
+          _threadMapping(detail::ThreadLocalMapping::make(_mapping)) {}
 
 template <class FromEndpoint, class ToEndpoint>
 typename ToEndpoint::Point Transform<FromEndpoint, ToEndpoint>::applyForward(
         typename FromEndpoint::Point const &point) const {
     auto const rawFromData = _fromEndpoint.dataFromPoint(point);
-    auto rawToData = _mapping->applyForward(rawFromData);
+    auto rawToData = _threadMapping->get().applyForward(rawFromData);
     return _toEndpoint.pointFromData(rawToData);
 }
 
@@ -87,7 +92,7 @@ template <class FromEndpoint, class ToEndpoint>
 typename ToEndpoint::Array Transform<FromEndpoint, ToEndpoint>::applyForward(
         typename FromEndpoint::Array const &array) const {
     auto const rawFromData = _fromEndpoint.dataFromArray(array);
-    auto rawToData = _mapping->applyForward(rawFromData);
+    auto rawToData = _threadMapping->get().applyForward(rawFromData);
     return _toEndpoint.arrayFromData(rawToData);
 }
 
@@ -95,7 +100,7 @@ template <class FromEndpoint, class ToEndpoint>
 typename FromEndpoint::Point Transform<FromEndpoint, ToEndpoint>::applyInverse(
         typename ToEndpoint::Point const &point) const {
     auto const rawFromData = _toEndpoint.dataFromPoint(point);
-    auto rawToData = _mapping->applyInverse(rawFromData);
+    auto rawToData = _threadMapping->get().applyInverse(rawFromData);
     return _fromEndpoint.pointFromData(rawToData);
 }
 
@@ -103,13 +108,44 @@ template <class FromEndpoint, class ToEndpoint>
 typename FromEndpoint::Array Transform<FromEndpoint, ToEndpoint>::applyInverse(
         typename ToEndpoint::Array const &array) const {
     auto const rawFromData = _toEndpoint.dataFromArray(array);
-    auto rawToData = _mapping->applyInverse(rawFromData);
+    auto rawToData = _threadMapping->get().applyInverse(rawFromData);
     return _fromEndpoint.arrayFromData(rawToData);
 }
 
+namespace {
+
+void checkRawShapes(ndarray::Array<double const, 2, 2> const &input, int nInputAxes,
+                    ndarray::Array<double, 2, 2> const &output, int nOutputAxes) {
+    if (input.getSize<0>() != static_cast<std::size_t>(nInputAxes) ||
+        output.getSize<0>() != static_cast<std::size_t>(nOutputAxes) ||
+        input.getSize<1>() != output.getSize<1>()) {
+        std::ostringstream buffer;
+        buffer << "Raw data shapes (" << input.getSize<0>() << ", " << input.getSize<1>() << ") and ("
+               << output.getSize<0>() << ", " << output.getSize<1>() << ") do not match (" << nInputAxes
+               << ", N) and (" << nOutputAxes << ", N)";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, buffer.str());
+    }
+}
+
+}  // namespace
+
+template <class FromEndpoint, class ToEndpoint>
+void Transform<FromEndpoint, ToEndpoint>::applyForward(ndarray::Array<double const, 2, 2> const &rawFrom,
+                                                       ndarray::Array<double, 2, 2> const &rawTo) const {
+    checkRawShapes(rawFrom, _fromEndpoint.getNAxes(), rawTo, _toEndpoint.getNAxes());
+    _threadMapping->get().applyForward(rawFrom, rawTo);
+}
+
+template <class FromEndpoint, class ToEndpoint>
+void Transform<FromEndpoint, ToEndpoint>::applyInverse(ndarray::Array<double const, 2, 2> const &rawTo,
+                                                       ndarray::Array<double, 2, 2> const &rawFrom) const {
+    checkRawShapes(rawTo, _toEndpoint.getNAxes(), rawFrom, _fromEndpoint.getNAxes());
+    _threadMapping->get().applyInverse(rawTo, rawFrom);
+}
+
 template <class FromEndpoint, class ToEndpoint>
 std::shared_ptr<Transform<ToEndpoint, FromEndpoint>> Transform<FromEndpoint, ToEndpoint>::inverted() const {
-    auto inverse = std::dynamic_pointer_cast<ast::Mapping>(_mapping->inverted());
+    auto inverse = std::dynamic_pointer_cast<ast::Mapping>(_threadMapping->get().inverted());
     if (!inverse) {
         // don't throw std::bad_cast because it doesn't let you provide debugging info
         std::ostringstream buffer;
@@ -124,11 +160,12 @@ Eigen::MatrixXd Transform<FromEndpoint, ToEndpoint>::getJacobian(FromPoint const
     int const nIn = _fromEndpoint.getNAxes();
     int const nOut = _toEndpoint.getNAxes();
     std::vector<double> const point = _fromEndpoint.dataFromPoint(x);
+    ast::Mapping const &mapping = _threadMapping->get();
 
     Eigen::MatrixXd jacobian(nOut, nIn);
     for (int i = 0; i < nOut; ++i) {
         for (int j = 0; j < nIn; ++j) {
-            jacobian(i, j) = _mapping->rate(point, i + 1, j + 1);
+            jacobian(i, j) = mapping.rate(point, i + 1, j + 1);
         }
     }
     return jacobian;
@@ -0,0 +1,257 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/geom/TransformApproximation.h"
+#include "lsst/afw/table/aggregates.h"
+#include "lsst/afw/table/io/CatalogVector.h"
+#include "lsst/afw/table/io/InputArchive.h"
+#include "lsst/afw/table/io/OutputArchive.h"
+#include "lsst/afw/table/io/Persistable.cc"
+
+namespace lsst {
+namespace afw {
+
+template std::shared_ptr<geom::TransformApproximation> table::io::PersistableFacade<
+        geom::TransformApproximation>::dynamicCast(std::shared_ptr<table::io::Persistable> const &);
+
+namespace geom {
+
+namespace {
+
+// Fraction of the forward transform's range by which the inverse's domain is grown, so points just
+// outside the image of the input bbox are still interpolated rather than extrapolated.
+double const INVERSE_MARGIN = 0.02;
+
+TransformApproximation::Function makeForwardFunction(TransformPoint2ToPoint2 const &transform) {
+    return [&transform](std::vector<lsst::geom::Point2D> const &points) {
+        return transform.applyForward(points);
+    };
+}
+
+TransformApproximation::Function makeInverseFunction(TransformPoint2ToPoint2 const &transform) {
+    if (!transform.hasInverse()) {
+        return TransformApproximation::Function();
+    }
+    return [&transform](std::vector<lsst::geom::Point2D> const &points) {
+        return transform.applyInverse(points);
+    };
+}
+
+std::shared_ptr<detail::ChebyshevPatches const> approximateInverse(
+        TransformApproximation::Function const &inverse, detail::ChebyshevPatches const &forward,
+        double tolerance, int order, int maxLevel) {
+    if (!inverse) {
+        return nullptr;
+    }
+    lsst::geom::Box2D range = forward.getRange();
+    range.grow(lsst::geom::Extent2D(INVERSE_MARGIN * range.getWidth(), INVERSE_MARGIN * range.getHeight()));
+    return std::make_shared<detail::ChebyshevPatches>(inverse, range, tolerance, order, maxLevel);
+}
+
+}  // namespace
+
+TransformApproximation::TransformApproximation(TransformPoint2ToPoint2 const &transform,
+                                               lsst::geom::Box2D const &bbox, double tolerance, int order,
+                                               int maxLevel)
+        : TransformApproximation(makeForwardFunction(transform), makeInverseFunction(transform), bbox,
+                                 tolerance, order, maxLevel) {}
+
+TransformApproximation::TransformApproximation(Function const &forward, Function const &inverse,
+                                               lsst::geom::Box2D const &bbox, double tolerance, int order,
+                                               int maxLevel)
+        : _forward(forward, bbox, tolerance, order, maxLevel),
+          _inverse(approximateInverse(inverse, _forward, tolerance, order, maxLevel)) {}
+
+TransformApproximation::TransformApproximation(detail::ChebyshevPatches forward,
+                                               std::shared_ptr<detail::ChebyshevPatches const> inverse)
+        : _forward(std::move(forward)), _inverse(std::move(inverse)) {
+    if (_inverse && _inverse->getOrder() != _forward.getOrder()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Forward and inverse approximations must have the same order.");
+    }
+}
+
+lsst::geom::Point2D TransformApproximation::applyInverse(lsst::geom::Point2D const &point) const {
+    if (!_inverse) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Approximation has no inverse.");
+    }
+    return _inverse->apply(point);
+}
+
+std::vector<lsst::geom::Point2D> TransformApproximation::applyInverse(
+        std::vector<lsst::geom::Point2D> const &points) const {
+    if (!_inverse) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Approximation has no inverse.");
+    }
+    return _inverse->apply(points);
+}
+
+lsst::geom::Box2D TransformApproximation::getOutputBBox() const {
+    return _inverse ? _inverse->getBBox() : lsst::geom::Box2D();
+}
+
+double TransformApproximation::getMaxInverseError() const {
+    return _inverse ? _inverse->getMaxError() : std::numeric_limits<double>::quiet_NaN();
+}
+
+// ------------------ persistence ---------------------------------------------------------------------------
+
+namespace {
+
+// One record for each of the forward and (optional) inverse approximations.
+struct ApproximationPersistenceHelper {
+    table::Schema schema;
+    table::Key<int> order;
+    table::Key<double> maxError;
+    table::Box2DKey bbox;
+
+    static ApproximationPersistenceHelper const &get() {
+        static ApproximationPersistenceHelper const instance;
+        return instance;
+    }
+
+private:
+    ApproximationPersistenceHelper()
+            : schema(),
+              order(schema.addField<int>("order", "order of the Chebyshev polynomials")),
+              maxError(schema.addField<double>("max_error", "largest error found in validation")),
+              bbox(table::Box2DKey::addFields(schema, "bbox", "domain of the approximation", "")) {}
+};
+
+// One record for each patch.
+struct PatchPersistenceHelper {
+    table::Schema schema;
+    table::Key<int> approximation;
+    table::Key<int> level;
+    table::Box2DKey bbox;
+    table::Key<table::Array<double>> coefficients;
+
+    explicit PatchPersistenceHelper(int nCoefficients)
+            : schema(),
+              approximation(schema.addField<int>("approximation", "0 for forward, 1 for inverse")),
+              level(schema.addField<int>("level", "number of times the domain was split")),
+              bbox(table::Box2DKey::addFields(schema, "bbox", "domain of the patch", "")),
+              coefficients(schema.addField<table::Array<double>>(
+                      "coefficients", "Chebyshev coefficients for x, then y, each ordered by y then x",
+                      2 * nCoefficients)) {}
+
+    explicit PatchPersistenceHelper(table::Schema const &s)
+            : schema(s),
+              approximation(s["approximation"]),
+              level(s["level"]),
+              bbox(s["bbox"]),
+              coefficients(s["coefficients"]) {}
+};
+
+void writePatches(detail::ChebyshevPatches const &patches, int index, PatchPersistenceHelper const &keys,
+                  table::BaseCatalog &catalog) {
+    for (auto const &patch : patches.getPatches()) {
+        std::shared_ptr<table::BaseRecord> record = catalog.addNew();
+        record->set(keys.approximation, index);
+        record->set(keys.level, patch.level);
+        record->set(keys.bbox, patch.bbox);
+        auto coefficients = (*record)[keys.coefficients];
+        std::copy(patch.xCoefficients.begin(), patch.xCoefficients.end(), coefficients.begin());
+        std::copy(patch.yCoefficients.begin(), patch.yCoefficients.end(),
+                  coefficients.begin() + patch.xCoefficients.size());
+    }
+}
+
+class TransformApproximationFactory : public table::io::PersistableFactory {
+public:
+    explicit TransformApproximationFactory(std::string const &name)
+            : afw::table::io::PersistableFactory(name) {}
+
+    std::shared_ptr<table::io::Persistable> read(InputArchive const &archive,
+                                                 CatalogVector const &catalogs) const override {
+        LSST_ARCHIVE_ASSERT(catalogs.size() == 2u);
+        table::BaseCatalog const &approximations = catalogs[0];
+        table::BaseCatalog const &patches = catalogs[1];
+        LSST_ARCHIVE_ASSERT(approximations.size() == 1u || approximations.size() == 2u);
+        auto const &approximationKeys = ApproximationPersistenceHelper::get();
+        LSST_ARCHIVE_ASSERT(approximations.getSchema() == approximationKeys.schema);
+        PatchPersistenceHelper const patchKeys(patches.getSchema());
+        std::vector<std::vector<detail::ChebyshevPatches::Patch>> patchLists(approximations.size());
+        for (auto const &record : patches) {
+            std::size_t const index = record.get(patchKeys.approximation);
+            LSST_ARCHIVE_ASSERT(index < patchLists.size());
+            auto const coefficients = record.get(patchKeys.coefficients);
+            std::size_t const half = coefficients.getSize<0>() / 2;
+            detail::ChebyshevPatches::Patch patch = {
+                    record.get(patchKeys.bbox), record.get(patchKeys.level),
+                    std::vector<double>(coefficients.begin(), coefficients.begin() + half),
+                    std::vector<double>(coefficients.begin() + half, coefficients.end())};
+            patchLists[index].push_back(std::move(patch));
+        }
+        std::vector<std::shared_ptr<detail::ChebyshevPatches const>> results;
+        for (std::size_t i = 0; i < approximations.size(); ++i) {
+            table::BaseRecord const &record = approximations[i];
+            results.push_back(std::make_shared<detail::ChebyshevPatches>(
+                    record.get(approximationKeys.bbox), record.get(approximationKeys.order),
+                    record.get(approximationKeys.maxError), std::move(patchLists[i])));
+        }
+        return std::make_shared<TransformApproximation>(*results[0],
+                                                        results.size() > 1 ? results[1] : nullptr);
+    }
+};
+
+std::string getTransformApproximationPersistenceName() { return "TransformApproximation"; }
+
+TransformApproximationFactory registration(getTransformApproximationPersistenceName());
+
+}  // namespace
+
+std::string TransformApproximation::getPersistenceName() const {
+    return getTransformApproximationPersistenceName();
+}
+
+std::string TransformApproximation::getPythonModule() const { return "lsst.afw.geom"; }
+
+void TransformApproximation::write(OutputArchiveHandle &handle) const {
+    auto const &approximationKeys = ApproximationPersistenceHelper::get();
+    table::BaseCatalog approximations = handle.makeCatalog(approximationKeys.schema);
+    PatchPersistenceHelper const patchKeys((getOrder() + 1) * (getOrder() + 1));
+    table::BaseCatalog patches = handle.makeCatalog(patchKeys.schema);
+    std::vector<detail::ChebyshevPatches const *> parts = {&_forward};
+    if (_inverse) {
+        parts.push_back(_inverse.get());
+    }
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        std::shared_ptr<table::BaseRecord> record = approximations.addNew();
+        record->set(approximationKeys.order, parts[i]->getOrder());
+        record->set(approximationKeys.maxError, parts[i]->getMaxError());
+        record->set(approximationKeys.bbox, parts[i]->getBBox());
+        writePatches(*parts[i], i, patchKeys, patches);
+    }
+    handle.saveCatalog(approximations);
+    handle.saveCatalog(patches);
+}
+
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
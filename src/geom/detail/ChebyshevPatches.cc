@@ -0,0 +1,311 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/geom/detail/ChebyshevPatches.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+namespace {
+
+// Number of points per chunk when evaluating many points in parallel.
+std::size_t const CHUNK_SIZE = 4096;
+
+// Fill t[0], ..., t[n-1] with the Chebyshev polynomials T_0(u), ..., T_{n-1}(u).
+inline void evaluateBasis(double u, int n, double *t) {
+    t[0] = 1.0;
+    if (n > 1) t[1] = u;
+    for (int j = 2; j < n; ++j) {
+        t[j] = 2.0 * u * t[j - 1] - t[j - 2];
+    }
+}
+
+// Zeros of T_n, the interpolation nodes of each patch.
+std::vector<double> makeNodes(int n) {
+    std::vector<double> nodes(n);
+    for (int a = 0; a < n; ++a) {
+        nodes[a] = std::cos(M_PI * (a + 0.5) / n);
+    }
+    return nodes;
+}
+
+// A uniform grid of 2n + 1 points on [-1, 1], which interleaves the nodes and includes the edges of
+// each patch; used to measure the error of the interpolant.
+std::vector<double> makeCheckPoints(int n) {
+    std::vector<double> points(2 * n + 1);
+    for (int a = 0; a <= 2 * n; ++a) {
+        points[a] = -1.0 + a / static_cast<double>(n);
+    }
+    return points;
+}
+
+// Update a running maximum, letting NaN (from a failed evaluation of the true function) win.
+inline void updateMaxError(double &maxError, double error) {
+    if (!std::isnan(maxError) && !(error <= maxError)) {
+        maxError = error;
+    }
+}
+
+// Points at which a patch is evaluated: the interpolation nodes, then the check points.
+void appendPatchPoints(lsst::geom::Box2D const &bbox, std::vector<double> const &nodes,
+                       std::vector<double> const &checks, std::vector<lsst::geom::Point2D> &points) {
+    double const cx = bbox.getCenterX(), cy = bbox.getCenterY();
+    double const hx = 0.5 * bbox.getWidth(), hy = 0.5 * bbox.getHeight();
+    for (double v : nodes) {
+        for (double u : nodes) {
+            points.emplace_back(cx + hx * u, cy + hy * v);
+        }
+    }
+    for (double v : checks) {
+        for (double u : checks) {
+            points.emplace_back(cx + hx * u, cy + hy * v);
+        }
+    }
+}
+
+// Compute interpolating coefficients from values at the nodes, using the discrete orthogonality of
+// the Chebyshev polynomials at the zeros of T_n.  basis[a*n + j] is T_j(nodes[a]).
+void fitCoefficients(lsst::geom::Point2D const *values, std::vector<double> const &basis, int n,
+                     std::vector<double> &xCoefficients, std::vector<double> &yCoefficients) {
+    // First transform along x for each row of nodes, then along y.
+    std::vector<double> gx(n * n, 0.0), gy(n * n, 0.0);
+    for (int b = 0; b < n; ++b) {
+        for (int a = 0; a < n; ++a) {
+            lsst::geom::Point2D const &value = values[b * n + a];
+            double const *t = &basis[a * n];
+            for (int j = 0; j < n; ++j) {
+                gx[b * n + j] += value.getX() * t[j];
+                gy[b * n + j] += value.getY() * t[j];
+            }
+        }
+    }
+    xCoefficients.assign(n * n, 0.0);
+    yCoefficients.assign(n * n, 0.0);
+    for (int b = 0; b < n; ++b) {
+        double const *t = &basis[b * n];
+        for (int k = 0; k < n; ++k) {
+            for (int j = 0; j < n; ++j) {
+                xCoefficients[k * n + j] += gx[b * n + j] * t[k];
+                yCoefficients[k * n + j] += gy[b * n + j] * t[k];
+            }
+        }
+    }
+    double const norm = 4.0 / (n * n);
+    for (int k = 0; k < n; ++k) {
+        for (int j = 0; j < n; ++j) {
+            double const factor = norm * (j == 0 ? 0.5 : 1.0) * (k == 0 ? 0.5 : 1.0);
+            xCoefficients[k * n + j] *= factor;
+            yCoefficients[k * n + j] *= factor;
+        }
+    }
+}
+
+struct Candidate {
+    lsst::geom::Box2D bbox;
+    int level;
+};
+
+}  // namespace
+
+ChebyshevPatches::ChebyshevPatches(Function const &function, lsst::geom::Box2D const &bbox, double tolerance,
+                                   int order, int maxLevel)
+        : _bbox(bbox), _range(), _order(order), _maxError(0.0) {
+    if (bbox.isEmpty() || bbox.getArea() <= 0.0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Cannot approximate over an empty box.");
+    }
+    if (!(tolerance > 0.0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Tolerance must be positive.");
+    }
+    if (order < 0 || order > MAX_ORDER) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Order %d not in [0, %d].") % order % MAX_ORDER).str());
+    }
+    if (maxLevel < 0 || maxLevel > MAX_LEVEL) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Maximum level %d not in [0, %d].") % maxLevel % MAX_LEVEL).str());
+    }
+    int const n = order + 1;
+    std::vector<double> const nodes = makeNodes(n);
+    std::vector<double> const checks = makeCheckPoints(n);
+    std::vector<double> basis(n * n);
+    for (int a = 0; a < n; ++a) {
+        evaluateBasis(nodes[a], n, &basis[a * n]);
+    }
+    std::size_t const nFit = n * n;
+    std::size_t const nPoints = nFit + checks.size() * checks.size();
+
+    // Refine breadth-first, evaluating the true function once per level for all candidate patches.
+    std::vector<Candidate> candidates = {{bbox, 0}};
+    while (!candidates.empty()) {
+        std::vector<lsst::geom::Point2D> points;
+        points.reserve(candidates.size() * nPoints);
+        for (auto const &candidate : candidates) {
+            appendPatchPoints(candidate.bbox, nodes, checks, points);
+        }
+        std::vector<lsst::geom::Point2D> const values = function(points);
+        if (values.size() != points.size()) {
+            throw LSST_EXCEPT(pex::exceptions::LengthError,
+                              "Function returned the wrong number of points.");
+        }
+        std::vector<Candidate> next;
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            Candidate const &candidate = candidates[i];
+            Patch patch = {candidate.bbox, candidate.level, {}, {}};
+            fitCoefficients(&values[i * nPoints], basis, n, patch.xCoefficients, patch.yCoefficients);
+            double error = 0.0;
+            for (std::size_t k = 0; k < nPoints; ++k) {
+                lsst::geom::Point2D const &value = values[i * nPoints + k];
+                if (std::isfinite(value.getX()) && std::isfinite(value.getY())) {
+                    _range.include(value);
+                }
+                if (k >= nFit) {
+                    lsst::geom::Point2D const approx = _evaluate(patch, points[i * nPoints + k]);
+                    updateMaxError(error, std::hypot(approx.getX() - value.getX(),
+                                                     approx.getY() - value.getY()));
+                }
+            }
+            if (!(error <= tolerance) && candidate.level < maxLevel) {
+                double const xMid = candidate.bbox.getCenterX(), yMid = candidate.bbox.getCenterY();
+                lsst::geom::Point2D const min = candidate.bbox.getMin(), max = candidate.bbox.getMax();
+                int const level = candidate.level + 1;
+                next.push_back({lsst::geom::Box2D(min, lsst::geom::Point2D(xMid, yMid)), level});
+                next.push_back({lsst::geom::Box2D(lsst::geom::Point2D(xMid, min.getY()),
+                                                  lsst::geom::Point2D(max.getX(), yMid)),
+                                level});
+                next.push_back({lsst::geom::Box2D(lsst::geom::Point2D(min.getX(), yMid),
+                                                  lsst::geom::Point2D(xMid, max.getY())),
+                                level});
+                next.push_back({lsst::geom::Box2D(lsst::geom::Point2D(xMid, yMid), max), level});
+            } else {
+                updateMaxError(_maxError, error);
+                _patches.push_back(std::move(patch));
+            }
+        }
+        candidates.swap(next);
+    }
+    _buildCells();
+}
+
+ChebyshevPatches::ChebyshevPatches(lsst::geom::Box2D const &bbox, int order, double maxError,
+                                   std::vector<Patch> patches)
+        : _bbox(bbox), _range(), _order(order), _maxError(maxError), _patches(std::move(patches)) {
+    if (bbox.isEmpty() || order < 0 || order > MAX_ORDER) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Invalid bbox or order for patches.");
+    }
+    std::size_t const nCoefficients = (order + 1) * (order + 1);
+    for (auto const &patch : _patches) {
+        if (patch.level < 0 || patch.level > MAX_LEVEL || patch.xCoefficients.size() != nCoefficients ||
+            patch.yCoefficients.size() != nCoefficients) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Inconsistent patch.");
+        }
+    }
+    _buildCells();
+}
+
+void ChebyshevPatches::_buildCells() {
+    int maxLevel = 0;
+    for (auto const &patch : _patches) {
+        maxLevel = std::max(maxLevel, patch.level);
+    }
+    _nCells = 1 << maxLevel;
+    _cellScaleX = _nCells / _bbox.getWidth();
+    _cellScaleY = _nCells / _bbox.getHeight();
+    _cells.assign(_nCells * _nCells, -1);
+    for (std::size_t i = 0; i < _patches.size(); ++i) {
+        Patch const &patch = _patches[i];
+        int const span = 1 << (maxLevel - patch.level);
+        int const x0 = std::lround((patch.bbox.getMinX() - _bbox.getMinX()) * _cellScaleX);
+        int const y0 = std::lround((patch.bbox.getMinY() - _bbox.getMinY()) * _cellScaleY);
+        if (x0 < 0 || y0 < 0 || x0 + span > _nCells || y0 + span > _nCells) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Patch does not lie within the bbox.");
+        }
+        for (int y = y0; y < y0 + span; ++y) {
+            auto const row = _cells.begin() + y * _nCells;
+            std::fill(row + x0, row + x0 + span, static_cast<int>(i));
+        }
+    }
+    if (std::find(_cells.begin(), _cells.end(), -1) != _cells.end()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Patches do not cover the bbox.");
+    }
+}
+
+lsst::geom::Point2D ChebyshevPatches::_evaluate(Patch const &patch, lsst::geom::Point2D const &point) const {
+    int const n = _order + 1;
+    double tx[MAX_ORDER + 1], ty[MAX_ORDER + 1];
+    evaluateBasis(2.0 * (point.getX() - patch.bbox.getCenterX()) / patch.bbox.getWidth(), n, tx);
+    evaluateBasis(2.0 * (point.getY() - patch.bbox.getCenterY()) / patch.bbox.getHeight(), n, ty);
+    double const *cx = patch.xCoefficients.data();
+    double const *cy = patch.yCoefficients.data();
+    double x = 0.0, y = 0.0;
+    for (int k = 0; k < n; ++k) {
+        double rowX = 0.0, rowY = 0.0;
+        for (int j = 0; j < n; ++j) {
+            rowX += cx[k * n + j] * tx[j];
+            rowY += cy[k * n + j] * tx[j];
+        }
+        x += rowX * ty[k];
+        y += rowY * ty[k];
+    }
+    return lsst::geom::Point2D(x, y);
+}
+
+lsst::geom::Point2D ChebyshevPatches::apply(lsst::geom::Point2D const &point) const {
+    double const u = (point.getX() - _bbox.getMinX()) * _cellScaleX;
+    double const v = (point.getY() - _bbox.getMinY()) * _cellScaleY;
+    if (!(std::isfinite(u) && std::isfinite(v))) {
+        double const nan = std::numeric_limits<double>::quiet_NaN();
+        return lsst::geom::Point2D(nan, nan);
+    }
+    // Clamp before converting to int, so points far outside the bbox use the nearest patch.
+    int const ix = static_cast<int>(std::min(std::max(u, 0.0), _nCells - 1.0));
+    int const iy = static_cast<int>(std::min(std::max(v, 0.0), _nCells - 1.0));
+    return _evaluate(_patches[_cells[iy * _nCells + ix]], point);
+}
+
+std::vector<lsst::geom::Point2D> ChebyshevPatches::apply(
+        std::vector<lsst::geom::Point2D> const &points) const {
+    std::vector<lsst::geom::Point2D> result(points.size());
+    std::size_t const nChunks = (points.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    lsst::afw::detail::parallelFor(0, nChunks, [this, &points, &result](std::size_t chunk) {
+        std::size_t const end = std::min(points.size(), (chunk + 1) * CHUNK_SIZE);
+        for (std::size_t i = chunk * CHUNK_SIZE; i < end; ++i) {
+            result[i] = apply(points[i]);
+        }
+    });
+    return result;
+}
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,116 @@
+// -*- lsst-c++ -*-
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/geom/detail/ThreadLocalMapping.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+namespace {
+
+struct CopyEntry {
+    std::weak_ptr<ThreadLocalMapping const> owner;
+    std::shared_ptr<ast::Mapping const> copy;
+};
+
+struct ThreadCopies {
+    std::unordered_map<std::uint64_t, CopyEntry> copies;  // keyed by ThreadLocalMapping ID
+    std::size_t pruneSize = MIN_PRUNE_SIZE;               // size at which to next release dead copies
+
+    static constexpr std::size_t MIN_PRUNE_SIZE = 16;
+
+    // Add a copy, first releasing copies of mappings that no longer exist if the table has doubled
+    // in size since that was last done, so that the cost of pruning is amortized over many additions.
+    void add(std::uint64_t id, std::weak_ptr<ThreadLocalMapping const> owner,
+             std::shared_ptr<ast::Mapping const> copy) {
+        if (copies.size() >= pruneSize) {
+            for (auto i = copies.begin(); i != copies.end();) {
+                if (i->second.owner.expired()) {
+                    i = copies.erase(i);
+                } else {
+                    ++i;
+                }
+            }
+            pruneSize = std::max(MIN_PRUNE_SIZE, 2 * copies.size());
+        }
+        copies.emplace(id, CopyEntry{std::move(owner), std::move(copy)});
+    }
+};
+
+constexpr std::size_t ThreadCopies::MIN_PRUNE_SIZE;
+
+// Copies of mappings made by or for the calling thread.
+ThreadCopies &getThreadCopies() {
+    thread_local ThreadCopies copies;
+    return copies;
+}
+
+std::atomic<std::uint64_t> nextId(0);
+
+// Serializes reads of prototype mappings by threads making copies.
+std::mutex copyMutex;
+
+}  // namespace
+
+std::shared_ptr<ThreadLocalMapping const> ThreadLocalMapping::make(
+        std::shared_ptr<ast::Mapping const> mapping) {
+    if (!mapping) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Mapping must not be null.");
+    }
+    // Until make() returns, no other thread can be copying this prototype, so this copy needs no lock.
+    std::shared_ptr<ast::Mapping const> copy = mapping->copy();
+    std::shared_ptr<ThreadLocalMapping const> result(new ThreadLocalMapping(std::move(mapping)));
+    getThreadCopies().add(result->_id, result, std::move(copy));
+    return result;
+}
+
+ThreadLocalMapping::ThreadLocalMapping(std::shared_ptr<ast::Mapping const> prototype)
+        : _prototype(std::move(prototype)), _id(nextId++) {}
+
+ast::Mapping const &ThreadLocalMapping::get() const {
+    auto &threadCopies = getThreadCopies();
+    auto const iter = threadCopies.copies.find(_id);
+    if (iter != threadCopies.copies.end()) {
+        return *iter->second.copy;
+    }
+    std::shared_ptr<ast::Mapping const> copy;
+    {
+        std::lock_guard<std::mutex> lock(copyMutex);
+        copy = _prototype->copy();
+    }
+    threadCopies.add(_id, shared_from_this(), copy);
+    return *copy;
+}
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
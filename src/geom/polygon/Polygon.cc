@@ -119,26 +119,137 @@ void addSubSampledEdge(std::vector<LsstPoint>& vertices,  // Vector of points to
     }
 }
 
-/// @internal Calculate area of overlap between polygon and pixel
-double pixelOverlap(BoostPolygon const& poly, int const x, int const y) {
-    std::vector<BoostPolygon> overlap;  // Overlap between pixel and polygon
-    LsstBox const pixel(lsst::geom::Point2D(x - 0.5, y - 0.5), lsst::geom::Point2D(x + 0.5, y + 0.5));
-    boost::geometry::intersection(poly, pixel, overlap);
-    double area = 0.0;
-    for (std::vector<BoostPolygon>::const_iterator i = overlap.begin(); i != overlap.end(); ++i) {
-        double const polyArea = boost::geometry::area(*i);
-        area += std::min(polyArea, 1.0);  // remove any rounding error
+/// @internal Fractional coverage below which a pixel is considered empty, and within which of unity
+/// it is considered full; absorbs round-off in the accumulated coverage.
+double const COVERAGE_EPSILON = 1.0e-10;
+
+/// @internal A non-horizontal polygon edge, in pixels from the lower-left corner of a bbox
+struct RasterEdge {
+    double u0, v0, u1, v1;
+
+    double getMinV() const { return std::min(v0, v1); }
+    double getMaxV() const { return std::max(v0, v1); }
+};
+
+/// @internal Add the edges of a ring to a list of edges to rasterize
+void addRingEdges(BoostPolygon::ring_type const& ring, double uOffset, double vOffset,
+                  std::vector<RasterEdge>& edges) {
+    for (std::size_t i = 0; i + 1 < ring.size(); ++i) {
+        RasterEdge const edge = {ring[i].getX() - uOffset, ring[i].getY() - vOffset,
+                                 ring[i + 1].getX() - uOffset, ring[i + 1].getY() - vOffset};
+        if (edge.v0 != edge.v1) {  // horizontal edges enclose no area
+            edges.push_back(edge);
+        }
     }
-    return area;
 }
 
-/// @internal Set each pixel in a row to the amount of overlap with polygon
-void pixelRowOverlap(std::shared_ptr<lsst::afw::image::Image<float>> const image, BoostPolygon const& poly,
-                     int const xStart, int const xStop, int const y) {
-    int x = xStart;
-    for (lsst::afw::image::Image<float>::x_iterator i = image->x_at(x - image->getX0(), y - image->getY0());
-         x <= xStop; ++i, ++x) {
-        *i = pixelOverlap(poly, x, y);
+/**
+ * @internal Accumulate the area to the right of a piece of an edge that lies within one pixel column
+ *
+ * `cover` holds the change in signed coverage from each pixel of a row to the next, so that the
+ * coverage of a pixel is the sum of the entries up to and including its own.
+ */
+void addEdgePiece(double uMid, double dv, int width, std::vector<double>& cover) {
+    if (uMid < 0.0) {
+        cover[0] += dv;
+        return;
+    }
+    int const column = static_cast<int>(uMid);
+    if (column >= width) {
+        return;
+    }
+    double const fraction = uMid - column;
+    cover[column] += dv * (1.0 - fraction);
+    cover[column + 1] += dv * fraction;
+}
+
+/// @internal Accumulate the part of an edge within row `row` (v in [row, row + 1])
+void addEdgeToRow(RasterEdge const& edge, int row, int width, std::vector<double>& cover) {
+    double const dudv = (edge.u1 - edge.u0) / (edge.v1 - edge.v0);
+    double const va = std::min(std::max(edge.v0, static_cast<double>(row)), row + 1.0);
+    double const vb = std::min(std::max(edge.v1, static_cast<double>(row)), row + 1.0);
+    double const ua = edge.u0 + (va - edge.v0) * dudv;
+    double const ub = edge.u0 + (vb - edge.v0) * dudv;
+    // Split the piece where it crosses pixel boundaries; pieces left of the bbox cover every pixel in
+    // the row and those right of it cover none, so only boundaries within the bbox matter.
+    double uPrev = ua, vPrev = va;
+    if (ua < ub) {
+        double const dvdu = (vb - va) / (ub - ua);
+        for (double u = std::max(std::floor(ua) + 1.0, 0.0); u < ub && u <= width; u += 1.0) {
+            double const v = va + (u - ua) * dvdu;
+            addEdgePiece(0.5 * (uPrev + u), v - vPrev, width, cover);
+            uPrev = u;
+            vPrev = v;
+        }
+    } else if (ua > ub) {
+        double const dvdu = (vb - va) / (ub - ua);
+        for (double u = std::min(std::ceil(ua) - 1.0, static_cast<double>(width)); u > ub && u >= 0.0;
+             u -= 1.0) {
+            double const v = va + (u - ua) * dvdu;
+            addEdgePiece(0.5 * (uPrev + u), v - vPrev, width, cover);
+            uPrev = u;
+            vPrev = v;
+        }
+    }
+    addEdgePiece(0.5 * (uPrev + ub), vb - vPrev, width, cover);
+}
+
+/**
+ * @internal Compute the exact fraction of each pixel in a bbox covered by a polygon
+ *
+ * This is a scanline rasterizer with an active edge table.  Each edge crossing a row contributes the
+ * area to its right within each pixel, which is exact because the edges are straight; the coverage
+ * of a pixel is then the running sum of the contributions along the row.  The cost is proportional to
+ * the number of pixels plus the number of pixel boundaries crossed by the edges, rather than a
+ * polygon intersection per pixel.
+ *
+ * @param poly  Polygon to rasterize.
+ * @param bbox  Pixels for which to compute the coverage.
+ * @param func  Called as `func(y, coverage)` for each row that intersects the polygon, in increasing
+ *              order of y, where `coverage[i]` is the fraction of pixel `bbox.getMinX() + i` covered.
+ */
+template <typename RowFunction>
+void rasterizePolygon(BoostPolygon const& poly, lsst::geom::Box2I const& bbox, RowFunction func) {
+    if (bbox.isEmpty()) {
+        return;
+    }
+    int const width = bbox.getWidth();
+    int const height = bbox.getHeight();
+    double const uOffset = bbox.getMinX() - 0.5;
+    double const vOffset = bbox.getMinY() - 0.5;
+    std::vector<RasterEdge> edges;
+    addRingEdges(poly.outer(), uOffset, vOffset, edges);
+    for (auto const& inner : poly.inners()) {
+        addRingEdges(inner, uOffset, vOffset, edges);
+    }
+    std::sort(edges.begin(), edges.end(),
+              [](RasterEdge const& a, RasterEdge const& b) { return a.getMinV() < b.getMinV(); });
+
+    std::vector<double> cover(width + 1);
+    std::vector<RasterEdge const*> active;
+    std::size_t next = 0;
+    for (int row = 0; row < height && (next < edges.size() || !active.empty()); ++row) {
+        while (next < edges.size() && edges[next].getMinV() < row + 1) {
+            active.push_back(&edges[next++]);
+        }
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [row](RasterEdge const* edge) { return edge->getMaxV() <= row; }),
+                     active.end());
+        if (active.empty()) {
+            continue;
+        }
+        std::fill(cover.begin(), cover.end(), 0.0);
+        for (RasterEdge const* edge : active) {
+            addEdgeToRow(*edge, row, width, cover);
+        }
+        // The sign of the coverage depends on the orientation of the polygon
+        double sum = 0.0;
+        for (int i = 0; i < width; ++i) {
+            sum += cover[i];
+            double const coverage = std::abs(sum);
+            cover[i] = coverage < COVERAGE_EPSILON ? 0.0 : std::min(coverage, 1.0);
+        }
+        func(row + bbox.getMinY(), cover);
     }
 }
 
@@ -445,75 +556,34 @@ std::shared_ptr<afw::image::Image<float>> Polygon::createImage(lsst::geom::Box2I
     std::shared_ptr<Image> image = std::make_shared<Image>(bbox);
     image->setXY0(bbox.getMin());
     *image = 0.0;
-    lsst::geom::Box2D bounds = getBBox();  // Polygon bounds
-    int xMin = std::max(static_cast<int>(bounds.getMinX()), bbox.getMinX());
-    int xMax = std::min(static_cast<int>(::ceil(bounds.getMaxX())), bbox.getMaxX());
-    int yMin = std::max(static_cast<int>(bounds.getMinY()), bbox.getMinY());
-    int yMax = std::min(static_cast<int>(::ceil(bounds.getMaxY())), bbox.getMaxY());
-    for (int y = yMin; y <= yMax; ++y) {
-        double const yPixelMin = (double)y - 0.5, yPixelMax = (double)y + 0.5;
-        BoostPolygon row;  // A polygon of row y
-        boost::geometry::assign(
-                row, LsstBox(lsst::geom::Point2D(xMin, yPixelMin), lsst::geom::Point2D(xMax, yPixelMax)));
-        std::vector<BoostPolygon> intersections;
-        boost::geometry::intersection(_impl->poly, row, intersections);
-
-        if (intersections.size() == 1 && boost::geometry::num_points(intersections[0]) == 5) {
-            // This row is fairly tame, and should have a long run of pixels within the polygon
-            BoostPolygon const& row = intersections[0];
-            std::vector<double> top, bottom;
-            top.reserve(2);
-            bottom.reserve(2);
-            bool failed = false;
-            for (std::vector<Point>::const_iterator i = row.outer().begin(); i != row.outer().end() - 1;
-                 ++i) {
-                double const xCoord = i->getX(), yCoord = i->getY();
-                if (yCoord == yPixelMin) {
-                    bottom.push_back(xCoord);
-                } else if (yCoord == yPixelMax) {
-                    top.push_back(xCoord);
-                } else {
-                    failed = true;
-                    break;
-                }
-            }
-            if (!failed && top.size() == 2 && bottom.size() == 2) {
-                std::sort(top.begin(), top.end());
-                std::sort(bottom.begin(), bottom.end());
-                int const xMin = std::min(top[0], bottom[0]);
-                int const xStart = ::ceil(std::max(top[0], bottom[0])) + 1;
-                int const xStop = std::min(top[1], bottom[1]) - 1;
-                int const xMax = ::ceil(std::max(top[1], bottom[1]));
-                pixelRowOverlap(image, _impl->poly, std::max(xMin, bbox.getMinX()),
-                                std::min(xStart, bbox.getMaxX()), y);
-                int x = xStart;
-                for (Image::x_iterator i = image->x_at(std::max(xStart, bbox.getMinX()) - image->getX0(),
-                                                       y - image->getY0());
-                     x <= std::min(xStop, bbox.getMaxX()); ++i, ++x) {
-                    *i = 1.0;
-                }
-                pixelRowOverlap(image, _impl->poly, std::max(xStop, bbox.getMinX()),
-                                std::min(xMax, bbox.getMaxX()), y);
-                continue;
-            }
+    rasterizePolygon(_impl->poly, bbox, [&image, &bbox](int y, std::vector<double> const& coverage) {
+        Image::x_iterator pixel = image->row_begin(y - bbox.getMinY());
+        for (int i = 0; i < bbox.getWidth(); ++i, ++pixel) {
+            *pixel = coverage[i];
         }
+    });
+    return image;
+}
 
-        // Last resort: do each pixel independently...
-        for (std::vector<BoostPolygon>::const_iterator p = intersections.begin(); p != intersections.end();
-             ++p) {
-            double xMinRow = xMax, xMaxRow = xMin;
-            std::vector<LsstPoint> const vertices = p->outer();
-            for (std::vector<LsstPoint>::const_iterator q = vertices.begin(); q != vertices.end(); ++q) {
-                double const x = q->getX();
-                if (x < xMinRow) xMinRow = x;
-                if (x > xMaxRow) xMaxRow = x;
+std::shared_ptr<SpanSet> Polygon::createSpanSet(lsst::geom::Box2I const& bbox) const {
+    std::vector<Span> spans;
+    rasterizePolygon(_impl->poly, bbox, [&spans, &bbox](int y, std::vector<double> const& coverage) {
+        int start = -1;  // Start of the current run of covered pixels, if any
+        for (int i = 0; i < bbox.getWidth(); ++i) {
+            bool const covered = coverage[i] >= 1.0 - COVERAGE_EPSILON;
+            if (covered && start < 0) {
+                start = i;
+            } else if (!covered && start >= 0) {
+                spans.push_back(Span(y, bbox.getMinX() + start, bbox.getMinX() + i - 1));
+                start = -1;
             }
-
-            pixelRowOverlap(image, _impl->poly, std::max(static_cast<int>(xMinRow), bbox.getMinX()),
-                            std::min(static_cast<int>(::ceil(xMaxRow)), bbox.getMaxX()), y);
         }
-    }
-    return image;
+        if (start >= 0) {
+            spans.push_back(Span(y, bbox.getMinX() + start, bbox.getMaxX()));
+        }
+    });
+    // Runs are generated in order and never touch, so they are already normalized
+    return std::make_shared<SpanSet>(std::move(spans), false);
 }
 
 // -------------- Table-based Persistence -------------------------------------------------------------------
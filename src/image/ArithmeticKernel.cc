@@ -0,0 +1,416 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/image/ArithmeticKernel.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+using Instruction = ArithmeticKernel::Instruction;
+
+// Number of pixels in each tile; small enough that the program's stack of tiles stays in L1 cache.
+std::size_t const TILE_SIZE = 256;
+
+// Minimum number of pixels in each block of rows evaluated by one thread.
+std::size_t const MIN_BLOCK_PIXELS = 1 << 16;
+
+// Recursive-descent parser that compiles an expression to a stack program.
+class Parser {
+public:
+    Parser(std::string const& text, std::vector<std::string>& variables, std::vector<Instruction>& program)
+            : _text(text), _variables(variables), _program(program) {}
+
+    void parse() {
+        parseSum();
+        skipSpace();
+        if (_pos != _text.size()) {
+            fail("unexpected character");
+        }
+    }
+
+private:
+    void parseSum() {
+        parseProduct();
+        for (;;) {
+            skipSpace();
+            char const c = peek();
+            if (c != '+' && c != '-') {
+                return;
+            }
+            ++_pos;
+            parseProduct();
+            emit(c == '+' ? Instruction::ADD : Instruction::SUBTRACT);
+        }
+    }
+
+    void parseProduct() {
+        parseUnary();
+        for (;;) {
+            skipSpace();
+            char const c = peek();
+            if (c != '*' && c != '/') {
+                return;
+            }
+            ++_pos;
+            parseUnary();
+            emit(c == '*' ? Instruction::MULTIPLY : Instruction::DIVIDE);
+        }
+    }
+
+    void parseUnary() {
+        skipSpace();
+        if (peek() == '-') {
+            ++_pos;
+            parseUnary();
+            emit(Instruction::NEGATE);
+        } else if (peek() == '+') {
+            ++_pos;
+            parseUnary();
+        } else {
+            parsePrimary();
+        }
+    }
+
+    void parsePrimary() {
+        skipSpace();
+        char const c = peek();
+        if (c == '(') {
+            ++_pos;
+            parseSum();
+            skipSpace();
+            if (peek() != ')') {
+                fail("expected ')'");
+            }
+            ++_pos;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            char const* begin = _text.c_str() + _pos;
+            char* end = nullptr;
+            double const value = std::strtod(begin, &end);
+            if (end == begin) {
+                fail("invalid number");
+            }
+            _pos += end - begin;
+            _program.push_back({Instruction::CONSTANT, -1, value});
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            std::size_t const begin = _pos;
+            while (std::isalnum(static_cast<unsigned char>(peek())) || peek() == '_') {
+                ++_pos;
+            }
+            std::string const name = _text.substr(begin, _pos - begin);
+            auto iter = std::find(_variables.begin(), _variables.end(), name);
+            if (iter == _variables.end()) {
+                iter = _variables.insert(iter, name);
+            }
+            _program.push_back({Instruction::LOAD, static_cast<int>(iter - _variables.begin()), 0.0});
+        } else {
+            fail("expected a number, variable or '('");
+        }
+    }
+
+    void emit(Instruction::Code code) { _program.push_back({code, -1, 0.0}); }
+
+    char peek() const { return _pos < _text.size() ? _text[_pos] : '\0'; }
+
+    void skipSpace() {
+        while (std::isspace(static_cast<unsigned char>(peek()))) {
+            ++_pos;
+        }
+    }
+
+    [[noreturn]] void fail(std::string const& message) const {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("%s at position %d of expression '%s'") % message % _pos % _text)
+                                  .str());
+    }
+
+    std::string const& _text;
+    std::vector<std::string>& _variables;
+    std::vector<Instruction>& _program;
+    std::size_t _pos = 0;
+};
+
+// Return the largest number of tiles on the stack at once.
+int computeStackSize(std::vector<Instruction> const& program) {
+    int size = 0;
+    int maxSize = 0;
+    for (auto const& instruction : program) {
+        switch (instruction.code) {
+            case Instruction::LOAD:
+            case Instruction::CONSTANT:
+                maxSize = std::max(maxSize, ++size);
+                break;
+            case Instruction::NEGATE:
+                break;
+            default:
+                --size;
+        }
+    }
+    return maxSize;
+}
+
+/*
+ * Run a program on one tile of n pixels, leaving the result in the first slot of `values` (and
+ * `variances`, if withVariance).  Slot i of the stack starts at values + i*TILE_SIZE.
+ *
+ * `load(variable, values, variances)` must fill the slot at the given pointers with the tile of an
+ * operand; `variances` is null if !withVariance.
+ */
+template <bool withVariance, typename Load>
+void runTile(std::vector<Instruction> const& program, std::size_t n, double* values, double* variances,
+             Load const& load) {
+    int top = -1;
+    for (auto const& instruction : program) {
+        switch (instruction.code) {
+            case Instruction::LOAD: {
+                ++top;
+                load(instruction.variable, values + top * TILE_SIZE,
+                     withVariance ? variances + top * TILE_SIZE : nullptr);
+                break;
+            }
+            case Instruction::CONSTANT: {
+                ++top;
+                std::fill_n(values + top * TILE_SIZE, n, instruction.constant);
+                if (withVariance) {
+                    std::fill_n(variances + top * TILE_SIZE, n, 0.0);
+                }
+                break;
+            }
+            case Instruction::NEGATE: {
+                double* v = values + top * TILE_SIZE;
+                for (std::size_t k = 0; k < n; ++k) {
+                    v[k] = -v[k];
+                }
+                break;
+            }
+            default: {
+                --top;
+                double* l = values + top * TILE_SIZE;
+                double const* r = l + TILE_SIZE;
+                double* lVar = withVariance ? variances + top * TILE_SIZE : nullptr;
+                double const* rVar = withVariance ? lVar + TILE_SIZE : nullptr;
+                switch (instruction.code) {
+                    case Instruction::ADD:
+                        for (std::size_t k = 0; k < n; ++k) {
+                            l[k] += r[k];
+                        }
+                        if (withVariance) {
+                            for (std::size_t k = 0; k < n; ++k) {
+                                lVar[k] += rVar[k];
+                            }
+                        }
+                        break;
+                    case Instruction::SUBTRACT:
+                        for (std::size_t k = 0; k < n; ++k) {
+                            l[k] -= r[k];
+                        }
+                        if (withVariance) {
+                            for (std::size_t k = 0; k < n; ++k) {
+                                lVar[k] += rVar[k];
+                            }
+                        }
+                        break;
+                    case Instruction::MULTIPLY:
+                        if (withVariance) {
+                            for (std::size_t k = 0; k < n; ++k) {
+                                lVar[k] = l[k] * l[k] * rVar[k] + r[k] * r[k] * lVar[k];
+                            }
+                        }
+                        for (std::size_t k = 0; k < n; ++k) {
+                            l[k] *= r[k];
+                        }
+                        break;
+                    case Instruction::DIVIDE:
+                        if (withVariance) {
+                            for (std::size_t k = 0; k < n; ++k) {
+                                double const r2 = r[k] * r[k];
+                                lVar[k] = (l[k] * l[k] * rVar[k] + r2 * lVar[k]) / (r2 * r2);
+                            }
+                        }
+                        for (std::size_t k = 0; k < n; ++k) {
+                            l[k] /= r[k];
+                        }
+                        break;
+                    default:
+                        throw LSST_EXCEPT(pex::exceptions::LogicError, "Invalid instruction.");
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Call `function(values, variances, y, x0, n)` for every tile of every row, with blocks of rows
+ * processed concurrently; each block has its own stack of tiles.
+ */
+template <typename Function>
+void forEachTile(lsst::geom::Extent2I const& dimensions, int stackSize, bool withVariance,
+                 Function const& function) {
+    std::size_t const width = dimensions.getX();
+    std::size_t const height = dimensions.getY();
+    if (width == 0 || height == 0) {
+        return;
+    }
+    std::size_t const nBlocks =
+            std::max<std::size_t>(1, std::min(height, width * height / MIN_BLOCK_PIXELS));
+    lsst::afw::detail::parallelFor(0, nBlocks, [&](std::size_t block) {
+        std::vector<double> values(stackSize * TILE_SIZE);
+        std::vector<double> variances(withVariance ? stackSize * TILE_SIZE : 0);
+        for (std::size_t y = block * height / nBlocks, end = (block + 1) * height / nBlocks; y < end; ++y) {
+            for (std::size_t x0 = 0; x0 < width; x0 += TILE_SIZE) {
+                function(values.data(), variances.data(), y, x0, std::min(TILE_SIZE, width - x0));
+            }
+        }
+    });
+}
+
+template <typename ImageT>
+void checkOperands(ImageT const& out, std::vector<std::shared_ptr<ImageT const>> const& operands,
+                   std::size_t nVariables) {
+    if (operands.size() != nVariables) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Expression has %d variables, but %d images were given") %
+                           nVariables % operands.size())
+                                  .str());
+    }
+    for (auto const& operand : operands) {
+        if (!operand) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Operand images must not be null.");
+        }
+        if (operand->getDimensions() != out.getDimensions()) {
+            throw LSST_EXCEPT(pex::exceptions::LengthError,
+                              (boost::format("Images are of different size, %dx%d v %dx%d") %
+                               out.getWidth() % out.getHeight() % operand->getWidth() % operand->getHeight())
+                                      .str());
+        }
+    }
+}
+
+}  // namespace
+
+ArithmeticKernel::ArithmeticKernel(std::string const& expression) : _expression(expression) {
+    Parser(_expression, _variables, _program).parse();
+    if (_variables.empty()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Expression '" + _expression + "' has no variables.");
+    }
+    _stackSize = computeStackSize(_program);
+}
+
+ArithmeticKernel::ArithmeticKernel(ArithmeticKernel const&) = default;
+ArithmeticKernel::ArithmeticKernel(ArithmeticKernel&&) = default;
+ArithmeticKernel& ArithmeticKernel::operator=(ArithmeticKernel const&) = default;
+ArithmeticKernel& ArithmeticKernel::operator=(ArithmeticKernel&&) = default;
+ArithmeticKernel::~ArithmeticKernel() = default;
+
+template <typename PixelT>
+void ArithmeticKernel::evaluate(Image<PixelT>& out,
+                                std::vector<std::shared_ptr<Image<PixelT> const>> const& operands) const {
+    checkOperands<Image<PixelT>>(out, operands, _variables.size());
+    std::vector<typename Image<PixelT>::ConstArray> arrays;
+    for (auto const& operand : operands) {
+        arrays.push_back(operand->getArray());
+    }
+    auto const outArray = out.getArray();
+    forEachTile(out.getDimensions(), _stackSize, false,
+                [&](double* values, double*, std::size_t y, std::size_t x0, std::size_t n) {
+                    runTile<false>(_program, n, values, nullptr, [&](int variable, double* dst, double*) {
+                        PixelT const* src = arrays[variable][y].getData() + x0;
+                        std::copy(src, src + n, dst);
+                    });
+                    PixelT* row = outArray[y].getData() + x0;
+                    for (std::size_t k = 0; k < n; ++k) {
+                        row[k] = static_cast<PixelT>(values[k]);
+                    }
+                });
+}
+
+template <typename PixelT>
+void ArithmeticKernel::evaluate(
+        MaskedImage<PixelT>& out,
+        std::vector<std::shared_ptr<MaskedImage<PixelT> const>> const& operands) const {
+    using MaskedImageT = MaskedImage<PixelT>;
+    checkOperands<MaskedImageT>(out, operands, _variables.size());
+    std::vector<typename MaskedImageT::Image::ConstArray> images;
+    std::vector<typename MaskedImageT::Mask::ConstArray> masks;
+    std::vector<typename MaskedImageT::Variance::ConstArray> variances;
+    for (auto const& operand : operands) {
+        images.push_back(operand->getImage()->getArray());
+        masks.push_back(operand->getMask()->getArray());
+        variances.push_back(operand->getVariance()->getArray());
+    }
+    auto const outImage = out.getImage()->getArray();
+    auto const outMask = out.getMask()->getArray();
+    auto const outVariance = out.getVariance()->getArray();
+    forEachTile(out.getDimensions(), _stackSize, true,
+                [&](double* values, double* vars, std::size_t y, std::size_t x0, std::size_t n) {
+                    runTile<true>(_program, n, values, vars,
+                                  [&](int variable, double* dstValues, double* dstVariances) {
+                                      PixelT const* src = images[variable][y].getData() + x0;
+                                      std::copy(src, src + n, dstValues);
+                                      auto const* srcVariance = variances[variable][y].getData() + x0;
+                                      std::copy(srcVariance, srcVariance + n, dstVariances);
+                                  });
+                    // Combine the masks before writing anything, in case the output is also an operand.
+                    MaskPixel combined[TILE_SIZE] = {};
+                    for (auto const& mask : masks) {
+                        MaskPixel const* src = mask[y].getData() + x0;
+                        for (std::size_t k = 0; k < n; ++k) {
+                            combined[k] |= src[k];
+                        }
+                    }
+                    PixelT* imageRow = outImage[y].getData() + x0;
+                    MaskPixel* maskRow = outMask[y].getData() + x0;
+                    VariancePixel* varianceRow = outVariance[y].getData() + x0;
+                    for (std::size_t k = 0; k < n; ++k) {
+                        imageRow[k] = static_cast<PixelT>(values[k]);
+                        maskRow[k] = combined[k];
+                        varianceRow[k] = static_cast<VariancePixel>(vars[k]);
+                    }
+                });
+}
+
+#define INSTANTIATE(TYPE)                                                                           \
+    template void ArithmeticKernel::evaluate(Image<TYPE>&,                                          \
+                                             std::vector<std::shared_ptr<Image<TYPE> const>> const&) \
+            const;                                                                                  \
+    template void ArithmeticKernel::evaluate(                                                       \
+            MaskedImage<TYPE>&, std::vector<std::shared_ptr<MaskedImage<TYPE> const>> const&) const;
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -25,10 +25,12 @@
 /*
  * Implementation for ImageBase and Image
  */
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <functional>
 #include <type_traits>
+#include <vector>
 #include "boost/mpl/vector.hpp"
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-variable"
@@ -38,9 +40,11 @@
 #include "boost/gil/gil_all.hpp"
 
 #include "lsst/pex/exceptions.h"
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/geom/wcsUtils.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/ImageAlgorithm.h"
+#include "lsst/afw/math/Function.h"
 #include "lsst/afw/fits.h"
 #include "lsst/afw/image/ImageFitsReader.h"
 
@@ -492,16 +496,40 @@ Image<PixelT>& Image<PixelT>::operator+=(Image<PixelT> const& rhs) {
     return *this;
 }
 
+namespace {
+
+// Minimum number of pixels in each block of rows that one thread adds a function to.
+std::size_t const MIN_FUNCTION_BLOCK_PIXELS = 1 << 14;
+
+// Add sign*function(x, y) to every pixel, evaluating the function a row at a time.
+template <typename PixelT>
+void addFunction(Image<PixelT>& out, math::Function2<double> const& function, double sign) {
+    std::size_t const width = out.getWidth();
+    std::size_t const height = out.getHeight();
+    if (width == 0 || height == 0) {
+        return;
+    }
+    double const x0 = out.indexToPosition(0, X);
+    auto const array = out.getArray();
+    std::size_t const nBlocks =
+            std::max<std::size_t>(1, std::min(height, width * height / MIN_FUNCTION_BLOCK_PIXELS));
+    lsst::afw::detail::parallelFor(0, nBlocks, [&](std::size_t block) {
+        std::vector<double> values(width);
+        for (std::size_t y = block * height / nBlocks, end = (block + 1) * height / nBlocks; y < end; ++y) {
+            function.evaluateRow(out.indexToPosition(y, Y), x0, width, values.data());
+            PixelT* row = array[y].getData();
+            for (std::size_t x = 0; x < width; ++x) {
+                row[x] = static_cast<PixelT>(row[x] + sign * values[x]);
+            }
+        }
+    });
+}
+
+}  // namespace
+
 template <typename PixelT>
 Image<PixelT>& Image<PixelT>::operator+=(math::Function2<double> const& function) {
-    for (int y = 0; y != this->getHeight(); ++y) {
-        double const yPos = this->indexToPosition(y, Y);
-        double xPos = this->indexToPosition(0, X);
-        for (typename Image<PixelT>::x_iterator ptr = this->row_begin(y), end = this->row_end(y); ptr != end;
-             ++ptr, ++xPos) {
-            *ptr += function(xPos, yPos);
-        }
-    }
+    addFunction(*this, function, 1.0);
     return *this;
 }
 
@@ -552,14 +580,7 @@ void Image<PixelT>::scaledMinus(double const c, Image<PixelT> const& rhs) {
 
 template <typename PixelT>
 Image<PixelT>& Image<PixelT>::operator-=(math::Function2<double> const& function) {
-    for (int y = 0; y != this->getHeight(); ++y) {
-        double const yPos = this->indexToPosition(y, Y);
-        double xPos = this->indexToPosition(0, X);
-        for (typename Image<PixelT>::x_iterator ptr = this->row_begin(y), end = this->row_end(y); ptr != end;
-             ++ptr, ++xPos) {
-            *ptr -= function(xPos, yPos);
-        }
-    }
+    addFunction(*this, function, -1.0);
     return *this;
 }
 
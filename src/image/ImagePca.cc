@@ -29,11 +29,14 @@
 #include <cmath>
 #include <cstdint>
 #include <memory>
+#include <random>
 
 #include "Eigen/Core"
 #include "Eigen/SVD"
 #include "Eigen/Eigenvalues"
+#include "Eigen/QR"
 
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/image/ImagePca.h"
 #include "lsst/afw/math/Statistics.h"
 
@@ -50,7 +53,11 @@ ImagePca<ImageT>::ImagePca(bool constantWeight)
           _dimensions(0, 0),
           _constantWeight(constantWeight),
           _eigenValues(std::vector<double>()),
-          _eigenImages(ImageList()) {}
+          _eigenImages(ImageList()),
+          _nComponents(0),
+          _reuseInnerProducts(false),
+          _innerProducts(),
+          _nInnerProducts(0) {}
 
 template <typename ImageT>
 ImagePca<ImageT>::ImagePca(ImagePca const&) = default;
@@ -82,6 +89,48 @@ void ImagePca<ImageT>::addImage(std::shared_ptr<ImageT> img, double flux) {
     _fluxList.push_back(flux);
 }
 
+template <typename ImageT>
+void ImagePca<ImageT>::removeImage(std::size_t index) {
+    if (index >= _imageList.size()) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::OutOfRangeError,
+                          (boost::format("Index %d is out of range; there are %d images") % index %
+                           _imageList.size())
+                                  .str());
+    }
+    _imageList.erase(_imageList.begin() + index);
+    _fluxList.erase(_fluxList.begin() + index);
+
+    if (index < _nInnerProducts) {
+        std::size_t const n = _nInnerProducts - 1;
+        Eigen::MatrixXd kept(n, n);
+        for (std::size_t j = 0; j != n; ++j) {
+            std::size_t const jj = (j < index) ? j : j + 1;
+            for (std::size_t i = 0; i != n; ++i) {
+                kept(i, j) = _innerProducts((i < index) ? i : i + 1, jj);
+            }
+        }
+        _innerProducts = std::move(kept);
+        _nInnerProducts = n;
+    }
+}
+
+template <typename ImageT>
+void ImagePca<ImageT>::setNumComponents(int nComponents) {
+    if (nComponents < 0) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                          (boost::format("Number of components %d is negative") % nComponents).str());
+    }
+    _nComponents = nComponents;
+}
+
+template <typename ImageT>
+void ImagePca<ImageT>::setReuseInnerProducts(bool reuse) {
+    _reuseInnerProducts = reuse;
+    if (!reuse) {
+        imagesModified();
+    }
+}
+
 template <typename ImageT>
 typename ImagePca<ImageT>::ImageList ImagePca<ImageT>::getImageList() const {
     return _imageList;
@@ -111,13 +160,185 @@ namespace {
  *
  * The notation is that in chapter 7 of Gyula Szokoly's thesis at JHU
  */
-template <typename T>
-struct SortEvalueDecreasing
-        : public std::binary_function<std::pair<T, int> const&, std::pair<T, int> const&, bool> {
-    bool operator()(std::pair<T, int> const& a, std::pair<T, int> const& b) {
-        return a.first > b.first;  // N.b. sort on greater
+
+// Minimum number of pixels (rows of the packed pixel matrix) handled by each thread
+std::size_t const MIN_BLOCK_PIXELS = 1 << 12;
+
+// Number of extra basis vectors, and of power iterations, used by the randomized eigen-solver
+int const EIGEN_OVERSAMPLING = 10;
+int const EIGEN_POWER_ITERATIONS = 4;
+
+// Number of eigenimages computed by default
+int const DEFAULT_EIGEN_IMAGES = 100;
+
+// Return the number of blocks that forEachRowBlock splits nRows rows into
+std::size_t countRowBlocks(std::size_t nRows) {
+    return std::max<std::size_t>(
+            1, std::min<std::size_t>(nRows / MIN_BLOCK_PIXELS, lsst::afw::detail::getDefaultNumThreads()));
+}
+
+// Call function(block, begin, end) on contiguous blocks of the rows [0, nRows), in parallel
+template <typename Function>
+void forEachRowBlock(std::size_t nRows, Function const& function) {
+    std::size_t const nBlocks = countRowBlocks(nRows);
+    lsst::afw::detail::parallelFor(0, nBlocks, [&](std::size_t block) {
+        function(block, block * nRows / nBlocks, (block + 1) * nRows / nBlocks);
+    });
+}
+
+/*
+ * Copy an image's pixels into a column of a matrix, row by row, multiplied by scale
+ *
+ * Non-finite pixels are set to zero (so they are ignored by the inner products, as in innerProduct),
+ * and their indices are appended to badPixels.
+ */
+template <typename PixelT>
+void packImage(Image<PixelT> const& image, double scale, double* column,
+               std::vector<std::size_t>& badPixels) {
+    std::size_t const width = image.getWidth();
+    auto const array = image.getArray();
+    for (std::size_t y = 0; y != array.template getSize<0>(); ++y) {
+        PixelT const* row = array[y].getData();
+        for (std::size_t x = 0; x != width; ++x) {
+            double const value = scale * row[x];
+            if (std::isfinite(value)) {
+                column[y * width + x] = value;
+            } else {
+                column[y * width + x] = 0.0;
+                badPixels.push_back(y * width + x);
+            }
+        }
     }
-};
+}
+
+// Copy a column of a matrix into an image's pixels, row by row
+template <typename PixelT>
+void unpackImage(double const* column, Image<PixelT>& image) {
+    std::size_t const width = image.getWidth();
+    auto const array = image.getArray();
+    for (std::size_t y = 0; y != array.template getSize<0>(); ++y) {
+        PixelT* row = array[y].getData();
+        for (std::size_t x = 0; x != width; ++x) {
+            row[x] = static_cast<PixelT>(column[y * width + x]);
+        }
+    }
+}
+
+/*
+ * Compute the inner products of the columns of pixels with its last nNew columns
+ *
+ * The matrix is split into blocks of rows that are handled in parallel; the products with earlier
+ * columns are general matrix products, and those among the new columns rank updates (SYRK), both of
+ * which Eigen blocks for the cache.  The upper-right nOld x nNew corner and the lower-right
+ * nNew x nNew corner of products are set; the rest is unchanged.
+ */
+void updateInnerProducts(Eigen::MatrixXd const& pixels, std::size_t nNew, Eigen::MatrixXd& products) {
+    std::size_t const nPixel = pixels.rows();
+    std::size_t const nImage = pixels.cols();
+    std::size_t const nOld = nImage - nNew;
+    std::size_t const nBlocks = countRowBlocks(nPixel);
+    std::vector<Eigen::MatrixXd> cross(nBlocks);
+    std::vector<Eigen::MatrixXd> square(nBlocks, Eigen::MatrixXd::Zero(nNew, nNew));
+    forEachRowBlock(nPixel, [&](std::size_t i, std::size_t begin, std::size_t end) {
+        auto const block = pixels.middleRows(begin, end - begin);
+        cross[i] = block.leftCols(nOld).transpose() * block.rightCols(nNew);
+        square[i].selfadjointView<Eigen::Lower>().rankUpdate(block.rightCols(nNew).transpose());
+    });
+    Eigen::MatrixXd totalCross = Eigen::MatrixXd::Zero(nOld, nNew);
+    Eigen::MatrixXd totalSquare = Eigen::MatrixXd::Zero(nNew, nNew);
+    for (std::size_t i = 0; i != nBlocks; ++i) {
+        totalCross += cross[i];
+        totalSquare += square[i];
+    }
+    totalSquare.triangularView<Eigen::StrictlyUpper>() = totalSquare.transpose();
+    products.topRightCorner(nOld, nNew) = totalCross;
+    products.bottomRightCorner(nNew, nNew) = totalSquare;
+}
+
+/*
+ * Find the nWanted largest eigenvalues of a symmetric positive semi-definite matrix, in decreasing
+ * order, and their eigenvectors
+ *
+ * If nWanted is much smaller than the size of the matrix, a randomized subspace iteration (Halko,
+ * Martinsson & Tropp, 2011, SIAM Review 53, 217; algorithms 4.4 and 5.3) is used; its random start
+ * is seeded the same way every time, so the results are reproducible.
+ */
+void solveEigenProblem(Eigen::MatrixXd const& matrix, int nWanted, Eigen::VectorXd& values,
+                       Eigen::MatrixXd& vectors) {
+    int const n = matrix.rows();
+    if (nWanted + EIGEN_OVERSAMPLING >= n / 2) {
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(matrix);  // eigenvalues increase
+        values = solver.eigenvalues().tail(nWanted).reverse();
+        vectors = solver.eigenvectors().rightCols(nWanted).rowwise().reverse();
+        return;
+    }
+
+    int const nBasis = nWanted + EIGEN_OVERSAMPLING;
+    std::mt19937 rng(1);
+    std::normal_distribution<double> normal;
+    Eigen::MatrixXd basis(n, nBasis);
+    for (int j = 0; j != nBasis; ++j) {
+        for (int i = 0; i != n; ++i) {
+            basis(i, j) = normal(rng);
+        }
+    }
+    Eigen::MatrixXd const thin = Eigen::MatrixXd::Identity(n, nBasis);
+    for (int iter = 0; iter <= EIGEN_POWER_ITERATIONS; ++iter) {
+        Eigen::HouseholderQR<Eigen::MatrixXd> qr(matrix * basis);
+        basis = qr.householderQ() * thin;
+    }
+    Eigen::MatrixXd const projected = basis.transpose() * matrix * basis;
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(projected);
+    values = solver.eigenvalues().tail(nWanted).reverse();
+    vectors = basis * solver.eigenvectors().rightCols(nWanted).rowwise().reverse();
+}
+
+/*
+ * Set the mask and variance planes of the eigenimages to what repeated calls to scaledPlus would give:
+ * the OR of the input masks, and the sum of the input variances weighted by the squared weights
+ */
+template <typename ImageT>
+void setEigenImagePlanes(detail::basic_tag const&, typename ImagePca<ImageT>::ImageList const&,
+                         Eigen::MatrixXd const&, typename ImagePca<ImageT>::ImageList const&) {}
+
+template <typename ImageT>
+void setEigenImagePlanes(detail::MaskedImage_tag const&,
+                         typename ImagePca<ImageT>::ImageList const& imageList,
+                         Eigen::MatrixXd const& weights,
+                         typename ImagePca<ImageT>::ImageList const& eigenImages) {
+    typedef typename ImageT::Mask::Pixel MaskPixelT;
+    std::size_t const nImage = imageList.size();
+    std::size_t const width = imageList[0]->getWidth();
+    std::size_t const nPixel = width * imageList[0]->getHeight();
+
+    Eigen::MatrixXd variances(nPixel, nImage);
+    typename ImageT::Mask mask(imageList[0]->getDimensions());
+    auto const maskArray = mask.getArray();
+    for (std::size_t j = 0; j != nImage; ++j) {
+        auto const varianceArray = imageList[j]->getVariance()->getArray();
+        auto const inMaskArray = imageList[j]->getMask()->getArray();
+        for (std::size_t y = 0; y != varianceArray.template getSize<0>(); ++y) {
+            auto const* varianceRow = varianceArray[y].getData();
+            MaskPixelT const* inMaskRow = inMaskArray[y].getData();
+            MaskPixelT* maskRow = maskArray[y].getData();
+            for (std::size_t x = 0; x != width; ++x) {
+                variances(y * width + x, j) = varianceRow[x];
+                maskRow[x] |= inMaskRow[x];
+            }
+        }
+    }
+
+    Eigen::MatrixXd const squaredWeights = weights.cwiseProduct(weights);
+    Eigen::MatrixXd eigenVariances(nPixel, eigenImages.size());
+    forEachRowBlock(nPixel, [&](std::size_t, std::size_t begin, std::size_t end) {
+        eigenVariances.middleRows(begin, end - begin).noalias() =
+                variances.middleRows(begin, end - begin) * squaredWeights;
+    });
+    for (std::size_t i = 0; i != eigenImages.size(); ++i) {
+        unpackImage(eigenVariances.col(i).data(), *eigenImages[i]->getVariance());
+        eigenImages[i]->getMask()->assign(mask);
+    }
+}
 }  // namespace
 
 template <typename ImageT>
@@ -140,75 +361,96 @@ void ImagePca<ImageT>::analyze() {
         return;
     }
     /*
-     * Find the eigenvectors/values of the scalar product matrix, R' (Eq. 7.4)
+     * Pack the images' pixels into the columns of a matrix, scaled to unit flux if all stars are to
+     * have the same weight
      */
-    Eigen::MatrixXd R(nImage, nImage);  // residuals' inner products
-
+    std::size_t const nPixel = static_cast<std::size_t>(_dimensions.getX()) * _dimensions.getY();
+    std::vector<double> scales(nImage);
     double flux_bar = 0;  // mean of flux for all regions
     for (int i = 0; i != nImage; ++i) {
-        typename GetImage<ImageT>::type const& im_i = *GetImage<ImageT>::getImage(_imageList[i]);
-        double const flux_i = getFlux(i);
-        flux_bar += flux_i;
-
-        for (int j = i; j != nImage; ++j) {
-            typename GetImage<ImageT>::type const& im_j = *GetImage<ImageT>::getImage(_imageList[j]);
-            double const flux_j = getFlux(j);
-
-            double dot = innerProduct(im_i, im_j);
-            if (_constantWeight) {
-                dot /= flux_i * flux_j;
-            }
-            R(i, j) = R(j, i) = dot / nImage;
-        }
+        flux_bar += getFlux(i);
+        scales[i] = _constantWeight ? 1.0 / getFlux(i) : 1.0;
     }
     flux_bar /= nImage;
-    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eVecValues(R);
-    Eigen::MatrixXd const& Q = eVecValues.eigenvectors();
-    Eigen::VectorXd const& lambda = eVecValues.eigenvalues();
-    //
-    // We need to sort the eigenValues, and remember the permutation we applied to the eigenImages
-    // We'll use the vector lambdaAndIndex to achieve this
-    //
-    std::vector<std::pair<double, int> > lambdaAndIndex;  // pairs (eValue, index)
-    lambdaAndIndex.reserve(nImage);
 
-    for (int i = 0; i != nImage; ++i) {
-        lambdaAndIndex.push_back(std::make_pair(lambda(i), i));
+    Eigen::MatrixXd pixels(nPixel, nImage);
+    std::vector<std::vector<std::size_t>> badPixelLists(nImage);
+    lsst::afw::detail::parallelFor(0, nImage, [&](std::size_t i) {
+        packImage(*GetImage<ImageT>::getImage(_imageList[i]), scales[i], pixels.col(i).data(),
+                  badPixelLists[i]);
+    });
+    /*
+     * Find the eigenvectors/values of the scalar product matrix, R' (Eq. 7.4), reusing the inner
+     * products of images that we have already seen if asked to
+     */
+    std::size_t const nOld = _reuseInnerProducts ? std::min<std::size_t>(_nInnerProducts, nImage) : 0;
+    Eigen::MatrixXd products(nImage, nImage);
+    products.topLeftCorner(nOld, nOld) = _innerProducts.topLeftCorner(nOld, nOld);
+    if (nOld < static_cast<std::size_t>(nImage)) {
+        updateInnerProducts(pixels, nImage - nOld, products);
+        products.bottomLeftCorner(nImage - nOld, nOld) =
+                products.topRightCorner(nOld, nImage - nOld).transpose();
     }
-    std::sort(lambdaAndIndex.begin(), lambdaAndIndex.end(), SortEvalueDecreasing<double>());
+    if (_reuseInnerProducts) {
+        _innerProducts = products;
+        _nInnerProducts = nImage;
+    }
+
+    Eigen::MatrixXd const R = products / nImage;  // residuals' inner products
+    int const nValues = (_nComponents > 0) ? std::min(_nComponents, nImage) : nImage;
+    Eigen::VectorXd lambda;
+    Eigen::MatrixXd Q;
+    solveEigenProblem(R, nValues, lambda, Q);
     //
     // Save the (sorted) eigen values
     //
-    _eigenValues.clear();
-    _eigenValues.reserve(nImage);
-    for (int i = 0; i != nImage; ++i) {
-        _eigenValues.push_back(lambdaAndIndex[i].first);
-    }
+    _eigenValues.assign(lambda.data(), lambda.data() + nValues);
     //
     // Contruct the first ncomp eigenimages in basis
     //
-    int ncomp = 100;  // number of components to keep
-
-    _eigenImages.clear();
-    _eigenImages.reserve(ncomp < nImage ? ncomp : nImage);
-
-    for (int i = 0; i < ncomp; ++i) {
-        if (i >= nImage) {
-            continue;
+    int const ncomp = (_nComponents > 0) ? nValues : std::min(DEFAULT_EIGEN_IMAGES, nImage);
+    Eigen::MatrixXd const weights = Q.leftCols(ncomp) * (_constantWeight ? flux_bar : 1.0);
+
+    Eigen::MatrixXd eigenPixels(nPixel, ncomp);
+    forEachRowBlock(nPixel, [&](std::size_t, std::size_t begin, std::size_t end) {
+        eigenPixels.middleRows(begin, end - begin).noalias() =
+                pixels.middleRows(begin, end - begin) * weights;
+    });
+    //
+    // Pixels that are not finite in some image were left out of the product; add them up directly so
+    // that they propagate into the eigenimages
+    //
+    std::vector<std::size_t> badPixels;
+    for (auto const& list : badPixelLists) {
+        badPixels.insert(badPixels.end(), list.begin(), list.end());
+    }
+    std::sort(badPixels.begin(), badPixels.end());
+    badPixels.erase(std::unique(badPixels.begin(), badPixels.end()), badPixels.end());
+    for (std::size_t pixel : badPixels) {
+        std::size_t const x = pixel % _dimensions.getX();
+        std::size_t const y = pixel / _dimensions.getX();
+        for (int i = 0; i != ncomp; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j != nImage; ++j) {
+                auto const array = GetImage<ImageT>::getImage(_imageList[j])->getArray();
+                sum += weights(j, i) * scales[j] * array[y][x];
+            }
+            eigenPixels(pixel, i) = sum;
         }
+    }
 
-        int const ii = lambdaAndIndex[i].second;  // the index after sorting (backwards) by eigenvalue
-
+    _eigenImages.clear();
+    _eigenImages.reserve(ncomp);
+    for (int i = 0; i != ncomp; ++i) {
         std::shared_ptr<ImageT> eImage(new ImageT(_dimensions));
-        *eImage = static_cast<typename ImageT::Pixel>(0);
-
-        for (int j = 0; j != nImage; ++j) {
-            int const jj = lambdaAndIndex[j].second;  // the index after sorting (backwards) by eigenvalue
-            double const weight = Q(jj, ii) * (_constantWeight ? flux_bar / getFlux(jj) : 1);
-            eImage->scaledPlus(weight, *_imageList[jj]);
-        }
+        unpackImage(eigenPixels.col(i).data(), *GetImage<ImageT>::getImage(eImage));
         _eigenImages.push_back(eImage);
     }
+    Eigen::MatrixXd rawWeights = weights;
+    for (int j = 0; j != nImage; ++j) {
+        rawWeights.row(j) *= scales[j];
+    }
+    setEigenImagePlanes<ImageT>(typename ImageT::image_category(), _imageList, rawWeights, _eigenImages);
 }
 
 namespace {
@@ -385,6 +627,7 @@ double do_updateBadPixels(detail::MaskedImage_tag const&,
 }  // namespace
 template <typename ImageT>
 double ImagePca<ImageT>::updateBadPixels(unsigned long mask, int const ncomp) {
+    imagesModified();  // the images' pixels may change
     return do_updateBadPixels<ImageT>(typename ImageT::image_category(), _imageList, _fluxList, _eigenImages,
                                       mask, ncomp);
 }
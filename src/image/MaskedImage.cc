@@ -25,6 +25,7 @@
 /*
  * Implementation for MaskedImage
  */
+#include <algorithm>
 #include <cstdint>
 #include <typeinfo>
 #include <sys/stat.h>
@@ -33,9 +34,11 @@
 #pragma clang diagnostic pop
 #include "boost/regex.hpp"
 #include "boost/filesystem/path.hpp"
+#include "boost/format.hpp"
 #include "lsst/log/Log.h"
 #include "lsst/pex/exceptions.h"
 
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/fits.h"
 #include "lsst/afw/image/MaskedImageFitsReader.h"
@@ -248,21 +251,86 @@ void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::assign(MaskedImage co
     _variance->assign(*rhs.getVariance(), bbox, origin);
 }
 
+namespace {
+
+// Minimum number of pixels in each block of rows processed by one thread in applyFused, so that images
+// too small to benefit are processed without starting any threads.
+std::size_t const MIN_FUSED_BLOCK_PIXELS = 1 << 16;
+
+/*
+ * Update all three planes of `lhs` from those of `rhs` in a single pass over the rows.
+ *
+ * `kernel(image, mask, variance, rhsImage, rhsMask, rhsVariance, width)` is called with pointers to the
+ * start of each row of each plane, and should be a simple loop over the row that the compiler can
+ * vectorize.  Each pixel of `lhs` is read and written exactly once, so the cost is set by memory
+ * bandwidth rather than by the number of planes.  Blocks of rows are processed concurrently by
+ * lsst::afw::detail::parallelFor, using the afw default number of threads.
+ *
+ * @throws lsst::pex::exceptions::LengthError if the images have different dimensions.
+ * @throws lsst::pex::exceptions::RuntimeError if the mask planes are not compatible.
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename RowKernel>
+void applyFused(MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& lhs,
+                MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& rhs, RowKernel const& kernel) {
+    if (lhs.getDimensions() != rhs.getDimensions()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Images are of different size, %dx%d v %dx%d") % lhs.getWidth() %
+                           lhs.getHeight() % rhs.getWidth() % rhs.getHeight())
+                                  .str());
+    }
+    if (lhs.getMask()->getMaskPlaneDict() != rhs.getMask()->getMaskPlaneDict()) {
+        throw LSST_EXCEPT(pex::exceptions::RuntimeError, "Mask dictionaries do not match");
+    }
+    auto const image = lhs.getImage()->getArray();
+    auto const mask = lhs.getMask()->getArray();
+    auto const variance = lhs.getVariance()->getArray();
+    auto const rhsImage = rhs.getImage()->getArray();
+    auto const rhsMask = rhs.getMask()->getArray();
+    auto const rhsVariance = rhs.getVariance()->getArray();
+    std::size_t const width = lhs.getWidth();
+    std::size_t const height = lhs.getHeight();
+    if (width == 0 || height == 0) {
+        return;
+    }
+    std::size_t const nBlocks = std::max<std::size_t>(
+            1, std::min(height, width * height / MIN_FUSED_BLOCK_PIXELS));
+    lsst::afw::detail::parallelFor(0, nBlocks, [&](std::size_t block) {
+        for (std::size_t y = block * height / nBlocks, end = (block + 1) * height / nBlocks; y < end; ++y) {
+            kernel(image[y].getData(), mask[y].getData(), variance[y].getData(), rhsImage[y].getData(),
+                   rhsMask[y].getData(), rhsVariance[y].getData(), width);
+        }
+    });
+}
+
+}  // namespace
+
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::
 operator+=(MaskedImage const& rhs) {
-    *_image += *rhs.getImage();
-    *_mask |= *rhs.getMask();
-    *_variance += *rhs.getVariance();
+    applyFused(*this, rhs,
+               [](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                  MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       im[x] += rIm[x];
+                       mk[x] |= rMk[x];
+                       var[x] += rVar[x];
+                   }
+               });
     return *this;
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::scaledPlus(double const c,
                                                                       MaskedImage const& rhs) {
-    (*_image).scaledPlus(c, *rhs.getImage());
-    *_mask |= *rhs.getMask();
-    (*_variance).scaledPlus(c * c, *rhs.getVariance());
+    applyFused(*this, rhs,
+               [c](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                   MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       im[x] += static_cast<ImagePixelT>(c * rIm[x]);
+                       mk[x] |= rMk[x];
+                       var[x] += static_cast<VariancePixelT>(c * c * rVar[x]);
+                   }
+               });
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
@@ -275,18 +343,30 @@ operator+=(ImagePixelT const rhs) {
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::
 operator-=(MaskedImage const& rhs) {
-    *_image -= *rhs.getImage();
-    *_mask |= *rhs.getMask();
-    *_variance += *rhs.getVariance();
+    applyFused(*this, rhs,
+               [](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                  MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       im[x] -= rIm[x];
+                       mk[x] |= rMk[x];
+                       var[x] += rVar[x];
+                   }
+               });
     return *this;
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::scaledMinus(double const c,
                                                                        MaskedImage const& rhs) {
-    (*_image).scaledMinus(c, *rhs.getImage());
-    *_mask |= *rhs.getMask();
-    (*_variance).scaledPlus(c * c, *rhs.getVariance());
+    applyFused(*this, rhs,
+               [c](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                   MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       im[x] -= static_cast<ImagePixelT>(c * rIm[x]);
+                       mk[x] |= rMk[x];
+                       var[x] += static_cast<VariancePixelT>(c * c * rVar[x]);
+                   }
+               });
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
@@ -296,56 +376,39 @@ operator-=(ImagePixelT const rhs) {
     return *this;
 }
 
-namespace {
-/// @internal Functor to calculate the variance of the product of two independent variables
-template <typename ImagePixelT, typename VariancePixelT>
-struct productVariance {
-    double operator()(ImagePixelT lhs, ImagePixelT rhs, VariancePixelT varLhs, VariancePixelT varRhs) {
-        return lhs * lhs * varRhs + rhs * rhs * varLhs;
-    }
-};
-
-/// @internal Functor to calculate variance of the product of two independent variables, with the rhs scaled
-/// by c
-template <typename ImagePixelT, typename VariancePixelT>
-struct scaledProductVariance {
-    double _c;
-    scaledProductVariance(double const c) : _c(c) {}
-    double operator()(ImagePixelT lhs, ImagePixelT rhs, VariancePixelT varLhs, VariancePixelT varRhs) {
-        return _c * _c * (lhs * lhs * varRhs + rhs * rhs * varLhs);
-    }
-};
-}  // namespace
+// In the kernels for products and quotients, the variance is computed from the image values before they
+// are updated.  The variance arithmetic is done in the pixel types (as for the images), not in double,
+// so single-precision images stay single-precision in the inner loops.
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::
 operator*=(MaskedImage const& rhs) {
-    // Must do variance before we modify the image values
-    transform_pixels(_image->_getRawView(),         // lhs
-                     rhs._image->_getRawView(),     // rhs,
-                     _variance->_getRawView(),      // Var(lhs),
-                     rhs._variance->_getRawView(),  // Var(rhs)
-                     _variance->_getRawView(),      // result
-                     productVariance<ImagePixelT, VariancePixelT>());
-
-    *_image *= *rhs.getImage();
-    *_mask |= *rhs.getMask();
+    applyFused(*this, rhs,
+               [](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                  MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       ImagePixelT const l = im[x], r = rIm[x];
+                       var[x] = static_cast<VariancePixelT>(l * l * rVar[x] + r * r * var[x]);
+                       im[x] = l * r;
+                       mk[x] |= rMk[x];
+                   }
+               });
     return *this;
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::scaledMultiplies(double const c,
                                                                             MaskedImage const& rhs) {
-    // Must do variance before we modify the image values
-    transform_pixels(_image->_getRawView(),         // lhs
-                     rhs._image->_getRawView(),     // rhs,
-                     _variance->_getRawView(),      // Var(lhs),
-                     rhs._variance->_getRawView(),  // Var(rhs)
-                     _variance->_getRawView(),      // result
-                     scaledProductVariance<ImagePixelT, VariancePixelT>(c));
-
-    (*_image).scaledMultiplies(c, *rhs.getImage());
-    *_mask |= *rhs.getMask();
+    applyFused(*this, rhs,
+               [c](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                   MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       ImagePixelT const l = im[x], r = rIm[x];
+                       var[x] = static_cast<VariancePixelT>(c * c * (l * l * rVar[x] + r * r * var[x]));
+                       im[x] = l * static_cast<ImagePixelT>(c * r);
+                       mk[x] |= rMk[x];
+                   }
+               });
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
@@ -356,57 +419,38 @@ operator*=(ImagePixelT const rhs) {
     return *this;
 }
 
-namespace {
-/// @internal Functor to calculate the variance of the ratio of two independent variables
-template <typename ImagePixelT, typename VariancePixelT>
-struct quotientVariance {
-    double operator()(ImagePixelT lhs, ImagePixelT rhs, VariancePixelT varLhs, VariancePixelT varRhs) {
-        ImagePixelT const rhs2 = rhs * rhs;
-        return (lhs * lhs * varRhs + rhs2 * varLhs) / (rhs2 * rhs2);
-    }
-};
-/// @internal Functor to calculate the variance of the ratio of two independent variables, the second scaled
-/// by c
-template <typename ImagePixelT, typename VariancePixelT>
-struct scaledQuotientVariance {
-    double _c;
-    scaledQuotientVariance(double c) : _c(c) {}
-    double operator()(ImagePixelT lhs, ImagePixelT rhs, VariancePixelT varLhs, VariancePixelT varRhs) {
-        ImagePixelT const rhs2 = rhs * rhs;
-        return (lhs * lhs * varRhs + rhs2 * varLhs) / (_c * _c * rhs2 * rhs2);
-    }
-};
-}  // namespace
-
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::
 operator/=(MaskedImage const& rhs) {
-    // Must do variance before we modify the image values
-    transform_pixels(_image->_getRawView(),         // lhs
-                     rhs._image->_getRawView(),     // rhs,
-                     _variance->_getRawView(),      // Var(lhs),
-                     rhs._variance->_getRawView(),  // Var(rhs)
-                     _variance->_getRawView(),      // result
-                     quotientVariance<ImagePixelT, VariancePixelT>());
-
-    *_image /= *rhs.getImage();
-    *_mask |= *rhs.getMask();
+    applyFused(*this, rhs,
+               [](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                  MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       ImagePixelT const l = im[x], r = rIm[x];
+                       ImagePixelT const r2 = r * r;
+                       var[x] = static_cast<VariancePixelT>((l * l * rVar[x] + r2 * var[x]) / (r2 * r2));
+                       im[x] = l / r;
+                       mk[x] |= rMk[x];
+                   }
+               });
     return *this;
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::scaledDivides(double const c,
                                                                          MaskedImage const& rhs) {
-    // Must do variance before we modify the image values
-    transform_pixels(_image->_getRawView(),         // lhs
-                     rhs._image->_getRawView(),     // rhs,
-                     _variance->_getRawView(),      // Var(lhs),
-                     rhs._variance->_getRawView(),  // Var(rhs)
-                     _variance->_getRawView(),      // result
-                     scaledQuotientVariance<ImagePixelT, VariancePixelT>(c));
-
-    (*_image).scaledDivides(c, *rhs.getImage());
-    *_mask |= *rhs._mask;
+    applyFused(*this, rhs,
+               [c](ImagePixelT* im, MaskPixelT* mk, VariancePixelT* var, ImagePixelT const* rIm,
+                   MaskPixelT const* rMk, VariancePixelT const* rVar, std::size_t width) {
+                   for (std::size_t x = 0; x < width; ++x) {
+                       ImagePixelT const l = im[x], r = rIm[x];
+                       ImagePixelT const r2 = r * r;
+                       var[x] = static_cast<VariancePixelT>((l * l * rVar[x] + r2 * var[x]) /
+                                                            (c * c * r2 * r2));
+                       im[x] = l / static_cast<ImagePixelT>(c * r);
+                       mk[x] |= rMk[x];
+                   }
+               });
 }
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
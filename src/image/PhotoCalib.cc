@@ -20,9 +20,11 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "lsst/geom/Point.h"
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/image/PhotoCalib.h"
 #include "lsst/afw/math/BoundedField.h"
 #include "lsst/afw/table/Source.h"
@@ -83,6 +85,40 @@ double toMagnitudeErr(double instFlux, double instFluxErr, double scale, double
     return 2.5 / log(10.0) * hypot(instFluxErr / instFlux, scaleErr / scale);
 }
 
+// Number of records whose calibrations are evaluated in one call to BoundedField::evaluate.
+std::size_t const CHUNK_SIZE = 4096;
+
+// Return a field's values for all records, without copying if the catalog is contiguous.
+ndarray::Array<double const, 1> getColumn(afw::table::SourceCatalog const &catalog,
+                                          afw::table::Key<double> const &key) {
+    if (!catalog.empty() && catalog.isContiguous()) {
+        return catalog.getColumnView()[key].shallow();
+    }
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(catalog.size());
+    auto iter = result.begin();
+    for (auto const &record : catalog) {
+        *iter++ = record.get(key);
+    }
+    return result;
+}
+
+// Write the columns of a (N, 2) array to a pair of fields.
+void setColumns(afw::table::SourceCatalog &catalog, afw::table::Key<double> const &key0,
+                afw::table::Key<double> const &key1, ndarray::Array<double const, 2, 2> const &values) {
+    if (!catalog.empty() && catalog.isContiguous()) {
+        auto columns = catalog.getColumnView();
+        columns[key0] = values[ndarray::view()(0)];
+        columns[key1] = values[ndarray::view()(1)];
+        return;
+    }
+    std::size_t i = 0;
+    for (auto &record : catalog) {
+        record.set(key0, values[i][0]);
+        record.set(key1, values[i][1]);
+        ++i;
+    }
+}
+
 }  // anonymous namespace
 
 // ------------------- Conversions to Maggies -------------------
@@ -125,16 +161,10 @@ ndarray::Array<double, 2, 2> PhotoCalib::instFluxToMaggies(afw::table::SourceCat
 
 void PhotoCalib::instFluxToMaggies(afw::table::SourceCatalog &sourceCatalog, std::string const &instFluxField,
                                    std::string const &outField) const {
-    auto instFluxKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFlux").key;
-    auto instFluxErrKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFluxErr").key;
     auto maggiesKey = sourceCatalog.getSchema().find<double>(outField + "_instFlux").key;
     auto maggiesErrKey = sourceCatalog.getSchema().find<double>(outField + "_instFluxErr").key;
-    for (auto &record : sourceCatalog) {
-        auto result =
-                instFluxToMaggies(record.get(instFluxKey), record.get(instFluxErrKey), record.getCentroid());
-        record.set(maggiesKey, result.value);
-        record.set(maggiesErrKey, result.err);
-    }
+    ndarray::Array<double, 2, 2> result = instFluxToMaggies(sourceCatalog, instFluxField);
+    setColumns(sourceCatalog, maggiesKey, maggiesErrKey, result);
 }
 
 // ------------------- Conversions to Magnitudes -------------------
@@ -180,16 +210,10 @@ ndarray::Array<double, 2, 2> PhotoCalib::instFluxToMagnitude(afw::table::SourceC
 
 void PhotoCalib::instFluxToMagnitude(afw::table::SourceCatalog &sourceCatalog,
                                      std::string const &instFluxField, std::string const &outField) const {
-    auto instFluxKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFlux").key;
-    auto instFluxErrKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFluxErr").key;
     auto magKey = sourceCatalog.getSchema().find<double>(outField + "_mag").key;
     auto magErrKey = sourceCatalog.getSchema().find<double>(outField + "_magErr").key;
-    for (auto &record : sourceCatalog) {
-        auto result = instFluxToMagnitude(record.get(instFluxKey), record.get(instFluxErrKey),
-                                          record.getCentroid());
-        record.set(magKey, result.value);
-        record.set(magErrKey, result.err);
-    }
+    ndarray::Array<double, 2, 2> result = instFluxToMagnitude(sourceCatalog, instFluxField);
+    setColumns(sourceCatalog, magKey, magErrKey, result);
 }
 
 // ------------------- other utility methods -------------------
@@ -321,38 +345,55 @@ double PhotoCalib::evaluate(lsst::geom::Point<double, 2> const &point) const {
         return _calibration->evaluate(point);
 }
 
+ndarray::Array<double const, 1> PhotoCalib::evaluateCatalog(
+        afw::table::SourceCatalog const &sourceCatalog) const {
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(sourceCatalog.size());
+    if (_isConstant) {
+        result.deep() = _calibrationMean;
+        return result;
+    }
+    auto const &centroidSlot = sourceCatalog.getTable()->getCentroidSlot();
+    if (!centroidSlot.isValid()) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError,
+                          "Catalog has no centroid slot, required by a spatially-varying PhotoCalib.");
+    }
+    auto const x = getColumn(sourceCatalog, centroidSlot.getMeasKey().getX());
+    auto const y = getColumn(sourceCatalog, centroidSlot.getMeasKey().getY());
+    std::size_t const size = sourceCatalog.size();
+    std::size_t const nChunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    lsst::afw::detail::parallelFor(0, nChunks, [&](std::size_t chunk) {
+        auto const range = ndarray::view(chunk * CHUNK_SIZE, std::min(size, (chunk + 1) * CHUNK_SIZE));
+        result[range].deep() = _calibration->evaluate(x[range], y[range]);
+    });
+    return result;
+}
+
 void PhotoCalib::instFluxToMaggiesArray(afw::table::SourceCatalog const &sourceCatalog,
                                         std::string const &instFluxField,
                                         ndarray::Array<double, 2, 2> result) const {
-    double instFlux, instFluxErr, maggies, calibration;
     auto instFluxKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFlux").key;
     auto instFluxErrKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFluxErr").key;
-    auto iter = result.begin();
-    for (auto const &rec : sourceCatalog) {
-        instFlux = rec.get(instFluxKey);
-        instFluxErr = rec.get(instFluxErrKey);
-        calibration = evaluate(rec.getCentroid());
-        maggies = toMaggies(instFlux, calibration);
-        (*iter)[0] = maggies;
-        (*iter)[1] = toMaggiesErr(instFlux, instFluxErr, calibration, _calibrationErr, maggies);
-        iter++;
+    auto const instFlux = getColumn(sourceCatalog, instFluxKey);
+    auto const instFluxErr = getColumn(sourceCatalog, instFluxErrKey);
+    auto const calibration = evaluateCatalog(sourceCatalog);
+    for (std::size_t i = 0, n = sourceCatalog.size(); i < n; ++i) {
+        double const maggies = toMaggies(instFlux[i], calibration[i]);
+        result[i][0] = maggies;
+        result[i][1] = toMaggiesErr(instFlux[i], instFluxErr[i], calibration[i], _calibrationErr, maggies);
     }
 }
 
 void PhotoCalib::instFluxToMagnitudeArray(afw::table::SourceCatalog const &sourceCatalog,
                                           std::string const &instFluxField,
                                           ndarray::Array<double, 2, 2> result) const {
-    double instFlux, instFluxErr, calibration;
     auto instFluxKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFlux").key;
     auto instFluxErrKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFluxErr").key;
-    auto iter = result.begin();
-    for (auto const &rec : sourceCatalog) {
-        instFlux = rec.get(instFluxKey);
-        instFluxErr = rec.get(instFluxErrKey);
-        calibration = evaluate(rec.getCentroid());
-        (*iter)[0] = toMagnitude(instFlux, calibration);
-        (*iter)[1] = toMagnitudeErr(instFlux, instFluxErr, calibration, _calibrationErr);
-        iter++;
+    auto const instFlux = getColumn(sourceCatalog, instFluxKey);
+    auto const instFluxErr = getColumn(sourceCatalog, instFluxErrKey);
+    auto const calibration = evaluateCatalog(sourceCatalog);
+    for (std::size_t i = 0, n = sourceCatalog.size(); i < n; ++i) {
+        result[i][0] = toMagnitude(instFlux[i], calibration[i]);
+        result[i][1] = toMagnitudeErr(instFlux[i], instFluxErr[i], calibration[i], _calibrationErr);
     }
 }
 
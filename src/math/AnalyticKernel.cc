@@ -80,12 +80,45 @@ std::shared_ptr<Kernel> AnalyticKernel::resized(int width, int height) const {
 }
 
 double AnalyticKernel::computeImage(image::Image<Pixel> &image, bool doNormalize, double x, double y) const {
+    return computeImage(image, doNormalize, computeKernelParameters(x, y));
+}
+
+double AnalyticKernel::computeImage(image::Image<Pixel> &image, bool doNormalize,
+                                    std::vector<double> const &kernelParams) const {
+    checkKernelParameters(kernelParams);
     lsst::geom::Extent2I llBorder = (image.getDimensions() - getDimensions()) / 2;
     image.setXY0(lsst::geom::Point2I(-lsst::geom::Extent2I(getCtr() + llBorder)));
-    if (this->isSpatiallyVarying()) {
-        this->setKernelParametersFromSpatialModel(x, y);
+    return doComputeImage(image, doNormalize, kernelParams);
+}
+
+namespace {
+
+// A copy of an AnalyticKernel's function, whose parameters are set for each image
+struct AnalyticWorkspace : public Kernel::Workspace {
+    explicit AnalyticWorkspace(AnalyticKernel const &kernel)
+            : Kernel::Workspace(kernel), function(kernel.getKernelFunction()) {}
+
+    AnalyticKernel::KernelFunctionPtr function;
+};
+
+}  // namespace
+
+double AnalyticKernel::computeImage(image::Image<Pixel> &image, bool doNormalize, double x, double y,
+                                    Workspace &workspace) const {
+    checkWorkspace(workspace);
+    if (!this->isSpatiallyVarying()) {
+        return computeImage(image, doNormalize, x, y);
     }
-    return doComputeImage(image, doNormalize);
+    std::vector<double> &kernelParams = workspace.getKernelParameters();
+    computeKernelParametersFromSpatialModel(kernelParams, x, y);
+    checkKernelParameters(kernelParams);
+    lsst::geom::Extent2I llBorder = (image.getDimensions() - getDimensions()) / 2;
+    image.setXY0(lsst::geom::Point2I(-lsst::geom::Extent2I(getCtr() + llBorder)));
+    return doComputeImageWithWorkspace(image, doNormalize, kernelParams, workspace);
+}
+
+std::unique_ptr<Kernel::Workspace> AnalyticKernel::makeWorkspace() const {
+    return std::make_unique<AnalyticWorkspace>(*this);
 }
 
 AnalyticKernel::KernelFunctionPtr AnalyticKernel::getKernelFunction() const {
@@ -108,16 +141,21 @@ std::vector<double> AnalyticKernel::getKernelParameters() const {
 //
 // Protected Member Functions
 //
-double AnalyticKernel::doComputeImage(image::Image<Pixel> &image, bool doNormalize) const {
+namespace {
+
+// Set the pixels of an AnalyticKernel's image from its function, and return their sum
+double computeImageFromFunction(image::Image<Kernel::Pixel> &image, bool doNormalize,
+                                AnalyticKernel::KernelFunction const &function) {
+    // evaluateRow (unlike operator()) leaves the function's caches alone
+    int const width = image.getWidth();
+    double const x0 = image.indexToPosition(0, image::X);
+    auto const array = image.getArray();
     double imSum = 0;
     for (int y = 0; y != image.getHeight(); ++y) {
-        double const fy = image.indexToPosition(y, image::Y);
-        image::Image<Pixel>::x_iterator ptr = image.row_begin(y);
-        for (int x = 0; x != image.getWidth(); ++x, ++ptr) {
-            double const fx = image.indexToPosition(x, image::X);
-            Pixel const pixelVal = (*_kernelFunctionPtr)(fx, fy);
-            *ptr = pixelVal;
-            imSum += pixelVal;
+        Kernel::Pixel *row = array[y].getData();
+        function.evaluateRow(image.indexToPosition(y, image::Y), x0, width, row);
+        for (int x = 0; x != width; ++x) {
+            imSum += row[x];
         }
     }
 
@@ -132,6 +170,29 @@ double AnalyticKernel::doComputeImage(image::Image<Pixel> &image, bool doNormali
     return imSum;
 }
 
+}  // namespace
+
+double AnalyticKernel::doComputeImage(image::Image<Pixel> &image, bool doNormalize,
+                                      std::vector<double> const &kernelParams) const {
+    // Use a copy of the kernel function if it needs different parameters, so this kernel is never
+    // modified
+    if (kernelParams == _kernelFunctionPtr->getParameters()) {
+        return computeImageFromFunction(image, doNormalize, *_kernelFunctionPtr);
+    }
+    KernelFunctionPtr kernelFunctionPtr = _kernelFunctionPtr->clone();
+    kernelFunctionPtr->setParameters(kernelParams);
+    return computeImageFromFunction(image, doNormalize, *kernelFunctionPtr);
+}
+
+double AnalyticKernel::doComputeImageWithWorkspace(image::Image<Pixel> &image, bool doNormalize,
+                                                   std::vector<double> const &kernelParams,
+                                                   Workspace &workspace) const {
+    // Setting the parameters of the workspace's copy of the function reuses its storage
+    KernelFunction &function = *static_cast<AnalyticWorkspace &>(workspace).function;
+    function.setParameters(kernelParams);
+    return computeImageFromFunction(image, doNormalize, function);
+}
+
 void AnalyticKernel::setKernelParameter(unsigned int ind, double value) const {
     _kernelFunctionPtr->setParameter(ind, value);
 }
@@ -21,9 +21,13 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "ndarray/eigen.h"
+#include "lsst/pex/exceptions.h"
 #include "lsst/afw/math/LeastSquares.h"
 #include "lsst/afw/math/ChebyshevBoundedField.h"
 #include "lsst/afw/math/detail/TrapezoidalPacker.h"
@@ -285,6 +289,121 @@ double ChebyshevBoundedField::evaluate(lsst::geom::Point2D const& position) cons
                               _coefficients.getSize<0>());
 }
 
+ndarray::Array<double, 1, 1> ChebyshevBoundedField::evaluate(ndarray::Array<double const, 1> const& x,
+                                                             ndarray::Array<double const, 1> const& y) const {
+    if (x.getSize<0>() != y.getSize<0>()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "x length " + std::to_string(x.getSize<0>()) + " != y length " +
+                                  std::to_string(y.getSize<0>()));
+    }
+    int const nPoints = x.getSize<0>();
+    int const nOrderX = _coefficients.getSize<1>();
+    int const nOrderY = _coefficients.getSize<0>();
+    double const scaleX = _toChebyshevRange[lsst::geom::AffineTransform::XX];
+    double const offsetX = _toChebyshevRange[lsst::geom::AffineTransform::X];
+    double const scaleY = _toChebyshevRange[lsst::geom::AffineTransform::YY];
+    double const offsetY = _toChebyshevRange[lsst::geom::AffineTransform::Y];
+
+    // This is the same pair of nested Clenshaw recurrences as the single-point evaluate(), run for a
+    // block of points at a time with the points in the innermost loops.
+    int const blockSize = 256;
+    std::vector<double> sx(blockSize), sy(blockSize), cx(blockSize), bx1(blockSize), bx2(blockSize),
+            by1(blockSize), by2(blockSize);
+    ndarray::Array<double, 1, 1> out = ndarray::allocate(nPoints);
+    for (int start = 0; start < nPoints; start += blockSize) {
+        int const n = std::min(blockSize, nPoints - start);
+        for (int p = 0; p < n; ++p) {
+            sx[p] = scaleX * x[start + p] + offsetX;
+            sy[p] = scaleY * y[start + p] + offsetY;
+        }
+        std::fill(by1.begin(), by1.end(), 0.0);
+        std::fill(by2.begin(), by2.end(), 0.0);
+        for (int j = nOrderY - 1; j >= 0; --j) {
+            // Evaluate the series in x for row j of the coefficients.
+            auto const row = _coefficients[j];
+            std::fill(bx1.begin(), bx1.end(), 0.0);
+            std::fill(bx2.begin(), bx2.end(), 0.0);
+            for (int i = nOrderX - 1; i > 0; --i) {
+                double const c = row[i];
+                for (int p = 0; p < n; ++p) {
+                    double const b = c + 2 * sx[p] * bx1[p] - bx2[p];
+                    bx2[p] = bx1[p];
+                    bx1[p] = b;
+                }
+            }
+            double const c0 = row[0];
+            for (int p = 0; p < n; ++p) {
+                cx[p] = c0 + sx[p] * bx1[p] - bx2[p];
+            }
+            // Use that as the coefficient of T_j(y).
+            if (j > 0) {
+                for (int p = 0; p < n; ++p) {
+                    double const b = cx[p] + 2 * sy[p] * by1[p] - by2[p];
+                    by2[p] = by1[p];
+                    by1[p] = b;
+                }
+            } else {
+                for (int p = 0; p < n; ++p) {
+                    out[start + p] = cx[p] + sy[p] * by1[p] - by2[p];
+                }
+            }
+        }
+    }
+    return out;
+}
+
+ndarray::Array<double, 2, 2> ChebyshevBoundedField::evaluateGrid(
+        ndarray::Array<double const, 1> const& x, ndarray::Array<double const, 1> const& y) const {
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    int const nOrderX = _coefficients.getSize<1>();
+    int const nOrderY = _coefficients.getSize<0>();
+    double const scaleX = _toChebyshevRange[lsst::geom::AffineTransform::XX];
+    double const offsetX = _toChebyshevRange[lsst::geom::AffineTransform::X];
+    double const scaleY = _toChebyshevRange[lsst::geom::AffineTransform::YY];
+    double const offsetY = _toChebyshevRange[lsst::geom::AffineTransform::Y];
+
+    // T_i(x) for every column, with i along rows so each basis function is contiguous in x.
+    ndarray::Array<double, 2, 2> tx = ndarray::allocate(std::max(nOrderX, 2), nx);
+    for (int j = 0; j < nx; ++j) {
+        tx[0][j] = 1.0;
+        tx[1][j] = scaleX * x[j] + offsetX;
+    }
+    for (int i = 2; i < nOrderX; ++i) {
+        double* t = tx[i].getData();
+        double const* t1 = tx[i - 1].getData();
+        double const* t2 = tx[i - 2].getData();
+        double const* t0 = tx[1].getData();
+        for (int j = 0; j < nx; ++j) {
+            t[j] = 2.0 * t0[j] * t1[j] - t2[j];
+        }
+    }
+
+    ndarray::Array<double, 2, 2> out = ndarray::allocate(ny, nx);
+    ndarray::Array<double, 1, 1> ty = ndarray::allocate(nOrderY);
+    std::vector<double> cx(nOrderX);
+    for (int k = 0; k < ny; ++k) {
+        // Contract the coefficients with T_j(y) to get the 1-d Chebyshev series in x for this row.
+        evaluateBasis1d(ty, scaleY * y[k] + offsetY);
+        std::fill(cx.begin(), cx.end(), 0.0);
+        for (int j = 0; j < nOrderY; ++j) {
+            for (int i = 0; i < nOrderX; ++i) {
+                cx[i] += ty[j] * _coefficients[j][i];
+            }
+        }
+        double* row = out[k].getData();
+        std::fill(row, row + nx, 0.0);
+        for (int i = 0; i < nOrderX; ++i) {
+            double const c = cx[i];
+            double const* t = tx[i].getData();
+            for (int j = 0; j < nx; ++j) {
+                row[j] += c * t[j];
+            }
+        }
+    }
+    return out;
+}
+
 // The integral of T_n(x) over [-1,1]:
 // https://en.wikipedia.org/wiki/Chebyshev_polynomials#Differentiation_and_integration
 double integrateTn(int n) {
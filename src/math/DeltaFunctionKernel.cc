@@ -83,7 +83,8 @@ std::string DeltaFunctionKernel::toString(std::string const& prefix) const {
     return os.str();
 }
 
-double DeltaFunctionKernel::doComputeImage(image::Image<Pixel>& image, bool) const {
+double DeltaFunctionKernel::doComputeImage(image::Image<Pixel>& image, bool,
+                                           std::vector<double> const&) const {
     const int pixelX = getPixel().getX();  // active pixel in Kernel
     const int pixelY = getPixel().getY();
 
@@ -101,7 +101,8 @@ std::shared_ptr<Kernel> FixedKernel::resized(int width, int height) const {
     return retPtr;
 }
 
-double FixedKernel::doComputeImage(image::Image<Pixel>& image, bool doNormalize) const {
+double FixedKernel::doComputeImage(image::Image<Pixel>& image, bool doNormalize,
+                                   std::vector<double> const&) const {
     double multFactor = 1.0;
     double imSum = this->_sum;
     if (doNormalize) {
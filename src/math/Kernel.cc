@@ -91,17 +91,49 @@ Kernel::Kernel(int width, int height, unsigned int nKernelParams, SpatialFunctio
 }
 
 double Kernel::computeImage(image::Image<Pixel> &image, bool doNormalize, double x, double y) const {
-    if (image.getDimensions() != this->getDimensions()) {
+    return computeImage(image, doNormalize, computeKernelParameters(x, y));
+}
+
+namespace {
+
+void checkImageDimensions(image::Image<Kernel::Pixel> const &image, Kernel const &kernel) {
+    if (image.getDimensions() != kernel.getDimensions()) {
         std::ostringstream os;
         os << "image dimensions = ( " << image.getWidth() << ", " << image.getHeight() << ") != ("
-           << this->getWidth() << ", " << this->getHeight() << ") = kernel dimensions";
+           << kernel.getWidth() << ", " << kernel.getHeight() << ") = kernel dimensions";
         throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
     }
+}
+
+}  // namespace
+
+double Kernel::computeImage(image::Image<Pixel> &image, bool doNormalize,
+                            std::vector<double> const &kernelParams) const {
+    checkImageDimensions(image, *this);
+    checkKernelParameters(kernelParams);
     image.setXY0(-_ctrX, -_ctrY);
-    if (this->isSpatiallyVarying()) {
-        this->setKernelParametersFromSpatialModel(x, y);
+    return doComputeImage(image, doNormalize, kernelParams);
+}
+
+Kernel::Workspace::Workspace(Kernel const &kernel)
+        : _kernel(kernel), _kernelParams(kernel.getNKernelParameters()) {}
+
+std::unique_ptr<Kernel::Workspace> Kernel::makeWorkspace() const {
+    return std::make_unique<Workspace>(*this);
+}
+
+double Kernel::computeImage(image::Image<Pixel> &image, bool doNormalize, double x, double y,
+                            Workspace &workspace) const {
+    checkWorkspace(workspace);
+    if (!this->isSpatiallyVarying()) {
+        return computeImage(image, doNormalize, x, y);
     }
-    return doComputeImage(image, doNormalize);
+    checkImageDimensions(image, *this);
+    std::vector<double> &kernelParams = workspace.getKernelParameters();
+    computeKernelParametersFromSpatialModel(kernelParams, x, y);
+    checkKernelParameters(kernelParams);
+    image.setXY0(-_ctrX, -_ctrY);
+    return doComputeImageWithWorkspace(image, doNormalize, kernelParams, workspace);
 }
 
 Kernel::Kernel(int width, int height, std::vector<SpatialFunctionPtr> spatialFunctionList)
@@ -152,13 +184,23 @@ void Kernel::setSpatialParameters(const std::vector<std::vector<double> > params
 
 void Kernel::computeKernelParametersFromSpatialModel(std::vector<double> &kernelParams, double x,
                                                      double y) const {
+    // Function2::evaluateRow leaves the functions' caches alone, so this may be called concurrently
     std::vector<double>::iterator paramIter = kernelParams.begin();
     std::vector<SpatialFunctionPtr>::const_iterator funcIter = _spatialFunctionList.begin();
     for (; funcIter != _spatialFunctionList.end(); ++funcIter, ++paramIter) {
-        *paramIter = (*(*funcIter))(x, y);
+        (*funcIter)->evaluateRow(y, x, 1, &(*paramIter));
     }
 }
 
+std::vector<double> Kernel::computeKernelParameters(double x, double y) const {
+    if (!this->isSpatiallyVarying()) {
+        return this->getKernelParameters();
+    }
+    std::vector<double> kernelParams(_spatialFunctionList.size());
+    computeKernelParametersFromSpatialModel(kernelParams, x, y);
+    return kernelParams;
+}
+
 Kernel::SpatialFunctionPtr Kernel::getSpatialFunction(unsigned int index) const {
     if (index >= _spatialFunctionList.size()) {
         if (!this->isSpatiallyVarying()) {
@@ -235,12 +277,33 @@ void Kernel::setKernelParameter(unsigned int, double) const {
 }
 
 void Kernel::setKernelParametersFromSpatialModel(double x, double y) const {
-    std::vector<SpatialFunctionPtr>::const_iterator funcIter = _spatialFunctionList.begin();
-    for (int ii = 0; funcIter != _spatialFunctionList.end(); ++funcIter, ++ii) {
-        this->setKernelParameter(ii, (*(*funcIter))(x, y));
+    std::vector<double> kernelParams(_spatialFunctionList.size());
+    computeKernelParametersFromSpatialModel(kernelParams, x, y);
+    for (unsigned int ii = 0; ii < kernelParams.size(); ++ii) {
+        this->setKernelParameter(ii, kernelParams[ii]);
+    }
+}
+
+void Kernel::checkKernelParameters(std::vector<double> const &kernelParams) const {
+    if (kernelParams.size() != this->getNKernelParameters()) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          (boost::format("kernelParams has %d entries instead of %d") % kernelParams.size() %
+                           this->getNKernelParameters())
+                                  .str());
+    }
+}
+
+void Kernel::checkWorkspace(Workspace const &workspace) const {
+    if (&workspace.getKernel() != this) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, "Workspace was made by a different kernel");
     }
 }
 
+double Kernel::doComputeImageWithWorkspace(image::Image<Pixel> &image, bool doNormalize,
+                                           std::vector<double> const &kernelParams, Workspace &) const {
+    return doComputeImage(image, doNormalize, kernelParams);
+}
+
 std::string Kernel::getPythonModule() const { return "lsst.afw.math"; }
 }  // namespace math
 }  // namespace afw
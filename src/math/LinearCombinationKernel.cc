@@ -244,13 +244,14 @@ std::string LinearCombinationKernel::toString(std::string const &prefix) const {
 //
 // Protected Member Functions
 //
-double LinearCombinationKernel::doComputeImage(image::Image<Pixel> &image, bool doNormalize) const {
+double LinearCombinationKernel::doComputeImage(image::Image<Pixel> &image, bool doNormalize,
+                                               std::vector<double> const &kernelParams) const {
     image = 0.0;
     double imSum = 0.0;
     std::vector<std::shared_ptr<image::Image<Pixel>>>::const_iterator kImPtrIter =
             _kernelImagePtrList.begin();
     std::vector<double>::const_iterator kSumIter = _kernelSumList.begin();
-    std::vector<double>::const_iterator kParIter = _kernelParams.begin();
+    std::vector<double>::const_iterator kParIter = kernelParams.begin();
     for (; kImPtrIter != _kernelImagePtrList.end(); ++kImPtrIter, ++kSumIter, ++kParIter) {
         image.scaledPlus(*kParIter, **kImPtrIter);
         imSum += (*kSumIter) * (*kParIter);
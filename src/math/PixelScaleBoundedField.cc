@@ -21,6 +21,10 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+#include <string>
+#include <vector>
+
 #include "lsst/afw/math/PixelScaleBoundedField.h"
 
 namespace lsst {
@@ -31,6 +35,36 @@ double PixelScaleBoundedField::evaluate(lsst::geom::Point2D const &position) con
     return std::pow(_skyWcs.getPixelScale(position).asDegrees(), 2) * _inverseScale;
 }
 
+ndarray::Array<double, 1, 1> PixelScaleBoundedField::evaluate(
+        ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) const {
+    if (x.getSize<0>() != y.getSize<0>()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "x length " + std::to_string(x.getSize<0>()) + " != y length " +
+                                  std::to_string(y.getSize<0>()));
+    }
+    // As SkyWcs::getPixelScale, but with the three points needed for each position gathered into a
+    // single vector.
+    int const nPoints = x.getSize<0>();
+    std::vector<lsst::geom::Point2D> pixels;
+    pixels.reserve(3 * nPoints);
+    for (int i = 0; i < nPoints; ++i) {
+        pixels.emplace_back(x[i], y[i]);
+        pixels.emplace_back(x[i] + 1.0, y[i]);
+        pixels.emplace_back(x[i], y[i] + 1.0);
+    }
+    std::vector<lsst::geom::SpherePoint> const sky = _skyWcs.pixelToSky(pixels);
+    ndarray::Array<double, 1, 1> out = ndarray::allocate(nPoints);
+    for (int i = 0; i < nPoints; ++i) {
+        auto const skyLL = sky[3 * i].getVector();
+        auto const skyDx = sky[3 * i + 1].getVector() - skyLL;
+        auto const skyDy = sky[3 * i + 2].getVector() - skyLL;
+        double const skyAreaSq = skyDx.cross(skyDy).getSquaredNorm();
+        lsst::geom::Angle const scale = std::pow(skyAreaSq, 0.25) * lsst::geom::radians;
+        out[i] = std::pow(scale.asDegrees(), 2) * _inverseScale;
+    }
+    return out;
+}
+
 bool PixelScaleBoundedField::operator==(BoundedField const &rhs) const {
     auto rhsCasted = dynamic_cast<PixelScaleBoundedField const *>(&rhs);
     if (!rhsCasted) return false;
@@ -44,8 +44,6 @@ SeparableKernel::SeparableKernel()
         : Kernel(),
           _kernelColFunctionPtr(),
           _kernelRowFunctionPtr(),
-          _localColList(0),
-          _localRowList(0),
           _kernelX(0),
           _kernelY(0),
           _kernelRowCache(0),
@@ -60,8 +58,6 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
                  spatialFunction),
           _kernelColFunctionPtr(kernelColFunction.clone()),
           _kernelRowFunctionPtr(kernelRowFunction.clone()),
-          _localColList(width),
-          _localRowList(height),
           _kernelX(width),
           _kernelY(height),
           _kernelRowCache(0),
@@ -75,8 +71,6 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
         : Kernel(width, height, spatialFunctionList),
           _kernelColFunctionPtr(kernelColFunction.clone()),
           _kernelRowFunctionPtr(kernelRowFunction.clone()),
-          _localColList(width),
-          _localRowList(height),
           _kernelX(width),
           _kernelY(height),
           _kernelRowCache(0),
@@ -122,19 +116,96 @@ std::shared_ptr<Kernel> SeparableKernel::resized(int width, int height) const {
 
 double SeparableKernel::computeVectors(std::vector<Pixel>& colList, std::vector<Pixel>& rowList,
                                        bool doNormalize, double x, double y) const {
-    if (static_cast<int>(colList.size()) != this->getWidth() ||
-        static_cast<int>(rowList.size()) != this->getHeight()) {
-        std::ostringstream os;
-        os << "colList.size(), rowList.size() = (" << colList.size() << ", " << rowList.size() << ") != ("
-           << this->getWidth() << ", " << this->getHeight() << ") = "
-           << "kernel dimensions";
-        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
-    }
     if (this->isSpatiallyVarying()) {
-        this->setKernelParametersFromSpatialModel(x, y);
+        return computeVectors(colList, rowList, doNormalize, computeKernelParameters(x, y));
+    }
+    _checkVectors(colList, rowList);
+
+    return basicComputeVectors(colList, rowList, doNormalize, *_kernelColFunctionPtr, *_kernelRowFunctionPtr);
+}
+
+namespace {
+/**
+ * @internal Return a function with parameters [begin, begin + function->getNParameters())
+ *
+ * This is function itself if it already has those parameters, else a modified copy.
+ */
+SeparableKernel::KernelFunctionPtr withParameters(SeparableKernel::KernelFunctionPtr const& function,
+                                                  std::vector<double>::const_iterator begin) {
+    std::vector<double> const& params = function->getParameters();
+    if (std::equal(params.begin(), params.end(), begin)) {
+        return function;
     }
+    SeparableKernel::KernelFunctionPtr copy = function->clone();
+    copy->setParameters(std::vector<double>(begin, begin + params.size()));
+    return copy;
+}
+}  // namespace
+
+double SeparableKernel::computeVectors(std::vector<Pixel>& colList, std::vector<Pixel>& rowList,
+                                       bool doNormalize, std::vector<double> const& kernelParams) const {
+    _checkVectors(colList, rowList);
+    checkKernelParameters(kernelParams);
+
+    // Never modify this kernel's functions, so several threads may compute vectors at once
+    KernelFunctionPtr colFunctionPtr = withParameters(_kernelColFunctionPtr, kernelParams.begin());
+    KernelFunctionPtr rowFunctionPtr = withParameters(
+            _kernelRowFunctionPtr, kernelParams.begin() + _kernelColFunctionPtr->getNParameters());
+    return basicComputeVectors(colList, rowList, doNormalize, *colFunctionPtr, *rowFunctionPtr);
+}
 
-    return basicComputeVectors(colList, rowList, doNormalize);
+namespace {
+// Copies of a SeparableKernel's functions, whose parameters are set for each position, and its vectors
+struct SeparableWorkspace : public Kernel::Workspace {
+    explicit SeparableWorkspace(SeparableKernel const& kernel)
+            : Kernel::Workspace(kernel),
+              colFunction(kernel.getKernelColFunction()),
+              rowFunction(kernel.getKernelRowFunction()),
+              colList(kernel.getWidth()),
+              rowList(kernel.getHeight()) {}
+
+    SeparableKernel::KernelFunctionPtr colFunction;
+    SeparableKernel::KernelFunctionPtr rowFunction;
+    std::vector<Kernel::Pixel> colList;
+    std::vector<Kernel::Pixel> rowList;
+};
+
+// Set the parameters of function to [begin, begin + function.getNParameters()) without allocating
+void setFunctionParameters(SeparableKernel::KernelFunction& function,
+                           std::vector<double>::const_iterator begin) {
+    for (unsigned int i = 0; i != function.getNParameters(); ++i, ++begin) {
+        function.setParameter(i, *begin);
+    }
+}
+
+// Set image(col, row) = colList(col) * rowList(row)
+void fillImage(image::Image<Kernel::Pixel>& image, std::vector<Kernel::Pixel> const& colList,
+               std::vector<Kernel::Pixel> const& rowList) {
+    for (int y = 0; y != image.getHeight(); ++y) {
+        image::Image<Kernel::Pixel>::x_iterator imPtr = image.row_begin(y);
+        for (std::vector<Kernel::Pixel>::const_iterator colIter = colList.begin(); colIter != colList.end();
+             ++colIter, ++imPtr) {
+            *imPtr = (*colIter) * rowList[y];
+        }
+    }
+}
+}  // namespace
+
+double SeparableKernel::computeVectors(std::vector<Pixel>& colList, std::vector<Pixel>& rowList,
+                                       bool doNormalize, double x, double y, Workspace& workspace) const {
+    checkWorkspace(workspace);
+    if (!this->isSpatiallyVarying()) {
+        return computeVectors(colList, rowList, doNormalize, x, y);
+    }
+    _checkVectors(colList, rowList);
+    std::vector<double>& kernelParams = workspace.getKernelParameters();
+    computeKernelParametersFromSpatialModel(kernelParams, x, y);
+    checkKernelParameters(kernelParams);
+    return _computeVectors(colList, rowList, doNormalize, kernelParams, workspace);
+}
+
+std::unique_ptr<Kernel::Workspace> SeparableKernel::makeWorkspace() const {
+    return std::make_unique<SeparableWorkspace>(*this);
 }
 
 SeparableKernel::KernelFunctionPtr SeparableKernel::getKernelColFunction() const {
@@ -169,17 +240,23 @@ std::vector<double> SeparableKernel::getKernelParameters() const {
 // Protected Member Functions
 //
 
-double SeparableKernel::doComputeImage(image::Image<Pixel>& image, bool doNormalize) const {
-    double imSum = basicComputeVectors(_localColList, _localRowList, doNormalize);
-
-    for (int y = 0; y != image.getHeight(); ++y) {
-        image::Image<Pixel>::x_iterator imPtr = image.row_begin(y);
-        for (std::vector<Pixel>::iterator colIter = _localColList.begin(); colIter != _localColList.end();
-             ++colIter, ++imPtr) {
-            *imPtr = (*colIter) * _localRowList[y];
-        }
-    }
+double SeparableKernel::doComputeImage(image::Image<Pixel>& image, bool doNormalize,
+                                       std::vector<double> const& kernelParams) const {
+    std::vector<Pixel> colList(this->getWidth());
+    std::vector<Pixel> rowList(this->getHeight());
+    double imSum = computeVectors(colList, rowList, doNormalize, kernelParams);
+    fillImage(image, colList, rowList);
+    return imSum;
+}
 
+double SeparableKernel::doComputeImageWithWorkspace(image::Image<Pixel>& image, bool doNormalize,
+                                                    std::vector<double> const& kernelParams,
+                                                    Workspace& workspace) const {
+    SeparableWorkspace& separableWorkspace = static_cast<SeparableWorkspace&>(workspace);
+    std::vector<Pixel>& colList = separableWorkspace.colList;
+    std::vector<Pixel>& rowList = separableWorkspace.rowList;
+    double imSum = _computeVectors(colList, rowList, doNormalize, kernelParams, workspace);
+    fillImage(image, colList, rowList);
     return imSum;
 }
 
@@ -196,21 +273,45 @@ void SeparableKernel::setKernelParameter(unsigned int ind, double value) const {
 // Private Member Functions
 //
 
+void SeparableKernel::_checkVectors(std::vector<Pixel> const& colList,
+                                    std::vector<Pixel> const& rowList) const {
+    if (static_cast<int>(colList.size()) != this->getWidth() ||
+        static_cast<int>(rowList.size()) != this->getHeight()) {
+        std::ostringstream os;
+        os << "colList.size(), rowList.size() = (" << colList.size() << ", " << rowList.size() << ") != ("
+           << this->getWidth() << ", " << this->getHeight() << ") = "
+           << "kernel dimensions";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+}
+
+double SeparableKernel::_computeVectors(std::vector<Pixel>& colList, std::vector<Pixel>& rowList,
+                                        bool doNormalize, std::vector<double> const& kernelParams,
+                                        Workspace& workspace) const {
+    SeparableWorkspace& separableWorkspace = static_cast<SeparableWorkspace&>(workspace);
+    KernelFunction& colFunction = *separableWorkspace.colFunction;
+    KernelFunction& rowFunction = *separableWorkspace.rowFunction;
+    setFunctionParameters(colFunction, kernelParams.begin());
+    setFunctionParameters(rowFunction, kernelParams.begin() + colFunction.getNParameters());
+    return basicComputeVectors(colList, rowList, doNormalize, colFunction, rowFunction);
+}
+
 double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::vector<Pixel>& rowList,
-                                            bool doNormalize) const {
+                                            bool doNormalize, KernelFunction const& colFunction,
+                                            KernelFunction const& rowFunction) const {
     double colSum = 0.0;
     if (_kernelColCache.empty()) {
         for (unsigned int i = 0; i != colList.size(); ++i) {
-            double colFuncValue = (*_kernelColFunctionPtr)(_kernelX[i]);
+            double colFuncValue = colFunction(_kernelX[i]);
             colList[i] = colFuncValue;
             colSum += colFuncValue;
         }
     } else {
         int const cacheSize = _kernelColCache.size();
 
-        int const indx = this->getKernelParameter(0) * cacheSize;
+        int const indx = colFunction.getParameter(0) * cacheSize;
 
-        std::vector<double>& cachedValues = _kernelColCache.at(indx);
+        std::vector<double> const& cachedValues = _kernelColCache.at(indx);
         for (unsigned int i = 0; i != colList.size(); ++i) {
             double colFuncValue = cachedValues[i];
             colList[i] = colFuncValue;
@@ -221,16 +322,16 @@ double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::ve
     double rowSum = 0.0;
     if (_kernelRowCache.empty()) {
         for (unsigned int i = 0; i != rowList.size(); ++i) {
-            double rowFuncValue = (*_kernelRowFunctionPtr)(_kernelY[i]);
+            double rowFuncValue = rowFunction(_kernelY[i]);
             rowList[i] = rowFuncValue;
             rowSum += rowFuncValue;
         }
     } else {
         int const cacheSize = _kernelRowCache.size();
 
-        int const indx = this->getKernelParameter(1) * cacheSize;
+        int const indx = rowFunction.getParameter(0) * cacheSize;
 
-        std::vector<double>& cachedValues = _kernelRowCache.at(indx);
+        std::vector<double> const& cachedValues = _kernelRowCache.at(indx);
         for (unsigned int i = 0; i != rowList.size(); ++i) {
             double rowFuncValue = cachedValues[i];
             rowList[i] = rowFuncValue;
@@ -238,10 +339,10 @@ double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::ve
 
 #if 0
             if (indx == cacheSize/2) {
-                if (::fabs(rowFuncValue - (*_kernelRowFunctionPtr)(_kernelX[i])) > 1e-2) {
+                if (::fabs(rowFuncValue - rowFunction(_kernelX[i])) > 1e-2) {
                     std::cout << indx << " " << i << " "
                               << rowFuncValue << " "
-                              << (*_kernelRowFunctionPtr)(_kernelX[i])
+                              << rowFunction(_kernelX[i])
                               << std::endl;
                 }
             }
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ndarray/eigen.h"
 #include "astshim.h"
@@ -64,15 +65,15 @@ ndarray::Array<double, 1, 1> TransformBoundedField::evaluate(ndarray::Array<doub
                                   std::to_string(x.getSize<0>()));
     }
 
-    // TODO if Mapping.applyForward gains support for x, y (DM-11226) then use that instead of copying data
+    // Go through Transform rather than its mapping, so this may be called from several threads at once.
     int const nPoints = x.getSize<0>();
-    ndarray::Array<double, 2, 2> xy = ndarray::allocate(ndarray::makeVector(2, nPoints));
+    std::vector<lsst::geom::Point2D> points;
+    points.reserve(nPoints);
     for (int col = 0; col < nPoints; ++col) {
-        xy[0][col] = x[col];
-        xy[1][col] = y[col];
+        points.emplace_back(x[col], y[col]);
     }
 
-    auto res2D = _transform.getMapping()->applyForward(xy);
+    auto res2D = _transform.applyForward(points);
 
     // res2D has shape 1 x N; return a 1-D view with the extra dimension stripped
     auto resShape = ndarray::makeVector(nPoints);
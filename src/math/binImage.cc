@@ -21,11 +21,17 @@
  */
 
 /*
- * Bin an Image or MaskedImage by an integral factor (the same in x and y)
+ * Bin an Image or MaskedImage by integral factors in x and y
  */
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <limits>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/math/offsetImage.h"
 
 namespace pexExcept = lsst::pex::exceptions;
@@ -34,67 +40,337 @@ namespace lsst {
 namespace afw {
 namespace math {
 
-template <typename ImageT>
-std::shared_ptr<ImageT> binImage(ImageT const& in, int const binsize, lsst::afw::math::Property const flags) {
-    return binImage(in, binsize, binsize, flags);
+namespace {
+
+using image::MaskPixel;
+using image::VariancePixel;
+
+// Minimum number of input pixels in each block of output rows binned by one thread.
+std::size_t const MIN_BLOCK_PIXELS = 1 << 16;
+
+struct BinOptions {
+    Property statistic;
+    MaskPixel andMask;           // ignore input pixels with any of these bits set
+    MaskPixel noGoodPixelsMask;  // set on output pixels with no good input pixels
+    bool nanSafe;                // ignore NaNs, rather than propagating them
+    bool keepPartialBins;        // include bins with fewer than binX*binY pixels at the right and top
+};
+
+// The planes of an input or output image; the mask and variance are empty for Images.
+template <typename PixelT, typename MaskT, typename VarianceT>
+struct Planes {
+    ndarray::Array<PixelT, 2, 1> values;
+    ndarray::Array<MaskT, 2, 1> mask;
+    ndarray::Array<VarianceT, 2, 1> variance;
+
+    bool isMasked() const { return mask.getData() != nullptr; }
+};
+
+template <typename PixelT>
+using InputPlanes = Planes<PixelT const, MaskPixel const, VariancePixel const>;
+
+template <typename PixelT>
+using OutputPlanes = Planes<PixelT, MaskPixel, VariancePixel>;
+
+template <typename PixelT>
+InputPlanes<PixelT> getPlanes(image::Image<PixelT> const& in) {
+    return {in.getArray(), {}, {}};
 }
 
-template <typename ImageT>
-std::shared_ptr<ImageT> binImage(ImageT const& in, int const binX, int const binY,
-                                 lsst::afw::math::Property const flags) {
-    if (flags != lsst::afw::math::MEAN) {
-        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
-                          (boost::format("Only afwMath::MEAN is supported, saw 0x%x") % flags).str());
+template <typename PixelT>
+InputPlanes<PixelT> getPlanes(image::MaskedImage<PixelT> const& in) {
+    return {in.getImage()->getArray(), in.getMask()->getArray(), in.getVariance()->getArray()};
+}
+
+template <typename PixelT>
+OutputPlanes<PixelT> getPlanes(image::Image<PixelT>& out) {
+    return {out.getArray(), {}, {}};
+}
+
+template <typename PixelT>
+OutputPlanes<PixelT> getPlanes(image::MaskedImage<PixelT>& out) {
+    return {out.getImage()->getArray(), out.getMask()->getArray(), out.getVariance()->getArray()};
+}
+
+template <typename PixelT>
+PixelT getEmptyValue() {
+    return std::numeric_limits<PixelT>::has_quiet_NaN ? std::numeric_limits<PixelT>::quiet_NaN() : 0;
+}
+
+/*
+ * Bins one band of input rows into one output row.
+ *
+ * The rows of a band are first reduced column by column into per-column accumulators, a loop over
+ * contiguous memory that the compiler can vectorize, and the accumulators are then reduced across the
+ * columns of each bin.  MEDIAN instead gathers the good pixels of each bin.  Each thread has its own
+ * RowBinner, which holds the accumulators.
+ */
+template <typename PixelT>
+class RowBinner {
+public:
+    RowBinner(InputPlanes<PixelT> const& in, OutputPlanes<PixelT> const& out, int binX, int binY,
+              BinOptions const& options)
+            : _in(in),
+              _out(out),
+              _binX(binX),
+              _binY(binY),
+              _options(options),
+              _inWidth(std::min<int>(in.values.template getSize<1>(),
+                                     out.values.template getSize<1>() * binX)),
+              _inHeight(in.values.template getSize<0>()),
+              _values(_inWidth),
+              _variances(_inWidth),
+              _counts(_inWidth),
+              _nans(_inWidth),
+              _masks(_inWidth) {}
+
+    void operator()(int oy) {
+        int const iyBegin = oy * _binY;
+        int const iyEnd = std::min(iyBegin + _binY, _inHeight);
+        if (_options.statistic == MEDIAN) {
+            binMedian(oy, iyBegin, iyEnd);
+            return;
+        }
+        accumulateColumns(iyBegin, iyEnd);
+        int const outWidth = _out.values.template getSize<1>();
+        bool const isExtremum = _options.statistic == MAX || _options.statistic == MIN;
+        for (int ox = 0; ox < outWidth; ++ox) {
+            int const xBegin = ox * _binX;
+            int const xEnd = std::min(xBegin + _binX, _inWidth);
+            double value = _values[xBegin];
+            double variance = _variances[xBegin];
+            int count = _counts[xBegin];
+            int nans = _nans[xBegin];
+            MaskPixel mask = _masks[xBegin];
+            for (int x = xBegin + 1; x < xEnd; ++x) {
+                if (!isExtremum) {
+                    value += _values[x];
+                    variance += _variances[x];
+                } else if (_counts[x] > 0 && (count == 0 || isBetter(_values[x], value))) {
+                    value = _values[x];
+                    variance = _variances[x];
+                }
+                count += _counts[x];
+                nans += _nans[x];
+                mask |= _masks[x];
+            }
+            if (_options.statistic == MEAN && count > 0) {
+                value /= count;
+                variance /= static_cast<double>(count) * count;
+            }
+            write(oy, ox, value, variance, count, nans, mask);
+        }
     }
-    if (binX <= 0 || binY <= 0) {
-        throw LSST_EXCEPT(pexExcept::DomainError,
-                          (boost::format("Binning must be >= 0, saw %dx%d") % binX % binY).str());
+
+private:
+    bool isBetter(double candidate, double current) const {
+        return _options.statistic == MAX ? candidate > current : candidate < current;
     }
 
-    int const outWidth = in.getWidth() / binX;
-    int const outHeight = in.getHeight() / binY;
+    // Return whether a pixel should be used; NaNs are never used, but are counted in _nans.
+    bool isGood(PixelT value, MaskPixel mask) const {
+        return !(mask & _options.andMask) && !std::isnan(static_cast<double>(value));
+    }
 
-    std::shared_ptr<ImageT> out =
-            std::shared_ptr<ImageT>(new ImageT(lsst::geom::Extent2I(outWidth, outHeight)));
-    out->setXY0(in.getXY0());
-    *out = typename ImageT::SinglePixel(0);
-
-    for (int oy = 0, iy = 0; oy < out->getHeight(); ++oy) {
-        for (int i = 0; i != binY; ++i, ++iy) {
-            typename ImageT::x_iterator optr = out->row_begin(oy);
-            for (typename ImageT::x_iterator iptr = in.row_begin(iy), iend = iptr + binX * outWidth;
-                 iptr < iend;) {
-                typename ImageT::SinglePixel val = *iptr;
-                ++iptr;
-                for (int j = 1; j != binX; ++j, ++iptr) {
-                    val += *iptr;
+    // Reduce the rows [iyBegin, iyEnd) into the per-column accumulators.
+    void accumulateColumns(int iyBegin, int iyEnd) {
+        bool const isExtremum = _options.statistic == MAX || _options.statistic == MIN;
+        std::fill(_values.begin(), _values.end(), 0.0);
+        std::fill(_variances.begin(), _variances.end(), 0.0);
+        std::fill(_counts.begin(), _counts.end(), 0);
+        std::fill(_nans.begin(), _nans.end(), 0);
+        std::fill(_masks.begin(), _masks.end(), 0);
+        for (int iy = iyBegin; iy < iyEnd; ++iy) {
+            PixelT const* values = _in.values[iy].getData();
+            MaskPixel const* masks = _in.isMasked() ? _in.mask[iy].getData() : nullptr;
+            VariancePixel const* variances = _in.isMasked() ? _in.variance[iy].getData() : nullptr;
+            if (!isExtremum && !masks) {
+                // The common case of a plain Image: only NaNs need special handling.
+                for (int x = 0; x < _inWidth; ++x) {
+                    bool const good = !std::isnan(static_cast<double>(values[x]));
+                    _values[x] += good ? values[x] : 0.0;
+                    _counts[x] += good;
+                    _nans[x] += !good;
+                }
+                continue;
+            }
+            for (int x = 0; x < _inWidth; ++x) {
+                MaskPixel const mask = masks ? masks[x] : 0;
+                _masks[x] |= mask;
+                _nans[x] += std::isnan(static_cast<double>(values[x]));
+                if (!isGood(values[x], mask)) {
+                    continue;
+                }
+                double const variance = variances ? variances[x] : 0.0;
+                if (!isExtremum) {
+                    _values[x] += values[x];
+                    _variances[x] += variance;
+                } else if (_counts[x] == 0 || isBetter(values[x], _values[x])) {
+                    _values[x] = values[x];
+                    _variances[x] = variance;
+                }
+                ++_counts[x];
+            }
+        }
+    }
+
+    // Bin the rows [iyBegin, iyEnd) into output row oy, taking the median of each bin.
+    void binMedian(int oy, int iyBegin, int iyEnd) {
+        int const outWidth = _out.values.template getSize<1>();
+        std::vector<double> pixels;
+        pixels.reserve(_binX * _binY);
+        for (int ox = 0; ox < outWidth; ++ox) {
+            int const xBegin = ox * _binX;
+            int const xEnd = std::min(xBegin + _binX, _inWidth);
+            pixels.clear();
+            double variance = 0.0;
+            int nans = 0;
+            MaskPixel mask = 0;
+            for (int iy = iyBegin; iy < iyEnd; ++iy) {
+                PixelT const* values = _in.values[iy].getData();
+                MaskPixel const* masks = _in.isMasked() ? _in.mask[iy].getData() : nullptr;
+                VariancePixel const* variances = _in.isMasked() ? _in.variance[iy].getData() : nullptr;
+                for (int x = xBegin; x < xEnd; ++x) {
+                    MaskPixel const pixelMask = masks ? masks[x] : 0;
+                    mask |= pixelMask;
+                    nans += std::isnan(static_cast<double>(values[x]));
+                    if (isGood(values[x], pixelMask)) {
+                        pixels.push_back(values[x]);
+                        variance += variances ? variances[x] : 0.0;
+                    }
+                }
+            }
+            int const count = pixels.size();
+            double value = 0.0;
+            if (count > 0) {
+                auto const middle = pixels.begin() + count / 2;
+                std::nth_element(pixels.begin(), middle, pixels.end());
+                value = *middle;
+                if (count % 2 == 0) {
+                    value = 0.5 * (value + *std::max_element(pixels.begin(), middle));
                 }
-                *optr += val;
-                ++optr;
+                // The variance of the median of n Gaussian samples is pi/2 times that of their mean.
+                variance *= 0.5 * lsst::geom::PI / (static_cast<double>(count) * count);
+            }
+            write(oy, ox, value, variance, count, nans, mask);
+        }
+    }
+
+    void write(int oy, int ox, double value, double variance, int count, int nans, MaskPixel mask) {
+        if (count == 0 || (nans > 0 && !_options.nanSafe)) {
+            value = std::numeric_limits<double>::quiet_NaN();
+            variance = std::numeric_limits<double>::quiet_NaN();
+        }
+        _out.values[oy][ox] = std::isnan(value) ? getEmptyValue<PixelT>() : static_cast<PixelT>(value);
+        if (_out.isMasked()) {
+            if (count == 0) {
+                mask |= _options.noGoodPixelsMask;
             }
+            _out.mask[oy][ox] = mask;
+            _out.variance[oy][ox] = variance;
         }
-        for (typename ImageT::x_iterator ptr = out->row_begin(oy), end = out->row_end(oy); ptr != end;
-             ++ptr) {
-            *ptr /= binX * binY;
+    }
+
+    InputPlanes<PixelT> const& _in;
+    OutputPlanes<PixelT> const& _out;
+    int const _binX;
+    int const _binY;
+    BinOptions const& _options;
+    int const _inWidth;   // number of input columns that fall in an output pixel
+    int const _inHeight;  // number of input rows
+    // Per-column accumulators for the current band of rows.
+    std::vector<double> _values;
+    std::vector<double> _variances;
+    std::vector<int> _counts;
+    std::vector<int> _nans;
+    std::vector<MaskPixel> _masks;
+};
+
+// Bin blocks of output rows in parallel.
+template <typename PixelT>
+void binPlanes(InputPlanes<PixelT> const& in, OutputPlanes<PixelT> const& out, int binX, int binY,
+               BinOptions const& options) {
+    std::size_t const outHeight = out.values.template getSize<0>();
+    std::size_t const nBlocks = std::max<std::size_t>(
+            1, std::min(outHeight, in.values.template getSize<0>() * in.values.template getSize<1>() /
+                                           MIN_BLOCK_PIXELS));
+    lsst::afw::detail::parallelFor(0, nBlocks, [&](std::size_t block) {
+        RowBinner<PixelT> binner(in, out, binX, binY, options);
+        for (std::size_t oy = block * outHeight / nBlocks, end = (block + 1) * outHeight / nBlocks; oy < end;
+             ++oy) {
+            binner(oy);
         }
+    });
+}
+
+template <typename ImageT>
+std::shared_ptr<ImageT> binImageImpl(ImageT const& in, int const binX, int const binY,
+                                     BinOptions const& options) {
+    Property const statistic = options.statistic;
+    if (statistic != MEAN && statistic != SUM && statistic != MEDIAN && statistic != MIN &&
+        statistic != MAX) {
+        throw LSST_EXCEPT(
+                pexExcept::InvalidParameterError,
+                (boost::format("Only afwMath::MEAN, SUM, MEDIAN, MIN and MAX are supported, saw 0x%x") %
+                 statistic)
+                        .str());
+    }
+    if (binX <= 0 || binY <= 0) {
+        throw LSST_EXCEPT(pexExcept::DomainError,
+                          (boost::format("Binning must be > 0, saw %dx%d") % binX % binY).str());
     }
 
+    int const outWidth = options.keepPartialBins ? (in.getWidth() + binX - 1) / binX : in.getWidth() / binX;
+    int const outHeight =
+            options.keepPartialBins ? (in.getHeight() + binY - 1) / binY : in.getHeight() / binY;
+
+    auto out = std::make_shared<ImageT>(lsst::geom::Extent2I(outWidth, outHeight));
+    out->setXY0(in.getXY0());
+    if (outWidth == 0 || outHeight == 0) {
+        return out;
+    }
+
+    binPlanes(getPlanes(in), getPlanes(*out), binX, binY, options);
     return out;
 }
 
+}  // namespace
+
+template <typename ImageT>
+std::shared_ptr<ImageT> binImage(ImageT const& in, int const binsize, lsst::afw::math::Property const flags) {
+    return binImage(in, binsize, binsize, flags);
+}
+
+template <typename ImageT>
+std::shared_ptr<ImageT> binImage(ImageT const& in, int const binX, int const binY,
+                                 lsst::afw::math::Property const flags) {
+    // No pixels are ignored, and NaNs propagate to the output, as they always have.
+    return binImageImpl(in, binX, binY, BinOptions{flags, 0, 0, false, false});
+}
+
+template <typename ImageT>
+std::shared_ptr<ImageT> binImage(ImageT const& in, int const binX, int const binY,
+                                 lsst::afw::math::Property const flags, StatisticsControl const& sctrl,
+                                 bool keepPartialBins) {
+    return binImageImpl(in, binX, binY,
+                        BinOptions{flags, static_cast<MaskPixel>(sctrl.getAndMask()),
+                                   static_cast<MaskPixel>(sctrl.getNoGoodPixelsMask()), sctrl.getNanSafe(),
+                                   keepPartialBins});
+}
+
 //
 // Explicit instantiations
 //
 /// @cond
-#define INSTANTIATE(TYPE)                                                                                  \
-    template std::shared_ptr<image::Image<TYPE>> binImage(image::Image<TYPE> const&, int,                  \
-                                                          lsst::afw::math::Property const);                \
-    template std::shared_ptr<image::Image<TYPE>> binImage(image::Image<TYPE> const&, int, int,             \
-                                                          lsst::afw::math::Property const);                \
-    template std::shared_ptr<image::MaskedImage<TYPE>> binImage(image::MaskedImage<TYPE> const&, int,      \
-                                                                lsst::afw::math::Property const);          \
-    template std::shared_ptr<image::MaskedImage<TYPE>> binImage(image::MaskedImage<TYPE> const&, int, int, \
-                                                                lsst::afw::math::Property const);
+#define INSTANTIATE_BIN_IMAGE(IMAGE)                                                                      \
+    template std::shared_ptr<IMAGE> binImage(IMAGE const&, int, lsst::afw::math::Property const);         \
+    template std::shared_ptr<IMAGE> binImage(IMAGE const&, int, int, lsst::afw::math::Property const);    \
+    template std::shared_ptr<IMAGE> binImage(IMAGE const&, int, int, lsst::afw::math::Property const,     \
+                                             StatisticsControl const&, bool);
+
+#define INSTANTIATE(TYPE)                           \
+    INSTANTIATE_BIN_IMAGE(image::Image<TYPE>)       \
+    INSTANTIATE_BIN_IMAGE(image::MaskedImage<TYPE>)
 
 INSTANTIATE(std::uint16_t)
 INSTANTIATE(int)
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <memory>
 #include <sstream>
 #include <vector>
 
@@ -267,6 +268,7 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "SeparableKernel basicConvolve: kernel is spatially varying");
 
+        std::unique_ptr<math::Kernel::Workspace> const workspace = kernel.makeWorkspace();
         for (int cnvY = goodBBox.getMinY(); cnvY <= goodBBox.getMaxY(); ++cnvY) {
             double const rowPos = inImage.indexToPosition(cnvY, image::Y);
 
@@ -277,7 +279,8 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
                 double const colPos = inImage.indexToPosition(cnvX, image::X);
 
                 KernelPixel kSum = kernel.computeVectors(kernelXVec, kernelYVec,
-                                                         convolutionControl.getDoNormalize(), colPos, rowPos);
+                                                         convolutionControl.getDoNormalize(), colPos, rowPos,
+                                                         *workspace);
 
                 // why does this trigger warnings? It did not in the past.
                 *cnvXIter = math::convolveAtAPoint<OutImageT, InImageT>(inImLoc, kernelXVec, kernelYVec);
@@ -387,6 +390,7 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
         LOGL_DEBUG("TRACE4.afw.math.convolve.convolveWithBruteForce",
                    "convolveWithBruteForce: kernel is spatially varying");
 
+        std::unique_ptr<math::Kernel::Workspace> const workspace = kernel.makeWorkspace();
         for (int cnvY = cnvStartY; cnvY != cnvEndY; ++cnvY) {
             double const rowPos = inImage.indexToPosition(cnvY, image::Y);
 
@@ -395,7 +399,7 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
             for (int cnvX = cnvStartX; cnvX != cnvEndX; ++cnvX, ++inImLoc.x(), ++cnvXIter) {
                 double const colPos = inImage.indexToPosition(cnvX, image::X);
 
-                KernelPixel kSum = kernel.computeImage(kernelImage, false, colPos, rowPos);
+                KernelPixel kSum = kernel.computeImage(kernelImage, false, colPos, rowPos, *workspace);
                 *cnvXIter = math::convolveAtAPoint<OutImageT, InImageT>(inImLoc, kernelLoc, kWidth, kHeight);
                 if (doNormalize) {
                     *cnvXIter = *cnvXIter / kSum;
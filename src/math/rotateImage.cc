@@ -23,9 +23,11 @@
 /*
  * Rotate an Image (or Mask or MaskedImage) by a fixed angle or number of quarter turns
  */
+#include <algorithm>
 #include <cstdint>
 
 #include "lsst/geom.h"
+#include "lsst/afw/detail/Parallel.h"
 #include "lsst/afw/math/offsetImage.h"
 #include "lsst/afw/image/LsstImageTypes.h"
 
@@ -35,6 +37,145 @@ namespace lsst {
 namespace afw {
 namespace math {
 
+namespace {
+
+// Side of the square tiles in which quarter turns are done; a tile of the input and of the output
+// together fit in L1 cache for all pixel types.
+int const TILE_SIZE = 32;
+
+// Minimum number of pixels in each band of rows processed by one thread.
+std::size_t const MIN_BAND_PIXELS = 1 << 16;
+
+// Call function(inPlane, outPlane) for each pair of corresponding pixel arrays.
+template <typename PixelT, typename Function>
+void forEachPlane(afwImage::ImageBase<PixelT> const& in, afwImage::ImageBase<PixelT>& out,
+                  Function const& function) {
+    function(in.getArray(), out.getArray());
+}
+
+template <typename PixelT, typename Function>
+void forEachPlane(afwImage::MaskedImage<PixelT> const& in, afwImage::MaskedImage<PixelT>& out,
+                  Function const& function) {
+    function(in.getImage()->getArray(), out.getImage()->getArray());
+    function(in.getMask()->getArray(), out.getMask()->getArray());
+    function(in.getVariance()->getArray(), out.getVariance()->getArray());
+}
+
+template <typename PixelT, typename Function>
+void forEachPlane(afwImage::ImageBase<PixelT>& image, Function const& function) {
+    function(image.getArray());
+}
+
+template <typename PixelT, typename Function>
+void forEachPlane(afwImage::MaskedImage<PixelT>& image, Function const& function) {
+    function(image.getImage()->getArray());
+    function(image.getMask()->getArray());
+    function(image.getVariance()->getArray());
+}
+
+// Call function(yBegin, yEnd) on bands of rows of an image of the given size, in parallel; band
+// boundaries are multiples of TILE_SIZE.
+template <typename Function>
+void forEachBand(int width, int height, Function const& function) {
+    std::size_t const nTileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+    std::size_t const nBands = std::max<std::size_t>(
+            1, std::min(nTileRows, static_cast<std::size_t>(width) * height / MIN_BAND_PIXELS));
+    lsst::afw::detail::parallelFor(0, nBands, [&](std::size_t band) {
+        int const yBegin = std::min<int>(height, band * nTileRows / nBands * TILE_SIZE);
+        int const yEnd = std::min<int>(height, (band + 1) * nTileRows / nBands * TILE_SIZE);
+        function(yBegin, yEnd);
+    });
+}
+
+/*
+ * Rotate a plane by one (clockwise = false) or three (clockwise = true) quarter turns, i.e. transpose
+ * it with one of the axes reversed.
+ *
+ * The copy is done in square tiles, so that while the input is read along rows, the output columns
+ * written are confined to a few cache lines.
+ */
+template <typename InArray, typename OutArray>
+void rotatePlaneBy90(InArray const& in, OutArray const& out, bool clockwise) {
+    int const width = in.template getSize<1>();
+    int const height = in.template getSize<0>();
+    auto* const outData = out.getData();
+    std::ptrdiff_t const outStride = out.template getStride<0>();
+    forEachBand(width, height, [&](int yBegin, int yEnd) {
+        for (int y0 = yBegin; y0 < yEnd; y0 += TILE_SIZE) {
+            int const y1 = std::min(y0 + TILE_SIZE, yEnd);
+            for (int x0 = 0; x0 < width; x0 += TILE_SIZE) {
+                int const x1 = std::min(x0 + TILE_SIZE, width);
+                for (int y = y0; y < y1; ++y) {
+                    auto const* inRow = in[y].getData();
+                    if (clockwise) {
+                        // out[width - 1 - x][y] = in[y][x]
+                        auto* outPtr = outData + (width - 1 - x0) * outStride + y;
+                        for (int x = x0; x < x1; ++x, outPtr -= outStride) {
+                            *outPtr = inRow[x];
+                        }
+                    } else {
+                        // out[x][height - 1 - y] = in[y][x]
+                        auto* outPtr = outData + x0 * outStride + (height - 1 - y);
+                        for (int x = x0; x < x1; ++x, outPtr += outStride) {
+                            *outPtr = inRow[x];
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+// Copy a plane rotated by 180 degrees.
+template <typename InArray, typename OutArray>
+void rotatePlaneBy180(InArray const& in, OutArray const& out) {
+    int const width = in.template getSize<1>();
+    int const height = in.template getSize<0>();
+    forEachBand(width, height, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; ++y) {
+            auto const* inRow = in[y].getData();
+            std::reverse_copy(inRow, inRow + width, out[height - 1 - y].getData());
+        }
+    });
+}
+
+// Flip a plane in place.
+template <typename Array>
+void flipPlaneInPlace(Array const& array, bool flipLR, bool flipTB) {
+    int const width = array.template getSize<1>();
+    int const height = array.template getSize<0>();
+    if (!flipTB) {
+        if (flipLR) {
+            forEachBand(width, height, [&](int yBegin, int yEnd) {
+                for (int y = yBegin; y < yEnd; ++y) {
+                    std::reverse(array[y].getData(), array[y].getData() + width);
+                }
+            });
+        }
+        return;
+    }
+    // Swap each row in the bottom half with its partner in the top half, reversing both if flipLR.
+    forEachBand(width, height / 2, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; ++y) {
+            auto* lower = array[y].getData();
+            auto* upper = array[height - 1 - y].getData();
+            if (flipLR) {
+                for (int x = 0; x < width; ++x) {
+                    std::swap(lower[x], upper[width - 1 - x]);
+                }
+            } else {
+                std::swap_ranges(lower, lower + width, upper);
+            }
+        }
+    });
+    if (flipLR && height % 2 == 1) {
+        auto* middle = array[height / 2].getData();
+        std::reverse(middle, middle + width);
+    }
+}
+
+}  // namespace
+
 template <typename ImageT>
 std::shared_ptr<ImageT> rotateImageBy90(ImageT const& inImage, int nQuarter) {
     std::shared_ptr<ImageT> outImage;  // output image
@@ -48,83 +189,31 @@ std::shared_ptr<ImageT> rotateImageBy90(ImageT const& inImage, int nQuarter) {
             outImage.reset(new ImageT(inImage, true));  // a deep copy of inImage
             break;
         case 1:
+        case 3:
             outImage.reset(new ImageT(lsst::geom::Extent2I(inImage.getHeight(), inImage.getWidth())));
-
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::y_iterator optr = outImage->col_begin(inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, ++optr) {
-                    *optr = *iptr;
-                }
-            }
-
+            forEachPlane(inImage, *outImage, [nQuarter](auto const& in, auto const& out) {
+                rotatePlaneBy90(in, out, nQuarter % 4 == 3);
+            });
             break;
         case 2:
             outImage.reset(new ImageT(inImage.getDimensions()));
-
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr =
-                        outImage->x_at(inImage.getWidth() - 1, inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
-            break;
-        case 3:
-            outImage.reset(new ImageT(lsst::geom::Extent2I(inImage.getHeight(), inImage.getWidth())));
-
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::y_iterator optr = outImage->y_at(y, inImage.getWidth() - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
-
+            forEachPlane(inImage, *outImage,
+                         [](auto const& in, auto const& out) { rotatePlaneBy180(in, out); });
             break;
     }
 
     return outImage;
 }
 
+template <typename ImageT>
+void flipImageInPlace(ImageT& image, bool flipLR, bool flipTB) {
+    forEachPlane(image, [flipLR, flipTB](auto const& array) { flipPlaneInPlace(array, flipLR, flipTB); });
+}
+
 template <typename ImageT>
 std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipTB) {
     std::shared_ptr<ImageT> outImage(new ImageT(inImage, true));  // Output image
-
-    if (flipLR) {
-        if (flipTB) {
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr =
-                        outImage->x_at(inImage.getWidth() - 1, inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
-        } else {
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr = outImage->x_at(inImage.getWidth() - 1, y);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
-        }
-    } else {
-        if (flipTB) {
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr = outImage->row_begin(inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, ++optr) {
-                    *optr = *iptr;
-                }
-            }
-        } else {
-            ;  // nothing to do
-        }
-    }
-
+    flipImageInPlace(*outImage, flipLR, flipTB);
     return outImage;
 }
 
@@ -139,7 +228,9 @@ std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipT
     template std::shared_ptr<afwImage::Image<TYPE>> flipImage(afwImage::Image<TYPE> const&, bool flipLR, \
                                                               bool flipTB);                              \
     template std::shared_ptr<afwImage::MaskedImage<TYPE>> flipImage(afwImage::MaskedImage<TYPE> const&,  \
-                                                                    bool flipLR, bool flipTB);
+                                                                    bool flipLR, bool flipTB);           \
+    template void flipImageInPlace(afwImage::Image<TYPE>&, bool flipLR, bool flipTB);                    \
+    template void flipImageInPlace(afwImage::MaskedImage<TYPE>&, bool flipLR, bool flipTB);
 
 INSTANTIATE(std::uint16_t)
 INSTANTIATE(int)
@@ -149,6 +240,7 @@ template std::shared_ptr<afwImage::Mask<afwImage::MaskPixel>> rotateImageBy90(
         afwImage::Mask<afwImage::MaskPixel> const&, int);
 template std::shared_ptr<afwImage::Mask<afwImage::MaskPixel>> flipImage(
         afwImage::Mask<afwImage::MaskPixel> const&, bool flipLR, bool flipTB);
+template void flipImageInPlace(afwImage::Mask<afwImage::MaskPixel>&, bool flipLR, bool flipTB);
 /// @endcond
 }  // namespace math
 }  // namespace afw
@@ -105,6 +105,13 @@ void LanczosWarpingKernel::setKernelParameter(unsigned int ind, double value) co
     SeparableKernel::setKernelParameter(ind, value);
 }
 
+void LanczosWarpingKernel::checkKernelParameters(std::vector<double> const &kernelParams) const {
+    SeparableKernel::checkKernelParameters(kernelParams);
+    for (unsigned int ind = 0; ind != kernelParams.size(); ++ind) {
+        checkWarpingKernelParameter(this, ind, kernelParams[ind]);
+    }
+}
+
 std::shared_ptr<Kernel> BilinearWarpingKernel::clone() const {
     return std::shared_ptr<Kernel>(new BilinearWarpingKernel());
 }
@@ -130,6 +137,13 @@ void BilinearWarpingKernel::setKernelParameter(unsigned int ind, double value) c
     SeparableKernel::setKernelParameter(ind, value);
 }
 
+void BilinearWarpingKernel::checkKernelParameters(std::vector<double> const &kernelParams) const {
+    SeparableKernel::checkKernelParameters(kernelParams);
+    for (unsigned int ind = 0; ind != kernelParams.size(); ++ind) {
+        checkWarpingKernelParameter(this, ind, kernelParams[ind]);
+    }
+}
+
 std::string BilinearWarpingKernel::BilinearFunction1::toString(std::string const &prefix) const {
     std::ostringstream os;
     os << "_BilinearFunction1: ";
@@ -151,6 +165,13 @@ void NearestWarpingKernel::setKernelParameter(unsigned int ind, double value) co
     SeparableKernel::setKernelParameter(ind, value);
 }
 
+void NearestWarpingKernel::checkKernelParameters(std::vector<double> const &kernelParams) const {
+    SeparableKernel::checkKernelParameters(kernelParams);
+    for (unsigned int ind = 0; ind != kernelParams.size(); ++ind) {
+        checkWarpingKernelParameter(this, ind, kernelParams[ind]);
+    }
+}
+
 std::string NearestWarpingKernel::NearestFunction1::toString(std::string const &prefix) const {
     std::ostringstream os;
     os << "_NearestFunction1: ";
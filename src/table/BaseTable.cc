@@ -1,8 +1,14 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <memory>
 
 #include "boost/shared_ptr.hpp"  // only for ndarray
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
 
 #include "lsst/afw/table/BaseColumnView.h"
 #include "lsst/afw/table/BaseRecord.h"
@@ -33,6 +39,9 @@ namespace table {
 
 namespace {
 
+// Blocks allocated for new records (rather than by preallocate) don't grow beyond this size.
+std::size_t const MAX_BLOCK_BYTES = 64 << 20;
+
 class Block : public ndarray::Manager {
 public:
     typedef boost::intrusive_ptr<Block> Ptr;
@@ -110,6 +119,21 @@ private:
 
 void BaseTable::preallocate(std::size_t n) { Block::preallocate(_schema.getRecordSize(), n, _manager); }
 
+void BaseTable::setBlockSize(std::size_t nRecords) {
+    if (nRecords == 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Block size must be positive");
+    }
+    _blockSize = nRecords;
+}
+
+void BaseTable::setBlockGrowthFactor(double factor) {
+    if (!(factor >= 1.0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Block growth factor must be >= 1; got %g") % factor).str());
+    }
+    _blockGrowthFactor = factor;
+}
+
 std::size_t BaseTable::getBufferSize() const {
     if (_manager) {
         return Block::getBufferSize(_schema.getRecordSize(), _manager);
@@ -146,7 +170,11 @@ std::shared_ptr<BaseRecord> BaseTable::_makeRecord() {
     return std::shared_ptr<BaseRecord>(new BaseRecord(shared_from_this()));
 }
 
-BaseTable::BaseTable(Schema const &schema) : daf::base::Citizen(typeid(this)), _schema(schema) {
+BaseTable::BaseTable(Schema const &schema)
+        : daf::base::Citizen(typeid(this)),
+          _schema(schema),
+          _blockSize(nRecordsPerBlock),
+          _blockGrowthFactor(blockGrowthFactor) {
     Block::padSchema(_schema);
     _schema.disconnectAliases();
     _schema.getAliasMap()->_table = this;
@@ -230,10 +258,69 @@ struct RecordDestroyer {
     char *data;
 };
 
+// A Schema Functor used to move variable-length array fields to a new location after the rest of the
+// record has been copied bytewise: those fields aren't trivially copyable, so we move-construct them in
+// place and destroy the originals.
+struct RecordRelocator {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {}
+
+    template <typename T>
+    void operator()(SchemaItem<Array<T> > const &item) const {
+        typedef ndarray::Array<T, 1, 1> Element;
+        if (item.key.isVariableLength()) {
+            move<Element>(item.key.getOffset());
+        }
+    }
+
+    void operator()(SchemaItem<std::string> const &item) const {
+        if (item.key.isVariableLength()) {
+            move<std::string>(item.key.getOffset());
+        }
+    }
+
+    template <typename Element>
+    void move(std::size_t offset) const {
+        Element *old = reinterpret_cast<Element *>(oldData + offset);
+        new (newData + offset) Element(std::move(*old));
+        old->~Element();
+    }
+
+    char *oldData;
+    char *newData;
+};
+
 }  // namespace
 
+void BaseTable::relocate(std::vector<BaseRecord *> const &records) {
+    if (records.empty()) {
+        return;
+    }
+    for (auto record : records) {
+        if (record->_table.get() != this) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError, "Cannot relocate records of a different table");
+        }
+    }
+    std::size_t const recordSize = _schema.getRecordSize();
+    Block::preallocate(recordSize, records.size(), _manager);
+    for (auto record : records) {
+        void *data = Block::get(recordSize, _manager);
+        std::memcpy(data, record->_data, recordSize);
+        RecordRelocator f = {reinterpret_cast<char *>(record->_data), reinterpret_cast<char *>(data)};
+        _schema.forEach(f);
+        record->_data = data;
+        record->_manager = _manager;
+    }
+}
+
 void BaseTable::_initialize(BaseRecord &record) {
-    record._data = Block::get(_schema.getRecordSize(), _manager);
+    std::size_t const recordSize = _schema.getRecordSize();
+    if (getBufferSize() == 0) {
+        Block::preallocate(recordSize, _blockSize, _manager);
+        std::size_t const maxBlockSize = std::max<std::size_t>(1, MAX_BLOCK_BYTES / recordSize);
+        _blockSize = std::min<std::size_t>(std::ceil(_blockSize * _blockGrowthFactor), maxBlockSize);
+    }
+    record._data = Block::get(recordSize, _manager);
     RecordInitializer f = {reinterpret_cast<char *>(record._data)};
     _schema.forEach(f);
     record._manager = _manager;  // manager always points to the most recently-used block.
@@ -254,6 +341,8 @@ void BaseTable::_destroy(BaseRecord &record) {
  */
 int BaseTable::nRecordsPerBlock = 100;
 
+double BaseTable::blockGrowthFactor = 1.0;
+
 // =============== BaseCatalog instantiation =================================================================
 
 template class CatalogT<BaseRecord>;
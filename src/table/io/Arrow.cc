@@ -0,0 +1,637 @@
+// -*- lsst-c++ -*-
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/table/io/Arrow.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace io {
+
+namespace {
+
+//----- Type and metadata conversions -----------------------------------------------------------------------
+
+// Arrow format strings and in-buffer representations of the afw.table element types.
+template <typename T>
+struct ArrowType;
+
+template <>
+struct ArrowType<std::uint8_t> {
+    typedef std::uint8_t Storage;
+    static char const *format() { return "C"; }
+};
+
+template <>
+struct ArrowType<std::uint16_t> {
+    typedef std::uint16_t Storage;
+    static char const *format() { return "S"; }
+};
+
+template <>
+struct ArrowType<std::int32_t> {
+    typedef std::int32_t Storage;
+    static char const *format() { return "i"; }
+};
+
+template <>
+struct ArrowType<std::int64_t> {
+    typedef std::int64_t Storage;
+    static char const *format() { return "l"; }
+};
+
+template <>
+struct ArrowType<float> {
+    typedef float Storage;
+    static char const *format() { return "f"; }
+};
+
+template <>
+struct ArrowType<double> {
+    typedef double Storage;
+    static char const *format() { return "g"; }
+};
+
+template <>
+struct ArrowType<lsst::geom::Angle> {
+    typedef double Storage;
+    static char const *format() { return "g"; }
+};
+
+template <typename T>
+T toStorage(T value) {
+    return value;
+}
+
+double toStorage(lsst::geom::Angle value) { return value.asRadians(); }
+
+template <typename T>
+T fromStorage(typename ArrowType<T>::Storage value) {
+    return value;
+}
+
+template <>
+lsst::geom::Angle fromStorage<lsst::geom::Angle>(double value) {
+    return value * lsst::geom::radians;
+}
+
+// Key-value field metadata, in the order it is encoded.
+typedef std::vector<std::pair<std::string, std::string>> Metadata;
+
+// Encode metadata in the Arrow binary format: the number of pairs, then the length and bytes of
+// each key and value, with all lengths as native-endian int32.
+std::string encodeMetadata(Metadata const &metadata) {
+    std::string result;
+    auto appendInt = [&result](std::int32_t value) {
+        result.append(reinterpret_cast<char const *>(&value), sizeof(value));
+    };
+    appendInt(metadata.size());
+    for (auto const &item : metadata) {
+        appendInt(item.first.size());
+        result += item.first;
+        appendInt(item.second.size());
+        result += item.second;
+    }
+    return result;
+}
+
+Metadata decodeMetadata(char const *data) {
+    Metadata result;
+    if (!data) {
+        return result;
+    }
+    auto readString = [&data]() {
+        std::int32_t size;
+        std::memcpy(&size, data, sizeof(size));
+        data += sizeof(size);
+        std::string value(data, size);
+        data += size;
+        return value;
+    };
+    std::int32_t size;
+    std::memcpy(&size, data, sizeof(size));
+    data += sizeof(size);
+    for (std::int32_t i = 0; i < size; ++i) {
+        std::string key = readString();
+        result.emplace_back(std::move(key), readString());
+    }
+    return result;
+}
+
+// Return the value for the given key, or an empty string if it is not present.
+std::string findMetadata(Metadata const &metadata, std::string const &key) {
+    for (auto const &item : metadata) {
+        if (item.first == key) {
+            return item.second;
+        }
+    }
+    return std::string();
+}
+
+template <typename T>
+Metadata describeField(Field<T> const &field) {
+    Metadata metadata;
+    if (!field.getDoc().empty()) {
+        metadata.emplace_back("afw:doc", field.getDoc());
+    }
+    if (!field.getUnits().empty()) {
+        metadata.emplace_back("afw:units", field.getUnits());
+    }
+    return metadata;
+}
+
+//----- Exported structures ---------------------------------------------------------------------------------
+
+// Smart pointers for child structures, which call the release callback (if the structure has not
+// been moved out by the consumer) before deleting the structure itself.
+struct ReleaseSchema {
+    void operator()(ArrowSchema *schema) const {
+        if (schema->release) schema->release(schema);
+        delete schema;
+    }
+};
+
+struct ReleaseArray {
+    void operator()(ArrowArray *array) const {
+        if (array->release) array->release(array);
+        delete array;
+    }
+};
+
+typedef std::unique_ptr<ArrowSchema, ReleaseSchema> SchemaPtr;
+typedef std::unique_ptr<ArrowArray, ReleaseArray> ArrayPtr;
+
+// Private data for an exported ArrowSchema.
+struct ExportedSchema {
+    std::string format;
+    std::string name;
+    std::string metadata;
+    std::vector<SchemaPtr> children;
+    std::vector<ArrowSchema *> childPointers;
+};
+
+// Private data for an exported ArrowArray.
+struct ExportedArray {
+    std::vector<void const *> buffers;
+    std::vector<std::unique_ptr<char[]>> storage;  // buffers repacked from the catalog
+    std::vector<ArrayPtr> children;
+    std::vector<ArrowArray *> childPointers;
+
+    // Allocate a zero-initialized buffer of n elements that lives as long as the array.
+    template <typename T>
+    T *allocate(std::size_t n) {
+        storage.emplace_back(new char[std::max(n, std::size_t(1)) * sizeof(T)]());
+        return reinterpret_cast<T *>(storage.back().get());
+    }
+};
+
+void releaseSchema(ArrowSchema *schema) {
+    delete static_cast<ExportedSchema *>(schema->private_data);
+    schema->release = nullptr;
+}
+
+void releaseArray(ArrowArray *array) {
+    delete static_cast<ExportedArray *>(array->private_data);
+    array->release = nullptr;
+}
+
+// Initialize `schema`, transferring ownership of `data` to it.
+void initSchema(ArrowSchema *schema, std::unique_ptr<ExportedSchema> data) {
+    for (auto const &child : data->children) {
+        data->childPointers.push_back(child.get());
+    }
+    schema->format = data->format.c_str();
+    schema->name = data->name.c_str();
+    schema->metadata = data->metadata.empty() ? nullptr : data->metadata.data();
+    schema->flags = 0;
+    schema->n_children = data->children.size();
+    schema->children = data->childPointers.empty() ? nullptr : data->childPointers.data();
+    schema->dictionary = nullptr;
+    schema->release = &releaseSchema;
+    schema->private_data = data.release();
+}
+
+// Initialize `array`, transferring ownership of `data` to it.
+void initArray(ArrowArray *array, std::size_t length, std::unique_ptr<ExportedArray> data) {
+    for (auto const &child : data->children) {
+        data->childPointers.push_back(child.get());
+    }
+    array->length = length;
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = data->buffers.size();
+    array->buffers = data->buffers.data();
+    array->n_children = data->children.size();
+    array->children = data->childPointers.empty() ? nullptr : data->childPointers.data();
+    array->dictionary = nullptr;
+    array->release = &releaseArray;
+    array->private_data = data.release();
+}
+
+SchemaPtr makeSchema(std::string const &format, std::string const &name, Metadata const &metadata,
+                     std::vector<SchemaPtr> children = std::vector<SchemaPtr>()) {
+    std::unique_ptr<ExportedSchema> data(new ExportedSchema());
+    data->format = format;
+    data->name = name;
+    data->metadata = metadata.empty() ? std::string() : encodeMetadata(metadata);
+    data->children = std::move(children);
+    SchemaPtr schema(new ArrowSchema());
+    initSchema(schema.get(), std::move(data));
+    return schema;
+}
+
+ArrayPtr makeArray(std::size_t length, std::unique_ptr<ExportedArray> data) {
+    ArrayPtr array(new ArrowArray());
+    initArray(array.get(), length, std::move(data));
+    return array;
+}
+
+// Compute the offsets of variable-size column entries, checking that they fit in an int32.
+template <typename Size>
+std::int32_t *computeOffsets(ExportedArray &data, std::vector<BaseRecord const *> const &records,
+                             std::string const &name, Size size) {
+    std::int32_t *offsets = data.allocate<std::int32_t>(records.size() + 1);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        total += size(*records[i]);
+        if (total > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+            throw LSST_EXCEPT(pex::exceptions::LengthError,
+                              "Column '" + name + "' is too large for an Arrow array with 32-bit offsets.");
+        }
+        offsets[i + 1] = total;
+    }
+    return offsets;
+}
+
+// Return the length of a string field, trimmed at the first null character.
+std::size_t stringLength(BaseRecord const &record, Key<std::string> const &key) {
+    char const *value = record[key];
+    if (key.isVariableLength()) {
+        return std::strlen(value);
+    }
+    return std::find(value, value + key.getSize(), '\0') - value;
+}
+
+//----- Export ----------------------------------------------------------------------------------------------
+
+// A Schema::forEach functor that creates an Arrow child for each field.  Buffers are allocated
+// immediately, while repacking the data is deferred to `tasks` so the columns can be filled in
+// parallel.
+struct ExportFields {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        typedef typename ArrowType<T>::Storage Storage;
+        static_assert(sizeof(Storage) == sizeof(T), "Element must be stored as its Arrow type.");
+        std::unique_ptr<ExportedArray> data(new ExportedArray());
+        data->buffers.push_back(nullptr);
+        Storage *values = data->allocate<Storage>(records.size());
+        data->buffers.push_back(values);
+        Key<T> const key = item.key;
+        tasks.push_back([key, values, &records = records]() {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                values[i] = toStorage(*records[i]->getElement(key));
+            }
+        });
+        Metadata metadata = describeField(item.field);
+        if (std::is_same<T, lsst::geom::Angle>::value) {
+            metadata.emplace_back("afw:type", "Angle");
+        }
+        add(makeSchema(ArrowType<T>::format(), item.field.getName(), metadata),
+            makeArray(records.size(), std::move(data)));
+    }
+
+    void operator()(SchemaItem<Flag> const &item) const {
+        std::unique_ptr<ExportedArray> data(new ExportedArray());
+        data->buffers.push_back(nullptr);
+        std::uint8_t *bits = data->allocate<std::uint8_t>((records.size() + 7) / 8);
+        data->buffers.push_back(bits);
+        Key<Flag> const key = item.key;
+        tasks.push_back([key, bits, &records = records]() {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                if (records[i]->get(key)) {
+                    bits[i >> 3] |= 1 << (i & 7);
+                }
+            }
+        });
+        add(makeSchema("b", item.field.getName(), describeField(item.field)),
+            makeArray(records.size(), std::move(data)));
+    }
+
+    void operator()(SchemaItem<std::string> const &item) const {
+        Key<std::string> const key = item.key;
+        std::unique_ptr<ExportedArray> data(new ExportedArray());
+        std::int32_t *offsets =
+                computeOffsets(*data, records, item.field.getName(),
+                               [&key](BaseRecord const &record) { return stringLength(record, key); });
+        char *chars = data->allocate<char>(offsets[records.size()]);
+        data->buffers.push_back(nullptr);
+        data->buffers.push_back(offsets);
+        data->buffers.push_back(chars);
+        tasks.push_back([key, offsets, chars, &records = records]() {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                std::memcpy(chars + offsets[i], (*records[i])[key], offsets[i + 1] - offsets[i]);
+            }
+        });
+        Metadata metadata = describeField(item.field);
+        metadata.emplace_back("afw:size", std::to_string(item.field.getSize()));
+        add(makeSchema("u", item.field.getName(), metadata), makeArray(records.size(), std::move(data)));
+    }
+
+    template <typename T>
+    void operator()(SchemaItem<Array<T>> const &item) const {
+        Key<Array<T>> const key = item.key;
+        std::unique_ptr<ExportedArray> data(new ExportedArray());
+        std::unique_ptr<ExportedArray> itemData(new ExportedArray());
+        data->buffers.push_back(nullptr);
+        itemData->buffers.push_back(nullptr);
+        std::string format;
+        std::size_t itemLength;
+        if (key.isVariableLength()) {
+            format = "+l";
+            std::int32_t *offsets =
+                    computeOffsets(*data, records, item.field.getName(), [&key](BaseRecord const &record) {
+                        return record.get(key).template getSize<0>();
+                    });
+            data->buffers.push_back(offsets);
+            itemLength = offsets[records.size()];
+            T *values = itemData->allocate<T>(itemLength);
+            itemData->buffers.push_back(values);
+            tasks.push_back([key, offsets, values, &records = records]() {
+                for (std::size_t i = 0; i < records.size(); ++i) {
+                    ndarray::Array<T const, 1, 1> const array = records[i]->get(key);
+                    std::copy(array.begin(), array.end(), values + offsets[i]);
+                }
+            });
+        } else {
+            std::size_t const size = key.getSize();
+            format = "+w:" + std::to_string(size);
+            itemLength = records.size() * size;
+            T *values = itemData->allocate<T>(itemLength);
+            itemData->buffers.push_back(values);
+            tasks.push_back([key, size, values, &records = records]() {
+                for (std::size_t i = 0; i < records.size(); ++i) {
+                    T const *element = records[i]->getElement(key);
+                    std::copy(element, element + size, values + i * size);
+                }
+            });
+        }
+        std::vector<SchemaPtr> itemSchema;
+        itemSchema.push_back(makeSchema(ArrowType<T>::format(), "item", Metadata()));
+        data->children.push_back(makeArray(itemLength, std::move(itemData)));
+        add(makeSchema(format, item.field.getName(), describeField(item.field), std::move(itemSchema)),
+            makeArray(records.size(), std::move(data)));
+    }
+
+    void add(SchemaPtr schema, ArrayPtr array) const {
+        schemaData->children.push_back(std::move(schema));
+        arrayData->children.push_back(std::move(array));
+    }
+
+    std::vector<BaseRecord const *> const &records;
+    ExportedSchema *schemaData;
+    ExportedArray *arrayData;
+    std::vector<std::function<void()>> &tasks;
+};
+
+//----- Import ----------------------------------------------------------------------------------------------
+
+typedef std::vector<std::function<void(std::vector<BaseRecord *> const &)>> ImportTasks;
+
+// Return true if the element at the given (logical) index is not null.
+bool isValid(ArrowArray const *array, std::int64_t index) {
+    if (array->null_count == 0 || array->n_buffers == 0 || !array->buffers[0]) {
+        return true;
+    }
+    std::int64_t const i = array->offset + index;
+    return static_cast<std::uint8_t const *>(array->buffers[0])[i >> 3] & (1 << (i & 7));
+}
+
+template <typename T>
+T const *getBuffer(ArrowArray const *array, int n, std::string const &name) {
+    if (array->n_buffers <= n || !array->buffers[n]) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Arrow array for field '" + name + "' is missing a data buffer.");
+    }
+    return static_cast<T const *>(array->buffers[n]);
+}
+
+// The name, documentation, and units of an imported field.
+struct FieldInfo {
+    std::string name;
+    std::string doc;
+    std::string units;
+    Metadata metadata;
+};
+
+// Add a scalar field, filled from the Arrow array at rows [first, first + records.size()).
+template <typename T>
+void importScalar(Schema &schema, FieldInfo const &info, ArrowArray const *array, std::int64_t first,
+                  ImportTasks &tasks) {
+    typedef typename ArrowType<T>::Storage Storage;
+    Storage const *values = getBuffer<Storage>(array, 1, info.name) + array->offset;
+    Key<T> const key = schema.addField(Field<T>(info.name, info.doc, info.units));
+    tasks.push_back([key, array, values, first](std::vector<BaseRecord *> const &records) {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (isValid(array, first + i)) {
+                records[i]->set(key, fromStorage<T>(values[first + i]));
+            }
+        }
+    });
+}
+
+void importFlag(Schema &schema, FieldInfo const &info, ArrowArray const *array, std::int64_t first,
+                ImportTasks &tasks) {
+    std::uint8_t const *bits = getBuffer<std::uint8_t>(array, 1, info.name);
+    Key<Flag> const key = schema.addField(Field<Flag>(info.name, info.doc));
+    tasks.push_back([key, array, bits, first](std::vector<BaseRecord *> const &records) {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (isValid(array, first + i)) {
+                std::int64_t const j = array->offset + first + i;
+                records[i]->set(key, ((bits[j >> 3] >> (j & 7)) & 1) != 0);
+            }
+        }
+    });
+}
+
+void importString(Schema &schema, FieldInfo const &info, ArrowArray const *array, std::int64_t first,
+                  std::size_t length, ImportTasks &tasks) {
+    std::int32_t const *offsets = getBuffer<std::int32_t>(array, 1, info.name) + array->offset + first;
+    char const *chars = getBuffer<char>(array, 2, info.name);
+    std::string const savedSize = findMetadata(info.metadata, "afw:size");
+    int size = 1;
+    if (!savedSize.empty()) {
+        size = std::stoi(savedSize);
+    } else {
+        for (std::size_t i = 0; i < length; ++i) {
+            size = std::max(size, offsets[i + 1] - offsets[i] + 1);
+        }
+    }
+    Key<std::string> const key = schema.addField(Field<std::string>(info.name, info.doc, info.units, size));
+    tasks.push_back([key, array, offsets, chars, first](std::vector<BaseRecord *> const &records) {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (isValid(array, first + i)) {
+                records[i]->set(key, std::string(chars + offsets[i], offsets[i + 1] - offsets[i]));
+            }
+        }
+    });
+}
+
+// Add an array field from a list (size == 0) or fixed-size list (size > 0) array.
+template <typename T>
+void importArray(Schema &schema, FieldInfo const &info, ArrowArray const *array, std::int64_t first, int size,
+                 ImportTasks &tasks) {
+    ArrowArray const *items = array->children[0];
+    T const *values = getBuffer<T>(items, 1, info.name) + items->offset;
+    Key<Array<T>> const key = schema.addField(Field<Array<T>>(info.name, info.doc, info.units, size));
+    if (size > 0) {
+        tasks.push_back([key, array, values, first, size](std::vector<BaseRecord *> const &records) {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                if (isValid(array, first + i)) {
+                    T const *begin = values + (array->offset + first + i) * size;
+                    std::copy(begin, begin + size, records[i]->getElement(key));
+                }
+            }
+        });
+    } else {
+        std::int32_t const *offsets = getBuffer<std::int32_t>(array, 1, info.name) + array->offset + first;
+        tasks.push_back([key, array, values, offsets, first](std::vector<BaseRecord *> const &records) {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                if (isValid(array, first + i)) {
+                    ndarray::Array<T, 1, 1> value = ndarray::allocate(offsets[i + 1] - offsets[i]);
+                    std::copy(values + offsets[i], values + offsets[i + 1], value.begin());
+                    records[i]->set(key, value);
+                }
+            }
+        });
+    }
+}
+
+// Add a field for a child of the imported struct array.
+void importField(Schema &schema, ArrowSchema const *type, ArrowArray const *array, std::int64_t first,
+                 std::size_t length, ImportTasks &tasks, ImportTasks &flagTasks) {
+    FieldInfo info;
+    info.name = type->name ? type->name : "";
+    info.metadata = decodeMetadata(type->metadata);
+    info.doc = findMetadata(info.metadata, "afw:doc");
+    info.units = findMetadata(info.metadata, "afw:units");
+    std::string const format = type->format;
+    if (format == "C") {
+        importScalar<std::uint8_t>(schema, info, array, first, tasks);
+    } else if (format == "S") {
+        importScalar<std::uint16_t>(schema, info, array, first, tasks);
+    } else if (format == "i") {
+        importScalar<std::int32_t>(schema, info, array, first, tasks);
+    } else if (format == "l") {
+        importScalar<std::int64_t>(schema, info, array, first, tasks);
+    } else if (format == "f") {
+        importScalar<float>(schema, info, array, first, tasks);
+    } else if (format == "g" && findMetadata(info.metadata, "afw:type") == "Angle") {
+        importScalar<lsst::geom::Angle>(schema, info, array, first, tasks);
+    } else if (format == "g") {
+        importScalar<double>(schema, info, array, first, tasks);
+    } else if (format == "b") {
+        // Flags share storage within a record, so they are filled serially.
+        importFlag(schema, info, array, first, flagTasks);
+    } else if (format == "u") {
+        importString(schema, info, array, first, length, tasks);
+    } else if ((format == "+l" || format.compare(0, 3, "+w:") == 0) && type->n_children == 1 &&
+               array->n_children == 1) {
+        int const size = format == "+l" ? 0 : std::stoi(format.substr(3));
+        std::string const itemFormat = type->children[0]->format;
+        if (itemFormat == "C") {
+            importArray<std::uint8_t>(schema, info, array, first, size, tasks);
+        } else if (itemFormat == "S") {
+            importArray<std::uint16_t>(schema, info, array, first, size, tasks);
+        } else if (itemFormat == "i") {
+            importArray<int>(schema, info, array, first, size, tasks);
+        } else if (itemFormat == "f") {
+            importArray<float>(schema, info, array, first, size, tasks);
+        } else if (itemFormat == "g") {
+            importArray<double>(schema, info, array, first, size, tasks);
+        } else {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              "Unsupported Arrow list item format '" + itemFormat + "' for field '" +
+                                      info.name + "'.");
+        }
+    } else {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Unsupported Arrow format '" + format + "' for field '" + info.name + "'.");
+    }
+}
+
+// Releases the imported structures however importArrow exits.
+struct ImportGuard {
+    ~ImportGuard() {
+        if (array->release) array->release(array);
+        if (schema->release) schema->release(schema);
+    }
+
+    ArrowSchema *schema;
+    ArrowArray *array;
+};
+
+}  // namespace
+
+void exportArrow(BaseCatalog const &catalog, ArrowSchema *schema, ArrowArray *array) {
+    std::vector<BaseRecord const *> records;
+    records.reserve(catalog.size());
+    for (auto const &record : catalog) {
+        records.push_back(&record);
+    }
+    std::unique_ptr<ExportedSchema> schemaData(new ExportedSchema());
+    std::unique_ptr<ExportedArray> arrayData(new ExportedArray());
+    schemaData->format = "+s";
+    arrayData->buffers.push_back(nullptr);
+    std::vector<std::function<void()>> tasks;
+    ExportFields f = {records, schemaData.get(), arrayData.get(), tasks};
+    catalog.getSchema().forEach(f);
+    lsst::afw::detail::parallelFor(0, tasks.size(), [&tasks](std::size_t i) { tasks[i](); });
+    initSchema(schema, std::move(schemaData));
+    initArray(array, records.size(), std::move(arrayData));
+}
+
+BaseCatalog importArrow(ArrowSchema *schema, ArrowArray *array) {
+    ImportGuard guard = {schema, array};
+    if (std::string(schema->format) != "+s" || array->n_children != schema->n_children) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Only Arrow struct arrays can be imported as catalogs.");
+    }
+    std::size_t const length = array->length;
+    Schema afwSchema;
+    ImportTasks tasks;
+    ImportTasks flagTasks;
+    for (std::int64_t i = 0; i < schema->n_children; ++i) {
+        importField(afwSchema, schema->children[i], array->children[i], array->offset, length, tasks,
+                    flagTasks);
+    }
+    BaseCatalog catalog(afwSchema);
+    catalog.reserve(length);
+    std::vector<BaseRecord *> records;
+    records.reserve(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        records.push_back(catalog.addNew().get());
+    }
+    lsst::afw::detail::parallelFor(0, tasks.size(), [&tasks, &records](std::size_t i) { tasks[i](records); });
+    for (auto const &task : flagTasks) {
+        task(records);
+    }
+    return catalog;
+}
+
+}  // namespace io
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
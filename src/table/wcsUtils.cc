@@ -25,6 +25,7 @@
 #include <memory>
 #include <vector>
 
+#include "ndarray.h"
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/table/fwd.h"
 #include "lsst/afw/table/aggregates.h"
@@ -67,6 +68,57 @@ inline void setValue(std::shared_ptr<SimpleRecord> record, Key const &key, typen
     record->set(key, value);
 }
 
+// Return a view of a double column
+ndarray::Array<double, 1> viewColumn(BaseColumnView const &columns, Key<double> const &key) {
+    return columns[key].shallow();
+}
+
+// Return a view of an Angle column, as radians
+ndarray::Array<double, 1> viewColumn(BaseColumnView const &columns, Key<lsst::geom::Angle> const &key) {
+    using AngleArray = ndarray::Array<lsst::geom::Angle, 1>;
+    using DoubleArray = ndarray::Array<double, 1>;
+    AngleArray angles = columns[key];
+    return ndarray::detail::ArrayAccess<DoubleArray>::construct(
+            reinterpret_cast<double *>(angles.getData()),
+            ndarray::detail::ArrayAccess<AngleArray>::getCore(angles));
+}
+
+// Return a copy of a field's values, as doubles (radians for Angle fields)
+template <typename Collection, typename T>
+ndarray::Array<double, 1> copyColumn(Collection const &records, Key<T> const &key) {
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(records.size());
+    auto iter = result.begin();
+    for (auto const &record : records) {
+        *iter++ = static_cast<double>(getValue(record, key));
+    }
+    return result;
+}
+
+// Return a field's values from a catalog: a view into the records if the catalog is contiguous, or else
+// a copy (in which case `isView` is set to false and the values must be written back with setColumn).
+template <typename Record, typename T>
+ndarray::Array<double, 1> getColumn(CatalogT<Record> &catalog, Key<T> const &key, bool &isView) {
+    isView = catalog.isContiguous();
+    return isView ? viewColumn(catalog.getColumnView(), key) : copyColumn(catalog, key);
+}
+
+// Return a copy of a field's values from a vector of records; `isView` is set to false.
+template <typename Record, typename T>
+ndarray::Array<double, 1> getColumn(std::vector<std::shared_ptr<Record>> &records, Key<T> const &key,
+                                    bool &isView) {
+    isView = false;
+    return copyColumn(records, key);
+}
+
+// Set a field in each record from a column of values
+template <typename Collection, typename T>
+void setColumn(Collection &records, Key<T> const &key, ndarray::Array<double, 1> const &values) {
+    auto iter = values.begin();
+    for (auto &record : records) {
+        setValue(record, key, T(*iter++));
+    }
+}
+
 }  // namespace
 
 template <typename ReferenceCollection>
@@ -78,17 +130,18 @@ void updateRefCentroids(geom::SkyWcs const &wcs, ReferenceCollection &refList) {
     CoordKey const coordKey(schema["coord"]);
     Point2DKey const centroidKey(schema["centroid"]);
     Key<Flag> const hasCentroidKey(schema["hasCentroid"]);
-    std::vector<lsst::geom::SpherePoint> skyList;
-    skyList.reserve(refList.size());
-    for (auto const &record : refList) {
-        skyList.emplace_back(getValue(record, coordKey));
+    bool isView = false;
+    auto const ra = getColumn(refList, coordKey.getRa(), isView);
+    auto const dec = getColumn(refList, coordKey.getDec(), isView);
+    auto const x = getColumn(refList, centroidKey.getX(), isView);
+    auto const y = getColumn(refList, centroidKey.getY(), isView);
+    wcs.skyToPixel(ra, dec, x, y);
+    if (!isView) {
+        setColumn(refList, centroidKey.getX(), x);
+        setColumn(refList, centroidKey.getY(), y);
     }
-    std::vector<lsst::geom::Point2D> const pixelList = wcs.skyToPixel(skyList);
-    auto pixelPos = pixelList.cbegin();
     for (auto &refObj : refList) {
-        setValue(refObj, centroidKey, *pixelPos);
         setValue(refObj, hasCentroidKey, true);
-        ++pixelPos;
     }
 }
 
@@ -100,16 +153,15 @@ void updateSourceCoords(geom::SkyWcs const &wcs, SourceCollection &sourceList) {
     auto const schema = getSchema(sourceList[0]);
     Point2DKey const centroidKey(schema["slot_Centroid"]);
     CoordKey const coordKey(schema["coord"]);
-    std::vector<lsst::geom::Point2D> pixelList;
-    pixelList.reserve(sourceList.size());
-    for (auto const &source : sourceList) {
-        pixelList.emplace_back(getValue(source, centroidKey));
-    }
-    std::vector<lsst::geom::SpherePoint> const skyList = wcs.pixelToSky(pixelList);
-    auto skyCoord = skyList.cbegin();
-    for (auto &source : sourceList) {
-        setValue(source, coordKey, *skyCoord);
-        ++skyCoord;
+    bool isView = false;
+    auto const x = getColumn(sourceList, centroidKey.getX(), isView);
+    auto const y = getColumn(sourceList, centroidKey.getY(), isView);
+    auto const ra = getColumn(sourceList, coordKey.getRa(), isView);
+    auto const dec = getColumn(sourceList, coordKey.getDec(), isView);
+    wcs.pixelToSky(x, y, ra, dec);
+    if (!isView) {
+        setColumn(sourceList, coordKey.getRa(), ra);
+        setColumn(sourceList, coordKey.getDec(), dec);
     }
 }
 
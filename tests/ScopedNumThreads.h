@@ -0,0 +1,57 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSST_AFW_TESTS_SCOPEDNUMTHREADS_H
+#define LSST_AFW_TESTS_SCOPEDNUMTHREADS_H
+
+#include "lsst/afw/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace detail {
+
+/*
+ * Set afw's default number of threads for the lifetime of this object, and then restore the previous
+ * default, so tests do not override AFW_NUM_THREADS for the tests that follow them.
+ */
+class ScopedNumThreads {
+public:
+    explicit ScopedNumThreads(int nThreads) : _previous(getDefaultNumThreads()) {
+        setDefaultNumThreads(nThreads);
+    }
+
+    ScopedNumThreads(ScopedNumThreads const &) = delete;
+    ScopedNumThreads(ScopedNumThreads &&) = delete;
+    ScopedNumThreads &operator=(ScopedNumThreads const &) = delete;
+    ScopedNumThreads &operator=(ScopedNumThreads &&) = delete;
+
+    ~ScopedNumThreads() { setDefaultNumThreads(_previous); }
+
+private:
+    int _previous;
+};
+
+}  // namespace detail
+}  // namespace afw
+}  // namespace lsst
+
+#endif
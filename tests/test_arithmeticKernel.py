@@ -0,0 +1,100 @@
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions
+import lsst.geom
+import lsst.afw.image
+
+
+class ArithmeticKernelTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        rng = np.random.RandomState(5)
+        self.bbox = lsst.geom.Box2I(lsst.geom.Point2I(-3, 4), lsst.geom.Extent2I(300, 250))
+        self.images = []
+        for i in range(3):
+            image = lsst.afw.image.MaskedImageF(self.bbox)
+            image.image.array[:, :] = rng.uniform(1.0, 5.0, size=image.image.array.shape)
+            image.variance.array[:, :] = rng.uniform(0.5, 2.0, size=image.variance.array.shape)
+            image.mask.array[:, :] = rng.randint(0, 4, size=image.mask.array.shape)
+            self.images.append(image)
+
+    def testParse(self):
+        kernel = lsst.afw.image.ArithmeticKernel("(raw - bias) * 1.7 / flat - bias")
+        self.assertEqual(kernel.getExpression(), "(raw - bias) * 1.7 / flat - bias")
+        self.assertEqual(kernel.getVariables(), ["raw", "bias", "flat"])
+        for bad in ["", "a +", "(a", "a)", "a b", "2 ** a", "1.5"]:
+            with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                lsst.afw.image.ArithmeticKernel(bad)
+
+    def testImage(self):
+        a, b, c = (image.image for image in self.images)
+        kernel = lsst.afw.image.ArithmeticKernel("(a - b) * 1.7 / c - -b")
+        out = lsst.afw.image.ImageF(self.bbox)
+        kernel.evaluate(out, [a, b, c])
+        expected = (a.array - b.array)*1.7/c.array + b.array
+        self.assertFloatsAlmostEqual(out.array, expected, rtol=1e-6)
+
+    def testMaskedImage(self):
+        a, b, c = self.images
+        kernel = lsst.afw.image.ArithmeticKernel("(a - b) / c")
+        out = lsst.afw.image.MaskedImageF(self.bbox)
+        kernel.evaluate(out, [a, b, c])
+        # Compare with the MaskedImage operators, which propagate variance the same way.
+        expected = a.clone()
+        expected -= b
+        expected /= c
+        self.assertFloatsAlmostEqual(out.image.array, expected.image.array, rtol=1e-6)
+        self.assertFloatsAlmostEqual(out.variance.array, expected.variance.array, rtol=1e-5)
+        np.testing.assert_array_equal(out.mask.array, expected.mask.array)
+
+    def testInPlace(self):
+        a, b, c = self.images
+        expected = a.image.array + 2.0*b.image.array
+        kernel = lsst.afw.image.ArithmeticKernel("a + 2*b")
+        kernel.evaluate(a, [a, b])
+        self.assertFloatsAlmostEqual(a.image.array, expected, rtol=1e-6)
+
+    def testErrors(self):
+        a, b, c = self.images
+        kernel = lsst.afw.image.ArithmeticKernel("a * b")
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            kernel.evaluate(a, [b])
+        small = lsst.afw.image.MaskedImageF(10, 10)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            kernel.evaluate(a, [b, small])
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
@@ -0,0 +1,139 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ArrowCpp
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-variable"
+#include "boost/test/unit_test.hpp"
+#pragma clang diagnostic pop
+
+#include <cstdint>
+#include <string>
+
+#include "lsst/utils/tests.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/Catalog.h"
+#include "lsst/afw/table/io/Arrow.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+BOOST_AUTO_TEST_CASE(ArrowRoundTrip) {
+    Schema schema;
+    auto a = schema.addField<std::int64_t>("a", "int64 field", "count");
+    auto b = schema.addField<float>("b", "float field");
+    auto c = schema.addField<lsst::geom::Angle>("c", "angle field");
+    auto d = schema.addField<Flag>("d", "first flag");
+    auto e = schema.addField<Flag>("e", "second flag");
+    auto f = schema.addField<std::string>("f", "fixed-length string", "", 8);
+    auto g = schema.addField<std::string>("g", "variable-length string", "", 0);
+    auto h = schema.addField<Array<double>>("h", "fixed-length array", "", 3);
+    auto i = schema.addField<Array<int>>("i", "variable-length array", "", 0);
+    BaseCatalog catalog(schema);
+    // Small blocks, so the catalog is not contiguous and every column is repacked.
+    catalog.getTable()->setBlockSize(2);
+    int const n = 11;
+    for (int j = 0; j < n; ++j) {
+        auto record = catalog.addNew();
+        record->set(a, 1000 * j);
+        record->set(b, 0.5f * j);
+        record->set(c, 0.25 * j * lsst::geom::radians);
+        record->set(d, j % 2 == 0);
+        record->set(e, j % 3 == 0);
+        record->set(f, std::string(j % 8, 'x'));
+        record->set(g, "string " + std::to_string(j));
+        for (int k = 0; k < 3; ++k) {
+            (*record)[h][k] = j + 0.1 * k;
+        }
+        ndarray::Array<int, 1, 1> values = ndarray::allocate(j % 4);
+        values.deep() = j;
+        record->set(i, values);
+    }
+    BOOST_REQUIRE(!catalog.isContiguous());
+
+    ArrowSchema arrowSchema;
+    ArrowArray arrowArray;
+    io::exportArrow(catalog, &arrowSchema, &arrowArray);
+    BOOST_CHECK_EQUAL(std::string(arrowSchema.format), "+s");
+    BOOST_CHECK_EQUAL(arrowSchema.n_children, 9);
+    BOOST_CHECK_EQUAL(arrowArray.length, n);
+    BOOST_CHECK_EQUAL(std::string(arrowSchema.children[0]->format), "l");
+    BOOST_CHECK_EQUAL(std::string(arrowSchema.children[3]->format), "b");
+    BOOST_CHECK_EQUAL(std::string(arrowSchema.children[5]->format), "u");
+    BOOST_CHECK_EQUAL(std::string(arrowSchema.children[7]->format), "+w:3");
+    BOOST_CHECK_EQUAL(std::string(arrowSchema.children[8]->format), "+l");
+    auto flagBits = static_cast<std::uint8_t const *>(arrowArray.children[3]->buffers[1]);
+    BOOST_CHECK_EQUAL(flagBits[0], 0x55);  // rows 0, 2, 4, 6
+    BOOST_CHECK_EQUAL(static_cast<std::int64_t const *>(arrowArray.children[0]->buffers[1])[7], 7000);
+
+    BaseCatalog copy = io::importArrow(&arrowSchema, &arrowArray);
+    BOOST_CHECK(arrowSchema.release == nullptr);
+    BOOST_CHECK(arrowArray.release == nullptr);
+    Schema const copySchema = copy.getSchema();
+    BOOST_CHECK(copySchema.compare(schema, Schema::IDENTICAL) == Schema::IDENTICAL);
+    BOOST_REQUIRE_EQUAL(copy.size(), catalog.size());
+    for (int j = 0; j < n; ++j) {
+        BaseRecord const &original = catalog[j];
+        BaseRecord const &record = copy[j];
+        BOOST_CHECK_EQUAL(record.get(a), original.get(a));
+        BOOST_CHECK_EQUAL(record.get(b), original.get(b));
+        BOOST_CHECK_EQUAL(record.get(c), original.get(c));
+        BOOST_CHECK_EQUAL(record.get(d), original.get(d));
+        BOOST_CHECK_EQUAL(record.get(e), original.get(e));
+        BOOST_CHECK_EQUAL(record.get(f), original.get(f));
+        BOOST_CHECK_EQUAL(record.get(g), original.get(g));
+        BOOST_CHECK_EQUAL_COLLECTIONS(record.get(h).begin(), record.get(h).end(), original.get(h).begin(),
+                                      original.get(h).end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(record.get(i).begin(), record.get(i).end(), original.get(i).begin(),
+                                      original.get(i).end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ArrowOwnsColumns) {
+    Schema schema;
+    auto key = schema.addField<double>("x", "only field");
+    BaseCatalog catalog(schema);
+    catalog.reserve(5);
+    for (int j = 0; j < 5; ++j) {
+        catalog.addNew()->set(key, 2.0 * j);
+    }
+    BOOST_REQUIRE(catalog.isContiguous());
+
+    ArrowSchema arrowSchema;
+    ArrowArray arrowArray;
+    io::exportArrow(catalog, &arrowSchema, &arrowArray);
+    // Records are padded, so even the only column of a contiguous catalog is copied, and the
+    // array is unaffected by later changes to the catalog.
+    BOOST_CHECK(arrowArray.children[0]->buffers[1] != catalog[0].getElement(key));
+    catalog[3].set(key, -1.0);
+    catalog.clear();
+    BOOST_CHECK_EQUAL(static_cast<double const *>(arrowArray.children[0]->buffers[1])[3], 6.0);
+    arrowArray.release(&arrowArray);
+    arrowSchema.release(&arrowSchema);
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,135 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BoundedFieldThreads
+
+#include <memory>
+#include <utility>
+
+#include "boost/test/unit_test.hpp"
+
+#include "astshim.h"
+#include "ndarray.h"
+#include "lsst/geom.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/math/BoundedField.h"
+#include "lsst/afw/math/ChebyshevBoundedField.h"
+#include "lsst/afw/math/TransformBoundedField.h"
+
+#include "ScopedNumThreads.h"
+
+/*
+ * Tests that BoundedField::fillImage and multiplyImage give the same images when afw's default number
+ * of threads is greater than one as when it is one, for a Chebyshev field and for a field backed by an
+ * AST mapping.
+ */
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace {
+
+// Tall enough to be split into many blocks of rows, and not a multiple of the block height.
+lsst::geom::Box2I const BBOX(lsst::geom::Point2I(-3, 4), lsst::geom::Extent2I(57, 301));
+
+template <typename T>
+bool isEqual(image::Image<T> const &a, image::Image<T> const &b) {
+    if (a.getBBox() != b.getBBox()) {
+        return false;
+    }
+    for (int y = 0; y < a.getHeight(); ++y) {
+        for (int x = 0; x < a.getWidth(); ++x) {
+            if (a(x, y) != b(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T>
+std::shared_ptr<image::Image<T>> makeImage() {
+    auto result = std::make_shared<image::Image<T>>(BBOX);
+    for (int y = 0; y < result->getHeight(); ++y) {
+        for (int x = 0; x < result->getWidth(); ++x) {
+            (*result)(x, y) = 1.0 + 0.5 * x - 0.25 * y;
+        }
+    }
+    return result;
+}
+
+// Fill and multiply images with field, with afw's default number of threads set to nThreads.
+template <typename T>
+std::pair<std::shared_ptr<image::Image<T>>, std::shared_ptr<image::Image<T>>> applyField(
+        BoundedField const &field, int nThreads) {
+    lsst::afw::detail::ScopedNumThreads const numThreads(nThreads);
+    auto filled = std::make_shared<image::Image<T>>(BBOX);
+    field.fillImage(*filled);
+    auto multiplied = makeImage<T>();
+    field.multiplyImage(*multiplied);
+    return std::make_pair(filled, multiplied);
+}
+
+template <typename T>
+void checkField(BoundedField const &field) {
+    auto const serial = applyField<T>(field, 1);
+    auto const parallel = applyField<T>(field, 4);
+    BOOST_CHECK(isEqual(*parallel.first, *serial.first));
+    BOOST_CHECK(isEqual(*parallel.second, *serial.second));
+    // The field is not constant, so the images are not trivially equal
+    BOOST_CHECK((*serial.first)(0, 0) != (*serial.first)(0, serial.first->getHeight() - 1));
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(Chebyshev) {
+    ndarray::Array<double, 2, 2> coefficients = ndarray::allocate(ndarray::makeVector(3, 3));
+    coefficients.deep() = 0.0;
+    coefficients[0][0] = 2.0;
+    coefficients[1][0] = 0.5;
+    coefficients[0][1] = -0.3;
+    coefficients[2][1] = 0.1;
+    ChebyshevBoundedField const field(BBOX, coefficients);
+    checkField<float>(field);
+    checkField<double>(field);
+}
+
+BOOST_AUTO_TEST_CASE(TransformBacked) {
+    // f(x, y) = 1.5 - 0.5 x + 0.01 y
+    // Each row is (coefficient, output axis, power of x, power of y)
+    double const terms[3][4] = {{1.5, 1.0, 0.0, 0.0}, {-0.5, 1.0, 1.0, 0.0}, {0.01, 1.0, 0.0, 1.0}};
+    ndarray::Array<double, 2, 2> coefficients = ndarray::allocate(ndarray::makeVector(3, 4));
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            coefficients[i][j] = terms[i][j];
+        }
+    }
+    ast::PolyMap const polyMap(coefficients, 1);
+    TransformBoundedField const field(BBOX, TransformBoundedField::Transform(polyMap));
+    checkField<float>(field);
+    checkField<double>(field);
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
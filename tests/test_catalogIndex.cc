@@ -0,0 +1,124 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CatalogIndexCpp
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-variable"
+#include "boost/test/unit_test.hpp"
+#pragma clang diagnostic pop
+
+#include <cmath>
+#include <vector>
+
+#include "lsst/utils/tests.h"
+#include "lsst/afw/table/Source.h"
+#include "lsst/afw/table/CatalogIndex.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace {
+
+typedef CatalogIndex<SourceRecord, RecordId> ParentIndex;
+
+// Build a catalog in which record i has parent i/3 (so each parent has three children).
+SourceCatalog makeCatalog(int num) {
+    SourceCatalog catalog(SourceTable::makeMinimalSchema());
+    for (int i = 0; i < num; ++i) {
+        auto record = catalog.addNew();
+        record->setId(100 + i);
+        record->setParent(i / 3);
+    }
+    return catalog;
+}
+
+// Check the index against a linear scan.
+void checkIndex(SourceCatalog const& catalog, ParentIndex const& index, RecordId parent) {
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < catalog.size(); ++i) {
+        if (catalog[i].getParent() == parent) {
+            expected.push_back(i);
+        }
+    }
+    auto const range = index.equalRange(parent);
+    std::vector<std::size_t> found(range.first, range.second);
+    BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(index.count(parent), expected.size());
+    if (expected.empty()) {
+        BOOST_CHECK(!index.find(parent));
+    } else {
+        BOOST_CHECK_EQUAL(index.find(parent)->getId(), catalog[expected.front()].getId());
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(CatalogIndexLookup) {
+    SourceCatalog catalog = makeCatalog(30);
+    Key<RecordId> const parentKey = catalog.getTable()->getParentKey();
+    for (auto method : {ParentIndex::HASH, ParentIndex::SORTED}) {
+        ParentIndex index(catalog, parentKey, method);
+        for (RecordId parent = -1; parent < 12; ++parent) {
+            checkIndex(catalog, index, parent);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CatalogIndexLazyRebuild) {
+    SourceCatalog catalog = makeCatalog(30);
+    Key<RecordId> const parentKey = catalog.getTable()->getParentKey();
+    ParentIndex index(catalog, parentKey, ParentIndex::SORTED);
+    checkIndex(catalog, index, 4);
+
+    // Mutations through the catalog API are picked up automatically
+    auto record = catalog.addNew();
+    record->setParent(4);
+    checkIndex(catalog, index, 4);
+    catalog.erase(catalog.begin() + 12);
+    checkIndex(catalog, index, 4);
+    catalog.sort(parentKey);
+    checkIndex(catalog, index, 4);
+
+    // Changing field values requires explicit invalidation
+    catalog[0].setParent(4);
+    index.invalidate();
+    checkIndex(catalog, index, 4);
+}
+
+BOOST_AUTO_TEST_CASE(CatalogIndexNaN) {
+    Schema schema;
+    Key<double> key = schema.addField<double>("value", "some value");
+    BaseCatalog catalog(schema);
+    for (int i = 0; i < 10; ++i) {
+        catalog.addNew()->set(key, i % 2 ? std::nan("") : 0.5 * i);
+    }
+    CatalogIndex<BaseRecord, double> index(catalog, key);
+    BOOST_CHECK_EQUAL(index.count(2.0), 1u);
+    BOOST_CHECK_EQUAL(index.count(std::nan("")), 0u);
+    BOOST_CHECK_EQUAL(index.find(2.0).get(), catalog.get(4).get());
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
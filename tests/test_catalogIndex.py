@@ -0,0 +1,128 @@
+#
+# LSST Data Management System
+# Copyright 2026 LSST Corporation.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <http://www.lsstcorp.org/LegalNotices/>.
+#
+
+"""
+Tests for table CatalogIndex
+
+Run with:
+   ./test_catalogIndex.py
+or
+   pytest test_catalogIndex.py
+"""
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.afw.table
+
+
+def makeCatalog(num):
+    """Make a catalog in which record i has parent i//3 (so each parent has
+    three children).
+    """
+    catalog = lsst.afw.table.SourceCatalog(lsst.afw.table.SourceTable.makeMinimalSchema())
+    for i in range(num):
+        record = catalog.addNew()
+        record.setId(100 + i)
+        record.setParent(i//3)
+    return catalog
+
+
+class CatalogIndexTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.catalog = makeCatalog(30)
+        self.parentKey = self.catalog.getTable().getParentKey()
+
+    def tearDown(self):
+        del self.catalog
+
+    def checkIndex(self, catalog, index, parent):
+        """Check an index against a linear scan.
+        """
+        expected = [i for i, record in enumerate(catalog) if record.getParent() == parent]
+        self.assertEqual(list(index.equalRange(parent)), expected)
+        self.assertEqual(index.count(parent), len(expected))
+        if expected:
+            self.assertEqual(index.find(parent).getId(), catalog[expected[0]].getId())
+        else:
+            self.assertIsNone(index.find(parent))
+
+    def testLookup(self):
+        Index = lsst.afw.table.SourceCatalogIndexL
+        for method in (Index.HASH, Index.SORTED):
+            index = Index(self.catalog, self.parentKey, method)
+            self.assertEqual(index.getKey(), self.parentKey)
+            self.assertEqual(index.getMethod(), method)
+            for parent in range(-1, 12):
+                self.checkIndex(self.catalog, index, parent)
+        self.assertEqual(Index(self.catalog, self.parentKey).getMethod(), Index.HASH)
+
+    def testLazyRebuild(self):
+        index = lsst.afw.table.SourceCatalogIndexL(self.catalog, self.parentKey,
+                                                   lsst.afw.table.SourceCatalogIndexL.SORTED)
+        self.checkIndex(self.catalog, index, 4)
+
+        # Mutations through the catalog API are picked up automatically
+        record = self.catalog.addNew()
+        record.setParent(4)
+        self.checkIndex(self.catalog, index, 4)
+        del self.catalog[12]
+        self.checkIndex(self.catalog, index, 4)
+        self.catalog.sort(self.parentKey)
+        self.checkIndex(self.catalog, index, 4)
+
+        # Changing field values requires explicit invalidation
+        self.catalog[0].setParent(4)
+        index.invalidate()
+        self.checkIndex(self.catalog, index, 4)
+
+    def testKeepsCatalogAlive(self):
+        catalog = makeCatalog(9)
+        index = lsst.afw.table.SourceCatalogIndexL(catalog, self.parentKey)
+        del catalog
+        self.assertEqual(list(index.equalRange(2)), [6, 7, 8])
+
+    def testNaN(self):
+        schema = lsst.afw.table.Schema()
+        key = schema.addField("value", type=np.float64, doc="some value")
+        catalog = lsst.afw.table.BaseCatalog(schema)
+        for i in range(10):
+            catalog.addNew().set(key, np.nan if i % 2 else 0.5*i)
+        index = lsst.afw.table.BaseCatalogIndexD(catalog, key)
+        self.assertEqual(index.count(2.0), 1)
+        self.assertEqual(index.count(np.nan), 0)
+        self.assertEqual(index.find(2.0).get(key), 2.0)
+
+
+class MemoryTester(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
@@ -116,6 +116,29 @@ class ChebyshevBoundedFieldTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsAlmostEqual(image1.array, image3.array, rtol=1.5E-2, atol=1.5E-2)
         self.assertFloatsAlmostEqual(image1.array, image4.array, rtol=2E-2, atol=2E-2)
 
+    def testEvaluateGrid(self):
+        """Test that the separable grid evaluation used by fillImage matches
+        point-by-point evaluation.
+        """
+        boxD = lsst.geom.Box2D(self.bbox)
+        x = np.linspace(boxD.getMinX(), boxD.getMaxX(), 17)
+        y = np.linspace(boxD.getMinY(), boxD.getMaxY(), 13)
+        xx, yy = np.meshgrid(x, y)
+        for ctrl, coefficients in self.cases:
+            field = lsst.afw.math.ChebyshevBoundedField(self.bbox, coefficients)
+            grid = field.evaluateGrid(x, y)
+            self.assertEqual(grid.shape, (y.size, x.size))
+            expect = field.evaluate(xx.ravel(), yy.ravel()).reshape(grid.shape)
+            self.assertFloatsAlmostEqual(grid, expect, rtol=1E-12, atol=1E-12)
+            image = lsst.afw.image.ImageD(self.bbox)
+            field.fillImage(image)
+            x0, y0 = self.bbox.getBegin()
+            ix, iy = np.meshgrid(np.arange(self.bbox.getWidth()) + x0,
+                                 np.arange(self.bbox.getHeight()) + y0)
+            expect = field.evaluate(ix.ravel().astype(float), iy.ravel().astype(float))
+            self.assertFloatsAlmostEqual(image.array, expect.reshape(image.array.shape),
+                                         rtol=1E-12, atol=1E-12)
+
     def testEvaluate(self):
         """Test the single-point evaluate method against explicitly-defined 1-d Chebyshevs
         (at the top of this file).
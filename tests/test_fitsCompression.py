@@ -858,6 +858,60 @@ class EmptyExposureTestCase(lsst.utils.tests.TestCase):
             self.checkEmptyExposure(lsst.afw.fits.compressionAlgorithmFromString(algorithm))
 
 
+class TiledReadTestCase(lsst.utils.tests.TestCase):
+    """Test reading subimages of tile-compressed images with multiple threads
+
+    The threaded reader decompresses the tiles itself, so it must reproduce
+    exactly what cfitsio gives us.
+    """
+    def setUp(self):
+        self.bbox = lsst.geom.Box2I(lsst.geom.Point2I(123, 456), lsst.geom.Extent2I(100, 75))
+        self.subBBox = lsst.geom.Box2I(lsst.geom.Point2I(140, 470), lsst.geom.Extent2I(53, 41))
+        self.tiles = np.array([16, 8], dtype=np.int64)
+        self.oldThreads = lsst.afw.fits.getImageReadThreads()
+
+    def tearDown(self):
+        lsst.afw.fits.setImageReadThreads(self.oldThreads)
+
+    def makeImage(self, ImageClass):
+        image = ImageClass(self.bbox)
+        rng = np.random.RandomState(12345)
+        dtype = image.getArray().dtype
+        noise = rng.normal(0.0, 67.89, image.getArray().shape).astype(dtype)
+        image.getArray()[:] = np.array(12345.6789, dtype=dtype) + noise
+        return image
+
+    def checkTiledRead(self, image, compression):
+        """Compare serial and threaded reads of the full image and a subimage"""
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            image.writeFits(filename, lsst.afw.fits.ImageWriteOptions(compression))
+            reader = lsst.afw.image.ImageFitsReader(filename)
+            dtype = image.getArray().dtype
+            for bbox in (self.bbox, self.subBBox):
+                lsst.afw.fits.setImageReadThreads(1)
+                serial = reader.read(bbox=bbox, dtype=dtype)
+                lsst.afw.fits.setImageReadThreads(4)
+                threaded = reader.read(bbox=bbox, dtype=dtype)
+                self.assertEqual(threaded.getBBox(), bbox)
+                self.assertImagesEqual(threaded, serial)
+
+    def testLosslessInt(self):
+        for cls, algorithm in itertools.product((lsst.afw.image.ImageU, lsst.afw.image.ImageI),
+                                                ("GZIP", "GZIP_SHUFFLE", "RICE")):
+            compression = ImageCompressionOptions(lsst.afw.fits.compressionAlgorithmFromString(algorithm),
+                                                  self.tiles)
+            self.checkTiledRead(self.makeImage(cls), compression)
+
+    def testLossyFloat(self):
+        for cls, algorithm in itertools.product((lsst.afw.image.ImageF, lsst.afw.image.ImageD),
+                                                ("GZIP", "GZIP_SHUFFLE", "RICE")):
+            compression = ImageCompressionOptions(lsst.afw.fits.compressionAlgorithmFromString(algorithm),
+                                                  self.tiles, 10.0)
+            image = self.makeImage(cls)
+            image.getArray()[3, 5] = np.nan
+            self.checkTiledRead(image, compression)
+
+
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
 
@@ -0,0 +1,112 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE FitsQuantize
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+
+#include "ndarray.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/fitsCompression.h"
+#include "lsst/afw/math/Random.h"
+
+#include "ScopedNumThreads.h"
+
+/*
+ * Tests of the scaling statistics estimated from a sample of the pixels, and of quantizing
+ * images with several threads.
+ */
+namespace lsst {
+namespace afw {
+namespace fits {
+
+namespace {
+
+// Gaussian noise, with noisier and brighter columns every `period` columns.
+ndarray::Array<float, 2, 2> makeImage(int width, int height, int period) {
+    math::Random rng(math::Random::MT19937, 3);
+    ndarray::Array<float, 2, 2> image = ndarray::allocate(height, width);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            image[y][x] = (x % period == 0) ? 50.0 + 10.0 * rng.gaussian() : 100.0 + rng.gaussian();
+        }
+    }
+    return image;
+}
+
+// Standard deviation from the interquartile range of all pixels, as the STDEV_* scalings define it.
+double computeFullStdev(ndarray::Array<float const, 2, 2> const &image) {
+    std::vector<float> values(image.getData(), image.getData() + image.getNumElements());
+    std::size_t const q1 = values.size() / 4, q3 = q1 + values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + q1, values.end());
+    float const lower = values[q1];
+    std::nth_element(values.begin(), values.begin() + q3, values.end());
+    return 0.741 * (values[q3] - lower);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(SampledStatistics) {
+    // 2e6 pixels are sampled every 20 pixels or so, which divides the width, so a stride that
+    // followed the columns down the image would see only the bad columns.
+    ndarray::Array<float const, 2, 2> const image = makeImage(2000, 1000, 20);
+    ndarray::Array<bool, 2, 2> mask = ndarray::allocate(image.getShape());
+    mask.deep() = false;
+    double const quantizeLevel = 4.0;
+    ImageScalingOptions const options(ImageScalingOptions::STDEV_BOTH, 32, {}, 1, quantizeLevel);
+    ImageScale const scale = options.determine(image, mask);
+    double const fullStdev = computeFullStdev(image);
+    BOOST_CHECK_CLOSE(scale.bscale * quantizeLevel, fullStdev, 3.0);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelQuantize) {
+    ndarray::Array<float const, 2, 2> const image = makeImage(300, 250, 7);
+    ImageScale const scale(32, 0.25, 100.0);
+    ndarray::Array<long, 1, 1> tiles = ndarray::allocate(2);
+    tiles[0] = 64;
+    tiles[1] = 16;
+    for (bool fuzz : {false, true}) {
+        std::shared_ptr<detail::PixelArrayBase> serial, parallel;
+        {
+            lsst::afw::detail::ScopedNumThreads const numThreads(1);
+            serial = scale.toFits(image, false, fuzz, tiles, 5);
+        }
+        {
+            lsst::afw::detail::ScopedNumThreads const numThreads(4);
+            parallel = scale.toFits(image, false, fuzz, tiles, 5);
+        }
+        BOOST_REQUIRE_EQUAL(serial->getNumElements(), parallel->getNumElements());
+        BOOST_CHECK(std::memcmp(serial->getData(), parallel->getData(),
+                                serial->getNumElements() * sizeof(std::int32_t)) == 0);
+    }
+}
+
+}  // namespace fits
+}  // namespace afw
+}  // namespace lsst
@@ -32,7 +32,10 @@ or
 
 import unittest
 
+import numpy as np
+
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.image as afwImage
 import lsst.afw.geom as afwGeom
@@ -164,6 +167,44 @@ class FootprintSetTestCase(unittest.TestCase):
                 for x in range(sp.getX0(), sp.getX1() + 1):
                     self.assertEqual(idImage[x, sp.getY(), afwImage.LOCAL], i + 1)
 
+    def testFootprintSetImageBands(self):
+        """Check that inserting a FootprintSet a band at a time matches inserting it at once"""
+        ds = afwDetect.FootprintSet(self.im, afwDetect.Threshold(10))
+
+        for relativeIDs in (True, False):
+            expected = ds.insertIntoImage(relativeIDs)
+            for bandHeight in (1, 3, 5, 8, 100):
+                bands = []
+
+                def addBand(band):
+                    self.assertEqual(band.getX0(), expected.getX0())
+                    self.assertEqual(band.getWidth(), expected.getWidth())
+                    bands.append((band.getY0(), band.array.copy()))
+
+                ds.insertIntoImageBands(addBand, bandHeight, relativeIDs)
+                self.assertEqual([y0 for y0, _ in bands],
+                                 list(range(expected.getY0(), expected.getBBox().getEndY(), bandHeight)))
+                np.testing.assert_array_equal(np.concatenate([array for _, array in bands]),
+                                              expected.array)
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            ds.insertIntoImageBands(lambda band: None, 0, True)
+
+    def testFootprintSetMask(self):
+        """Check that setting a mask plane from a FootprintSet matches setting it Footprint by Footprint"""
+        ds = afwDetect.FootprintSet(self.im, afwDetect.Threshold(10))
+        mask = afwImage.Mask(self.im.getBBox())
+        ds.setMask(mask, "DETECTED")
+
+        expected = afwImage.Mask(self.im.getBBox())
+        bitmask = expected.getPlaneBitMask("DETECTED")
+        for foot in ds.getFootprints():
+            foot.spans.setMask(expected, bitmask)
+        np.testing.assert_array_equal(mask.array, expected.array)
+
+        with self.assertRaises(lsst.pex.exceptions.OutOfRangeError):
+            ds.setMask(afwImage.Mask(4, 4), "DETECTED")
+
     def testFootprintsImage(self):
         """Check that we can search Images as well as MaskedImages"""
         ds = afwDetect.FootprintSet(self.im, afwDetect.Threshold(10))
@@ -554,6 +595,39 @@ class PeaksInFootprintsTestCase(unittest.TestCase):
 
         self.doTestPeaks(polarity=False, callback=callback)
 
+    def testPeaksMatchNeighbourTest(self):
+        """Test that the peaks found are exactly the pixels no neighbour exceeds"""
+        rng = np.random.RandomState(7)
+        for xy0 in (lsst.geom.Point2I(0, 0), lsst.geom.Point2I(5, 11), lsst.geom.Point2I(-30, -20)):
+            for polarity in (True, False):
+                image = afwImage.ImageF(lsst.geom.Box2I(xy0, lsst.geom.Extent2I(61, 47)))
+                array = rng.normal(size=image.array.shape).astype(np.float32)
+                array[10:20, 10:50] += 3.0
+                array[30:40, :] += 3.0  # touches the left and right edges
+                array[::7, ::5] = np.round(array[::7, ::5])  # ties between neighbours
+                image.array[:, :] = array if polarity else -array
+                threshold = afwDetect.Threshold(1.0, afwDetect.Threshold.VALUE, polarity)
+                fs = afwDetect.FootprintSet(image, threshold)
+                sign = 1.0 if polarity else -1.0
+                values = sign*image.array
+                height, width = values.shape
+                for foot in fs.getFootprints():
+                    expected = set()
+                    for span in foot.getSpans():
+                        y = span.getY() - xy0.getY()
+                        if y < 1 or y > height - 2:
+                            continue
+                        for x in range(max(span.getMinX() - xy0.getX(), 1),
+                                       min(span.getMaxX() - xy0.getX(), width - 2) + 1):
+                            neighbours = values[y - 1:y + 2, x - 1:x + 2]
+                            if not (neighbours > values[y, x]).any():
+                                expected.add((x + xy0.getX(), y + xy0.getY()))
+                    found = set((peak.getIx(), peak.getIy()) for peak in foot.getPeaks())
+                    if expected:
+                        self.assertEqual(found, expected)
+                    else:
+                        self.assertEqual(len(found), 1)
+
     def testGrowFootprints(self):
         """Test that we can grow footprints, correctly merging those that now touch"""
         def callback():
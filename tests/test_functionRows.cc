@@ -0,0 +1,131 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE FunctionRows
+
+#include <cmath>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+
+#include "lsst/geom.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/math/FunctionLibrary.h"
+
+#include "ScopedNumThreads.h"
+
+/*
+ * Tests that Function2::evaluateRow agrees with operator(), and that adding functions to images
+ * (which uses it, from several threads) agrees with a pixel-by-pixel evaluation.
+ */
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace {
+
+bool isClose(double actual, double expected) {
+    return std::abs(actual - expected) <= 1e-12 * (1.0 + std::abs(expected));
+}
+
+std::vector<double> makeParameters(int n) {
+    std::vector<double> result;
+    for (int i = 0; i < n; ++i) {
+        result.push_back(0.5 - 0.13 * i * (i % 2 == 0 ? 1 : -1));
+    }
+    return result;
+}
+
+void checkRows(Function2<double> const &function) {
+    std::vector<double> values(37);
+    for (double y : {-3.0, 0.25, 12.5}) {
+        // Alternate between operator() and evaluateRow to check that the caches used by operator()
+        // are not disturbed.
+        function.evaluateRow(y, -4.5, values.size(), values.data());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            BOOST_CHECK(isClose(values[i], function(-4.5 + i, y)));
+        }
+    }
+}
+
+// Count the pixels of img that differ from offset + sign*function.
+int countFailures(image::Image<float> const &img, Function2<double> const &function, double offset,
+                  double sign) {
+    int nFailures = 0;
+    for (int y = 0; y < img.getHeight(); ++y) {
+        for (int x = 0; x < img.getWidth(); ++x) {
+            double const value = function(img.getX0() + x, img.getY0() + y);
+            if (std::abs(img(x, y) - (offset + sign * value)) > 1e-5 * (1.0 + std::abs(value))) {
+                ++nFailures;
+            }
+        }
+    }
+    return nFailures;
+}
+
+void checkImage(Function2<double> const &function) {
+    lsst::geom::Box2I const bbox(lsst::geom::Point2I(-20, 7), lsst::geom::Extent2I(300, 200));
+    for (int nThreads : {1, 4}) {
+        lsst::afw::detail::ScopedNumThreads const numThreads(nThreads);
+        image::Image<float> img(bbox);
+        img = 2.0;
+        img += function;
+        BOOST_CHECK_EQUAL(countFailures(img, function, 2.0, 1.0), 0);
+        img = 2.0;
+        img -= function;
+        BOOST_CHECK_EQUAL(countFailures(img, function, 2.0, -1.0), 0);
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(Polynomial) {
+    PolynomialFunction2<double> const function(makeParameters(10));
+    checkRows(function);
+    checkImage(PolynomialFunction2<double>(makeParameters(6)));
+}
+
+BOOST_AUTO_TEST_CASE(Chebyshev) {
+    lsst::geom::Box2D const range(lsst::geom::Point2D(-25.0, 0.0), lsst::geom::Point2D(290.0, 210.0));
+    for (int nParams : {1, 3, 10, 15}) {
+        Chebyshev1Function2<double> const function(makeParameters(nParams), range);
+        checkRows(function);
+        checkImage(function);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Gaussian) {
+    GaussianFunction2<double> const function(40.0, 25.0, 0.3);
+    checkRows(function);
+    checkImage(function);
+}
+
+BOOST_AUTO_TEST_CASE(DefaultImplementation) {
+    DoubleGaussianFunction2<double> const function(30.0, 60.0, 0.1);
+    checkRows(function);
+    checkImage(function);
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
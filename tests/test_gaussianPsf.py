@@ -91,6 +91,18 @@ class GaussianPsfTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsAlmostEqual(image.getArray(), check.getArray(), atol=1E-4, rtol=1E-4,
                                      plotOnFailure=True)
 
+    def testOffsetImageExact(self):
+        """Images at offset positions are sampled directly from the Gaussian,
+        on the same bounding box the base class's recentering would use."""
+        kernelBBox = self.psf.computeKernelImage().getBBox()
+        for x, y in [(0.5, -0.5), (10.7, -3.4), (-20.49, 7.51), (3.0, 4.0)]:
+            image = self.psf.computeImage(lsst.geom.Point2D(x, y))
+            bbox = lsst.geom.Box2I(kernelBBox)
+            bbox.shift(lsst.geom.Extent2I(int(np.floor(x + 0.5)), int(np.floor(y + 0.5))))
+            self.assertEqual(image.getBBox(), bbox)
+            check = makeGaussianImage(bbox, self.psf.getSigma(), x, y)
+            self.assertFloatsAlmostEqual(image.getArray(), check.getArray(), atol=1E-14, rtol=1E-12)
+
     def testApertureFlux(self):
         image = self.psf.computeKernelImage(lsst.geom.Point2D(0.0, 0.0))
         # test aperture implementation is very crude; can only test to about
@@ -104,6 +116,42 @@ class GaussianPsfTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsAlmostEqual(
             self.psf.computeShape().getDeterminantRadius(), 4.0)
 
+    def testComputeImages(self):
+        positions = [lsst.geom.Point2D(x, y) for x, y in
+                     ((0.25, 0.25), (10.5, -3.0), (0.25, 0.25), (117.2, 45.9))]
+        images = self.psf.computeImages(positions)
+        self.assertEqual(len(images), len(positions))
+        for position, image in zip(positions, images):
+            check = self.psf.computeImage(position)
+            self.assertEqual(image.getBBox(), check.getBBox())
+            self.assertFloatsEqual(image.getArray(), check.getArray())
+        kernelImages = self.psf.computeKernelImages(positions)
+        for image in kernelImages:
+            self.assertFloatsEqual(image.getArray(), self.psf.computeKernelImage().getArray())
+        # COPY images may be modified without affecting the cache
+        images[0].getArray()[:, :] = 0.0
+        self.assertFloatsAlmostEqual(self.psf.computeImages(positions[:1])[0].getArray().sum(), 1.0,
+                                     atol=1E-4)
+
+    def testCacheGridSpacing(self):
+        self.assertEqual(self.psf.getCacheGridSpacing(), 0.0)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            self.psf.setCacheGridSpacing(-1.0)
+        position = lsst.geom.Point2D(10.1, 20.3)
+        exact = self.psf.computeImage(position)
+        self.psf.setCacheGridSpacing(0.25)
+        # Kernel images are shared between nearby positions...
+        kernelImage = self.psf.computeKernelImage(position)
+        check = self.psf.computeKernelImage(lsst.geom.Point2D(10.0, 20.25))
+        self.assertEqual(kernelImage.getBBox(), check.getBBox())
+        self.assertFloatsEqual(kernelImage.getArray(), check.getArray())
+        # ...but images are still centered on the exact position.
+        for image in (self.psf.computeImage(position), self.psf.computeImages([position])[0]):
+            self.assertEqual(image.getBBox(), exact.getBBox())
+            self.assertFloatsAlmostEqual(image.getArray(), exact.getArray(), atol=1E-4)
+        other = self.psf.computeImage(lsst.geom.Point2D(10.0, 20.25))
+        self.assertFloatsNotEqual(other.getArray(), exact.getArray())
+
     def testPersistence(self):
         with lsst.utils.tests.getTempFilePath(".fits") as filename:
             self.psf.writeFits(filename)
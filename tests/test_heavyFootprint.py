@@ -36,6 +36,7 @@ import unittest
 import numpy as np
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.image as afwImage
 import lsst.afw.detection as afwDetect
@@ -151,6 +152,51 @@ class HeavyFootprintTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsEqual(
             self.mi.getImage().getArray(), omi.getImage().getArray())
 
+    def testMakeHeavyMatchesSingle(self):
+        """Test that makeHeavy extracts the same pixels as makeHeavyFootprint"""
+        rng = np.random.RandomState(5)
+        mi = afwImage.MaskedImageF(lsst.geom.BoxI(lsst.geom.PointI(-7, 12), lsst.geom.ExtentI(60, 40)))
+        mi.image.array[:, :] = rng.normal(size=mi.image.array.shape)
+        mi.mask.array[:, :] = rng.randint(0, 0x10, size=mi.mask.array.shape)
+        mi.variance.array[:, :] = rng.uniform(1.0, 2.0, size=mi.variance.array.shape)
+        original = mi.Factory(mi, True)
+        fs = afwDetect.FootprintSet(mi, afwDetect.Threshold(1.0))
+        feet = [afwDetect.Footprint(foot) for foot in fs.getFootprints()]
+        self.assertGreater(len(feet), 1)
+
+        fs.makeHeavy(mi)
+        for foot, heavy in zip(feet, fs.getFootprints()):
+            self.assertTrue(heavy.isHeavy())
+            self.assertEqual(heavy.getSpans(), foot.getSpans())
+            self.assertEqual(len(heavy.getPeaks()), len(foot.getPeaks()))
+            expected = afwDetect.makeHeavyFootprint(foot, original)
+            self.assertFloatsEqual(heavy.getImageArray(), expected.getImageArray())
+            self.assertFloatsEqual(heavy.getMaskArray(), expected.getMaskArray())
+            self.assertFloatsEqual(heavy.getVarianceArray(), expected.getVarianceArray())
+        self.assertMaskedImagesEqual(mi, original)
+
+        # Resetting the source pixels as they are extracted
+        ctrl = afwDetect.HeavyFootprintCtrl(afwDetect.HeavyFootprintCtrl.SET)
+        ctrl.setImageVal(-1.0)
+        ctrl.setMaskVal(0x3)
+        ctrl.setVarianceVal(5.0)
+        fs = afwDetect.FootprintSet(mi, afwDetect.Threshold(1.0))
+        fs.makeHeavy(mi, ctrl)
+        for foot, heavy in zip(feet, fs.getFootprints()):
+            expected = afwDetect.makeHeavyFootprint(foot, original)
+            self.assertFloatsEqual(heavy.getImageArray(), expected.getImageArray())
+            self.assertFloatsEqual(heavy.getMaskArray(), expected.getMaskArray())
+            for span in foot.getSpans():
+                for x in range(span.getX0(), span.getX1() + 1):
+                    image, mask, variance = mi[x, span.getY(), afwImage.PARENT]
+                    self.assertEqual(image, -1.0)
+                    self.assertEqual(mask, original.mask[x, span.getY(), afwImage.PARENT] & ~0x3)
+                    self.assertEqual(variance, 5.0)
+
+        # Footprints must lie within the image
+        with self.assertRaises(lsst.pex.exceptions.OutOfRangeError):
+            fs.makeHeavy(afwImage.MaskedImageF(10, 10))
+
     def testXY0(self):
         """Test that inserting a HeavyFootprint obeys XY0"""
         fs = afwDetect.FootprintSet(self.mi, afwDetect.Threshold(1))
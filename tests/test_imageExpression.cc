@@ -0,0 +1,167 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ImageExpression
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+
+#include "lsst/geom.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/image/ArithmeticKernel.h"
+#include "lsst/afw/image/ImageExpression.h"
+
+#include "ScopedNumThreads.h"
+
+/*
+ * Tests that expression templates and compiled ArithmeticKernels agree with pixel-by-pixel evaluation,
+ * on images large enough to be split between threads.
+ */
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+using MaskedImageF = MaskedImage<float>;
+
+lsst::geom::Extent2I const DIMENSIONS(523, 310);
+
+bool isClose(double actual, double expected) {
+    return std::abs(actual - expected) <= 1e-5 * (1.0 + std::abs(expected));
+}
+
+std::shared_ptr<MaskedImageF> makeImage(int seed) {
+    auto result = std::make_shared<MaskedImageF>(DIMENSIONS);
+    for (int y = 0; y < result->getHeight(); ++y) {
+        for (int x = 0; x < result->getWidth(); ++x) {
+            float const value = 1.0 + std::fmod(0.37 * (x + seed) + 0.61 * (y * seed + 1), 7.0);
+            (*result->getImage())(x, y) = value;
+            (*result->getMask())(x, y) = (x + y + seed) % 5 == 0 ? 1 << (seed % 3) : 0;
+            (*result->getVariance())(x, y) = 0.5 * value + seed;
+        }
+    }
+    return result;
+}
+
+// Check `out` against (a - b) * 2 / c, with variance and mask propagation if `masked`.
+int countFailures(MaskedImageF const &out, MaskedImageF const &a, MaskedImageF const &b,
+                  MaskedImageF const &c, bool masked) {
+    int nFailures = 0;
+    for (int y = 0; y < out.getHeight(); ++y) {
+        for (int x = 0; x < out.getWidth(); ++x) {
+            double const va = (*a.getImage())(x, y), vb = (*b.getImage())(x, y), vc = (*c.getImage())(x, y);
+            double const n = 2.0 * (va - vb);
+            double const nVar = 4.0 * ((*a.getVariance())(x, y) + (*b.getVariance())(x, y));
+            double const expectedVariance =
+                    (n * n * (*c.getVariance())(x, y) + vc * vc * nVar) / std::pow(vc, 4);
+            MaskPixel const expectedMask = (*a.getMask())(x, y) | (*b.getMask())(x, y) | (*c.getMask())(x, y);
+            if (!isClose((*out.getImage())(x, y), n / vc)) {
+                ++nFailures;
+            } else if (masked && (!isClose((*out.getVariance())(x, y), expectedVariance) ||
+                                  (*out.getMask())(x, y) != expectedMask)) {
+                ++nFailures;
+            }
+        }
+    }
+    return nFailures;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ExpressionImage) {
+    auto const a = makeImage(1), b = makeImage(2), c = makeImage(3);
+    for (int nThreads : {1, 4}) {
+        lsst::afw::detail::ScopedNumThreads const numThreads(nThreads);
+        MaskedImageF out(DIMENSIONS);
+        using namespace expressions;
+        evaluate(*out.getImage(), (term(*a->getImage()) - term(*b->getImage())) * 2 / term(*c->getImage()));
+        BOOST_CHECK_EQUAL(countFailures(out, *a, *b, *c, false), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ExpressionMaskedImage) {
+    auto const a = makeImage(1), b = makeImage(2), c = makeImage(3);
+    for (int nThreads : {1, 4}) {
+        lsst::afw::detail::ScopedNumThreads const numThreads(nThreads);
+        MaskedImageF out(*a, true);
+        using namespace expressions;
+        // The output is also an operand.
+        evaluate(out, 2.0 * (term(out) - term(*b)) / term(*c));
+        BOOST_CHECK_EQUAL(countFailures(out, *a, *b, *c, true), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ExpressionSizeMismatch) {
+    MaskedImageF out(DIMENSIONS);
+    MaskedImageF const other(lsst::geom::Extent2I(10, 11));
+    using namespace expressions;
+    BOOST_CHECK_THROW(evaluate(out, term(out) + term(other)), pex::exceptions::LengthError);
+    BOOST_CHECK_THROW(evaluate(out, -term(other)), pex::exceptions::LengthError);
+}
+
+BOOST_AUTO_TEST_CASE(KernelImage) {
+    auto const a = makeImage(1), b = makeImage(2), c = makeImage(3);
+    ArithmeticKernel const kernel("(a - b) * 2 / c");
+    BOOST_CHECK(kernel.getVariables() == std::vector<std::string>({"a", "b", "c"}));
+    for (int nThreads : {1, 4}) {
+        lsst::afw::detail::ScopedNumThreads const numThreads(nThreads);
+        MaskedImageF out(DIMENSIONS);
+        kernel.evaluate(*out.getImage(), {a->getImage(), b->getImage(), c->getImage()});
+        BOOST_CHECK_EQUAL(countFailures(out, *a, *b, *c, false), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(KernelMaskedImage) {
+    auto const b = makeImage(2), c = makeImage(3);
+    ArithmeticKernel const kernel("-(-2.0*out - 2e0*-b) / c");
+    BOOST_CHECK(kernel.getVariables() == std::vector<std::string>({"out", "b", "c"}));
+    for (int nThreads : {1, 4}) {
+        lsst::afw::detail::ScopedNumThreads const numThreads(nThreads);
+        auto const a = makeImage(1);
+        auto out = std::make_shared<MaskedImageF>(*a, true);
+        // The output is also an operand.
+        kernel.evaluate(*out, {out, b, c});
+        BOOST_CHECK_EQUAL(countFailures(*out, *a, *b, *c, true), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(KernelErrors) {
+    BOOST_CHECK_THROW(ArithmeticKernel("a +"), pex::exceptions::InvalidParameterError);
+    BOOST_CHECK_THROW(ArithmeticKernel("(a + b"), pex::exceptions::InvalidParameterError);
+    BOOST_CHECK_THROW(ArithmeticKernel("a b"), pex::exceptions::InvalidParameterError);
+    BOOST_CHECK_THROW(ArithmeticKernel("a % b"), pex::exceptions::InvalidParameterError);
+    BOOST_CHECK_THROW(ArithmeticKernel("1 + 2"), pex::exceptions::InvalidParameterError);
+    ArithmeticKernel const kernel("a + b");
+    auto const a = makeImage(1);
+    auto const small = std::make_shared<MaskedImageF>(lsst::geom::Extent2I(10, 11));
+    MaskedImageF out(DIMENSIONS);
+    BOOST_CHECK_THROW(kernel.evaluate(out, {a}), pex::exceptions::LengthError);
+    BOOST_CHECK_THROW(kernel.evaluate(out, {a, small}), pex::exceptions::LengthError);
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -210,6 +210,158 @@ class ImagePcaTestCase(lsst.utils.tests.TestCase):
             mos = displayUtils.Mosaic(background=-10)
             ds9.mtv(mos.makeMosaic(eImages), frame=1)
 
+    def makeImages(self, nImage, width=15, height=13, nBases=4, noise=0.01, seed=1):
+        """Make images that are random combinations of a few smooth bases, plus noise"""
+        rng = np.random.RandomState(seed)
+        y, x = np.indices((height, width))
+        bases = [np.sin(0.3*(i + 1)*x + 0.7*i)*np.cos(0.2*(i + 1)*y) for i in range(nBases)]
+        images, fluxes = [], []
+        for i in range(nImage):
+            im = afwImage.ImageD(width, height)
+            im.array[:, :] = sum(rng.normal()*b for b in bases) + noise*rng.normal(size=(height, width))
+            images.append(im)
+            fluxes.append(rng.uniform(0.5, 2.0))
+        return images, fluxes
+
+    def assertEigenImagesAlmostEqual(self, eImages1, eImages2, rtol):
+        """Check that two lists of eigenimages agree, up to the sign of each"""
+        self.assertEqual(len(eImages1), len(eImages2))
+        for e1, e2 in zip(eImages1, eImages2):
+            sign = np.sign(np.sum(e1.array*e2.array))
+            self.assertFloatsAlmostEqual(e1.array, sign*e2.array, rtol=rtol,
+                                         atol=rtol*np.abs(e2.array).max())
+
+    def testPcaMatchesDirect(self):
+        """Test that the PCA decomposition matches one computed directly with numpy"""
+        images, fluxes = self.makeImages(12)
+        for constantWeight in (True, False):
+            pca = afwImage.ImagePcaD(constantWeight)
+            for im, flux in zip(images, fluxes):
+                pca.addImage(im, flux)
+            pca.analyze()
+
+            scales = [1.0/flux if constantWeight else 1.0 for flux in fluxes]
+            data = np.array([scale*im.array.flatten() for scale, im in zip(scales, images)]).T
+            values, vectors = np.linalg.eigh(np.dot(data.T, data)/len(images))
+            order = np.argsort(values)[::-1]
+            self.assertFloatsAlmostEqual(np.array(pca.getEigenValues()), values[order], rtol=1e-10,
+                                         atol=1e-12*values.max())
+
+            fluxBar = np.mean(fluxes) if constantWeight else 1.0
+            eImages = pca.getEigenImages()
+            self.assertEqual(len(eImages), len(images))
+            # Only compare the well-determined components
+            for i in range(4):
+                expected = afwImage.ImageD(images[0].getDimensions())
+                eVector = vectors[:, order[i]]
+                expected.array[:, :] = fluxBar*np.dot(data, eVector).reshape(expected.array.shape)
+                self.assertEigenImagesAlmostEqual([eImages[i]], [expected], rtol=1e-8)
+
+    def testPcaIncremental(self):
+        """Test that adding and removing images between analyses matches analyzing from scratch"""
+        images, fluxes = self.makeImages(20)
+        pca = afwImage.ImagePcaD()
+        self.assertFalse(pca.getReuseInnerProducts())
+        pca.setReuseInnerProducts(True)
+        for im, flux in zip(images[:15], fluxes[:15]):
+            pca.addImage(im, flux)
+        pca.analyze()
+        for im, flux in zip(images[15:], fluxes[15:]):
+            pca.addImage(im, flux)
+        for index in (3, 16, 0):
+            pca.removeImage(index)
+        pca.analyze()
+        with self.assertRaises(pexExcept.OutOfRangeError):
+            pca.removeImage(len(images))
+
+        kept = [i for i in range(len(images)) if i not in (0, 4, 18)]
+        self.assertEqual([im.array.tolist() for im in pca.getImageList()],
+                         [images[i].array.tolist() for i in kept])
+        direct = afwImage.ImagePcaD()
+        for i in kept:
+            direct.addImage(images[i], fluxes[i])
+        direct.analyze()
+
+        self.assertFloatsAlmostEqual(np.array(pca.getEigenValues()), np.array(direct.getEigenValues()),
+                                     rtol=1e-10, atol=1e-12*direct.getEigenValues()[0])
+        self.assertEigenImagesAlmostEqual(pca.getEigenImages()[:4], direct.getEigenImages()[:4], rtol=1e-8)
+
+    def testPcaImagesModified(self):
+        """Test that analyze() sees images that were modified in place"""
+        images, fluxes = self.makeImages(10)
+        for reuse in (False, True):
+            pca = afwImage.ImagePcaD()
+            pca.setReuseInnerProducts(reuse)
+            for im, flux in zip(images, fluxes):
+                pca.addImage(afwImage.ImageD(im, True), flux)
+            pca.analyze()
+            before = np.array(pca.getEigenValues())
+
+            modified = pca.getImageList()[2]
+            modified.array[:, :] = 2.0*images[5].array
+            if reuse:
+                pca.imagesModified()
+            pca.analyze()
+
+            direct = afwImage.ImagePcaD()
+            for i, flux in enumerate(fluxes):
+                direct.addImage(modified if i == 2 else images[i], flux)
+            direct.analyze()
+            self.assertFloatsNotEqual(np.array(pca.getEigenValues()), before)
+            self.assertFloatsAlmostEqual(np.array(pca.getEigenValues()), np.array(direct.getEigenValues()),
+                                         rtol=1e-10, atol=1e-12*direct.getEigenValues()[0])
+
+    def testPcaTruncated(self):
+        """Test computing only the leading components"""
+        images, fluxes = self.makeImages(60, nBases=3)
+        full = afwImage.ImagePcaD()
+        truncated = afwImage.ImagePcaD()
+        truncated.setNumComponents(3)
+        self.assertEqual(truncated.getNumComponents(), 3)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            truncated.setNumComponents(-1)
+        for im, flux in zip(images, fluxes):
+            full.addImage(im, flux)
+            truncated.addImage(im, flux)
+        full.analyze()
+        truncated.analyze()
+
+        self.assertEqual(len(truncated.getEigenValues()), 3)
+        self.assertEqual(len(truncated.getEigenImages()), 3)
+        self.assertFloatsAlmostEqual(np.array(truncated.getEigenValues()),
+                                     np.array(full.getEigenValues()[:3]), rtol=1e-8)
+        self.assertEigenImagesAlmostEqual(truncated.getEigenImages(), full.getEigenImages()[:3], rtol=1e-6)
+
+    def testPcaMaskedImage(self):
+        """Test the mask and variance planes of the eigenimages of MaskedImages"""
+        images, fluxes = self.makeImages(5)
+        pca = afwImage.ImagePcaMD()
+        masks = []
+        for i, (im, flux) in enumerate(zip(images, fluxes)):
+            mi = afwImage.MaskedImageD(im.getDimensions())
+            mi.image.array[:, :] = im.array
+            mi.variance.array[:, :] = 0.1*(i + 1)
+            mi.mask[i, i, afwImage.LOCAL] = 0x1 << i
+            masks.append(mi.mask.array.copy())
+            pca.addImage(mi, flux)
+        pca.analyze()
+
+        # The image planes should match those of a PCA of the image planes alone
+        fluxBar = np.mean(fluxes)
+        direct = afwImage.ImagePcaD()
+        for im, flux in zip(images, fluxes):
+            direct.addImage(im, flux)
+        direct.analyze()
+        for eImage, dImage in zip(pca.getEigenImages(), direct.getEigenImages()):
+            self.assertFloatsAlmostEqual(eImage.image.array, dImage.array, rtol=1e-10)
+            np.testing.assert_array_equal(eImage.mask.array, np.bitwise_or.reduce(masks))
+            # Recover each image's weight from the eigenimage, and check the variance
+            data = np.array([im.array.flatten()/flux for im, flux in zip(images, fluxes)]).T
+            weights = np.linalg.lstsq(data, eImage.image.array.flatten()/fluxBar, rcond=None)[0]
+            expected = sum((fluxBar*w/flux)**2*0.1*(i + 1)
+                           for i, (w, flux) in enumerate(zip(weights, fluxes)))
+            self.assertFloatsAlmostEqual(eImage.variance.array, expected, rtol=1e-6)
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
@@ -705,6 +705,51 @@ class KernelTestCase(lsst.utils.tests.TestCase):
             self.fail(
                 "Clone was modified by changing original's spatial parameters")
 
+    def testComputeImageWithParameters(self):
+        """Test computing images for explicit kernel parameters
+
+        Computing an image at a position must not change the kernel parameters.
+        """
+        spFunc = afwMath.PolynomialFunction2D(1)
+        sParams = (
+            (1.0, 0.01, 0.0),
+            (1.0, 0.0, 0.01),
+            (0.5, 0.005, 0.005),
+        )
+        gaussFunc = afwMath.GaussianFunction2D(1.0, 1.0, 0.0)
+        kernel = afwMath.AnalyticKernel(5, 8, gaussFunc, spFunc)
+        kernel.setSpatialParameters(sParams)
+        kernelParams = kernel.getKernelParameters()
+
+        for x, y in ((0, 0), (100, 200), (35.5, 7.25)):
+            params = kernel.computeKernelParameters(x, y)
+            assert_allclose(params, [sp[0] + sp[1]*x + sp[2]*y for sp in sParams])
+            kim = afwImage.ImageD(kernel.getDimensions())
+            kSum = kernel.computeImage(kim, False, x, y)
+            kim2 = afwImage.ImageD(kernel.getDimensions())
+            kSum2 = kernel.computeImage(kim2, False, params)
+            self.assertEqual(kSum, kSum2)
+            self.assertEqual(kim.getXY0(), kim2.getXY0())
+            np.testing.assert_array_equal(kim.getArray(), kim2.getArray())
+            self.assertEqual(kernel.getKernelParameters(), kernelParams)
+
+        kim = afwImage.ImageD(kernel.getDimensions())
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            kernel.computeImage(kim, True, [1.0, 1.0])
+
+        gaussFunc1 = afwMath.GaussianFunction1D(1.0)
+        sepKernel = afwMath.SeparableKernel(5, 8, gaussFunc1, gaussFunc1, spFunc)
+        sepKernel.setSpatialParameters(sParams[:2])
+        invKernel = afwMath.SeparableKernel(5, 8, gaussFunc1, gaussFunc1)
+        x, y = 40, 60
+        invKernel.setKernelParameters(sepKernel.computeKernelParameters(x, y))
+        kim = afwImage.ImageD(sepKernel.getDimensions())
+        sepKernel.computeImage(kim, True, x, y)
+        kim2 = afwImage.ImageD(invKernel.getDimensions())
+        invKernel.computeImage(kim2, True)
+        np.testing.assert_array_equal(kim.getArray(), kim2.getArray())
+        self.assertEqual(sepKernel.getKernelParameters(), [1.0, 1.0])
+
     def testSetCtr(self):
         """Test setCtrCol/Row"""
         kWidth = 3
@@ -0,0 +1,208 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE KernelThreads
+
+#include <memory>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+
+#include "lsst/geom.h"
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/math/FunctionLibrary.h"
+#include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/warpExposure.h"
+
+/*
+ * Tests that kernel images computed from several threads at once, on the same kernel, match those
+ * computed one at a time, with or without a workspace, and that computing them leaves the kernel
+ * unchanged.
+ */
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace {
+
+typedef image::Image<Kernel::Pixel> KernelImage;
+
+std::vector<lsst::geom::Point2D> makePositions() {
+    std::vector<lsst::geom::Point2D> result;
+    for (int i = 0; i < 64; ++i) {
+        result.emplace_back(7.5 * i, 500.0 - 3.25 * i);
+    }
+    return result;
+}
+
+// Compute the images of kernel at each position, from nThreads threads at once.
+std::vector<std::shared_ptr<KernelImage>> computeImages(Kernel const &kernel,
+                                                        std::vector<lsst::geom::Point2D> const &positions,
+                                                        int nThreads) {
+    std::vector<std::shared_ptr<KernelImage>> result(positions.size());
+    lsst::afw::detail::parallelFor(0, positions.size(),
+                                   [&](std::size_t i) {
+                                       auto img = std::make_shared<KernelImage>(kernel.getDimensions());
+                                       kernel.computeImage(*img, true, positions[i].getX(),
+                                                           positions[i].getY());
+                                       result[i] = img;
+                                   },
+                                   nThreads);
+    return result;
+}
+
+bool isEqual(KernelImage const &a, KernelImage const &b) {
+    if (a.getBBox() != b.getBBox()) {
+        return false;
+    }
+    for (int y = 0; y < a.getHeight(); ++y) {
+        for (int x = 0; x < a.getWidth(); ++x) {
+            if (a(x, y) != b(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void checkKernel(Kernel const &kernel) {
+    std::vector<double> const kernelParams = kernel.getKernelParameters();
+    std::vector<lsst::geom::Point2D> const positions = makePositions();
+    std::vector<std::shared_ptr<KernelImage>> const serial = computeImages(kernel, positions, 1);
+    std::vector<std::shared_ptr<KernelImage>> const parallel = computeImages(kernel, positions, 4);
+    std::unique_ptr<Kernel::Workspace> const workspace = kernel.makeWorkspace();
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        BOOST_CHECK(isEqual(*parallel[i], *serial[i]));
+
+        KernelImage img(kernel.getDimensions());
+        std::vector<double> const params =
+                kernel.computeKernelParameters(positions[i].getX(), positions[i].getY());
+        kernel.computeImage(img, true, params);
+        BOOST_CHECK(isEqual(img, *serial[i]));
+
+        KernelImage wsImg(kernel.getDimensions());
+        kernel.computeImage(wsImg, true, positions[i].getX(), positions[i].getY(), *workspace);
+        BOOST_CHECK(isEqual(wsImg, *serial[i]));
+    }
+    BOOST_CHECK(kernel.getKernelParameters() == kernelParams);
+    if (kernel.isSpatiallyVarying()) {
+        BOOST_CHECK(!isEqual(*serial.front(), *serial.back()));
+    }
+}
+
+PolynomialFunction2<double> const spatialFunction(1);
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(Analytic) {
+    GaussianFunction2<Kernel::Pixel> const gaussian(1.0, 1.0, 0.0);
+    AnalyticKernel kernel(9, 11, gaussian, spatialFunction);
+    kernel.setSpatialParameters({{1.5, 0.001, 0.0}, {1.2, 0.0, 0.002}, {0.1, 0.0005, 0.0005}});
+    checkKernel(kernel);
+
+    // The images match those of a spatially invariant kernel with the same parameters
+    lsst::geom::Point2D const position(120.0, 350.0);
+    AnalyticKernel invariant(9, 11, gaussian);
+    invariant.setKernelParameters(kernel.computeKernelParameters(position.getX(), position.getY()));
+    KernelImage expected(invariant.getDimensions());
+    invariant.computeImage(expected, true);
+    KernelImage img(kernel.getDimensions());
+    kernel.computeImage(img, true, position.getX(), position.getY());
+    BOOST_CHECK(isEqual(img, expected));
+}
+
+BOOST_AUTO_TEST_CASE(Separable) {
+    GaussianFunction1<Kernel::Pixel> const gaussian(1.0);
+    SeparableKernel kernel(7, 9, gaussian, gaussian, spatialFunction);
+    kernel.setSpatialParameters({{1.0, 0.002, 0.0}, {1.3, 0.0, 0.001}});
+    checkKernel(kernel);
+
+    // The vectors computed with a workspace match those computed without
+    std::unique_ptr<Kernel::Workspace> const workspace = kernel.makeWorkspace();
+    std::vector<Kernel::Pixel> colList(kernel.getWidth()), rowList(kernel.getHeight());
+    std::vector<Kernel::Pixel> wsColList(kernel.getWidth()), wsRowList(kernel.getHeight());
+    for (auto const &position : makePositions()) {
+        kernel.computeVectors(colList, rowList, false, position.getX(), position.getY());
+        kernel.computeVectors(wsColList, wsRowList, false, position.getX(), position.getY(), *workspace);
+        BOOST_CHECK(wsColList == colList);
+        BOOST_CHECK(wsRowList == rowList);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LinearCombination) {
+    typedef GaussianFunction2<Kernel::Pixel> Gaussian;
+    KernelList basis;
+    basis.push_back(std::make_shared<DeltaFunctionKernel>(5, 5, lsst::geom::Point2I(2, 2)));
+    basis.push_back(std::make_shared<AnalyticKernel>(5, 5, Gaussian(1.0, 1.0, 0.0)));
+    basis.push_back(std::make_shared<AnalyticKernel>(5, 5, Gaussian(2.0, 1.0, 0.5)));
+    LinearCombinationKernel kernel(basis, spatialFunction);
+    kernel.setSpatialParameters({{1.0, 0.0, 0.0}, {0.1, 0.001, 0.0}, {0.2, 0.0, 0.001}});
+    checkKernel(kernel);
+}
+
+BOOST_AUTO_TEST_CASE(Invariant) {
+    checkKernel(DeltaFunctionKernel(5, 7, lsst::geom::Point2I(1, 3)));
+    checkKernel(AnalyticKernel(9, 9, GaussianFunction2<Kernel::Pixel>(1.5, 1.0, 0.3)));
+    KernelImage img(lsst::geom::Extent2I(6, 4));
+    for (int y = 0; y < img.getHeight(); ++y) {
+        for (int x = 0; x < img.getWidth(); ++x) {
+            img(x, y) = 1.0 + x + 2.0 * y;
+        }
+    }
+    checkKernel(FixedKernel(img));
+}
+
+BOOST_AUTO_TEST_CASE(WrongParameters) {
+    AnalyticKernel kernel(9, 11, GaussianFunction2<Kernel::Pixel>(1.0, 1.0, 0.0), spatialFunction);
+    KernelImage img(kernel.getDimensions());
+    BOOST_CHECK_THROW(kernel.computeImage(img, true, std::vector<double>{1.0, 1.0}),
+                      lsst::pex::exceptions::InvalidParameterError);
+}
+
+BOOST_AUTO_TEST_CASE(WrongWorkspace) {
+    AnalyticKernel kernel(9, 11, GaussianFunction2<Kernel::Pixel>(1.0, 1.0, 0.0), spatialFunction);
+    AnalyticKernel other(9, 11, GaussianFunction2<Kernel::Pixel>(1.0, 1.0, 0.0), spatialFunction);
+    std::unique_ptr<Kernel::Workspace> const workspace = other.makeWorkspace();
+    KernelImage img(kernel.getDimensions());
+    BOOST_CHECK_THROW(kernel.computeImage(img, true, 1.0, 2.0, *workspace),
+                      lsst::pex::exceptions::InvalidParameterError);
+}
+
+BOOST_AUTO_TEST_CASE(WarpingParameters) {
+    // Warping kernels check their parameters however they are given
+    LanczosWarpingKernel kernel(3);
+    std::vector<Kernel::Pixel> colList(kernel.getWidth()), rowList(kernel.getHeight());
+    kernel.computeVectors(colList, rowList, true, std::vector<double>{0.25, 0.75});
+    BOOST_CHECK_THROW(kernel.computeVectors(colList, rowList, true, std::vector<double>{0.25, 1.5}),
+                      lsst::pex::exceptions::InvalidParameterError);
+    KernelImage img(kernel.getDimensions());
+    BOOST_CHECK_THROW(kernel.computeImage(img, true, std::vector<double>{-0.5, 0.5}),
+                      lsst::pex::exceptions::InvalidParameterError);
+    BOOST_CHECK_THROW(kernel.setKernelParameters(std::vector<double>{-0.5, 0.5}),
+                      lsst::pex::exceptions::InvalidParameterError);
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,168 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE MaskedImageArithmetic
+
+#include <cmath>
+#include <functional>
+
+#include "boost/test/unit_test.hpp"
+
+#include "lsst/geom.h"
+#include "lsst/afw/detail/Parallel.h"
+#include "lsst/afw/image/MaskedImage.h"
+
+#include "ScopedNumThreads.h"
+
+/*
+ * Tests that the fused MaskedImage arithmetic kernels agree with a pixel-by-pixel evaluation, on
+ * subimages (whose rows are not contiguous) large enough to be split between threads.
+ */
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+using MaskedImageF = MaskedImage<float>;
+using Pixel = MaskedImageF::SinglePixel;
+using Operation = std::function<void(MaskedImageF &, MaskedImageF const &)>;
+using Expectation = std::function<Pixel(Pixel const &, Pixel const &)>;
+
+// The subimage is large enough to be split into several blocks of rows.
+lsst::geom::Box2I const PARENT_BBOX(lsst::geom::Point2I(-5, 10), lsst::geom::Extent2I(620, 430));
+lsst::geom::Box2I const SUB_BBOX(lsst::geom::Point2I(3, 17), lsst::geom::Extent2I(601, 400));
+
+bool isClose(double actual, double expected) {
+    return std::abs(actual - expected) <= 1e-5 * (1.0 + std::abs(expected));
+}
+
+MaskedImageF makeImage(int seed) {
+    MaskedImageF result(PARENT_BBOX);
+    for (int y = 0; y < result.getHeight(); ++y) {
+        for (int x = 0; x < result.getWidth(); ++x) {
+            float const value = 1.0 + std::fmod(0.37 * (x + seed) + 0.61 * (y * seed + 1), 7.0);
+            (*result.getImage())(x, y) = value;
+            (*result.getMask())(x, y) = (x + y + seed) % 5 == 0 ? 1 << (seed % 3) : 0;
+            (*result.getVariance())(x, y) = 0.5 * value + seed;
+        }
+    }
+    return result;
+}
+
+void checkOperation(Operation const &operation, Expectation const &expectation) {
+    for (int nThreads : {1, 4}) {
+        lsst::afw::detail::ScopedNumThreads const numThreads(nThreads);
+        MaskedImageF lhsParent = makeImage(1);
+        MaskedImageF const rhsParent = makeImage(2);
+        MaskedImageF const original(lhsParent, true);
+        MaskedImageF lhs(lhsParent, SUB_BBOX);
+        MaskedImageF const rhs(rhsParent, SUB_BBOX);
+        operation(lhs, rhs);
+        int nFailures = 0;
+        for (int y = 0; y < lhsParent.getHeight(); ++y) {
+            for (int x = 0; x < lhsParent.getWidth(); ++x) {
+                lsst::geom::Point2I const index(x, y);
+                Pixel const before(original.getImage()->get(index, LOCAL),
+                                   original.getMask()->get(index, LOCAL),
+                                   original.getVariance()->get(index, LOCAL));
+                Pixel const other(rhsParent.getImage()->get(index, LOCAL),
+                                  rhsParent.getMask()->get(index, LOCAL),
+                                  rhsParent.getVariance()->get(index, LOCAL));
+                bool const inside = SUB_BBOX.contains(index + lsst::geom::Extent2I(PARENT_BBOX.getMin()));
+                Pixel const expected = inside ? expectation(before, other) : before;
+                if (!isClose(lhsParent.getImage()->get(index, LOCAL), expected.image()) ||
+                    lhsParent.getMask()->get(index, LOCAL) != expected.mask() ||
+                    !isClose(lhsParent.getVariance()->get(index, LOCAL), expected.variance())) {
+                    ++nFailures;
+                }
+            }
+        }
+        BOOST_CHECK_EQUAL(nFailures, 0);
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(FusedAddition) {
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs += rhs; },
+                   [](Pixel const &l, Pixel const &r) {
+                       return Pixel(l.image() + r.image(), l.mask() | r.mask(),
+                                    l.variance() + r.variance());
+                   });
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs.scaledPlus(2.5, rhs); },
+                   [](Pixel const &l, Pixel const &r) {
+                       return Pixel(l.image() + 2.5 * r.image(), l.mask() | r.mask(),
+                                    l.variance() + 6.25 * r.variance());
+                   });
+}
+
+BOOST_AUTO_TEST_CASE(FusedSubtraction) {
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs -= rhs; },
+                   [](Pixel const &l, Pixel const &r) {
+                       return Pixel(l.image() - r.image(), l.mask() | r.mask(),
+                                    l.variance() + r.variance());
+                   });
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs.scaledMinus(2.5, rhs); },
+                   [](Pixel const &l, Pixel const &r) {
+                       return Pixel(l.image() - 2.5 * r.image(), l.mask() | r.mask(),
+                                    l.variance() + 6.25 * r.variance());
+                   });
+}
+
+BOOST_AUTO_TEST_CASE(FusedMultiplication) {
+    auto const product = [](double c) {
+        return [c](Pixel const &l, Pixel const &r) {
+            double const li = l.image(), ri = r.image();
+            return Pixel(c * li * ri, l.mask() | r.mask(),
+                         c * c * (li * li * r.variance() + ri * ri * l.variance()));
+        };
+    };
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs *= rhs; }, product(1.0));
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs.scaledMultiplies(0.5, rhs); },
+                   product(0.5));
+}
+
+BOOST_AUTO_TEST_CASE(FusedDivision) {
+    auto const quotient = [](double c) {
+        return [c](Pixel const &l, Pixel const &r) {
+            double const li = l.image(), ri = r.image();
+            return Pixel(li / (c * ri), l.mask() | r.mask(),
+                         (li * li * r.variance() + ri * ri * l.variance()) / (c * c * std::pow(ri, 4)));
+        };
+    };
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs /= rhs; }, quotient(1.0));
+    checkOperation([](MaskedImageF &lhs, MaskedImageF const &rhs) { lhs.scaledDivides(0.5, rhs); },
+                   quotient(0.5));
+}
+
+BOOST_AUTO_TEST_CASE(FusedSizeMismatch) {
+    MaskedImageF lhs(lsst::geom::Extent2I(10, 10));
+    MaskedImageF const rhs(lsst::geom::Extent2I(10, 11));
+    BOOST_CHECK_THROW(lhs += rhs, pex::exceptions::LengthError);
+    BOOST_CHECK_THROW(lhs.scaledDivides(2.0, rhs), pex::exceptions::LengthError);
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -35,6 +35,7 @@ import unittest
 import numpy as np
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.image as afwImage
 import lsst.afw.math as afwMath
@@ -234,6 +235,35 @@ class TransformImageTestCase(unittest.TestCase):
         # for a while, swig couldn't handle the resulting std::shared_ptr<Mask>
         afwMath.flipImage(mask, True, False)
 
+    def testTiledRotateAndFlip(self):
+        """Test rotations and flips of images spanning several tiles against numpy"""
+        rng = np.random.RandomState(6)
+        image = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(3, -4), lsst.geom.Extent2I(97, 70)))
+        image.image.array[:, :] = rng.normal(size=image.image.array.shape)
+        image.mask.array[:, :] = rng.randint(0, 16, size=image.mask.array.shape)
+        image.variance.array[:, :] = rng.uniform(size=image.variance.array.shape)
+        planes = [image.image, image.mask, image.variance]
+        for nQuarter in range(-1, 5):
+            outImage = afwMath.rotateImageBy90(image, nQuarter)
+            for inPlane, outPlane in zip(planes, [outImage.image, outImage.mask, outImage.variance]):
+                # numpy arrays are indexed [y, x], so a counter-clockwise rotation in afw's (x, y) is
+                # a clockwise one in numpy's.
+                np.testing.assert_array_equal(outPlane.array, np.rot90(inPlane.array, -nQuarter))
+        for flipLR in (False, True):
+            for flipTB in (False, True):
+                expected = [plane.array for plane in planes]
+                if flipLR:
+                    expected = [array[:, ::-1] for array in expected]
+                if flipTB:
+                    expected = [array[::-1, :] for array in expected]
+                outImage = afwMath.flipImage(image, flipLR, flipTB)
+                self.assertEqual(outImage.getBBox(), image.getBBox())
+                inPlace = image.clone()
+                afwMath.flipImageInPlace(inPlace, flipLR, flipTB)
+                for result in (outImage, inPlace):
+                    for array, outPlane in zip(expected, [result.image, result.mask, result.variance]):
+                        np.testing.assert_array_equal(outPlane.array, array)
+
 
 class BinImageTestCase(unittest.TestCase):
     """A test case for binning images"""
@@ -288,6 +318,79 @@ class BinImageTestCase(unittest.TestCase):
             ds9.mtv(inImage, frame=2, title="unbinned")
             ds9.mtv(outImage, frame=3, title="binned %dx%d" % (binX, binY))
 
+    def testBinStatistics(self):
+        """Test binning with each statistic, against numpy"""
+        rng = np.random.RandomState(3)
+        inImage = afwImage.ImageF(203, 131)
+        inImage.array[:, :] = rng.normal(size=inImage.array.shape)
+        binX, binY = 3, 5
+        ny, nx = inImage.getHeight()//binY, inImage.getWidth()//binX
+        blocks = inImage.array[:ny*binY, :nx*binX].reshape(ny, binY, nx, binX).astype(np.float64)
+        for flag, func in [(afwMath.MEAN, np.mean), (afwMath.SUM, np.sum), (afwMath.MEDIAN, np.median),
+                           (afwMath.MIN, np.min), (afwMath.MAX, np.max)]:
+            outImage = afwMath.binImage(inImage, binX, binY, flag)
+            np.testing.assert_allclose(outImage.array, func(blocks, axis=(1, 3)), rtol=1e-5, atol=1e-6)
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.binImage(inImage, binX, binY, afwMath.STDEV)
+
+    def testBinMaskedImage(self):
+        """Test that binning MaskedImages ignores masked pixels and propagates variance"""
+        rng = np.random.RandomState(4)
+        inImage = afwImage.MaskedImageF(64, 48)
+        inImage.image.array[:, :] = rng.normal(size=inImage.image.array.shape)
+        inImage.variance.array[:, :] = rng.uniform(0.5, 2.0, size=inImage.variance.array.shape)
+        bad = inImage.mask.getPlaneBitMask("BAD")
+        inImage.mask.array[:, :] = np.where(rng.uniform(size=inImage.mask.array.shape) < 0.2, bad, 0)
+        inImage.mask.array[:4, :4] = bad  # a block with no good pixels
+        binX, binY = 4, 4
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setAndMask(bad)
+
+        def blocks(array):
+            return array.reshape(12, binY, 16, binX).swapaxes(1, 2).reshape(12, 16, binX*binY)
+
+        good = blocks(inImage.mask.array) == 0
+        values = np.where(good, blocks(inImage.image.array), 0.0)
+        variances = np.where(good, blocks(inImage.variance.array), 0.0)
+        n = good.sum(axis=2)
+        with np.errstate(invalid="ignore", divide="ignore"):
+            expectedMean = values.sum(axis=2)/n
+            expectedMeanVariance = variances.sum(axis=2)/n**2
+
+        outImage = afwMath.binImage(inImage, binX, binY, afwMath.MEAN, sctrl)
+        np.testing.assert_allclose(outImage.image.array, expectedMean, rtol=1e-5, atol=1e-6)
+        np.testing.assert_allclose(outImage.variance.array, expectedMeanVariance, rtol=1e-5)
+        self.assertTrue(np.isnan(outImage.image.array[0, 0]))
+        noData = outImage.mask.getPlaneBitMask("NO_DATA")
+        self.assertEqual(outImage.mask.array[0, 0], bad | noData)
+        np.testing.assert_array_equal(outImage.mask.array[n > 0], np.where(n < 16, bad, 0)[n > 0])
+
+        outImage = afwMath.binImage(inImage, binX, binY, afwMath.SUM, sctrl)
+        np.testing.assert_allclose(outImage.image.array[n > 0], values.sum(axis=2)[n > 0], rtol=1e-5,
+                                   atol=1e-6)
+        np.testing.assert_allclose(outImage.variance.array[n > 0], variances.sum(axis=2)[n > 0], rtol=1e-5)
+
+        outImage = afwMath.binImage(inImage, binX, binY, afwMath.MAX, sctrl)
+        maxValues = np.where(good, blocks(inImage.image.array), -np.inf).max(axis=2)
+        np.testing.assert_allclose(outImage.image.array[n > 0], maxValues[n > 0], rtol=1e-6)
+
+        # Without an and-mask every pixel is used, as by the default overload.
+        outImage = afwMath.binImage(inImage, binX, binY, afwMath.MEAN, afwMath.StatisticsControl())
+        defaultImage = afwMath.binImage(inImage, binX, binY)
+        np.testing.assert_allclose(outImage.image.array, defaultImage.image.array, rtol=1e-6)
+        np.testing.assert_allclose(outImage.variance.array, defaultImage.variance.array, rtol=1e-6)
+
+    def testBinPartial(self):
+        """Test binning with partial blocks at the edges"""
+        inImage = afwImage.ImageD(10, 7)
+        inImage.array[:, :] = np.arange(70).reshape(7, 10)
+        outImage = afwMath.binImage(inImage, 4, 3, afwMath.MEAN, afwMath.StatisticsControl(), True)
+        self.assertEqual(outImage.getDimensions(), lsst.geom.Extent2I(3, 3))
+        self.assertAlmostEqual(outImage.array[2, 2], np.mean(inImage.array[6:, 8:]))
+        self.assertAlmostEqual(outImage.array[0, 2], np.mean(inImage.array[:3, 8:]))
+        self.assertAlmostEqual(outImage.array[1, 1], np.mean(inImage.array[3:6, 4:8]))
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
@@ -0,0 +1,104 @@
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions
+import lsst.geom
+import lsst.afw.image
+import lsst.afw.detection
+
+
+class OversampledPsfTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.sigma = 2.0
+        self.wrapped = lsst.afw.detection.GaussianPsf(25, 25, self.sigma)
+        self.bbox = lsst.geom.Box2I(lsst.geom.Point2I(-10, 20), lsst.geom.Extent2I(500, 300))
+        self.psf = lsst.afw.detection.OversampledPsf(self.wrapped, self.bbox, cellSize=128, oversampling=4)
+
+    def tearDown(self):
+        del self.psf
+        del self.wrapped
+
+    def makeGaussianImage(self, bbox, position):
+        y, x = np.mgrid[bbox.getBeginY():bbox.getEndY(), bbox.getBeginX():bbox.getEndX()]
+        array = np.exp(-0.5*((x - position.getX())**2 + (y - position.getY())**2)/self.sigma**2)
+        return array/array.sum()
+
+    def testAccessors(self):
+        self.assertEqual(self.psf.getBBox(), self.bbox)
+        self.assertEqual(self.psf.getCellSize(), 128)
+        self.assertEqual(self.psf.getOversampling(), 4)
+        self.assertEqual(self.psf.computeBBox(), self.wrapped.computeBBox())
+        self.assertFloatsEqual(self.psf.computeKernelImage().getArray(),
+                               self.wrapped.computeKernelImage().getArray())
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            lsst.afw.detection.OversampledPsf(self.wrapped, self.bbox, cellSize=0)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            lsst.afw.detection.OversampledPsf(self.wrapped, self.bbox, oversampling=0)
+
+    def testPhases(self):
+        """Images at the precomputed sub-pixel phases match the wrapped Psf exactly."""
+        for x, y in ((35.25, 50.0), (300.5, 151.75), (-40.0, 400.25)):
+            position = lsst.geom.Point2D(x, y)
+            image = self.psf.computeImage(position)
+            check = self.wrapped.computeImage(position)
+            self.assertEqual(image.getBBox(), check.getBBox())
+            # OversampledPsf renormalizes its images; the wrapped Psf's shifted images need not be.
+            self.assertFloatsAlmostEqual(image.getArray(), check.getArray()/check.getArray().sum(),
+                                         atol=1E-12)
+
+    def testInterpolation(self):
+        rng = np.random.RandomState(5)
+        for x, y in zip(rng.uniform(-20, 500, size=10), rng.uniform(10, 330, size=10)):
+            position = lsst.geom.Point2D(x, y)
+            image = self.psf.computeImage(position)
+            self.assertEqual(image.getBBox(), self.wrapped.computeImage(position).getBBox())
+            self.assertFloatsAlmostEqual(image.getArray().sum(), 1.0, atol=1E-12)
+            check = self.makeGaussianImage(image.getBBox(), position)
+            self.assertFloatsAlmostEqual(image.getArray(), check, atol=1E-4)
+
+    def testPersistence(self):
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            self.psf.writeFits(filename)
+            psf = lsst.afw.detection.OversampledPsf.readFits(filename)
+        self.assertEqual(psf.getBBox(), self.bbox)
+        self.assertEqual(psf.getCellSize(), self.psf.getCellSize())
+        self.assertEqual(psf.getOversampling(), self.psf.getOversampling())
+        position = lsst.geom.Point2D(101.3, 54.9)
+        self.assertFloatsEqual(psf.computeImage(position).getArray(),
+                               self.psf.computeImage(position).getArray())
+
+
+class MemoryTester(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
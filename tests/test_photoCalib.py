@@ -289,6 +289,37 @@ class PhotoCalibTestCase(lsst.utils.tests.TestCase):
         expectMag = np.array([[-2.5*np.log10(expect), errMag], [22.5, errMagNano]])
         self._testSourceCatalog(photoCalib, catalog, expectMaggies, expectMag)
 
+    def testLargeCatalog(self):
+        """Test that the batched catalog conversions match per-record
+        conversions, for contiguous and non-contiguous catalogs spanning
+        several evaluation chunks.
+        """
+        photoCalib = lsst.afw.image.PhotoCalib(self.linearXCalibration, self.calibrationErr)
+        catalog = lsst.afw.table.SourceCatalog(self.table)
+        catalog.reserve(10000)
+        for x, y, flux in zip(np.random.uniform(-100, 100, 10000), np.random.uniform(-100, 100, 10000),
+                              np.random.uniform(100, 1000, 10000)):
+            record = catalog.addNew()
+            record.set('centroid_x', x)
+            record.set('centroid_y', y)
+            record.set(self.instFluxKey, flux)
+            record.set(self.instFluxErrKey, self.instFluxErr)
+        for cat in (catalog, catalog[::3]):
+            self.assertEqual(cat.isContiguous(), cat is catalog)
+            expectMaggies = np.array([[m.value, m.err] for m in
+                                      (photoCalib.instFluxToMaggies(r, self.instFluxKeyName) for r in cat)])
+            expectMag = np.array([[m.value, m.err] for m in
+                                  (photoCalib.instFluxToMagnitude(r, self.instFluxKeyName) for r in cat)])
+            self.assertFloatsAlmostEqual(photoCalib.instFluxToMaggies(cat, self.instFluxKeyName),
+                                         expectMaggies, rtol=1E-14)
+            self.assertFloatsAlmostEqual(photoCalib.instFluxToMagnitude(cat, self.instFluxKeyName),
+                                         expectMag, rtol=1E-14)
+            photoCalib.instFluxToMagnitude(cat, self.instFluxKeyName, self.instFluxKeyName)
+            self.assertFloatsAlmostEqual(np.array([r.get(self.magnitudeKey) for r in cat]), expectMag[:, 0],
+                                         rtol=1E-14)
+            self.assertFloatsAlmostEqual(np.array([r.get(self.magnitudeErrKey) for r in cat]),
+                                         expectMag[:, 1], rtol=1E-14)
+
     def testComputeScaledCalibration(self):
         photoCalib = lsst.afw.image.PhotoCalib(self.calibration, bbox=self.bbox)
         scaledCalib = lsst.afw.image.PhotoCalib(photoCalib.computeScaledCalibration())
@@ -266,6 +266,23 @@ class PolygonTest(lsst.utils.tests.TestCase):
             self.assertAlmostEqual(
                 image.getArray().sum()/poly.calculateArea(), 1.0, 6)
 
+    def testImageExact(self):
+        """Test that Polygon.createImage matches per-pixel intersections"""
+        polygons = [self.polygon(7, 4.3, 5.2, 4.9), self.polygon(200, 6.1, 3.3, 5.7),
+                    afwGeom.Polygon([lsst.geom.Point2D(x, y) for x, y in
+                                     ((-2.5, 1.5), (9.3, -0.2), (4.0, 4.0), (10.7, 11.2), (0.2, 6.5))])]
+        box = lsst.geom.Box2I(lsst.geom.Point2I(0, 1), lsst.geom.Extent2I(9, 8))
+        for poly in polygons:
+            array = poly.createImage(box).getArray()
+            spans = poly.createSpanSet(box)
+            for y in range(box.getMinY(), box.getMaxY() + 1):
+                for x in range(box.getMinX(), box.getMaxX() + 1):
+                    pixel = lsst.geom.Box2D(lsst.geom.Point2D(x - 0.5, y - 0.5),
+                                            lsst.geom.Point2D(x + 0.5, y + 0.5))
+                    expected = sum(p.calculateArea() for p in poly.intersection(pixel))
+                    self.assertAlmostEqual(array[y - box.getMinY(), x - box.getMinX()], expected, 6)
+                    self.assertEqual(spans.contains(lsst.geom.Point2I(x, y)), expected > 1.0 - 1e-6)
+
     def testTransform(self):
         """Test constructor for Polygon involving transforms"""
         box = lsst.geom.Box2D(lsst.geom.Point2D(0.0, 0.0),
@@ -0,0 +1,105 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PsfCacheThreads
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+
+#include "lsst/geom.h"
+#include "lsst/afw/detection/GaussianPsf.h"
+
+/*
+ * Stress tests for computing images of one Psf from many threads at once.
+ *
+ * The cache is kept much smaller than the number of positions, so threads keep adding and evicting
+ * entries in the same shards while others read them.
+ */
+namespace lsst {
+namespace afw {
+namespace detection {
+
+namespace {
+
+int const N_THREADS = 8;
+int const N_POSITIONS = 200;
+
+bool imagesEqual(Psf::Image const &a, Psf::Image const &b) {
+    if (a.getBBox() != b.getBBox()) {
+        return false;
+    }
+    for (int y = 0; y < a.getHeight(); ++y) {
+        for (int x = 0; x < a.getWidth(); ++x) {
+            if (a(x, y) != b(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(PsfCacheConcurrentEvaluation) {
+    auto const reference = std::make_shared<GaussianPsf>(15, 15, 2.0);
+    std::vector<lsst::geom::Point2D> positions;
+    std::vector<std::shared_ptr<Psf::Image>> expected;
+    for (int i = 0; i < N_POSITIONS; ++i) {
+        positions.emplace_back(0.37 * i, 1.5 * (i % 13) - 0.25);
+        expected.push_back(reference->computeImage(positions.back()));
+    }
+
+    // A small cache, so threads are constantly evicting each other's images.
+    auto const psf = std::make_shared<GaussianPsf>(15, 15, 2.0);
+    psf->setCacheCapacity(20);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < N_THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < N_POSITIONS; ++i) {
+                int const k = (i * (t + 1)) % N_POSITIONS;
+                auto image = psf->computeImage(positions[k], image::Color(), Psf::INTERNAL);
+                if (!imagesEqual(*image, *expected[k])) {
+                    ++failures;
+                }
+            }
+            auto images = psf->computeImages(positions);
+            for (int k = 0; k < N_POSITIONS; ++k) {
+                if (!imagesEqual(*images[k], *expected[k])) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(failures.load(), 0);
+}
+
+}  // namespace detection
+}  // namespace afw
+}  // namespace lsst
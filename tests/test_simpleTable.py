@@ -426,6 +426,40 @@ class SimpleTableTestCase(lsst.utils.tests.TestCase):
         cat8.extend(list(cat7), True)
         cat8.extend(list(cat7), deep=True)
 
+    def testMakeContiguous(self):
+        schema = lsst.afw.table.Schema()
+        k1 = schema.addField("f1", type=np.int32, doc="int")
+        kArray = schema.addField("fArray", type="ArrayI", size=0, doc="variable-length array")
+        kString = schema.addField("fString", type="String", size=0, doc="variable-length string")
+        catalog = lsst.afw.table.BaseCatalog(schema)
+        # Geometric growth is opt-in
+        self.assertEqual(catalog.table.getBlockGrowthFactor(), 1.0)
+        catalog.table.setBlockSize(7)
+        catalog.table.setBlockGrowthFactor(1.5)
+        self.assertEqual(catalog.table.getBlockSize(), 7)
+        self.assertEqual(catalog.table.getBlockGrowthFactor(), 1.5)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            catalog.table.setBlockGrowthFactor(0.5)
+        for i in range(100):
+            record = catalog.addNew()
+            record.set(k1, i)
+            record.set(kArray, np.arange(i % 5, dtype=np.int32))
+            record.set(kString, "record %d" % i)
+        self.assertGreater(catalog.table.getBlockSize(), 7)
+        self.assertFalse(catalog.isContiguous())
+        with self.assertRaises(lsst.pex.exceptions.RuntimeError):
+            catalog.getColumnView()
+        first = catalog[0]
+        catalog.makeContiguous()
+        self.assertTrue(catalog.isContiguous())
+        self.assertFloatsEqual(catalog.getColumnView()[k1], np.arange(100))
+        for i, record in enumerate(catalog):
+            self.assertEqual(list(record.get(kArray)), list(range(i % 5)))
+            self.assertEqual(record.get(kString), "record %d" % i)
+        # Records keep their identity
+        first.set(k1, -1)
+        self.assertEqual(catalog[0].get(k1), -1)
+
     def testTicket2308(self):
         inputSchema = lsst.afw.table.SourceTable.makeMinimalSchema()
         mapper1 = lsst.afw.table.SchemaMapper(inputSchema)
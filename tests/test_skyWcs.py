@@ -7,6 +7,7 @@ import astropy.io.fits
 import astropy.coordinates
 import astropy.wcs
 import astshim as ast
+import numpy as np
 from numpy.testing import assert_allclose
 
 import lsst.utils.tests
@@ -379,6 +380,32 @@ class SimpleSkyWcsTestCase(SkyWcsBaseTestCase):
             self.assertFalse(frameDict.hasDomain(domain))
             self.assertTrue(skyWcs.getFrameDict().hasDomain(domain))
 
+    def testArrayMethods(self):
+        """Test pixelToSkyArray and skyToPixelArray against the point methods,
+        with enough points for several chunks and threads
+        """
+        cdMatrix = makeCdMatrix(scale=self.scale)
+        # crval is just below RA=360 so some outputs must be wrapped
+        wcs = makeSkyWcs(crpix=self.crpix, crval=self.crvalList[2], cdMatrix=cdMatrix)
+        rng = np.random.RandomState(5)
+        x = rng.uniform(self.bbox.getMinX(), self.bbox.getMaxX(), size=10000)
+        y = rng.uniform(self.bbox.getMinY(), self.bbox.getMaxY(), size=10000)
+        pixels = [lsst.geom.Point2D(xi, yi) for xi, yi in zip(x, y)]
+        skyList = wcs.pixelToSky(pixels)
+        for nThreads in (1, 3):
+            ra, dec = wcs.pixelToSkyArray(x, y, nThreads=nThreads)
+            self.assertTrue(np.all(ra >= 0.0) and np.all(ra < 2*np.pi))
+            assert_allclose(ra, [sky.getRa().asRadians() for sky in skyList], rtol=0, atol=1e-12)
+            assert_allclose(dec, [sky.getDec().asRadians() for sky in skyList], rtol=0, atol=1e-12)
+            xOut, yOut = wcs.skyToPixelArray(ra, dec, nThreads=nThreads)
+            assert_allclose(xOut, x, rtol=0, atol=1e-7)
+            assert_allclose(yOut, y, rtol=0, atol=1e-7)
+
+        ra, dec = wcs.pixelToSkyArray(x[:0], y[:0])
+        self.assertEqual(len(ra), 0)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            wcs.pixelToSkyArray(x, y[:-1])
+
     def testMakeModifiedWcsNoActualPixels(self):
         """Test makeModifiedWcs on a SkyWcs that has no ACTUAL_PIXELS frame
         """
@@ -118,6 +118,39 @@ class SpanSetTestCase(lsst.utils.tests.TestCase):
         self.assertTrue(spanSetLarge.contains(spanSetSmall))
         self.assertFalse(spanSetSmall.contains(lsst.geom.Point2I(100, 100)))
 
+    def testContainsPoint(self):
+        # Compare the indexed lookup against the Spans themselves, for dense and sparse SpanSets and
+        # for Spans that were not normalized.
+        circle = afwGeom.SpanSet.fromShape(6, afwGeom.Stencil.CIRCLE)
+        sparse = circle.union(circle.shiftedBy(3, 200)).union(afwGeom.SpanSet.fromShape(1).shiftedBy(-5, 90))
+        unsorted = afwGeom.SpanSet([afwGeom.Span(2, 0, 10), afwGeom.Span(1, 4, 6), afwGeom.Span(2, 3, 4)],
+                                   False)
+        for spanSet in (circle, sparse, unsorted):
+            bbox = spanSet.getBBox()
+            bbox.grow(2)
+            for y in range(bbox.getMinY(), bbox.getMaxY() + 1):
+                for x in range(bbox.getMinX(), bbox.getMaxX() + 1):
+                    expected = any(span.contains(x, y) for span in spanSet)
+                    self.assertEqual(spanSet.contains(lsst.geom.Point2I(x, y)), expected)
+
+    def testTransformedByMatchesBruteForce(self):
+        spanSet = afwGeom.SpanSet.fromShape(8, afwGeom.Stencil.CIRCLE).shiftedBy(3, -2)
+        spanSet = spanSet.union(afwGeom.SpanSet.fromShape(2).shiftedBy(20, 5))
+        affine = lsst.geom.AffineTransform(lsst.geom.LinearTransform.makeRotation(30*lsst.geom.degrees)
+                                           * lsst.geom.LinearTransform.makeScaling(1.7),
+                                           lsst.geom.Extent2D(4.25, -3.5))
+        transformed = spanSet.transformedBy(affine)
+        inverse = affine.inverted()
+        bbox = transformed.getBBox()
+        bbox.grow(3)
+        for y in range(bbox.getMinY(), bbox.getMaxY() + 1):
+            for x in range(bbox.getMinX(), bbox.getMaxX() + 1):
+                source = inverse(lsst.geom.Point2D(x, y))
+                sourcePoint = lsst.geom.Point2I(int(np.floor(0.5 + source.getX())),
+                                                int(np.floor(0.5 + source.getY())))
+                self.assertEqual(transformed.contains(lsst.geom.Point2I(x, y)),
+                                 spanSet.contains(sourcePoint))
+
     def testComputeCentroid(self):
         spanSetShape = afwGeom.SpanSet.fromShape(4, afwGeom.Stencil.CIRCLE).shiftedBy(2, 2)
         center = spanSetShape.computeCentroid()
@@ -146,6 +146,22 @@ class UpdateTestCase(lsst.utils.tests.TestCase):
         # check that centroids and coords match
         self.checkCatalogs()
 
+    def testNonContiguousCatalogs(self):
+        """Check updating catalogs whose records are not contiguous in memory,
+        which cannot be updated through column views"""
+        self.setCatalogs(maxPix=1500, numPoints=8)
+        sourceCat = self.sourceCat[::2]
+        refCat = self.refCat[::2]
+        self.assertFalse(sourceCat.isContiguous())
+        self.assertFalse(refCat.isContiguous())
+
+        afwTable.updateSourceCoords(self.wcs, sourceCat)
+        afwTable.updateRefCentroids(self.wcs, refCat)
+
+        self.sourceCat = sourceCat
+        self.refCat = refCat
+        self.checkCatalogs()
+
     def checkCatalogs(self, maxPixDiff=1e-5, maxSkyDiff=0.001*lsst.geom.arcseconds):
         """Check that the source and reference object catalogs have equal centroids and coords"""
         self.assertEqual(len(self.sourceCat), len(self.refCat))
@@ -0,0 +1,149 @@
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions
+import lsst.geom
+from lsst.afw.geom import (TransformApproximation, SkyWcsApproximation, makeRadialTransform,
+                           makeCdMatrix, makeSkyWcs, makeModifiedWcs)
+
+
+class TransformApproximationTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.random = np.random.RandomState(5)
+        self.bbox = lsst.geom.Box2D(lsst.geom.Point2D(-1000, -1000), lsst.geom.Extent2D(2000, 2000))
+        self.transform = makeRadialTransform([0.0, 1.0, 0.0, 1E-9])
+        self.points = [lsst.geom.Point2D(x, y) for x, y in
+                       zip(self.random.uniform(self.bbox.getMinX(), self.bbox.getMaxX(), 200),
+                           self.random.uniform(self.bbox.getMinY(), self.bbox.getMaxY(), 200))]
+
+    def checkTransform(self, approx, tolerance):
+        expected = self.transform.applyForward(self.points)
+        for a, b in zip(approx.applyForward(self.points), expected):
+            self.assertLess(a.distanceSquared(b), tolerance**2)
+        for p in self.points[:10]:
+            self.assertLess(approx.applyForward(p).distanceSquared(self.transform.applyForward(p)),
+                            tolerance**2)
+        for a, b in zip(approx.applyInverse(expected), self.points):
+            self.assertLess(a.distanceSquared(b), tolerance**2)
+
+    def testTransform(self):
+        tolerance = 1E-3
+        approx = TransformApproximation(self.transform, self.bbox, tolerance)
+        self.assertTrue(approx.hasInverse())
+        self.assertEqual(approx.getBBox(), self.bbox)
+        self.assertEqual(approx.getOrder(), 5)
+        self.assertLess(approx.getMaxForwardError(), tolerance)
+        self.assertLess(approx.getMaxInverseError(), tolerance)
+        self.checkTransform(approx, tolerance)
+
+    def testRefinement(self):
+        coarse = TransformApproximation(self.transform, self.bbox, 1E-2, order=2)
+        fine = TransformApproximation(self.transform, self.bbox, 1E-6, order=2)
+        self.assertGreater(fine.getForwardPatchCount(), coarse.getForwardPatchCount())
+        self.assertLess(fine.getMaxForwardError(), 1E-6)
+
+    def testInvalid(self):
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            TransformApproximation(self.transform, self.bbox, 0.0)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            TransformApproximation(self.transform, lsst.geom.Box2D(), 1E-3)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            TransformApproximation(self.transform, self.bbox, 1E-3, order=-1)
+
+    def testPersistence(self):
+        approx = TransformApproximation(self.transform, self.bbox, 1E-3)
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            approx.writeFits(filename)
+            copy = TransformApproximation.readFits(filename)
+        self.assertEqual(copy.getForwardPatchCount(), approx.getForwardPatchCount())
+        self.assertEqual(copy.getMaxForwardError(), approx.getMaxForwardError())
+        self.assertEqual(copy.getMaxInverseError(), approx.getMaxInverseError())
+        for a, b in zip(copy.applyForward(self.points), approx.applyForward(self.points)):
+            self.assertEqual(a, b)
+
+
+class SkyWcsApproximationTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.random = np.random.RandomState(6)
+        self.bbox = lsst.geom.Box2D(lsst.geom.Point2D(0, 0), lsst.geom.Extent2D(4000, 4000))
+        self.pixels = [lsst.geom.Point2D(x, y) for x, y in
+                       zip(self.random.uniform(self.bbox.getMinX(), self.bbox.getMaxX(), 200),
+                           self.random.uniform(self.bbox.getMinY(), self.bbox.getMaxY(), 200))]
+
+    def makeWcs(self, crval):
+        cdMatrix = makeCdMatrix(scale=0.2*lsst.geom.arcseconds, orientation=30*lsst.geom.degrees)
+        wcs = makeSkyWcs(crpix=lsst.geom.Point2D(2000, 2000), crval=crval, cdMatrix=cdMatrix)
+        return makeModifiedWcs(pixelTransform=makeRadialTransform([0.0, 1.0, 0.0, 1E-10]), wcs=wcs,
+                               modifyActualPixels=False)
+
+    def checkWcs(self, wcs, approx, skyTolerance, pixelTolerance):
+        sky = wcs.pixelToSky(self.pixels)
+        for a, b in zip(approx.pixelToSky(self.pixels), sky):
+            self.assertLess(a.separation(b), skyTolerance)
+        for a, b in zip(approx.skyToPixel(sky), self.pixels):
+            self.assertLess(a.distanceSquared(b), pixelTolerance**2)
+        self.assertLess(approx.pixelToSky(self.pixels[0]).separation(sky[0]), skyTolerance)
+        self.assertLess(approx.skyToPixel(sky[0]).distanceSquared(self.pixels[0]), pixelTolerance**2)
+
+    def testSkyWcs(self):
+        skyTolerance = 1E-3*lsst.geom.arcseconds
+        pixelTolerance = 1E-3
+        # Include a field containing the pole and one straddling RA = 0.
+        for crval in (lsst.geom.SpherePoint(45, 30, lsst.geom.degrees),
+                      lsst.geom.SpherePoint(0, -5, lsst.geom.degrees),
+                      lsst.geom.SpherePoint(200, 89.9, lsst.geom.degrees)):
+            with self.subTest(crval=crval):
+                wcs = self.makeWcs(crval)
+                approx = SkyWcsApproximation(wcs, self.bbox, skyTolerance, pixelTolerance)
+                self.assertLess(approx.getMaxSkyError(), skyTolerance)
+                self.assertLess(approx.getMaxPixelError(), pixelTolerance)
+                self.checkWcs(wcs, approx, skyTolerance, pixelTolerance)
+
+    def testPersistence(self):
+        wcs = self.makeWcs(lsst.geom.SpherePoint(45, 30, lsst.geom.degrees))
+        approx = SkyWcsApproximation(wcs, self.bbox, 1E-3*lsst.geom.arcseconds, 1E-3)
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            approx.writeFits(filename)
+            copy = SkyWcsApproximation.readFits(filename)
+        self.assertEqual(copy.getTangentPoint(), approx.getTangentPoint())
+        self.assertEqual(copy.getMaxSkyError(), approx.getMaxSkyError())
+        for a, b in zip(copy.pixelToSky(self.pixels), approx.pixelToSky(self.pixels)):
+            self.assertEqual(a, b)
+
+
+class MemoryTester(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
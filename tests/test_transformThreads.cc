@@ -0,0 +1,190 @@
+// -*- LSST-C++ -*-
+
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TransformThreads
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+
+#include "ndarray.h"
+#include "lsst/geom.h"
+#include "lsst/afw/geom/SkyWcs.h"
+#include "lsst/afw/geom/Transform.h"
+#include "lsst/afw/geom/transformFactory.h"
+
+#include "ScopedNumThreads.h"
+
+/*
+ * Stress tests for evaluating one Transform or SkyWcs from many threads at once.
+ *
+ * The thread that creates each object evaluates it while the other threads do.  These tests are most
+ * useful when built with -fsanitize=thread.
+ */
+namespace lsst {
+namespace afw {
+namespace geom {
+
+namespace {
+
+int const N_THREADS = 8;
+int const N_ITERATIONS = 50;
+
+std::vector<lsst::geom::Point2D> makePixels() {
+    std::vector<lsst::geom::Point2D> pixels;
+    for (int i = 0; i < 20; ++i) {
+        for (int j = 0; j < 20; ++j) {
+            pixels.emplace_back(100.0 * i + 0.25, 100.0 * j - 0.5);
+        }
+    }
+    return pixels;
+}
+
+// Call func(threadIndex) from N_THREADS new threads and from the calling thread (which has index
+// N_THREADS) at once, and count the calls that return false.
+template <typename Function>
+int runConcurrently(Function const &func) {
+    std::atomic<int> failures(0);
+    auto const run = [&func, &failures](int t) {
+        for (int i = 0; i < N_ITERATIONS; ++i) {
+            if (!func(t)) {
+                ++failures;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < N_THREADS; ++t) {
+        threads.emplace_back(run, t);
+    }
+    run(N_THREADS);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return failures.load();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(SkyWcsConcurrentEvaluation) {
+    auto const cdMatrix = makeCdMatrix(0.2 * lsst::geom::arcseconds, 30 * lsst::geom::degrees);
+    auto const wcs = makeSkyWcs(lsst::geom::Point2D(1000, 1000),
+                                lsst::geom::SpherePoint(45, 30, lsst::geom::degrees), cdMatrix);
+    auto const pixels = makePixels();
+    auto const sky = wcs->pixelToSky(pixels);
+    auto const roundTrip = wcs->skyToPixel(sky);
+
+    int const failures = runConcurrently([&](int t) {
+        std::size_t const k = t % pixels.size();
+        return wcs->pixelToSky(pixels) == sky && wcs->skyToPixel(sky) == roundTrip &&
+               wcs->pixelToSky(pixels[k]) == sky[k] && wcs->skyToPixel(sky[k]) == roundTrip[k];
+    });
+    BOOST_CHECK_EQUAL(failures, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SkyWcsColumnsWithThreads) {
+    // A WCS built on this thread, evaluated on columns by several worker threads at once.  With a
+    // default of one thread, only the nThreads argument can make the work run concurrently.
+    lsst::afw::detail::ScopedNumThreads const numThreads(1);
+    auto const cdMatrix = makeCdMatrix(0.2 * lsst::geom::arcseconds, 30 * lsst::geom::degrees);
+    auto const wcs = makeSkyWcs(lsst::geom::Point2D(1000, 1000),
+                                lsst::geom::SpherePoint(45, 30, lsst::geom::degrees), cdMatrix);
+    std::size_t const size = 50000;  // several chunks per thread
+    ndarray::Array<double, 1, 1> x = ndarray::allocate(size), y = ndarray::allocate(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        x[i] = 0.1 * (i % 2000);
+        y[i] = 0.3 * (i / 2000);
+    }
+    ndarray::Array<double, 1, 1> ra = ndarray::allocate(size), dec = ndarray::allocate(size);
+    wcs->pixelToSky(x, y, ra, dec, 1);
+    ndarray::Array<double, 1, 1> x1 = ndarray::allocate(size), y1 = ndarray::allocate(size);
+    wcs->skyToPixel(ra, dec, x1, y1, 1);
+
+    for (int iteration = 0; iteration < 5; ++iteration) {
+        ndarray::Array<double, 1, 1> raN = ndarray::allocate(size), decN = ndarray::allocate(size);
+        wcs->pixelToSky(x, y, raN, decN, N_THREADS);
+        ndarray::Array<double, 1, 1> xN = ndarray::allocate(size), yN = ndarray::allocate(size);
+        wcs->skyToPixel(ra, dec, xN, yN, N_THREADS);
+        BOOST_CHECK(std::equal(raN.begin(), raN.end(), ra.begin()));
+        BOOST_CHECK(std::equal(decN.begin(), decN.end(), dec.begin()));
+        BOOST_CHECK(std::equal(xN.begin(), xN.end(), x1.begin()));
+        BOOST_CHECK(std::equal(yN.begin(), yN.end(), y1.begin()));
+    }
+    auto const sky = wcs->pixelToSky(lsst::geom::Point2D(x[size - 1], y[size - 1]));
+    BOOST_CHECK_CLOSE(sky.getLongitude().asRadians(), ra[size - 1], 1e-10);
+    BOOST_CHECK_CLOSE(sky.getLatitude().asRadians(), dec[size - 1], 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(TransformConcurrentEvaluation) {
+    auto const transform = makeRadialTransform(std::vector<double>{0.0, 1.0, 0.0, 1e-8});
+    auto const pixels = makePixels();
+    auto const expected = transform->applyForward(pixels);
+    auto const inverse = transform->applyInverse(expected);
+    auto const jacobian = transform->getJacobian(pixels.back());
+
+    int const failures = runConcurrently([&](int) {
+        return transform->applyForward(pixels) == expected && transform->applyInverse(expected) == inverse &&
+               transform->getJacobian(pixels.back()) == jacobian;
+    });
+    BOOST_CHECK_EQUAL(failures, 0);
+}
+
+BOOST_AUTO_TEST_CASE(TransformsCreatedInWorkerThreads) {
+    // Transforms that are created and destroyed while other threads hold copies of their mappings.
+    auto const pixels = makePixels();
+    int const failures = runConcurrently([&](int t) {
+        auto const transform = makeRadialTransform(std::vector<double>{0.0, 1.0 + t, 0.0, 1e-8});
+        auto const expected = transform->applyForward(pixels);
+        bool ok = true;
+        std::thread other([&]() { ok = transform->applyForward(pixels) == expected; });
+        other.join();
+        return ok;
+    });
+    BOOST_CHECK_EQUAL(failures, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ManyShortLivedTransforms) {
+    // Enough Transforms are created and destroyed on each thread that its copies are pruned several
+    // times, which must not release the copy of a Transform that is still in use.
+    auto const pixels = makePixels();
+    int const failures = runConcurrently([&](int t) {
+        auto const kept = makeRadialTransform(std::vector<double>{0.0, 1.0 + t, 0.0, 1e-8});
+        auto const expected = kept->applyForward(pixels);
+        bool ok = true;
+        for (int i = 0; i < 200; ++i) {
+            auto const temporary = makeRadialTransform(std::vector<double>{0.0, 2.0 + i, 0.0, 1e-8});
+            temporary->applyForward(pixels);
+            ok = ok && kept->applyForward(pixels) == expected;
+        }
+        return ok;
+    });
+    BOOST_CHECK_EQUAL(failures, 0);
+}
+
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst